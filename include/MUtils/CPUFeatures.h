@@ -60,6 +60,7 @@ namespace MUtils
 		static const quint32 FLAG_AVX2  = 0x200U;	///< \brief CPU feature flag \details Indicates that the CPU supports the *AVX2* instruction set extension
 		static const quint32 FLAG_FMA3  = 0x400U;	///< \brief CPU feature flag \details Indicates that the CPU supports the *FMA3* instruction
 		static const quint32 FLAG_LZCNT = 0x800U;	///< \brief CPU feature flag \details Indicates that the CPU supports the *LZCNT* instruction
+		static const quint32 FLAG_AVX512F = 0x1000U;	///< \brief CPU feature flag \details Indicates that the CPU supports the *AVX-512 Foundation* instruction set extension
 
 		/**
 		* \brief Struct to hold information about the CPU. See `_cpu_info_t` for details!
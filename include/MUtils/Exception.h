@@ -22,6 +22,7 @@
 #pragma once
 
 #include <stdexcept>
+#include <cstdio>
 
 #define MUTILS_PRINT_ERROR(FORMAT, ...) do \
 { \
@@ -56,10 +57,16 @@ while(0)
 } \
 while(0)
 
+#if defined(_MSC_VER)
+#define MUTILS_SNPRINTF(BUFFER, SIZE, FORMAT, ...) _snprintf_s((BUFFER), (SIZE), _TRUNCATE, (FORMAT), __VA_ARGS__)
+#else
+#define MUTILS_SNPRINTF(BUFFER, SIZE, FORMAT, ...) snprintf((BUFFER), (SIZE), (FORMAT), __VA_ARGS__)
+#endif
+
 #define MUTILS_THROW_FMT(MESSAGE, ...) do \
 { \
 	char _message[256]; \
-	_snprintf_s(_message, 256, _TRUNCATE, (MESSAGE), __VA_ARGS__); \
+	MUTILS_SNPRINTF(_message, 256, (MESSAGE), __VA_ARGS__); \
 	throw std::runtime_error(_message); \
 } \
 while(0)
@@ -34,16 +34,132 @@
 //Qt
 #include <QByteArray>
 #include <QFile>
+#include <QMap>
+#include <QList>
+#include <QStringList>
 
 namespace MUtils
 {
 	namespace Hash
 	{
 		static const quint16 HASH_BLAKE2_512 = 0x0000U;	///< \brief Hash algorithm identifier \details Use [BLAKE2](https://blake2.net/) hash algorithm, with a length of 512-Bit.
+		static const quint16 HASH_BLAKE2BP_512 = 0x0001U;	///< \brief Hash algorithm identifier \details Use [BLAKE2bp](https://blake2.net/) hash algorithm (4-way parallel tree mode of BLAKE2b), with a length of 512-Bit. Large inputs are spread over up to 4 threads.
+		static const quint16 HASH_BLAKE2SP_256 = 0x0002U;	///< \brief Hash algorithm identifier \details Use [BLAKE2sp](https://blake2.net/) hash algorithm (8-way parallel tree mode of BLAKE2s), with a length of 256-Bit. Large inputs are spread over up to 8 threads.
 		static const quint16 HASH_KECCAK_224 = 0x0100U;	///< \brief Hash algorithm identifier \details Use [Keccak](http://keccak.noekeon.org/) (SHA-3) hash algorithm, with a length of 224-Bit.
 		static const quint16 HASH_KECCAK_256 = 0x0101U;	///< \brief Hash algorithm identifier \details Use [Keccak](http://keccak.noekeon.org/) (SHA-3) hash algorithm, with a length of 256-Bit.
 		static const quint16 HASH_KECCAK_384 = 0x0102U;	///< \brief Hash algorithm identifier \details Use [Keccak](http://keccak.noekeon.org/) (SHA-3) hash algorithm, with a length of 384-Bit.
 		static const quint16 HASH_KECCAK_512 = 0x0103U;	///< \brief Hash algorithm identifier \details Use [Keccak](http://keccak.noekeon.org/) (SHA-3) hash algorithm, with a length of 512-Bit.
+		static const quint16 HASH_SHA3_224   = 0x0200U;	///< \brief Hash algorithm identifier \details Use [SHA-3](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) hash algorithm, with a length of 224-Bit.
+		static const quint16 HASH_SHA3_256   = 0x0201U;	///< \brief Hash algorithm identifier \details Use [SHA-3](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) hash algorithm, with a length of 256-Bit.
+		static const quint16 HASH_SHA3_384   = 0x0202U;	///< \brief Hash algorithm identifier \details Use [SHA-3](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) hash algorithm, with a length of 384-Bit.
+		static const quint16 HASH_SHA3_512   = 0x0203U;	///< \brief Hash algorithm identifier \details Use [SHA-3](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) hash algorithm, with a length of 512-Bit.
+		static const quint16 HASH_SHAKE_128  = 0x0300U;	///< \brief Hash algorithm identifier \details Use [SHAKE128](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) extendable-output function. Hash::digest() returns 256-Bit; use Hash::digest_xof() for other lengths.
+		static const quint16 HASH_SHAKE_256  = 0x0301U;	///< \brief Hash algorithm identifier \details Use [SHAKE256](https://csrc.nist.gov/pubs/fips/202/final) (FIPS 202) extendable-output function. Hash::digest() returns 512-Bit; use Hash::digest_xof() for other lengths.
+		static const quint16 HASH_BLAKE3     = 0x0400U;	///< \brief Hash algorithm identifier \details Use [BLAKE3](https://github.com/BLAKE3-team/BLAKE3) hash algorithm, with a length of 256-Bit. If a key is given, the *keyed_hash* mode is used: A key of exactly 32 bytes is used as-is, any other key is first hashed to 32 bytes with BLAKE3. Large inputs are spread over multiple threads. Use Hash::digest_xof() for other output lengths.
+		static const quint16 HASH_BLAKE3_DERIVE_KEY = 0x0401U;	///< \brief Hash algorithm identifier \details Use [BLAKE3](https://github.com/BLAKE3-team/BLAKE3) hash algorithm in *derive_key* mode, with a length of 256-Bit. The key is used as the (globally unique, application-specific) context string and the input data is the key material; the context string must **not** be empty. Use Hash::digest_xof() for other output lengths.
+		static const quint16 HASH_XXH3_64    = 0x0500U;	///< \brief Hash algorithm identifier \details Use [XXH3](https://github.com/Cyan4973/xxHash) non-cryptographic hash algorithm, with a length of 64-Bit. Suitable for checksums and cache keys, but **not** for security purposes. If a key is given, it is hashed to the 64-Bit seed value. The digest uses the canonical (big-endian) byte order.
+		static const quint16 HASH_XXH3_128   = 0x0501U;	///< \brief Hash algorithm identifier \details Use [XXH3](https://github.com/Cyan4973/xxHash) non-cryptographic hash algorithm, with a length of 128-Bit. Suitable for checksums and de-duplication, but **not** for security purposes. If a key is given, it is hashed to the 64-Bit seed value. The digest uses the canonical (big-endian) byte order.
+		static const quint16 HASH_CRC32C     = 0x0600U;	///< \brief Hash algorithm identifier \details Use the CRC-32C (Castagnoli) checksum, with a length of 32-Bit. Uses the SSE4.2 `crc32` instruction, if supported by the CPU. Suitable for error detection only, **not** for security purposes. If a key is given, it is processed as a prefix of the message. The digest is big-endian.
+
+		/**
+		* \brief Progress callback for Hash::update_stream()
+		*
+		* The callback is invoked on the calling thread after each buffer has been processed. The `progress` parameter is in the 0.0 to 1.0 range; it is always 0.0 for sequential devices, whose size is unknown. Return `false` in order to cancel the operation.
+		*/
+		typedef bool (*progress_callback_t)(const double &progress, void *const userData);
+
+		static const quint32 STREAM_BUFFER_SIZE = 4194304U;	///< \brief Default buffer size used by Hash::update_stream(), in bytes
+		static const quint32 STREAM_QUEUE_DEPTH = 2U;		///< \brief Default number of buffers used by Hash::update_stream()
+		static const quint32 DIGEST_MAX_SIZE = 64U;		///< \brief Maximum size of a (fixed-length) hash value of any supported algorithm, in bytes
+		static const quint32 TREE_CHUNK_SIZE = 1048576U;	///< \brief Default chunk size used by MUtils::Hash::HashTree, in bytes
+
+		/**
+		* \brief Convert binary data into a Hexadecimal-encoded ASCII string
+		*
+		* Like `QByteArray::toHex()`, but uses SSSE3 or AVX2, if supported by the CPU. This is the conversion used by Hash::digest() and friends.
+		*
+		* \param data A read-only reference to a QByteArray object holding the binary data to be converted.
+		*
+		* \param bUpper If set to `true`, the upper-case letters `A` to `F` are used; otherwise the lower-case letters `a` to `f` are used.
+		*
+		* \return The function returns a QByteArray object holding the Hexadecimal-encoded string, which is exactly twice as long as the input.
+		*/
+		MUTILS_API QByteArray to_hex(const QByteArray &data, const bool bUpper = false);
+
+		/**
+		* \brief Convert binary data into a Hexadecimal-encoded ASCII string, using a caller-provided buffer
+		*
+		* Like MUtils::Hash::to_hex(), but the result is written to the given buffer, so that no memory needs to be allocated. The output is **not** NULL-terminated.
+		*
+		* \param data A read-only pointer to the binary data to be converted.
+		*
+		* \param len The length of the binary data, in bytes.
+		*
+		* \param out A pointer to the buffer that receives the Hexadecimal-encoded string.
+		*
+		* \param outLen The size of the output buffer, in bytes. It must be at least `2 * len` bytes.
+		*
+		* \param bUpper If set to `true`, the upper-case letters `A` to `F` are used; otherwise the lower-case letters `a` to `f` are used.
+		*
+		* \return The function returns the number of characters that have been written, i.e. `2 * len`. The function throws, if the buffer is too small!
+		*/
+		MUTILS_API size_t to_hex_into(const quint8 *const data, const size_t len, char *const out, const size_t outLen, const bool bUpper = false);
+
+		/**
+		* \brief Convert a Hexadecimal-encoded ASCII string back into binary data
+		*
+		* Both, upper-case and lower-case letters are accepted. Unlike `QByteArray::fromHex()`, invalid characters are **not** skipped silently; instead, the complete input is rejected.
+		*
+		* \param hex A read-only reference to a QByteArray object holding the Hexadecimal-encoded string.
+		*
+		* \return The function returns a QByteArray object holding the binary data. If the input has an odd length or contains any character that is not a hex digit, an empty QByteArray is returned.
+		*/
+		MUTILS_API QByteArray from_hex(const QByteArray &hex);
+
+		/**
+		* \brief Convert a Hexadecimal-encoded ASCII string back into binary data, using a caller-provided buffer
+		*
+		* Like MUtils::Hash::from_hex(), but the result is written to the given buffer, so that no memory needs to be allocated.
+		*
+		* \param hex A read-only pointer to the Hexadecimal-encoded string. It does **not** need to be NULL-terminated.
+		*
+		* \param len The length of the Hexadecimal-encoded string, in characters.
+		*
+		* \param out A pointer to the buffer that receives the binary data.
+		*
+		* \param outLen The size of the output buffer, in bytes. It must be at least `len / 2` bytes.
+		*
+		* \return The function returns `true`, if the string was decoded successfully, i.e. exactly `len / 2` bytes have been written; it returns `false`, if the string has an odd length or contains any character that is not a hex digit, in which case the contents of the buffer are undefined. The function throws, if the buffer is too small!
+		*/
+		MUTILS_API bool from_hex_into(const char *const hex, const size_t len, quint8 *const out, const size_t outLen);
+
+		/**
+		* \brief Compare two hash values in constant time
+		*
+		* The run-time of this function depends on the length of the hash values only, but **not** on their contents. Use this function, rather than `memcmp()` or `QByteArray::operator==()`, when comparing a computed MAC (keyed hash value) with an expected value that might be controlled by an attacker.
+		*
+		* \param a A read-only pointer to the first hash value.
+		*
+		* \param b A read-only pointer to the second hash value.
+		*
+		* \param len The length of both hash values, in bytes.
+		*
+		* \return The function returns `true`, if the hash values are equal; otherwise it returns `false`.
+		*/
+		MUTILS_API bool digest_equal(const quint8 *const a, const quint8 *const b, const size_t len);
+
+		/**
+		* \brief Compare two hash values in constant time
+		*
+		* Like MUtils::Hash::digest_equal(const quint8*, const quint8*, size_t), but works on QByteArray objects. Hash values of different lengths are never equal. The lengths themselves are **not** considered secret.
+		*
+		* \param a A read-only reference to a QByteArray object holding the first hash value.
+		*
+		* \param b A read-only reference to a QByteArray object holding the second hash value.
+		*
+		* \return The function returns `true`, if the hash values are equal; otherwise it returns `false`.
+		*/
+		MUTILS_API bool digest_equal(const QByteArray &a, const QByteArray &b);
 
 		/**
 		* \brief This abstract class specifies the generic interface for all support hash algorithms.
@@ -90,10 +206,46 @@ namespace MUtils
 			*
 			* \param data A reference to a QFile object. The QFile object must be open and readable. All data from the current file position to the end of the file will be processed.
 			*
+			* Regular files are memory-mapped (in windows of 32 MiB) and the mapped pages are processed directly, i.e. without copying the file contents into an intermediate buffer. Sequential devices, such as pipes, as well as files that can not be mapped are read through a re-used buffer instead. Either way, the file position is at the end of the file after the function has returned successfully.
+			*
 			* \return The function returns `true`, if all data in the file was processed successfully; otherwise (e.g. in case of file read errors) it returns `false`.
 			*/
 			bool update(QFile &file);
 
+			/**
+			* \brief Process the next chunk of input data, starting at the specified file offset
+			*
+			* Like Hash::update(QFile&), but the file is positioned to the given offset first and, optionally, only a limited number of bytes is processed. Together with Hash::save_state() and Hash::restore_state(), this allows for hashing huge files in several "sessions", e.g. in order to resume an interrupted computation without re-reading the data that has already been processed.
+			*
+			* \param file A reference to a QFile object. The QFile object must be open and readable. For sequential devices, such as pipes, the offset must be equal to the current position.
+			*
+			* \param offset The file offset, in bytes, where processing starts.
+			*
+			* \param length The maximum number of bytes to be processed. If set to a negative value, all data up to the end of the file will be processed.
+			*
+			* \return The function returns `true`, if the data was processed successfully; otherwise (e.g. in case of file read errors or if the offset is invalid) it returns `false`. If less than `length` bytes are available, because the end of the file was reached, this is **not** considered an error.
+			*/
+			bool update(QFile &file, const qint64 offset, const qint64 length = -1);
+
+			/**
+			* \brief Process the next chunk of input data, using asynchronous read-ahead
+			*
+			* Like Hash::update(QFile&), but the file is read by a background thread, so that reading the next buffer overlaps with hashing the current one. The background thread fills up to `queueDepth` buffers in advance; with the default settings this is classic double-buffering. The function blocks until all data has been processed, the operation has failed or it was cancelled.
+			*
+			* \param file A reference to a QFile object. The QFile object must be open and readable. All data from the current file position to the end of the file will be processed. The QFile object must **not** be accessed by any other thread while this function is running.
+			*
+			* \param bufferSize The size of each buffer, in bytes.
+			*
+			* \param queueDepth The number of buffers. Must be at least 2 in order to overlap I/O and computation; smaller values are adjusted.
+			*
+			* \param callback An optional progress callback that is invoked after each buffer has been processed. It may cancel the operation by returning `false`. If set to `NULL`, no progress will be reported.
+			*
+			* \param userData An optional pointer that is passed to the progress callback as-is.
+			*
+			* \return The function returns `true`, if all data in the file was processed successfully; otherwise (e.g. in case of file read errors or if the operation was cancelled) it returns `false`.
+			*/
+			bool update_stream(QFile &file, const quint32 bufferSize = STREAM_BUFFER_SIZE, const quint32 queueDepth = STREAM_QUEUE_DEPTH, const progress_callback_t callback = NULL, void *const userData = NULL);
+
 			/**
 			* \brief Retrieve the hash value
 			*
@@ -103,12 +255,98 @@ namespace MUtils
 			*
 			* \return The function returns a QByteArray object holding the final hash value (digest). The format depends on the `bAsHex` parameter.
 			*/
-			QByteArray digest(const bool bAsHex = true) { return bAsHex ? finalize().toHex() : finalize(); }
+			QByteArray digest(const bool bAsHex = true) { return bAsHex ? to_hex(finalize()) : finalize(); }
+
+			/**
+			* \brief Retrieve a hash value of the specified length
+			*
+			* This function is used to retrieve the final hash value (digest) of an arbitrary length, after all input data has been processed successfully. It is only supported by *extendable-output functions* (XOF), such as SHAKE128 and SHAKE256. Just like Hash::digest(), it may only be called once.
+			*
+			* \param length The desired length of the hash value, in bytes.
+			*
+			* \param bAsHex If set to `true`, the function returns the hash value as a Hexadecimal-encoded ASCII string; if set to `false`, the function returns the hash value as "raw" bytes.
+			*
+			* \return The function returns a QByteArray object holding the final hash value (digest). The function throws, if the hash algorithm does not support variable-length output!
+			*/
+			QByteArray digest_xof(const quint32 length, const bool bAsHex = true) { return bAsHex ? to_hex(finalize_xof(length)) : finalize_xof(length); }
+
+			/**
+			* \brief Retrieve the hash value into a caller-provided buffer
+			*
+			* Like Hash::digest(), but the "raw" hash value is written to the given buffer, so that no memory needs to be allocated. Just like Hash::digest(), it may only be called once, unless the instance is reset.
+			*
+			* \param out A pointer to the buffer that receives the hash value.
+			*
+			* \param len The size of the buffer, in bytes. It must be at least as big as the hash value, see MUtils::Hash::digest_size(); a buffer of Hash::DIGEST_MAX_SIZE bytes is sufficient for any single algorithm. For a MultiHash, the hash value is the concatenation of all hash values, see MultiHash::digest_size().
+			*
+			* \return The function returns the size of the hash value that has been written to the buffer, in bytes. The function throws, if the buffer is too small!
+			*/
+			size_t digest_into(quint8 *const out, const size_t len) { return finalize_into(out, len); }
+
+			/**
+			* \brief Retrieve the hash value, as a Hexadecimal-encoded ASCII string, into a caller-provided buffer
+			*
+			* Like Hash::digest(true), but the Hexadecimal-encoded hash value is written to the given buffer, so that no memory needs to be allocated. The output is **not** NULL-terminated. Just like Hash::digest(), it may only be called once, unless the instance is reset.
+			*
+			* \param out A pointer to the buffer that receives the Hexadecimal-encoded hash value.
+			*
+			* \param len The size of the buffer, in bytes. It must be at least twice as big as the hash value; a buffer of `2 * Hash::DIGEST_MAX_SIZE` bytes is sufficient for any single algorithm. For a MultiHash, it must be at least `2 * MultiHash::digest_size()` bytes.
+			*
+			* \return The function returns the number of characters that have been written. The function throws, if the buffer is too small!
+			*/
+			size_t digest_hex_into(char *const out, const size_t len) { return finalize_hex_into(out, len); }
+
+			/**
+			* \brief Retrieve a hash value of the specified length into a caller-provided buffer
+			*
+			* Like Hash::digest_xof(), but the "raw" hash value is written to the given buffer, so that no memory needs to be allocated. It is only supported by *extendable-output functions* (XOF).
+			*
+			* \param out A pointer to the buffer that receives the hash value.
+			*
+			* \param len The desired length of the hash value, in bytes. Exactly `len` bytes are written to the buffer.
+			*/
+			void digest_xof_into(quint8 *const out, const size_t len) { finalize_xof_into(out, len); }
+
+			/**
+			* \brief Save the intermediate state of the hash function
+			*
+			* The state is exported in a versioned, platform-independent binary format and it is protected by a checksum. It can be stored (e.g. in a file) and, later on, be loaded into a new instance via Hash::restore_state(), in order to continue the computation where it was left off. The state of a *keyed* instance implicitly contains the key, so it must be handled with the same care as the key itself!
+			*
+			* Currently, this is supported by the BLAKE2 (`HASH_BLAKE2_512`), Keccak and SHA-3/SHAKE algorithms only. The function throws, if the hash algorithm does not support state serialization or if the hash value has already been retrieved.
+			*
+			* \return The function returns a QByteArray object holding the serialized state.
+			*/
+			QByteArray save_state(void) const { return serialize(); }
+
+			/**
+			* \brief Restore a previously saved intermediate state of the hash function
+			*
+			* \param state A QByteArray object holding a state that has been returned by Hash::save_state(). The state must have been saved by an instance of the *same* hash algorithm.
+			*
+			* \return The function returns `true`, if the state was restored successfully; otherwise (e.g. if the state is corrupted, truncated or was saved by a different hash algorithm) it returns `false` and the current state is left unchanged.
+			*/
+			bool restore_state(const QByteArray &state) { return deserialize(state); }
+
+			/**
+			* \brief Reset the hash function to its initial state
+			*
+			* Discards all input data that has been processed so far, so that the same instance can be used to compute the hash value of another message. This function may be called at any time, including after Hash::digest() or Hash::digest_xof(). The key that was specified when the instance was created remains in effect.
+			*
+			* This function does **not** allocate any memory. Re-using a single instance via Hash::reset() therefore avoids the heap allocations implied by creating a new instance, which can make a considerable difference when hashing large numbers of short messages.
+			*/
+			void reset(void) { reinit(); }
 
 		protected:
 			Hash(const char* /*key*/ = NULL) {/*nothing to do*/};
 			virtual bool process(const quint8 *const data, const quint32 len) = 0;
-			virtual QByteArray finalize(void) = 0;
+			virtual void reinit(void) = 0;
+			virtual QByteArray finalize(void);
+			virtual QByteArray finalize_xof(const quint32 length);
+			virtual size_t finalize_into(quint8 *const out, const size_t len) = 0;
+			virtual size_t finalize_hex_into(char *const out, const size_t len);
+			virtual void finalize_xof_into(quint8 *const out, const size_t len);
+			virtual QByteArray serialize(void) const;
+			virtual bool deserialize(const QByteArray &state);
 
 		private:
 			MUTILS_NO_COPY(Hash);
@@ -123,8 +361,445 @@ namespace MUtils
 		*
 		* \param key Specifies on optional key that is used to "seed" the hash function. If a key is given, it must be a NULL-terminated string of appropriate length. If set to `NULL`, the optional seeding is skipped.
 		*
-		* \return Returns a pointer to a new MUtils::Hash::Hash object that implements the desired hash function. The function throws if an invalid algorithm identifier was specified!
+		* \return Returns a pointer to a new MUtils::Hash::Hash object that implements the desired hash function. The function throws if an invalid algorithm identifier was specified, or if HASH_BLAKE3_DERIVE_KEY is used without a context string!
 		*/
 		MUTILS_API Hash *create(const quint16 &hashId, const char *const key = NULL);
+
+		/**
+		* \brief Create instance of a hash function, with a binary key
+		*
+		* This function works like MUtils::Hash::create(const quint16&, const char *const), except that the key is given as a byte array. HASH_BLAKE3 and HASH_BLAKE3_DERIVE_KEY use the *whole* byte array, so the key may contain NULL characters. All other hash functions throw, if the key contains a NULL character.
+		*
+		* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+		*
+		* \param key Specifies the key that is used to "seed" the hash function. An empty byte array is the same as no key at all.
+		*
+		* \return Returns a pointer to a new MUtils::Hash::Hash object that implements the desired hash function. The function throws if an invalid algorithm identifier or an invalid key was specified!
+		*/
+		MUTILS_API Hash *create(const quint16 &hashId, const QByteArray &key);
+
+		/**
+		* \brief Get the size of the hash value of a hash function
+		*
+		* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+		*
+		* \return The function returns the size of the hash value, as returned by Hash::digest(), in bytes. The function throws if an invalid algorithm identifier was specified!
+		*/
+		MUTILS_API size_t digest_size(const quint16 &hashId);
+
+		/**
+		* \brief Compute the hash value of a single message in one call
+		*
+		* This function produces the same result as creating an instance via MUtils::Hash::create(), processing the message and retrieving the hash value via Hash::digest_into(). However, the hash function's state lives on the stack, so this function does **not** allocate any memory at all.
+		*
+		* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+		*
+		* \param data A read-only pointer to the memory buffer holding the message.
+		*
+		* \param len The length of the message, in bytes.
+		*
+		* \param out A pointer to the buffer that receives the "raw" hash value.
+		*
+		* \param outLen The size of the output buffer, in bytes. It must be at least MUtils::Hash::digest_size() bytes; a buffer of Hash::DIGEST_MAX_SIZE bytes is always sufficient.
+		*
+		* \param key Specifies on optional key that is used to "seed" the hash function, see MUtils::Hash::create() for details.
+		*
+		* \return The function returns the size of the hash value that has been written to the output buffer, in bytes. The function throws if an invalid algorithm identifier was specified or if the output buffer is too small!
+		*/
+		MUTILS_API size_t compute(const quint16 &hashId, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen, const char *const key = NULL);
+
+		/**
+		* \brief Compute the hash value of a single message in one call, with a binary key
+		*
+		* This function works like MUtils::Hash::compute(const quint16&, const quint8 *const, const size_t, quint8 *const, const size_t, const char *const), except that the key is given as a byte array, see MUtils::Hash::create(const quint16&, const QByteArray&) for details.
+		*/
+		MUTILS_API size_t compute(const quint16 &hashId, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen, const QByteArray &key);
+
+		class MUTILS_API HashPool_Private;
+
+		/**
+		* \brief A thread-safe pool of re-usable hash function instances
+		*
+		* All instances in the pool use the hash algorithm and the key that were specified when the pool was created. HashPool::acquire() takes an idle instance from the pool, or creates a new one if the pool is empty; HashPool::release() resets the instance and puts it back into the pool. Once the pool has "warmed up", i.e. it holds as many instances as are used concurrently, acquiring and releasing instances does **not** allocate any memory.
+		*
+		* The functions of this class may be called from different threads concurrently, but each acquired instance must be used by only one thread at a time.
+		*/
+		class MUTILS_API HashPool
+		{
+		public:
+			/**
+			* \brief Create a new pool
+			*
+			* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+			*
+			* \param key Specifies on optional key that is used to "seed" the hash function, see MUtils::Hash::create() for details.
+			*/
+			HashPool(const quint16 &hashId, const char *const key = NULL);
+
+			/**
+			* \brief Destroy the pool, including all idle instances
+			*
+			* All acquired instances must have been released before the pool is destroyed.
+			*/
+			~HashPool(void);
+
+			/**
+			* \brief Acquire an instance from the pool
+			*
+			* \return The function returns a pointer to a MUtils::Hash::Hash object in its initial state. The pool retains ownership of the object, so it must be returned via HashPool::release() rather than being destroyed by the caller.
+			*/
+			Hash *acquire(void);
+
+			/**
+			* \brief Return an instance to the pool
+			*
+			* \param hash A pointer to a MUtils::Hash::Hash object that has been acquired from *this* pool. The object is reset and must no longer be used by the caller.
+			*/
+			void release(Hash *const hash);
+
+		private:
+			HashPool(const HashPool&) : p(NULL) { throw "Constructor is disabled!"; }
+			HashPool &operator=(const HashPool&) { throw "Assignment operator is disabled!"; }
+
+			HashPool_Private *const p;
+		};
+
+		class MUTILS_API MultiHash_Private;
+
+		/**
+		* \brief A composite hash function that computes the hash values of several algorithms in a single pass
+		*
+		* Each chunk of input data is fed to *all* of the hash functions that were specified when the instance was created, so the input needs to be read only once, e.g. when hashing a file via Hash::update(QFile&). Optionally, the hash functions process each (sufficiently big) chunk in parallel, using the global thread pool.
+		*
+		* Use MultiHash::digests() in order to retrieve the individual hash values. Hash::digest() returns the concatenation of all hash values, in the order of the algorithm identifiers.
+		*/
+		class MUTILS_API MultiHash : public Hash
+		{
+		public:
+			/**
+			* \brief Create a new composite hash function
+			*
+			* \param hashIds Specifies the desired hash functions. Each element must be a valid hash algorithm identifier, as defined in the `Hash.h` header file. The list must not be empty.
+			*
+			* \param bParallel If set to `true`, the hash functions process each chunk of input data in parallel threads; if set to `false`, they process it one after another on the calling thread.
+			*
+			* \param key Specifies on optional key that is used to "seed" *all* hash functions, see MUtils::Hash::create() for details.
+			*
+			* The constructor throws if the list is empty or if an invalid algorithm identifier was specified!
+			*/
+			MultiHash(const QList<quint16> &hashIds, const bool bParallel = false, const char *const key = NULL);
+
+			virtual ~MultiHash(void);
+
+			/**
+			* \brief Get the algorithm identifiers
+			*
+			* \return The function returns the algorithm identifiers, in the order they were specified when the instance was created.
+			*/
+			const QList<quint16> &hashIds(void) const;
+
+			/**
+			* \brief Get the size of the combined hash value
+			*
+			* \return The function returns the size of the hash value, as returned by Hash::digest() or Hash::digest_into(), in bytes. This is the sum of the MUtils::Hash::digest_size() of all algorithms and it may exceed Hash::DIGEST_MAX_SIZE.
+			*/
+			size_t digest_size(void) const;
+
+			/**
+			* \brief Retrieve the individual hash values
+			*
+			* Like Hash::digest(), this function may only be called once, unless the instance is reset.
+			*
+			* \param bAsHex If set to `true`, the function returns the hash values as Hexadecimal-encoded ASCII strings; if set to `false`, the function returns the hash values as "raw" bytes.
+			*
+			* \return The function returns a list containing the hash value of each algorithm, in the order of MultiHash::hashIds().
+			*/
+			QList<QByteArray> digests(const bool bAsHex = true);
+
+		protected:
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual QByteArray finalize(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+			virtual size_t finalize_hex_into(char *const out, const size_t len);
+
+		private:
+			MultiHash(const MultiHash&) : Hash(), p(NULL) { throw "Constructor is disabled!"; }
+			MultiHash &operator=(const MultiHash&) { throw "Assignment operator is disabled!"; }
+
+			MultiHash_Private *const p;
+		};
+
+		class MUTILS_API HashTree_Private;
+
+		/**
+		* \brief A hash tree (Merkle tree) over the fixed-size chunks of a file
+		*
+		* The file is split into chunks of a fixed size and each chunk is hashed individually, giving the *leaf* digests. The leaf digests are then combined pair-wise, level by level, until the *root* digest remains. Leaves are hashed as `H(0x00 || chunk)` and inner nodes as `H(0x01 || left || right)`; an unpaired node is passed on to the next level unchanged. An empty file consists of a single empty chunk.
+		*
+		* Once the tree has been built, it can be saved to a "sidecar" file and be loaded again later. After parts of the file have been modified, only the chunks that overlap with the modified ("dirty") ranges need to be re-hashed in order to update the tree. Also, the file can be re-verified against the tree, in which case the mismatching chunks are reported. All chunks are processed by a pool of worker threads.
+		*
+		* This class is **not** thread-safe, i.e. do **not** call the *same* HashTree instance from difference threads, unless serialization is ensured.
+		*/
+		class MUTILS_API HashTree
+		{
+		public:
+			/**
+			* \brief Create a new, empty hash tree
+			*
+			* \param hashId Specifies the hash function used for the leaves and inner nodes. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+			*
+			* \param chunkSize The size of each chunk, in bytes. Must be in the 4 KiB to 1 GiB range.
+			*
+			* \param key Specifies on optional key that is used to "seed" the hash function, see MUtils::Hash::create() for details.
+			*
+			* The constructor throws if an invalid algorithm identifier or an invalid chunk size was specified!
+			*/
+			HashTree(const quint16 &hashId, const quint32 &chunkSize = TREE_CHUNK_SIZE, const char *const key = NULL);
+
+			~HashTree(void);
+
+			/**
+			* \brief Build the tree by hashing all chunks of the file
+			*
+			* \param filePath The path of the file to be hashed.
+			*
+			* \param threads The number of worker threads. If set to zero, the number of available processors is used.
+			*
+			* \return The function returns `true`, if the file was processed successfully; otherwise (e.g. in case of file read errors) it returns `false` and the tree is cleared.
+			*/
+			bool build(const QString &filePath, const quint32 &threads = 0);
+
+			/**
+			* \brief Update the tree after a range of the file has been modified
+			*
+			* Only the chunks that overlap with the given range are re-hashed. If the size of the file has changed, the chunks beyond the previous end of the file (or the new last chunk, if the file was truncated) are re-hashed too. If the tree is empty, the whole file is hashed, as with HashTree::build().
+			*
+			* \param filePath The path of the file. This must be the file that the tree has been built from.
+			*
+			* \param offset The offset of the modified range, in bytes.
+			*
+			* \param length The length of the modified range, in bytes.
+			*
+			* \param threads The number of worker threads. If set to zero, the number of available processors is used.
+			*
+			* \return The function returns `true`, if the tree was updated successfully; otherwise (e.g. in case of file read errors) it returns `false` and the tree is cleared.
+			*/
+			bool update(const QString &filePath, const qint64 &offset, const qint64 &length, const quint32 &threads = 0);
+
+			/**
+			* \brief Verify the file against the tree
+			*
+			* All chunks of the file are re-hashed and compared to the corresponding leaf digests. The tree itself is **not** modified.
+			*
+			* \param filePath The path of the file to be verified.
+			*
+			* \param mismatched Receives the indices of all chunks whose digest does not match, in ascending order. If the size of the file has changed, this includes the chunks that have been added or removed.
+			*
+			* \param threads The number of worker threads. If set to zero, the number of available processors is used.
+			*
+			* \return The function returns `true`, if the file was processed successfully (regardless of whether any mismatches were found); otherwise (e.g. in case of file read errors) it returns `false`.
+			*/
+			bool verify(const QString &filePath, QList<quint32> &mismatched, const quint32 &threads = 0) const;
+
+			/**
+			* \brief Save the tree to a sidecar file
+			*
+			* The sidecar file contains the chunk size, the file size and all leaf digests, in a versioned binary format that is protected by a checksum. The key, if any, is **not** stored.
+			*
+			* \return The function returns `true`, if the file was written successfully; otherwise it returns `false`.
+			*/
+			bool save(const QString &sidecarPath) const;
+
+			/**
+			* \brief Load the tree from a sidecar file
+			*
+			* The sidecar file must have been written by HashTree::save() using the *same* hash algorithm. The chunk size is taken from the sidecar file.
+			*
+			* \return The function returns `true`, if the file was loaded successfully; otherwise (e.g. if the file is corrupted or was written using a different hash algorithm) it returns `false` and the tree is left unchanged.
+			*/
+			bool load(const QString &sidecarPath);
+
+			/**
+			* \brief Check whether the tree is empty, i.e. it has not been built or loaded yet
+			*/
+			bool isEmpty(void) const;
+
+			quint16 hashId(void) const;	///< \brief Get the hash algorithm identifier
+			quint32 chunkSize(void) const;	///< \brief Get the chunk size, in bytes
+			qint64 fileSize(void) const;	///< \brief Get the size of the file that the tree has been built from, in bytes
+			quint32 chunkCount(void) const;	///< \brief Get the number of chunks (leaves); zero, if the tree is empty
+
+			/**
+			* \brief Get the digest of a chunk
+			*
+			* \param index The index of the chunk; must be less than HashTree::chunkCount().
+			*
+			* \param bAsHex If set to `true`, the function returns the digest as a Hexadecimal-encoded ASCII string; if set to `false`, the function returns the "raw" bytes.
+			*/
+			QByteArray leaf(const quint32 &index, const bool bAsHex = true) const;
+
+			/**
+			* \brief Get the root digest
+			*
+			* \param bAsHex If set to `true`, the function returns the digest as a Hexadecimal-encoded ASCII string; if set to `false`, the function returns the "raw" bytes.
+			*
+			* \return The function returns the root digest; an empty QByteArray, if the tree is empty.
+			*/
+			QByteArray root(const bool bAsHex = true) const;
+
+		private:
+			HashTree(const HashTree&) : p(NULL) { throw "Constructor is disabled!"; }
+			HashTree &operator=(const HashTree&) { throw "Assignment operator is disabled!"; }
+
+			HashTree_Private *const p;
+		};
+
+		/**
+		* \brief Map of file paths to hash values, as returned by MUtils::Hash::hash_files()
+		*/
+		typedef QMap<QString, QByteArray> DigestMap;
+
+		/**
+		* \brief Compute the hash values of multiple files in parallel
+		*
+		* This function hashes all given files, distributing the work across a pool of worker threads. Big files are processed as individual tasks, while small files are grouped into batches. The tasks are handed out biggest-first and idle workers "steal" pending tasks from busy ones, so that the load remains balanced. Each file is hashed by a separate MUtils::Hash::Hash instance, as returned by MUtils::Hash::create(). The function blocks until all files have been processed.
+		*
+		* \param files The paths of the files to be hashed.
+		*
+		* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+		*
+		* \param threads The number of worker threads. If set to zero, the number of available processors is used.
+		*
+		* \param bAsHex If set to `true`, the hash values are returned as Hexadecimal-encoded ASCII strings; if set to `false`, the "raw" bytes are returned.
+		*
+		* \param key Specifies on optional key that is used to "seed" the hash function, see MUtils::Hash::create() for details.
+		*
+		* \return Returns a map that contains the hash value of each file, with the file path as key. If a file could not be read, its hash value is an empty QByteArray. The function throws if an invalid algorithm identifier was specified!
+		*/
+		MUTILS_API DigestMap hash_files(const QStringList &files, const quint16 &hashId, const quint32 &threads = 0, const bool bAsHex = true, const char *const key = NULL);
+
+		/**
+		* \brief Compute the hash values of multiple messages in one call
+		*
+		* This function hashes a list of independent messages. It produces the same results as creating a separate MUtils::Hash::Hash instance (via MUtils::Hash::create()) for each message, but it is considerably faster for large numbers of *short* messages. For the Keccak algorithms, the messages are processed in parallel SIMD lanes, i.e. 4 messages at a time with AVX2 or 8 messages at a time with AVX-512, if supported by the CPU.
+		*
+		* \param messages The messages to be hashed.
+		*
+		* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+		*
+		* \param bAsHex If set to `true`, the hash values are returned as Hexadecimal-encoded ASCII strings; if set to `false`, the "raw" bytes are returned.
+		*
+		* \param key Specifies on optional key that is used to "seed" the hash function, see MUtils::Hash::create() for details.
+		*
+		* \return Returns a list containing the hash value of each message, in the same order as the input messages. The function throws if an invalid algorithm identifier was specified!
+		*/
+		MUTILS_API QList<QByteArray> hash_messages(const QList<QByteArray> &messages, const quint16 &hashId, const bool bAsHex = true, const char *const key = NULL);
+
+		class MUTILS_API HashCache_Private;
+
+		/**
+		* \brief A persistent cache of file digests
+		*
+		* The cache remembers the digest of each file, together with the file's size, its modification time and its file identifier (the *inode* number and device on POSIX systems, the file index and volume serial number on Windows). As long as none of these have changed, the cached digest is returned without reading the file. Otherwise, the file is hashed again and the cache is updated.
+		*
+		* The cache is stored as an append-only log file, `MUtilsHashCache.log`, in the cache directory. Each record is protected by a checksum; a truncated or corrupted record at the end of the log (e.g. after a crash) is ignored. Superseded records are dropped when the log is compacted, which happens automatically when the log is opened and contains many of them. Several processes may share the same cache directory, but records that another process appends are only seen after re-opening the cache. Access to the log is coordinated by an advisory lock on `MUtilsHashCache.lock`, so that compaction does not lose the records that other processes append concurrently; the automatic compaction is skipped, while another process is using the log.
+		*
+		* Only *unkeyed* digests are cached. This class is thread-safe.
+		*/
+		class MUTILS_API HashCache
+		{
+		public:
+			/**
+			* \brief Open the cache in the given directory
+			*
+			* \param directory The directory where the log file is stored; it is created, if it does not exist yet. In order for the cache to persist across restarts, this should be a stable per-application location, such as `QStandardPaths::writableLocation(QStandardPaths::CacheLocation)`, but **not** the application's *Temp* folder, as returned by MUtils::temp_folder(), which is removed when the application exits.
+			*
+			* The constructor throws, if the directory is empty! If the directory can not be created, a single warning is issued and the cache is *disabled*: Digests are still remembered in memory, but nothing is written to disk, and logFile() returns an empty string.
+			*/
+			HashCache(const QString &directory);
+
+			~HashCache(void);
+
+			/**
+			* \brief Get the digest of a file, from the cache if possible
+			*
+			* If the cache contains a valid entry for the file, the cached digest is returned; only the file's metadata is queried. Otherwise the file is hashed and the new digest is added to the cache.
+			*
+			* \param filePath The path of the file.
+			*
+			* \param hashId Specifies the desired hash function. This must be a valid hash algorithm identifier, as defined in the `Hash.h` header file.
+			*
+			* \param bAsHex If set to `true`, the function returns the digest as a Hexadecimal-encoded ASCII string; if set to `false`, the function returns the "raw" bytes.
+			*
+			* \return The function returns the digest of the file; an empty QByteArray, if the file could not be read. The function throws if an invalid algorithm identifier was specified!
+			*/
+			QByteArray digest(const QString &filePath, const quint16 &hashId, const bool bAsHex = true);
+
+			/**
+			* \brief Get the digests of multiple files, from the cache if possible
+			*
+			* Works like HashCache::digest(), but the files that are *not* found in the cache are hashed in parallel, using MUtils::Hash::hash_files().
+			*
+			* \param threads The number of worker threads. If set to zero, the number of available processors is used.
+			*
+			* \return Returns a map that contains the digest of each file, with the file path as key. If a file could not be read, its digest is an empty QByteArray. The function throws if an invalid algorithm identifier was specified!
+			*/
+			DigestMap digests(const QStringList &files, const quint16 &hashId, const quint32 &threads = 0, const bool bAsHex = true);
+
+			/**
+			* \brief Look up the digest of a file, without hashing it
+			*
+			* \return The function returns `true` and sets \p digest, if the cache contains a valid entry for the file; otherwise it returns `false`.
+			*/
+			bool lookup(const QString &filePath, const quint16 &hashId, QByteArray &digest, const bool bAsHex = true) const;
+
+			/**
+			* \brief Rewrite the log file, so that it contains only the current entries
+			*
+			* Entries for files that no longer exist are dropped as well.
+			*
+			* \return The function returns `true`, if the log file was rewritten successfully; otherwise it returns `false`.
+			*/
+			bool compact(void);
+
+			/**
+			* \brief Remove all entries from the cache and truncate the log file
+			*/
+			void clear(void);
+
+			quint32 count(void) const;	///< \brief Get the number of entries in the cache
+			QString logFile(void) const;	///< \brief Get the full path of the log file
+
+		private:
+			HashCache(const HashCache&) : p(NULL) { throw "Constructor is disabled!"; }
+			HashCache &operator=(const HashCache&) { throw "Assignment operator is disabled!"; }
+
+			HashCache_Private *const p;
+		};
+
+		//Internal (do *not* call directly!)
+		namespace Internal
+		{
+			//For the known-answer tests only: Forces the given kernel (SIMD implementation), or restores the automatic selection with KERNEL_AUTO.
+			//Returns false, if the kernel is not available in this build, or not supported by the CPU; the current kernel is kept in that case
+			typedef enum
+			{
+				KERNEL_AUTO  = 0,
+				KERNEL_REF   = 1,
+				KERNEL_SSE2  = 2,
+				KERNEL_SSSE3 = 3,
+				KERNEL_SSE41 = 4,
+				KERNEL_SSE42 = 5,
+				KERNEL_AVX2  = 6
+			}
+			kernel_t;
+
+			MUTILS_API bool blake2_select_kernel(const kernel_t kernel);
+			MUTILS_API bool blake3_select_kernel(const kernel_t kernel);
+			MUTILS_API bool xxh3_select_kernel(const kernel_t kernel);
+			MUTILS_API bool crc32c_select_kernel(const kernel_t kernel);
+			MUTILS_API bool hex_select_kernel(const kernel_t kernel);
+		}
 	}
 }
@@ -31,12 +31,29 @@
 namespace MUtils
 {
 	class MUTILS_API IPCChannel_Private;
+	class MUTILS_API IPCChannelNotifier;
+	class MUTILS_API IPCChannel;
+
+	//Internal (do *not* call directly!)
+	namespace Internal
+	{
+		//For the recovery tests only: The next send (read) of a MODE_MPMC or MODE_PUBSUB channel stops right after it has reserved (claimed)
+		//its records and leaves them pending, just as if the process had died at that point
+		MUTILS_API void ipc_abandon_next(IPCChannel *const channel);
+	}
 
 	class MUTILS_API IPCChannel
 	{
+		friend class IPCChannelNotifier;
+		friend void Internal::ipc_abandon_next(IPCChannel *const channel);
+
 	public:
-		static const quint32 MAX_PARAM_LEN = 4096;
-		static const quint32 MAX_PARAM_CNT = 4;
+		static const quint32 MAX_MESSAGE_LEN = 262144; //Maximum size of a message, in bytes (20 bytes, plus 4 bytes + UTF-8 length per param)
+		static const quint32 MAX_PARAM_CNT = 1024;
+
+		static const quint32 BUFFER_SIZE = 1048576; //Size of each shared buffer, in bytes
+		static const quint32 BUFFER_COUNT = 32;     //Number of shared buffers per channel
+		static const quint32 NO_BUFFER = 0xFFFFFFFF;
 
 		typedef enum
 		{
@@ -47,13 +64,57 @@ namespace MUtils
 		}
 		ipc_result_t;
 
-		IPCChannel(const QString &applicationId, const quint32 &versionNo, const QString &channelId);
+		typedef enum
+		{
+			MODE_LOCKED = 0,	//Any number of senders and readers; every operation takes the system-wide lock
+			MODE_SPSC = 1,		//Exactly one sending thread and one reading thread (system-wide); lock-free, the kernel is only entered when a side has to wait
+			MODE_MPMC = 2,		//Any number of senders and readers; lock-free, senders reserve and readers claim records via CAS, each message is read once
+			MODE_PUBSUB = 3		//Any number of senders; every channel instance is a subscriber that receives *all* messages, slow subscribers lose messages
+		}
+		ipc_mode_t;
+
+		typedef struct ipc_message_t
+		{
+			quint32 command;
+			quint32 flags;
+			QStringList params;
+			quint32 buffer;      //Handle of the attached shared buffer, or NO_BUFFER
+			quint32 buffer_size; //Number of valid bytes in the attached shared buffer
+
+			ipc_message_t(void) : command(0), flags(0), buffer(NO_BUFFER), buffer_size(0) {}
+		}
+		ipc_message_t;
+
+		//If "sharedBuffers" is true, a pool of BUFFER_COUNT x BUFFER_SIZE bytes of shared memory is attached; all instances must agree on it
+		IPCChannel(const QString &applicationId, const quint32 &versionNo, const QString &channelId, const ipc_mode_t &mode = MODE_LOCKED, const bool &sharedBuffers = false);
 		~IPCChannel(void);
 
 		int initialize(void);
 
-		bool send(const quint32 &command, const quint32 &flags, const QStringList &params = QStringList());
-		bool read(quint32 &command, quint32 &flags, QStringList &params);
+		//Timeouts are in milliseconds: A negative timeout waits forever, a zero timeout does not wait at all. Only on Linux, a positive timeout
+		//sleeps in the kernel (futex); elsewhere, including Windows, QSystemSemaphore can not wait with a timeout, so the channel is polled
+		//via sleep_ms() in steps of 2 ms until the timeout expires, which adds up to 2 ms of latency and some wake-ups while idle
+		bool send(const quint32 &command, const quint32 &flags, const QStringList &params = QStringList(), const qint32 &timeout_ms = -1);
+		bool read(quint32 &command, quint32 &flags, QStringList &params, const qint32 &timeout_ms = -1);
+		bool read(ipc_message_t &message, const qint32 &timeout_ms = -1);
+
+		inline bool try_send(const quint32 &command, const quint32 &flags, const QStringList &params = QStringList()) { return send(command, flags, params, 0); }
+		inline bool try_read(quint32 &command, quint32 &flags, QStringList &params) { return read(command, flags, params, 0); }
+
+		//Batch operations: All messages that fit into the ring are written (read) under a single lock, with a single wake-up of the other side
+		bool send_batch(const QList<ipc_message_t> &messages);
+		int read_batch(QList<ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms = -1); //Returns the number of messages appended, 0 on timeout, -1 on error
+
+		//Zero-copy payloads (only with "sharedBuffers" enabled): The sender allocates a shared buffer, fills it in place and sends its handle,
+		//which hands the buffer over to the reader of the message; the reader accesses the same pages via buffer_data() and must call
+		//release_buffer() when done. Messages received via the read(command, flags, params) overload have their buffer released automatically.
+		quint8 *alloc_buffer(quint32 &handle, const qint32 &timeout_ms = -1);
+		bool send_buffer(const quint32 &command, const quint32 &flags, const quint32 &handle, const quint32 &size, const QStringList &params = QStringList(), const qint32 &timeout_ms = -1);
+		const quint8 *buffer_data(const quint32 &handle);
+		bool release_buffer(const quint32 &handle);
+
+		//MODE_PUBSUB only: Number of times this subscriber has fallen behind the senders by more than the ring size and has skipped messages
+		quint32 overflow_count(void) const;
 
 	private:
 		IPCChannel(const IPCChannel&) : p(NULL), m_appVersionNo((unsigned int)(-1)) { throw "Constructor is disabled!"; }
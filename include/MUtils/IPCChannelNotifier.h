@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QObject>
+
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class IPCChannel;
+	class IPCChannelNotifier_Thread;
+
+	/*
+	 * Emits messagesAvailable() whenever new messages have been written to the channel, so that a consumer can be driven by its event
+	 * loop, instead of a thread that blocks in IPCChannel::read(). The receiver should drain the channel, e.g. via IPCChannel::try_read()
+	 * or IPCChannel::read_batch() with a zero timeout; the signal is not repeated for messages that have already been signalled.
+	 *
+	 * The channel must be initialized before and it must outlive the notifier.
+	 */
+	class MUTILS_API IPCChannelNotifier : public QObject
+	{
+		Q_OBJECT
+		friend class IPCChannelNotifier_Thread;
+
+	public:
+		IPCChannelNotifier(IPCChannel *const channel, QObject *const parent = NULL);
+		~IPCChannelNotifier(void);
+
+	signals:
+		void messagesAvailable(void);
+
+	private:
+		IPCChannelNotifier(const IPCChannelNotifier&) : QObject(NULL), m_thread(NULL) { throw "Constructor is disabled!"; }
+		IPCChannelNotifier &operator=(const IPCChannelNotifier&) { throw "Assignment operator is disabled!"; }
+
+		IPCChannelNotifier_Thread *const m_thread;
+	};
+}
@@ -180,6 +180,10 @@ namespace MUtils
 					#else
 						#error Compiler is not supported!
 					#endif
+				#elif defined(__clang__)
+					"Clang " __clang_version__;
+				#elif defined(__GNUC__)
+					"GCC " __VERSION__;
 				#else
 					#error Compiler is not supported!
 				#endif
@@ -190,10 +194,12 @@ namespace MUtils
 		static const char *const compiler_arch(void)
 		{
 			static const char *const COMPILER_ARCH =
-				#if defined(_M_X64)
+				#if defined(_M_X64) || defined(__x86_64__)
 					"x64";
-				#elif defined(_M_IX86)
+				#elif defined(_M_IX86) || defined(__i386__)
 					"x86";
+				#elif defined(_M_ARM64) || defined(__aarch64__)
+					"arm64";
 				#else
 					#error Architecture is not supported!
 				#endif
@@ -34,6 +34,15 @@ namespace MUtils
 		{
 			namespace Blake2Impl
 			{
+				enum blake2s_constant
+				{
+					BLAKE2S_BLOCKBYTES = 64,
+					BLAKE2S_OUTBYTES   = 32,
+					BLAKE2S_KEYBYTES   = 32,
+					BLAKE2S_SALTBYTES  = 8,
+					BLAKE2S_PERSONALBYTES = 8
+				};
+
 				enum blake2b_constant
 				{
 					BLAKE2B_BLOCKBYTES = 128,
@@ -43,6 +52,38 @@ namespace MUtils
 					BLAKE2B_PERSONALBYTES = 16
 				};
 
+				enum blake2_tree_constant
+				{
+					BLAKE2BP_PARALLELISM = 4,
+					BLAKE2SP_PARALLELISM = 8
+				};
+
+				#pragma pack(push, 1)
+				typedef struct __blake2s_param
+				{
+					uint8_t  digest_length; // 1
+					uint8_t  key_length;    // 2
+					uint8_t  fanout;        // 3
+					uint8_t  depth;         // 4
+					uint32_t leaf_length;   // 8
+					uint8_t  node_offset[6];// 14
+					uint8_t  node_depth;    // 15
+					uint8_t  inner_length;  // 16
+					uint8_t  salt[BLAKE2S_SALTBYTES]; // 24
+					uint8_t  personal[BLAKE2S_PERSONALBYTES];  // 32
+				} blake2s_param;
+				#pragma pack(pop)
+
+				typedef struct ALIGN( 64 ) __blake2s_state
+				{
+					uint32_t h[8];
+					uint32_t t[2];
+					uint32_t f[2];
+					uint8_t  buf[2 * BLAKE2S_BLOCKBYTES];
+					size_t   buflen;
+					uint8_t  last_node;
+				} blake2s_state;
+
 				#pragma pack(push, 1)
 				typedef struct __blake2b_param
 				{
@@ -58,8 +99,9 @@ namespace MUtils
 					uint8_t  salt[BLAKE2B_SALTBYTES]; // 48
 					uint8_t  personal[BLAKE2B_PERSONALBYTES];  // 64
 				} blake2b_param;
+				#pragma pack(pop)
 
-				ALIGN( 64 ) typedef struct __blake2b_state
+				typedef struct ALIGN( 64 ) __blake2b_state
 				{
 					uint64_t h[8];
 					uint64_t t[2];
@@ -68,7 +110,38 @@ namespace MUtils
 					size_t   buflen;
 					uint8_t  last_node;
 				} blake2b_state;
-				#pragma pack(pop)
+
+				typedef struct ALIGN( 64 ) __blake2bp_state
+				{
+					blake2b_state S[BLAKE2BP_PARALLELISM];
+					blake2b_state R;
+					uint8_t  buf[BLAKE2BP_PARALLELISM * BLAKE2B_BLOCKBYTES];
+					size_t   buflen;
+				} blake2bp_state;
+
+				typedef struct ALIGN( 64 ) __blake2sp_state
+				{
+					blake2s_state S[BLAKE2SP_PARALLELISM];
+					blake2s_state R;
+					uint8_t  buf[BLAKE2SP_PARALLELISM * BLAKE2S_BLOCKBYTES];
+					size_t   buflen;
+				} blake2sp_state;
+
+				// Runs task(arg, 0) ... task(arg, count-1), possibly in parallel, and returns when all are done
+				typedef void ( *blake2_task_fn )( void *arg, const size_t index );
+				typedef void ( *blake2_parallel_fn )( blake2_task_fn task, void *arg, const size_t count );
+
+				// Compression function implementations
+				enum blake2b_impl
+				{
+					BLAKE2B_IMPL_REF   = 0,
+					BLAKE2B_IMPL_SSE41 = 1,
+					BLAKE2B_IMPL_AVX2  = 2
+				};
+
+				// Dispatch API
+				int blake2b_select_impl( const blake2b_impl impl );
+				blake2b_impl blake2b_current_impl( void );
 
 				// Streaming API
 				int blake2b_init( blake2b_state *S, const uint8_t outlen );
@@ -77,6 +150,23 @@ namespace MUtils
 				int blake2b_update( blake2b_state *S, const uint8_t *in, uint64_t inlen );
 				int blake2b_final( blake2b_state *S, uint8_t *out, uint8_t outlen );
 
+				int blake2s_init( blake2s_state *S, const uint8_t outlen );
+				int blake2s_init_key( blake2s_state *S, const uint8_t outlen, const void *key, const uint8_t keylen );
+				int blake2s_init_param( blake2s_state *S, const blake2s_param *P );
+				int blake2s_update( blake2s_state *S, const uint8_t *in, uint64_t inlen );
+				int blake2s_final( blake2s_state *S, uint8_t *out, uint8_t outlen );
+
+				// Tree-mode API (the "parallel" callback may be NULL, in which case the leaves are processed sequentially)
+				int blake2bp_init( blake2bp_state *S, const uint8_t outlen );
+				int blake2bp_init_key( blake2bp_state *S, const uint8_t outlen, const void *key, const uint8_t keylen );
+				int blake2bp_update( blake2bp_state *S, const uint8_t *in, uint64_t inlen, blake2_parallel_fn parallel );
+				int blake2bp_final( blake2bp_state *S, uint8_t *out, const uint8_t outlen );
+
+				int blake2sp_init( blake2sp_state *S, const uint8_t outlen );
+				int blake2sp_init_key( blake2sp_state *S, const uint8_t outlen, const void *key, const uint8_t keylen );
+				int blake2sp_update( blake2sp_state *S, const uint8_t *in, uint64_t inlen, blake2_parallel_fn parallel );
+				int blake2sp_final( blake2sp_state *S, uint8_t *out, const uint8_t outlen );
+
 				// Simple API
 				int blake2b( uint8_t *out, const void *in, const void *key, const uint8_t outlen, const uint64_t inlen, uint8_t keylen );
 
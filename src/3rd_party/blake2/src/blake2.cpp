@@ -17,6 +17,20 @@
 
 #include "../include/blake2.h"
 
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BLAKE2_HAVE_X86 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <smmintrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define BLAKE2_TARGET(X) __attribute__((target(X)))
+#else
+#define BLAKE2_TARGET(X)
+#endif
+
 /*------------------------------------*/
 /* blake2-impl.h */
 /*------------------------------------*/
@@ -335,7 +349,7 @@ int MUtils::Hash::Internal::Blake2Impl::blake2b_init_key( blake2b_state *S, cons
   return 0;
 }
 
-static int blake2b_compress( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] )
+static int blake2b_compress_ref( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] )
 {
   uint64_t m[16];
   uint64_t v[16];
@@ -398,6 +412,303 @@ static int blake2b_compress( MUtils::Hash::Internal::Blake2Impl::blake2b_state *
   return 0;
 }
 
+#if defined(BLAKE2_HAVE_X86)
+
+/*------------------------------------*/
+/* blake2b-sse41.c */
+/*------------------------------------*/
+
+#define LOADU(p)  _mm_loadu_si128( (const __m128i *)(p) )
+#define STOREU(p,r) _mm_storeu_si128((__m128i *)(p), r)
+#define LOADM(a,b) _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i *)&m[a] ), _mm_loadl_epi64( (const __m128i *)&m[b] ) )
+
+#define ROTI64(x, c) \
+    (-(c) == 32) ? _mm_shuffle_epi32((x), _MM_SHUFFLE(2,3,0,1))  \
+    : (-(c) == 24) ? _mm_shuffle_epi8((x), r24) \
+    : (-(c) == 16) ? _mm_shuffle_epi8((x), r16) \
+    : (-(c) == 63) ? _mm_xor_si128(_mm_srli_epi64((x), -(c)), _mm_add_epi64((x), (x)))  \
+    : _mm_xor_si128(_mm_srli_epi64((x), -(c)), _mm_slli_epi64((x), 64-(-(c))))
+
+#define G1(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1) \
+  row1l = _mm_add_epi64(_mm_add_epi64(row1l, b0), row2l); \
+  row1h = _mm_add_epi64(_mm_add_epi64(row1h, b1), row2h); \
+  \
+  row4l = _mm_xor_si128(row4l, row1l); \
+  row4h = _mm_xor_si128(row4h, row1h); \
+  \
+  row4l = ROTI64(row4l, -32); \
+  row4h = ROTI64(row4h, -32); \
+  \
+  row3l = _mm_add_epi64(row3l, row4l); \
+  row3h = _mm_add_epi64(row3h, row4h); \
+  \
+  row2l = _mm_xor_si128(row2l, row3l); \
+  row2h = _mm_xor_si128(row2h, row3h); \
+  \
+  row2l = ROTI64(row2l, -24); \
+  row2h = ROTI64(row2h, -24);
+
+#define G2(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1) \
+  row1l = _mm_add_epi64(_mm_add_epi64(row1l, b0), row2l); \
+  row1h = _mm_add_epi64(_mm_add_epi64(row1h, b1), row2h); \
+  \
+  row4l = _mm_xor_si128(row4l, row1l); \
+  row4h = _mm_xor_si128(row4h, row1h); \
+  \
+  row4l = ROTI64(row4l, -16); \
+  row4h = ROTI64(row4h, -16); \
+  \
+  row3l = _mm_add_epi64(row3l, row4l); \
+  row3h = _mm_add_epi64(row3h, row4h); \
+  \
+  row2l = _mm_xor_si128(row2l, row3l); \
+  row2h = _mm_xor_si128(row2h, row3h); \
+  \
+  row2l = ROTI64(row2l, -63); \
+  row2h = ROTI64(row2h, -63);
+
+#define DIAGONALIZE(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h) \
+  t0 = _mm_alignr_epi8(row2h, row2l, 8); \
+  t1 = _mm_alignr_epi8(row2l, row2h, 8); \
+  row2l = t0; \
+  row2h = t1; \
+  \
+  t0 = row3l; \
+  row3l = row3h; \
+  row3h = t0;    \
+  \
+  t0 = _mm_alignr_epi8(row4h, row4l, 8); \
+  t1 = _mm_alignr_epi8(row4l, row4h, 8); \
+  row4l = t1; \
+  row4h = t0;
+
+#define UNDIAGONALIZE(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h) \
+  t0 = _mm_alignr_epi8(row2l, row2h, 8); \
+  t1 = _mm_alignr_epi8(row2h, row2l, 8); \
+  row2l = t0; \
+  row2h = t1; \
+  \
+  t0 = row3l; \
+  row3l = row3h; \
+  row3h = t0; \
+  \
+  t0 = _mm_alignr_epi8(row4l, row4h, 8); \
+  t1 = _mm_alignr_epi8(row4h, row4l, 8); \
+  row4l = t1; \
+  row4h = t0;
+
+#define ROUND(r) \
+  b0 = LOADM(blake2b_sigma[r][ 0], blake2b_sigma[r][ 2]); \
+  b1 = LOADM(blake2b_sigma[r][ 4], blake2b_sigma[r][ 6]); \
+  G1(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1); \
+  b0 = LOADM(blake2b_sigma[r][ 1], blake2b_sigma[r][ 3]); \
+  b1 = LOADM(blake2b_sigma[r][ 5], blake2b_sigma[r][ 7]); \
+  G2(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1); \
+  DIAGONALIZE(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h); \
+  b0 = LOADM(blake2b_sigma[r][ 8], blake2b_sigma[r][10]); \
+  b1 = LOADM(blake2b_sigma[r][12], blake2b_sigma[r][14]); \
+  G1(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1); \
+  b0 = LOADM(blake2b_sigma[r][ 9], blake2b_sigma[r][11]); \
+  b1 = LOADM(blake2b_sigma[r][13], blake2b_sigma[r][15]); \
+  G2(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h,b0,b1); \
+  UNDIAGONALIZE(row1l,row2l,row3l,row4l,row1h,row2h,row3h,row4h);
+
+BLAKE2_TARGET("sse4.1")
+static int blake2b_compress_sse41( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] )
+{
+  __m128i row1l, row1h;
+  __m128i row2l, row2h;
+  __m128i row3l, row3h;
+  __m128i row4l, row4h;
+  __m128i b0, b1;
+  __m128i t0, t1;
+  uint64_t m[16];
+
+  const __m128i r16 = _mm_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 );
+  const __m128i r24 = _mm_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 );
+
+  memcpy( m, block, sizeof( m ) ); /* x86 is little-endian */
+
+  row1l = LOADU( &S->h[0] );
+  row1h = LOADU( &S->h[2] );
+  row2l = LOADU( &S->h[4] );
+  row2h = LOADU( &S->h[6] );
+  row3l = LOADU( &blake2b_IV[0] );
+  row3h = LOADU( &blake2b_IV[2] );
+  row4l = _mm_xor_si128( LOADU( &blake2b_IV[4] ), LOADU( &S->t[0] ) );
+  row4h = _mm_xor_si128( LOADU( &blake2b_IV[6] ), LOADU( &S->f[0] ) );
+
+  ROUND( 0 );
+  ROUND( 1 );
+  ROUND( 2 );
+  ROUND( 3 );
+  ROUND( 4 );
+  ROUND( 5 );
+  ROUND( 6 );
+  ROUND( 7 );
+  ROUND( 8 );
+  ROUND( 9 );
+  ROUND( 10 );
+  ROUND( 11 );
+
+  row1l = _mm_xor_si128( row3l, row1l );
+  row1h = _mm_xor_si128( row3h, row1h );
+  STOREU( &S->h[0], _mm_xor_si128( LOADU( &S->h[0] ), row1l ) );
+  STOREU( &S->h[2], _mm_xor_si128( LOADU( &S->h[2] ), row1h ) );
+  row2l = _mm_xor_si128( row4l, row2l );
+  row2h = _mm_xor_si128( row4h, row2h );
+  STOREU( &S->h[4], _mm_xor_si128( LOADU( &S->h[4] ), row2l ) );
+  STOREU( &S->h[6], _mm_xor_si128( LOADU( &S->h[6] ), row2h ) );
+  return 0;
+}
+
+#undef G1
+#undef G2
+#undef DIAGONALIZE
+#undef UNDIAGONALIZE
+#undef ROUND
+#undef ROTI64
+
+/*------------------------------------*/
+/* blake2b-avx2.c */
+/*------------------------------------*/
+
+#define LOADM256(a,b,c,d) _mm256_inserti128_si256( _mm256_castsi128_si256( LOADM(a,b) ), LOADM(c,d), 1 )
+
+#define ROTR32(x)  _mm256_shuffle_epi32( (x), _MM_SHUFFLE(2,3,0,1) )
+#define ROTR24(x)  _mm256_shuffle_epi8( (x), r24 )
+#define ROTR16(x)  _mm256_shuffle_epi8( (x), r16 )
+#define ROTR63(x)  _mm256_xor_si256( _mm256_srli_epi64( (x), 63 ), _mm256_add_epi64( (x), (x) ) )
+
+#define G1(a,b,c,d,m) \
+  a = _mm256_add_epi64( _mm256_add_epi64( a, m ), b ); \
+  d = ROTR32( _mm256_xor_si256( d, a ) ); \
+  c = _mm256_add_epi64( c, d ); \
+  b = ROTR24( _mm256_xor_si256( b, c ) );
+
+#define G2(a,b,c,d,m) \
+  a = _mm256_add_epi64( _mm256_add_epi64( a, m ), b ); \
+  d = ROTR16( _mm256_xor_si256( d, a ) ); \
+  c = _mm256_add_epi64( c, d ); \
+  b = ROTR63( _mm256_xor_si256( b, c ) );
+
+#define DIAGONALIZE(a,b,c,d) \
+  b = _mm256_permute4x64_epi64( b, _MM_SHUFFLE(0,3,2,1) ); \
+  c = _mm256_permute4x64_epi64( c, _MM_SHUFFLE(1,0,3,2) ); \
+  d = _mm256_permute4x64_epi64( d, _MM_SHUFFLE(2,1,0,3) );
+
+#define UNDIAGONALIZE(a,b,c,d) \
+  b = _mm256_permute4x64_epi64( b, _MM_SHUFFLE(2,1,0,3) ); \
+  c = _mm256_permute4x64_epi64( c, _MM_SHUFFLE(1,0,3,2) ); \
+  d = _mm256_permute4x64_epi64( d, _MM_SHUFFLE(0,3,2,1) );
+
+#define ROUND(r) \
+  b0 = LOADM256(blake2b_sigma[r][ 0], blake2b_sigma[r][ 2], blake2b_sigma[r][ 4], blake2b_sigma[r][ 6]); \
+  G1(a,b,c,d,b0); \
+  b0 = LOADM256(blake2b_sigma[r][ 1], blake2b_sigma[r][ 3], blake2b_sigma[r][ 5], blake2b_sigma[r][ 7]); \
+  G2(a,b,c,d,b0); \
+  DIAGONALIZE(a,b,c,d); \
+  b0 = LOADM256(blake2b_sigma[r][ 8], blake2b_sigma[r][10], blake2b_sigma[r][12], blake2b_sigma[r][14]); \
+  G1(a,b,c,d,b0); \
+  b0 = LOADM256(blake2b_sigma[r][ 9], blake2b_sigma[r][11], blake2b_sigma[r][13], blake2b_sigma[r][15]); \
+  G2(a,b,c,d,b0); \
+  UNDIAGONALIZE(a,b,c,d);
+
+BLAKE2_TARGET("avx2")
+static int blake2b_compress_avx2( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] )
+{
+  __m256i a, b, c, d, b0;
+  uint64_t m[16];
+
+  const __m256i r16 = _mm256_setr_epi8( 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9, 2, 3, 4, 5, 6, 7, 0, 1, 10, 11, 12, 13, 14, 15, 8, 9 );
+  const __m256i r24 = _mm256_setr_epi8( 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10, 3, 4, 5, 6, 7, 0, 1, 2, 11, 12, 13, 14, 15, 8, 9, 10 );
+
+  memcpy( m, block, sizeof( m ) ); /* x86 is little-endian */
+
+  a = _mm256_loadu_si256( (const __m256i *)&S->h[0] );
+  b = _mm256_loadu_si256( (const __m256i *)&S->h[4] );
+  c = _mm256_loadu_si256( (const __m256i *)&blake2b_IV[0] );
+  d = _mm256_xor_si256( _mm256_loadu_si256( (const __m256i *)&blake2b_IV[4] ), _mm256_loadu_si256( (const __m256i *)&S->t[0] ) );
+
+  ROUND( 0 );
+  ROUND( 1 );
+  ROUND( 2 );
+  ROUND( 3 );
+  ROUND( 4 );
+  ROUND( 5 );
+  ROUND( 6 );
+  ROUND( 7 );
+  ROUND( 8 );
+  ROUND( 9 );
+  ROUND( 10 );
+  ROUND( 11 );
+
+  a = _mm256_xor_si256( a, c );
+  b = _mm256_xor_si256( b, d );
+  _mm256_storeu_si256( (__m256i *)&S->h[0], _mm256_xor_si256( _mm256_loadu_si256( (const __m256i *)&S->h[0] ), a ) );
+  _mm256_storeu_si256( (__m256i *)&S->h[4], _mm256_xor_si256( _mm256_loadu_si256( (const __m256i *)&S->h[4] ), b ) );
+  return 0;
+}
+
+#undef G1
+#undef G2
+#undef DIAGONALIZE
+#undef UNDIAGONALIZE
+#undef ROUND
+#undef ROTR32
+#undef ROTR24
+#undef ROTR16
+#undef ROTR63
+#undef LOADM256
+#undef LOADM
+#undef LOADU
+#undef STOREU
+
+#endif /*BLAKE2_HAVE_X86*/
+
+/*------------------------------------*/
+/* Dispatch */
+/*------------------------------------*/
+
+typedef int ( *blake2b_compress_fn )( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] );
+
+static blake2b_compress_fn g_blake2b_compress = blake2b_compress_ref;
+static MUtils::Hash::Internal::Blake2Impl::blake2b_impl g_blake2b_impl = MUtils::Hash::Internal::Blake2Impl::BLAKE2B_IMPL_REF;
+
+static inline int blake2b_compress( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES] )
+{
+  return g_blake2b_compress( S, block );
+}
+
+/* must be called before any other thread starts hashing, the CPU support is *not* verified here */
+int MUtils::Hash::Internal::Blake2Impl::blake2b_select_impl( const blake2b_impl impl )
+{
+  switch( impl )
+  {
+  case BLAKE2B_IMPL_REF:
+    g_blake2b_compress = blake2b_compress_ref;
+    break;
+#if defined(BLAKE2_HAVE_X86)
+  case BLAKE2B_IMPL_SSE41:
+    g_blake2b_compress = blake2b_compress_sse41;
+    break;
+  case BLAKE2B_IMPL_AVX2:
+    g_blake2b_compress = blake2b_compress_avx2;
+    break;
+#endif
+  default:
+    return -1;
+  }
+
+  g_blake2b_impl = impl;
+  return 0;
+}
+
+MUtils::Hash::Internal::Blake2Impl::blake2b_impl MUtils::Hash::Internal::Blake2Impl::blake2b_current_impl( void )
+{
+  return g_blake2b_impl;
+}
+
 /* inlen now in bytes */
 int MUtils::Hash::Internal::Blake2Impl::blake2b_update( blake2b_state *S, const uint8_t *in, uint64_t inlen )
 {
@@ -416,6 +727,19 @@ int MUtils::Hash::Internal::Blake2Impl::blake2b_update( blake2b_state *S, const
       S->buflen -= BLAKE2B_BLOCKBYTES;
       in += fill;
       inlen -= fill;
+      if( inlen > BLAKE2B_BLOCKBYTES ) // Buffered block can not be the last one, compress input in-place
+      {
+        blake2b_increment_counter( S, BLAKE2B_BLOCKBYTES );
+        blake2b_compress( S, S->buf );
+        S->buflen = 0;
+        while( inlen > BLAKE2B_BLOCKBYTES )
+        {
+          blake2b_increment_counter( S, BLAKE2B_BLOCKBYTES );
+          blake2b_compress( S, in );
+          in += BLAKE2B_BLOCKBYTES;
+          inlen -= BLAKE2B_BLOCKBYTES;
+        }
+      }
     }
     else // inlen <= fill
     {
@@ -482,6 +806,586 @@ int MUtils::Hash::Internal::Blake2Impl::blake2b( uint8_t *out, const void *in, c
   return 0;
 }
 
+/*------------------------------------*/
+/* blake2s-ref.c */
+/*------------------------------------*/
+
+static const uint32_t blake2s_IV[8] =
+{
+  0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+  0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+static inline int blake2s_set_lastnode( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S )
+{
+  S->f[1] = ~0U;
+  return 0;
+}
+
+static inline int blake2s_set_lastblock( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S )
+{
+  if( S->last_node ) blake2s_set_lastnode( S );
+
+  S->f[0] = ~0U;
+  return 0;
+}
+
+static inline int blake2s_increment_counter( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S, const uint32_t inc )
+{
+  S->t[0] += inc;
+  S->t[1] += ( S->t[0] < inc );
+  return 0;
+}
+
+static inline int blake2s_init0( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S )
+{
+  int i;
+
+  memset( S, 0, sizeof( MUtils::Hash::Internal::Blake2Impl::blake2s_state ) );
+
+  for( i = 0; i < 8; ++i ) S->h[i] = blake2s_IV[i];
+
+  return 0;
+}
+
+/* init2 xors IV with input parameter block */
+int MUtils::Hash::Internal::Blake2Impl::blake2s_init_param( blake2s_state *S, const blake2s_param *P )
+{
+  const uint8_t *p;
+  size_t i;
+
+  blake2s_init0( S );
+  p = ( const uint8_t * )( P );
+
+  /* IV XOR ParamBlock */
+  for( i = 0; i < 8; ++i )
+    S->h[i] ^= load32( p + sizeof( S->h[i] ) * i );
+
+  return 0;
+}
+
+static inline void blake2s_param_init( MUtils::Hash::Internal::Blake2Impl::blake2s_param *P, const uint8_t outlen, const uint8_t keylen )
+{
+  P->digest_length = outlen;
+  P->key_length    = keylen;
+  P->fanout        = 1;
+  P->depth         = 1;
+  store32( &P->leaf_length, 0 );
+  store48( &P->node_offset, 0 );
+  P->node_depth    = 0;
+  P->inner_length  = 0;
+  memset( P->salt,     0, sizeof( P->salt ) );
+  memset( P->personal, 0, sizeof( P->personal ) );
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2s_init( blake2s_state *S, const uint8_t outlen )
+{
+  blake2s_param P[1];
+
+  if ( ( !outlen ) || ( outlen > BLAKE2S_OUTBYTES ) ) return -1;
+
+  blake2s_param_init( P, outlen, 0 );
+  return blake2s_init_param( S, P );
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2s_init_key( blake2s_state *S, const uint8_t outlen, const void *key, const uint8_t keylen )
+{
+  blake2s_param P[1];
+
+  if ( ( !outlen ) || ( outlen > BLAKE2S_OUTBYTES ) ) return -1;
+
+  if ( !key || !keylen || keylen > BLAKE2S_KEYBYTES ) return -1;
+
+  blake2s_param_init( P, outlen, keylen );
+
+  if( blake2s_init_param( S, P ) < 0 ) return -1;
+
+  {
+    uint8_t block[BLAKE2S_BLOCKBYTES];
+    memset( block, 0, BLAKE2S_BLOCKBYTES );
+    memcpy( block, key, keylen );
+    blake2s_update( S, block, BLAKE2S_BLOCKBYTES );
+    secure_zero_memory( block, BLAKE2S_BLOCKBYTES ); /* Burn the key from stack */
+  }
+  return 0;
+}
+
+static int blake2s_compress( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S, const uint8_t block[MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES] )
+{
+  uint32_t m[16];
+  uint32_t v[16];
+  int i;
+
+  for( i = 0; i < 16; ++i )
+    m[i] = load32( block + i * sizeof( m[i] ) );
+
+  for( i = 0; i < 8; ++i )
+    v[i] = S->h[i];
+
+  v[ 8] = blake2s_IV[0];
+  v[ 9] = blake2s_IV[1];
+  v[10] = blake2s_IV[2];
+  v[11] = blake2s_IV[3];
+  v[12] = S->t[0] ^ blake2s_IV[4];
+  v[13] = S->t[1] ^ blake2s_IV[5];
+  v[14] = S->f[0] ^ blake2s_IV[6];
+  v[15] = S->f[1] ^ blake2s_IV[7];
+#define G(r,i,a,b,c,d) \
+  do { \
+    a = a + b + m[blake2b_sigma[r][2*i+0]]; \
+    d = rotr32(d ^ a, 16); \
+    c = c + d; \
+    b = rotr32(b ^ c, 12); \
+    a = a + b + m[blake2b_sigma[r][2*i+1]]; \
+    d = rotr32(d ^ a, 8); \
+    c = c + d; \
+    b = rotr32(b ^ c, 7); \
+  } while(0)
+#define ROUND(r)  \
+  do { \
+    G(r,0,v[ 0],v[ 4],v[ 8],v[12]); \
+    G(r,1,v[ 1],v[ 5],v[ 9],v[13]); \
+    G(r,2,v[ 2],v[ 6],v[10],v[14]); \
+    G(r,3,v[ 3],v[ 7],v[11],v[15]); \
+    G(r,4,v[ 0],v[ 5],v[10],v[15]); \
+    G(r,5,v[ 1],v[ 6],v[11],v[12]); \
+    G(r,6,v[ 2],v[ 7],v[ 8],v[13]); \
+    G(r,7,v[ 3],v[ 4],v[ 9],v[14]); \
+  } while(0)
+  ROUND( 0 );
+  ROUND( 1 );
+  ROUND( 2 );
+  ROUND( 3 );
+  ROUND( 4 );
+  ROUND( 5 );
+  ROUND( 6 );
+  ROUND( 7 );
+  ROUND( 8 );
+  ROUND( 9 );
+
+  for( i = 0; i < 8; ++i )
+    S->h[i] = S->h[i] ^ v[i] ^ v[i + 8];
+
+#undef G
+#undef ROUND
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2s_update( blake2s_state *S, const uint8_t *in, uint64_t inlen )
+{
+  while( inlen > 0 )
+  {
+    size_t left = S->buflen;
+    size_t fill = 2 * BLAKE2S_BLOCKBYTES - left;
+
+    if( inlen > fill )
+    {
+      memcpy( S->buf + left, in, fill ); // Fill buffer
+      S->buflen += fill;
+      blake2s_increment_counter( S, BLAKE2S_BLOCKBYTES );
+      blake2s_compress( S, S->buf ); // Compress
+      memcpy( S->buf, S->buf + BLAKE2S_BLOCKBYTES, BLAKE2S_BLOCKBYTES ); // Shift buffer left
+      S->buflen -= BLAKE2S_BLOCKBYTES;
+      in += fill;
+      inlen -= fill;
+      if( inlen > BLAKE2S_BLOCKBYTES ) // Buffered block can not be the last one, compress input in-place
+      {
+        blake2s_increment_counter( S, BLAKE2S_BLOCKBYTES );
+        blake2s_compress( S, S->buf );
+        S->buflen = 0;
+        while( inlen > BLAKE2S_BLOCKBYTES )
+        {
+          blake2s_increment_counter( S, BLAKE2S_BLOCKBYTES );
+          blake2s_compress( S, in );
+          in += BLAKE2S_BLOCKBYTES;
+          inlen -= BLAKE2S_BLOCKBYTES;
+        }
+      }
+    }
+    else // inlen <= fill
+    {
+      memcpy( S->buf + left, in, (size_t) inlen );
+      S->buflen = (size_t)(S->buflen + inlen); // Be lazy, do not compress
+      in += inlen;
+      inlen -= inlen;
+    }
+  }
+
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2s_final( blake2s_state *S, uint8_t *out, uint8_t outlen )
+{
+  int i;
+
+  uint8_t buffer[BLAKE2S_OUTBYTES];
+
+  if( S->buflen > BLAKE2S_BLOCKBYTES )
+  {
+    blake2s_increment_counter( S, BLAKE2S_BLOCKBYTES );
+    blake2s_compress( S, S->buf );
+    S->buflen -= BLAKE2S_BLOCKBYTES;
+    memcpy( S->buf, S->buf + BLAKE2S_BLOCKBYTES, S->buflen );
+  }
+
+  blake2s_increment_counter( S, ( uint32_t )S->buflen );
+  blake2s_set_lastblock( S );
+  memset( S->buf + S->buflen, 0, 2 * BLAKE2S_BLOCKBYTES - S->buflen ); /* Padding */
+  blake2s_compress( S, S->buf );
+
+  for( i = 0; i < 8; ++i ) /* Output full hash to temp buffer */
+    store32( buffer + sizeof( S->h[i] ) * i, S->h[i] );
+
+  memcpy( out, buffer, outlen );
+  return 0;
+}
+
+/*------------------------------------*/
+/* blake2bp-ref.c */
+/*------------------------------------*/
+
+#define PARALLELISM_DEGREE MUtils::Hash::Internal::Blake2Impl::BLAKE2BP_PARALLELISM
+
+static inline int blake2bp_init_leaf( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, uint8_t outlen, uint8_t keylen, uint64_t offset )
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2b_param P[1];
+  memset( P, 0, sizeof( P ) );
+  blake2b_param_set_digest_length( P, outlen );
+  P->key_length = keylen;
+  blake2b_param_set_fanout( P, PARALLELISM_DEGREE );
+  blake2b_param_set_max_depth( P, 2 );
+  blake2b_param_set_leaf_length( P, 0 );
+  blake2b_param_set_node_offset( P, offset );
+  blake2b_param_set_node_depth( P, 0 );
+  blake2b_param_set_inner_length( P, MUtils::Hash::Internal::Blake2Impl::BLAKE2B_OUTBYTES );
+  return MUtils::Hash::Internal::Blake2Impl::blake2b_init_param( S, P );
+}
+
+static inline int blake2bp_init_root( MUtils::Hash::Internal::Blake2Impl::blake2b_state *S, uint8_t outlen, uint8_t keylen )
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2b_param P[1];
+  memset( P, 0, sizeof( P ) );
+  blake2b_param_set_digest_length( P, outlen );
+  P->key_length = keylen;
+  blake2b_param_set_fanout( P, PARALLELISM_DEGREE );
+  blake2b_param_set_max_depth( P, 2 );
+  blake2b_param_set_leaf_length( P, 0 );
+  blake2b_param_set_node_offset( P, 0 );
+  blake2b_param_set_node_depth( P, 1 );
+  blake2b_param_set_inner_length( P, MUtils::Hash::Internal::Blake2Impl::BLAKE2B_OUTBYTES );
+  return MUtils::Hash::Internal::Blake2Impl::blake2b_init_param( S, P );
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2bp_init( blake2bp_state *S, const uint8_t outlen )
+{
+  if( !outlen || outlen > BLAKE2B_OUTBYTES ) return -1;
+
+  memset( S->buf, 0, sizeof( S->buf ) );
+  S->buflen = 0;
+
+  if( blake2bp_init_root( &S->R, outlen, 0 ) < 0 )
+    return -1;
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    if( blake2bp_init_leaf( &S->S[i], BLAKE2B_OUTBYTES, 0, i ) < 0 ) return -1;
+
+  S->R.last_node = 1;
+  S->S[PARALLELISM_DEGREE - 1].last_node = 1;
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2bp_init_key( blake2bp_state *S, const uint8_t outlen, const void *key, const uint8_t keylen )
+{
+  if( !outlen || outlen > BLAKE2B_OUTBYTES ) return -1;
+
+  if( !key || !keylen || keylen > BLAKE2B_KEYBYTES ) return -1;
+
+  memset( S->buf, 0, sizeof( S->buf ) );
+  S->buflen = 0;
+
+  if( blake2bp_init_root( &S->R, outlen, keylen ) < 0 )
+    return -1;
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    if( blake2bp_init_leaf( &S->S[i], BLAKE2B_OUTBYTES, keylen, i ) < 0 ) return -1;
+
+  S->R.last_node = 1;
+  S->S[PARALLELISM_DEGREE - 1].last_node = 1;
+  {
+    uint8_t block[BLAKE2B_BLOCKBYTES];
+    memset( block, 0, BLAKE2B_BLOCKBYTES );
+    memcpy( block, key, keylen );
+
+    for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+      blake2b_update( &S->S[i], block, BLAKE2B_BLOCKBYTES );
+
+    secure_zero_memory( block, BLAKE2B_BLOCKBYTES ); /* Burn the key from stack */
+  }
+  return 0;
+}
+
+typedef struct __blake2bp_task
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2bp_state *S;
+  const uint8_t *in;
+  uint64_t inlen;
+} blake2bp_task;
+
+/* each leaf consumes every PARALLELISM_DEGREE-th block, starting at its own index */
+static void blake2bp_update_leaf( void *arg, const size_t i )
+{
+  const blake2bp_task *const task = ( const blake2bp_task * )arg;
+  const uint8_t *in__ = task->in + i * MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES;
+  uint64_t inlen__ = task->inlen;
+
+  while( inlen__ >= PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES )
+  {
+    MUtils::Hash::Internal::Blake2Impl::blake2b_update( &task->S->S[i], in__, MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES );
+    in__ += PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES;
+    inlen__ -= PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2B_BLOCKBYTES;
+  }
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2bp_update( blake2bp_state *S, const uint8_t *in, uint64_t inlen, blake2_parallel_fn parallel )
+{
+  size_t left = S->buflen;
+  size_t fill = sizeof( S->buf ) - left;
+
+  if( left && inlen >= fill )
+  {
+    memcpy( S->buf + left, in, fill );
+
+    for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+      blake2b_update( &S->S[i], S->buf + i * BLAKE2B_BLOCKBYTES, BLAKE2B_BLOCKBYTES );
+
+    in += fill;
+    inlen -= fill;
+    left = 0;
+  }
+
+  if( inlen >= PARALLELISM_DEGREE * BLAKE2B_BLOCKBYTES )
+  {
+    blake2bp_task task = { S, in, inlen };
+    if( parallel )
+    {
+      parallel( blake2bp_update_leaf, &task, PARALLELISM_DEGREE );
+    }
+    else
+    {
+      for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+        blake2bp_update_leaf( &task, i );
+    }
+  }
+
+  in += inlen - inlen % ( PARALLELISM_DEGREE * BLAKE2B_BLOCKBYTES );
+  inlen %= PARALLELISM_DEGREE * BLAKE2B_BLOCKBYTES;
+
+  if( inlen > 0 )
+    memcpy( S->buf + left, in, (size_t) inlen );
+
+  S->buflen = left + (size_t) inlen;
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2bp_final( blake2bp_state *S, uint8_t *out, const uint8_t outlen )
+{
+  uint8_t hash[PARALLELISM_DEGREE][BLAKE2B_OUTBYTES];
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+  {
+    if( S->buflen > i * BLAKE2B_BLOCKBYTES )
+    {
+      size_t left = S->buflen - i * BLAKE2B_BLOCKBYTES;
+
+      if( left > BLAKE2B_BLOCKBYTES ) left = BLAKE2B_BLOCKBYTES;
+
+      blake2b_update( &S->S[i], S->buf + i * BLAKE2B_BLOCKBYTES, left );
+    }
+
+    blake2b_final( &S->S[i], hash[i], BLAKE2B_OUTBYTES );
+  }
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    blake2b_update( &S->R, hash[i], BLAKE2B_OUTBYTES );
+
+  return blake2b_final( &S->R, out, outlen );
+}
+
+#undef PARALLELISM_DEGREE
+
+/*------------------------------------*/
+/* blake2sp-ref.c */
+/*------------------------------------*/
+
+#define PARALLELISM_DEGREE MUtils::Hash::Internal::Blake2Impl::BLAKE2SP_PARALLELISM
+
+static inline int blake2sp_init_leaf( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S, uint8_t outlen, uint8_t keylen, uint64_t offset )
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2s_param P[1];
+  memset( P, 0, sizeof( P ) );
+  P->digest_length = outlen;
+  P->key_length = keylen;
+  P->fanout = PARALLELISM_DEGREE;
+  P->depth = 2;
+  store32( &P->leaf_length, 0 );
+  store48( P->node_offset, offset );
+  P->node_depth = 0;
+  P->inner_length = MUtils::Hash::Internal::Blake2Impl::BLAKE2S_OUTBYTES;
+  return MUtils::Hash::Internal::Blake2Impl::blake2s_init_param( S, P );
+}
+
+static inline int blake2sp_init_root( MUtils::Hash::Internal::Blake2Impl::blake2s_state *S, uint8_t outlen, uint8_t keylen )
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2s_param P[1];
+  memset( P, 0, sizeof( P ) );
+  P->digest_length = outlen;
+  P->key_length = keylen;
+  P->fanout = PARALLELISM_DEGREE;
+  P->depth = 2;
+  store32( &P->leaf_length, 0 );
+  store48( P->node_offset, 0ULL );
+  P->node_depth = 1;
+  P->inner_length = MUtils::Hash::Internal::Blake2Impl::BLAKE2S_OUTBYTES;
+  return MUtils::Hash::Internal::Blake2Impl::blake2s_init_param( S, P );
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2sp_init( blake2sp_state *S, const uint8_t outlen )
+{
+  if( !outlen || outlen > BLAKE2S_OUTBYTES ) return -1;
+
+  memset( S->buf, 0, sizeof( S->buf ) );
+  S->buflen = 0;
+
+  if( blake2sp_init_root( &S->R, outlen, 0 ) < 0 )
+    return -1;
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    if( blake2sp_init_leaf( &S->S[i], BLAKE2S_OUTBYTES, 0, i ) < 0 ) return -1;
+
+  S->R.last_node = 1;
+  S->S[PARALLELISM_DEGREE - 1].last_node = 1;
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2sp_init_key( blake2sp_state *S, const uint8_t outlen, const void *key, const uint8_t keylen )
+{
+  if( !outlen || outlen > BLAKE2S_OUTBYTES ) return -1;
+
+  if( !key || !keylen || keylen > BLAKE2S_KEYBYTES ) return -1;
+
+  memset( S->buf, 0, sizeof( S->buf ) );
+  S->buflen = 0;
+
+  if( blake2sp_init_root( &S->R, outlen, keylen ) < 0 )
+    return -1;
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    if( blake2sp_init_leaf( &S->S[i], BLAKE2S_OUTBYTES, keylen, i ) < 0 ) return -1;
+
+  S->R.last_node = 1;
+  S->S[PARALLELISM_DEGREE - 1].last_node = 1;
+  {
+    uint8_t block[BLAKE2S_BLOCKBYTES];
+    memset( block, 0, BLAKE2S_BLOCKBYTES );
+    memcpy( block, key, keylen );
+
+    for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+      blake2s_update( &S->S[i], block, BLAKE2S_BLOCKBYTES );
+
+    secure_zero_memory( block, BLAKE2S_BLOCKBYTES ); /* Burn the key from stack */
+  }
+  return 0;
+}
+
+typedef struct __blake2sp_task
+{
+  MUtils::Hash::Internal::Blake2Impl::blake2sp_state *S;
+  const uint8_t *in;
+  uint64_t inlen;
+} blake2sp_task;
+
+/* each leaf consumes every PARALLELISM_DEGREE-th block, starting at its own index */
+static void blake2sp_update_leaf( void *arg, const size_t i )
+{
+  const blake2sp_task *const task = ( const blake2sp_task * )arg;
+  const uint8_t *in__ = task->in + i * MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES;
+  uint64_t inlen__ = task->inlen;
+
+  while( inlen__ >= PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES )
+  {
+    MUtils::Hash::Internal::Blake2Impl::blake2s_update( &task->S->S[i], in__, MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES );
+    in__ += PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES;
+    inlen__ -= PARALLELISM_DEGREE * MUtils::Hash::Internal::Blake2Impl::BLAKE2S_BLOCKBYTES;
+  }
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2sp_update( blake2sp_state *S, const uint8_t *in, uint64_t inlen, blake2_parallel_fn parallel )
+{
+  size_t left = S->buflen;
+  size_t fill = sizeof( S->buf ) - left;
+
+  if( left && inlen >= fill )
+  {
+    memcpy( S->buf + left, in, fill );
+
+    for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+      blake2s_update( &S->S[i], S->buf + i * BLAKE2S_BLOCKBYTES, BLAKE2S_BLOCKBYTES );
+
+    in += fill;
+    inlen -= fill;
+    left = 0;
+  }
+
+  if( inlen >= PARALLELISM_DEGREE * BLAKE2S_BLOCKBYTES )
+  {
+    blake2sp_task task = { S, in, inlen };
+    if( parallel )
+    {
+      parallel( blake2sp_update_leaf, &task, PARALLELISM_DEGREE );
+    }
+    else
+    {
+      for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+        blake2sp_update_leaf( &task, i );
+    }
+  }
+
+  in += inlen - inlen % ( PARALLELISM_DEGREE * BLAKE2S_BLOCKBYTES );
+  inlen %= PARALLELISM_DEGREE * BLAKE2S_BLOCKBYTES;
+
+  if( inlen > 0 )
+    memcpy( S->buf + left, in, (size_t) inlen );
+
+  S->buflen = left + (size_t) inlen;
+  return 0;
+}
+
+int MUtils::Hash::Internal::Blake2Impl::blake2sp_final( blake2sp_state *S, uint8_t *out, const uint8_t outlen )
+{
+  uint8_t hash[PARALLELISM_DEGREE][BLAKE2S_OUTBYTES];
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+  {
+    if( S->buflen > i * BLAKE2S_BLOCKBYTES )
+    {
+      size_t left = S->buflen - i * BLAKE2S_BLOCKBYTES;
+
+      if( left > BLAKE2S_BLOCKBYTES ) left = BLAKE2S_BLOCKBYTES;
+
+      blake2s_update( &S->S[i], S->buf + i * BLAKE2S_BLOCKBYTES, left );
+    }
+
+    blake2s_final( &S->S[i], hash[i], BLAKE2S_OUTBYTES );
+  }
+
+  for( size_t i = 0; i < PARALLELISM_DEGREE; ++i )
+    blake2s_update( &S->R, hash[i], BLAKE2S_OUTBYTES );
+
+  return blake2s_final( &S->R, out, outlen );
+}
+
+#undef PARALLELISM_DEGREE
+
 #if defined(BLAKE2B_SELFTEST)
 #include <string.h>
 #include "blake2-kat.h"
@@ -0,0 +1,84 @@
+/*
+   BLAKE3 reference source code package - C implementations
+
+   Written in 2019-2020 by Jack O'Connor, Samuel Neves, Jean-Philippe Aumasson
+   and Zooko Wilcox-O'Hearn
+
+   To the extent possible under law, the author(s) have dedicated all copyright
+   and related and neighboring rights to this software to the public domain
+   worldwide. This software is distributed without any warranty.
+
+   You should have received a copy of the CC0 Public Domain Dedication along with
+   this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+#pragma once
+#ifndef __BLAKE3_H__
+#define __BLAKE3_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		namespace Internal
+		{
+			namespace Blake3Impl
+			{
+				enum blake3_constant
+				{
+					BLAKE3_KEY_LEN   = 32,
+					BLAKE3_OUT_LEN   = 32,
+					BLAKE3_BLOCK_LEN = 64,
+					BLAKE3_CHUNK_LEN = 1024,
+					BLAKE3_MAX_DEPTH = 54
+				};
+
+				typedef struct __blake3_chunk_state
+				{
+					uint32_t cv[8];
+					uint64_t chunk_counter;
+					uint8_t  buf[BLAKE3_BLOCK_LEN];
+					uint8_t  buf_len;
+					uint8_t  blocks_compressed;
+					uint8_t  flags;
+				} blake3_chunk_state;
+
+				typedef struct __blake3_hasher
+				{
+					uint32_t key[8];
+					blake3_chunk_state chunk;
+					uint8_t  cv_stack_len;
+					uint8_t  cv_stack[(BLAKE3_MAX_DEPTH + 1) * BLAKE3_OUT_LEN]; // The stack size is MAX_DEPTH + 1 because we do lazy merging
+				} blake3_hasher;
+
+				// Runs task(arg, 0) ... task(arg, count-1), possibly in parallel, and returns when all are done
+				typedef void ( *blake3_task_fn )( void *arg, const size_t index );
+				typedef void ( *blake3_parallel_fn )( blake3_task_fn task, void *arg, const size_t count );
+
+				// Chunk compression implementations (BLAKE3_IMPL_SSE41 processes 4 chunks at a time, BLAKE3_IMPL_AVX2 processes 8)
+				enum blake3_impl
+				{
+					BLAKE3_IMPL_REF   = 0,
+					BLAKE3_IMPL_SSE41 = 1,
+					BLAKE3_IMPL_AVX2  = 2
+				};
+
+				// Dispatch API
+				int blake3_select_impl( const blake3_impl impl );
+				blake3_impl blake3_current_impl( void );
+
+				// Streaming API (the "parallel" callback may be NULL, in which case all subtrees are processed on the calling thread)
+				void blake3_hasher_init( blake3_hasher *S );
+				void blake3_hasher_init_keyed( blake3_hasher *S, const uint8_t key[BLAKE3_KEY_LEN] );
+				void blake3_hasher_init_derive_key_raw( blake3_hasher *S, const void *context, size_t context_len );
+				void blake3_hasher_update( blake3_hasher *S, const void *input, size_t input_len, blake3_parallel_fn parallel );
+				void blake3_hasher_finalize( const blake3_hasher *S, uint8_t *out, size_t out_len );
+				void blake3_hasher_finalize_seek( const blake3_hasher *S, uint64_t seek, uint8_t *out, size_t out_len );
+			}
+		}
+	}
+}
+
+#endif
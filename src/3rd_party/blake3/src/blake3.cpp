@@ -0,0 +1,1085 @@
+/*
+   BLAKE3 reference source code package - C implementations
+
+   Written in 2019-2020 by Jack O'Connor, Samuel Neves, Jean-Philippe Aumasson
+   and Zooko Wilcox-O'Hearn
+
+   To the extent possible under law, the author(s) have dedicated all copyright
+   and related and neighboring rights to this software to the public domain
+   worldwide. This software is distributed without any warranty.
+
+   You should have received a copy of the CC0 Public Domain Dedication along with
+   this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/blake3.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BLAKE3_HAVE_X86 1
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#include <smmintrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define BLAKE3_TARGET(X) __attribute__((target(X)))
+#else
+#define BLAKE3_TARGET(X)
+#endif
+
+using namespace MUtils::Hash::Internal::Blake3Impl;
+
+/*------------------------------------*/
+/* blake3_impl.h */
+/*------------------------------------*/
+
+enum blake3_flags
+{
+  CHUNK_START         = 1 << 0,
+  CHUNK_END           = 1 << 1,
+  PARENT              = 1 << 2,
+  ROOT                = 1 << 3,
+  KEYED_HASH          = 1 << 4,
+  DERIVE_KEY_CONTEXT  = 1 << 5,
+  DERIVE_KEY_MATERIAL = 1 << 6
+};
+
+#define MAX_SIMD_DEGREE 8
+#define MAX_SIMD_DEGREE_OR_2 ( MAX_SIMD_DEGREE > 2 ? MAX_SIMD_DEGREE : 2 )
+
+/* subtrees handed to the "parallel" callback are never smaller than this, and there are at most PARALLEL_MAX_TASKS of them */
+#define PARALLEL_MIN_BYTES ( 64 * BLAKE3_CHUNK_LEN )
+#define PARALLEL_MAX_TASKS 64
+
+static const uint32_t blake3_IV[8] =
+{
+  0x6A09E667UL, 0xBB67AE85UL, 0x3C6EF372UL, 0xA54FF53AUL,
+  0x510E527FUL, 0x9B05688CUL, 0x1F83D9ABUL, 0x5BE0CD19UL
+};
+
+static const uint8_t blake3_MSG_SCHEDULE[7][16] =
+{
+  {  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15 },
+  {  2,  6,  3, 10,  7,  0,  4, 13,  1, 11, 12,  5,  9, 14, 15,  8 },
+  {  3,  4, 10, 12, 13,  2,  7, 14,  6,  5,  9,  0, 11, 15,  8,  1 },
+  { 10,  7, 12,  9, 14,  3, 13, 15,  4,  0, 11,  2,  5,  8,  1,  6 },
+  { 12, 13,  9, 11, 15, 10, 14,  8,  7,  2,  5,  3,  0,  1,  6,  4 },
+  {  9, 14, 11,  5,  8, 12, 15,  1, 13,  3,  0, 10,  2,  6,  4,  7 },
+  { 11, 15,  5,  0,  1,  9,  8,  6, 14, 10,  2, 12,  3,  4,  7, 13 }
+};
+
+static inline uint32_t load32( const void *src )
+{
+  const uint8_t *p = ( const uint8_t * )src;
+  return ( ( uint32_t )( p[0] ) <<  0 ) | ( ( uint32_t )( p[1] ) <<  8 ) |
+         ( ( uint32_t )( p[2] ) << 16 ) | ( ( uint32_t )( p[3] ) << 24 );
+}
+
+static inline void store32( void *dst, uint32_t w )
+{
+  uint8_t *p = ( uint8_t * )dst;
+  p[0] = ( uint8_t )( w >>  0 );
+  p[1] = ( uint8_t )( w >>  8 );
+  p[2] = ( uint8_t )( w >> 16 );
+  p[3] = ( uint8_t )( w >> 24 );
+}
+
+static inline void load_key_words( const uint8_t key[BLAKE3_KEY_LEN], uint32_t key_words[8] )
+{
+  for( size_t i = 0; i < 8; ++i )
+    key_words[i] = load32( &key[i * 4] );
+}
+
+static inline void store_cv_words( uint8_t bytes_out[32], const uint32_t cv_words[8] )
+{
+  for( size_t i = 0; i < 8; ++i )
+    store32( &bytes_out[i * 4], cv_words[i] );
+}
+
+static inline uint32_t counter_low( uint64_t counter ) { return ( uint32_t )counter; }
+static inline uint32_t counter_high( uint64_t counter ) { return ( uint32_t )( counter >> 32 ); }
+
+static inline uint32_t rotr32( const uint32_t w, const unsigned c )
+{
+  return ( w >> c ) | ( w << ( 32 - c ) );
+}
+
+static inline unsigned popcnt( uint64_t x )
+{
+  unsigned count = 0;
+  while( x != 0 )
+  {
+    count += 1;
+    x &= x - 1;
+  }
+  return count;
+}
+
+/* largest power of two less than or equal to x (x must not be zero) */
+static inline uint64_t round_down_to_power_of_2( uint64_t x )
+{
+  uint64_t result = 1;
+  while( x >>= 1 )
+    result <<= 1;
+  return result;
+}
+
+/*------------------------------------*/
+/* blake3_portable.c */
+/*------------------------------------*/
+
+static inline void g( uint32_t *state, size_t a, size_t b, size_t c, size_t d, uint32_t x, uint32_t y )
+{
+  state[a] = state[a] + state[b] + x;
+  state[d] = rotr32( state[d] ^ state[a], 16 );
+  state[c] = state[c] + state[d];
+  state[b] = rotr32( state[b] ^ state[c], 12 );
+  state[a] = state[a] + state[b] + y;
+  state[d] = rotr32( state[d] ^ state[a], 8 );
+  state[c] = state[c] + state[d];
+  state[b] = rotr32( state[b] ^ state[c], 7 );
+}
+
+static inline void round_fn( uint32_t state[16], const uint32_t *msg, size_t round )
+{
+  const uint8_t *schedule = blake3_MSG_SCHEDULE[round];
+
+  // Mix the columns.
+  g( state, 0, 4,  8, 12, msg[schedule[0]], msg[schedule[1]] );
+  g( state, 1, 5,  9, 13, msg[schedule[2]], msg[schedule[3]] );
+  g( state, 2, 6, 10, 14, msg[schedule[4]], msg[schedule[5]] );
+  g( state, 3, 7, 11, 15, msg[schedule[6]], msg[schedule[7]] );
+
+  // Mix the rows.
+  g( state, 0, 5, 10, 15, msg[schedule[ 8]], msg[schedule[ 9]] );
+  g( state, 1, 6, 11, 12, msg[schedule[10]], msg[schedule[11]] );
+  g( state, 2, 7,  8, 13, msg[schedule[12]], msg[schedule[13]] );
+  g( state, 3, 4,  9, 14, msg[schedule[14]], msg[schedule[15]] );
+}
+
+static inline void compress_pre( uint32_t state[16], const uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN], uint8_t block_len, uint64_t counter, uint8_t flags )
+{
+  uint32_t block_words[16];
+  for( size_t i = 0; i < 16; ++i )
+    block_words[i] = load32( block + 4 * i );
+
+  state[ 0] = cv[0];
+  state[ 1] = cv[1];
+  state[ 2] = cv[2];
+  state[ 3] = cv[3];
+  state[ 4] = cv[4];
+  state[ 5] = cv[5];
+  state[ 6] = cv[6];
+  state[ 7] = cv[7];
+  state[ 8] = blake3_IV[0];
+  state[ 9] = blake3_IV[1];
+  state[10] = blake3_IV[2];
+  state[11] = blake3_IV[3];
+  state[12] = counter_low( counter );
+  state[13] = counter_high( counter );
+  state[14] = ( uint32_t )block_len;
+  state[15] = ( uint32_t )flags;
+
+  for( size_t r = 0; r < 7; ++r )
+    round_fn( state, &block_words[0], r );
+}
+
+static void blake3_compress_in_place( uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN], uint8_t block_len, uint64_t counter, uint8_t flags )
+{
+  uint32_t state[16];
+  compress_pre( state, cv, block, block_len, counter, flags );
+  for( size_t i = 0; i < 8; ++i )
+    cv[i] = state[i] ^ state[i + 8];
+}
+
+static void blake3_compress_xof( const uint32_t cv[8], const uint8_t block[BLAKE3_BLOCK_LEN], uint8_t block_len, uint64_t counter, uint8_t flags, uint8_t out[64] )
+{
+  uint32_t state[16];
+  compress_pre( state, cv, block, block_len, counter, flags );
+  for( size_t i = 0; i < 8; ++i )
+  {
+    store32( &out[ 4 * i     ], state[i    ] ^ state[i + 8] );
+    store32( &out[ 4 * i + 32], state[i + 8] ^ cv[i] );
+  }
+}
+
+static inline void hash_one_portable( const uint8_t *input, size_t blocks, const uint32_t key[8], uint64_t counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t out[BLAKE3_OUT_LEN] )
+{
+  uint32_t cv[8];
+  memcpy( cv, key, BLAKE3_KEY_LEN );
+  uint8_t block_flags = flags | flags_start;
+  while( blocks > 0 )
+  {
+    if( blocks == 1 )
+      block_flags |= flags_end;
+    blake3_compress_in_place( cv, input, BLAKE3_BLOCK_LEN, counter, block_flags );
+    input = &input[BLAKE3_BLOCK_LEN];
+    blocks -= 1;
+    block_flags = flags;
+  }
+  store_cv_words( out, cv );
+}
+
+static void blake3_hash_many_ref( const uint8_t *const *inputs, size_t num_inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  while( num_inputs > 0 )
+  {
+    hash_one_portable( inputs[0], blocks, key, counter, flags, flags_start, flags_end, out );
+    if( increment_counter )
+      counter += 1;
+    inputs += 1;
+    num_inputs -= 1;
+    out = &out[BLAKE3_OUT_LEN];
+  }
+}
+
+#if defined(BLAKE3_HAVE_X86)
+
+/*------------------------------------*/
+/* blake3_sse41.c */
+/*------------------------------------*/
+
+#define DEGREE 4
+
+#define ADD128(a, b) _mm_add_epi32( (a), (b) )
+#define XOR128(a, b) _mm_xor_si128( (a), (b) )
+#define ROT16_128(x) _mm_shuffle_epi8( (x), _mm_set_epi8( 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2 ) )
+#define ROT12_128(x) _mm_or_si128( _mm_srli_epi32( (x), 12 ), _mm_slli_epi32( (x), 32 - 12 ) )
+#define ROT8_128(x)  _mm_shuffle_epi8( (x), _mm_set_epi8( 12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1 ) )
+#define ROT7_128(x)  _mm_or_si128( _mm_srli_epi32( (x), 7 ), _mm_slli_epi32( (x), 32 - 7 ) )
+
+#define G128(a, b, c, d, x, y) do \
+{ \
+  a = ADD128( ADD128( a, b ), x ); d = ROT16_128( XOR128( d, a ) ); \
+  c = ADD128( c, d );              b = ROT12_128( XOR128( b, c ) ); \
+  a = ADD128( ADD128( a, b ), y ); d = ROT8_128( XOR128( d, a ) );  \
+  c = ADD128( c, d );              b = ROT7_128( XOR128( b, c ) );  \
+} \
+while(0)
+
+BLAKE3_TARGET("sse4.1")
+static inline void round_fn4( __m128i v[16], const __m128i m[16], size_t r )
+{
+  const uint8_t *s = blake3_MSG_SCHEDULE[r];
+  G128( v[0], v[4], v[ 8], v[12], m[s[ 0]], m[s[ 1]] );
+  G128( v[1], v[5], v[ 9], v[13], m[s[ 2]], m[s[ 3]] );
+  G128( v[2], v[6], v[10], v[14], m[s[ 4]], m[s[ 5]] );
+  G128( v[3], v[7], v[11], v[15], m[s[ 6]], m[s[ 7]] );
+  G128( v[0], v[5], v[10], v[15], m[s[ 8]], m[s[ 9]] );
+  G128( v[1], v[6], v[11], v[12], m[s[10]], m[s[11]] );
+  G128( v[2], v[7], v[ 8], v[13], m[s[12]], m[s[13]] );
+  G128( v[3], v[4], v[ 9], v[14], m[s[14]], m[s[15]] );
+}
+
+BLAKE3_TARGET("sse4.1")
+static inline void transpose_vecs4( __m128i vecs[DEGREE] )
+{
+  // Interleave 32-bit lanes. The low unpack is lanes 00/11 and the high is 22/33.
+  __m128i ab_01 = _mm_unpacklo_epi32( vecs[0], vecs[1] );
+  __m128i ab_23 = _mm_unpackhi_epi32( vecs[0], vecs[1] );
+  __m128i cd_01 = _mm_unpacklo_epi32( vecs[2], vecs[3] );
+  __m128i cd_23 = _mm_unpackhi_epi32( vecs[2], vecs[3] );
+
+  // Interleave 64-bit lanes.
+  vecs[0] = _mm_unpacklo_epi64( ab_01, cd_01 );
+  vecs[1] = _mm_unpackhi_epi64( ab_01, cd_01 );
+  vecs[2] = _mm_unpacklo_epi64( ab_23, cd_23 );
+  vecs[3] = _mm_unpackhi_epi64( ab_23, cd_23 );
+}
+
+BLAKE3_TARGET("sse4.1")
+static inline void transpose_msg_vecs4( const uint8_t *const *inputs, size_t block_offset, __m128i out[16] )
+{
+  for( size_t i = 0; i < 4; ++i )
+  {
+    for( size_t j = 0; j < DEGREE; ++j )
+      out[4 * i + j] = _mm_loadu_si128( ( const __m128i * )&inputs[j][block_offset + 16 * i] );
+    transpose_vecs4( &out[4 * i] );
+  }
+}
+
+BLAKE3_TARGET("sse4.1")
+static inline void load_counters4( uint64_t counter, bool increment_counter, __m128i *out_lo, __m128i *out_hi )
+{
+  const __m128i mask = _mm_set1_epi32( -( int32_t )increment_counter );
+  const __m128i add0 = _mm_set_epi32( 3, 2, 1, 0 );
+  const __m128i add1 = _mm_and_si128( mask, add0 );
+  __m128i l = _mm_add_epi32( _mm_set1_epi32( ( int32_t )counter ), add1 );
+  __m128i carry = _mm_cmpgt_epi32( _mm_xor_si128( add1, _mm_set1_epi32( 0x80000000 ) ), _mm_xor_si128( l, _mm_set1_epi32( 0x80000000 ) ) );
+  __m128i h = _mm_sub_epi32( _mm_set1_epi32( ( int32_t )( counter >> 32 ) ), carry );
+  *out_lo = l;
+  *out_hi = h;
+}
+
+BLAKE3_TARGET("sse4.1")
+static void blake3_hash4_sse41( const uint8_t *const *inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  __m128i h_vecs[8];
+  for( size_t i = 0; i < 8; ++i )
+    h_vecs[i] = _mm_set1_epi32( ( int32_t )key[i] );
+
+  __m128i counter_low_vec, counter_high_vec;
+  load_counters4( counter, increment_counter, &counter_low_vec, &counter_high_vec );
+  uint8_t block_flags = flags | flags_start;
+
+  for( size_t block = 0; block < blocks; ++block )
+  {
+    if( block + 1 == blocks )
+      block_flags |= flags_end;
+
+    __m128i msg_vecs[16];
+    transpose_msg_vecs4( inputs, block * BLAKE3_BLOCK_LEN, msg_vecs );
+
+    __m128i v[16] =
+    {
+      h_vecs[0], h_vecs[1], h_vecs[2], h_vecs[3],
+      h_vecs[4], h_vecs[5], h_vecs[6], h_vecs[7],
+      _mm_set1_epi32( ( int32_t )blake3_IV[0] ), _mm_set1_epi32( ( int32_t )blake3_IV[1] ),
+      _mm_set1_epi32( ( int32_t )blake3_IV[2] ), _mm_set1_epi32( ( int32_t )blake3_IV[3] ),
+      counter_low_vec, counter_high_vec,
+      _mm_set1_epi32( ( int32_t )BLAKE3_BLOCK_LEN ), _mm_set1_epi32( ( int32_t )block_flags )
+    };
+
+    for( size_t r = 0; r < 7; ++r )
+      round_fn4( v, msg_vecs, r );
+
+    for( size_t i = 0; i < 8; ++i )
+      h_vecs[i] = XOR128( v[i], v[i + 8] );
+
+    block_flags = flags;
+  }
+
+  // The first four vecs now contain the first half of each output hash, and the second four vecs contain the second half.
+  transpose_vecs4( &h_vecs[0] );
+  transpose_vecs4( &h_vecs[4] );
+
+  for( size_t i = 0; i < DEGREE; ++i )
+  {
+    _mm_storeu_si128( ( __m128i * )&out[i * BLAKE3_OUT_LEN +  0], h_vecs[i    ] );
+    _mm_storeu_si128( ( __m128i * )&out[i * BLAKE3_OUT_LEN + 16], h_vecs[i + 4] );
+  }
+}
+
+BLAKE3_TARGET("sse4.1")
+static void blake3_hash_many_sse41( const uint8_t *const *inputs, size_t num_inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  while( num_inputs >= DEGREE )
+  {
+    blake3_hash4_sse41( inputs, blocks, key, counter, increment_counter, flags, flags_start, flags_end, out );
+    if( increment_counter )
+      counter += DEGREE;
+    inputs += DEGREE;
+    num_inputs -= DEGREE;
+    out = &out[DEGREE * BLAKE3_OUT_LEN];
+  }
+  blake3_hash_many_ref( inputs, num_inputs, blocks, key, counter, increment_counter, flags, flags_start, flags_end, out );
+}
+
+#undef G128
+#undef ROT7_128
+#undef ROT8_128
+#undef ROT12_128
+#undef ROT16_128
+#undef XOR128
+#undef ADD128
+#undef DEGREE
+
+/*------------------------------------*/
+/* blake3_avx2.c */
+/*------------------------------------*/
+
+#define DEGREE 8
+
+#define ADD256(a, b) _mm256_add_epi32( (a), (b) )
+#define XOR256(a, b) _mm256_xor_si256( (a), (b) )
+#define ROT16_256(x) _mm256_shuffle_epi8( (x), _mm256_set_epi8( 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2, 13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2 ) )
+#define ROT12_256(x) _mm256_or_si256( _mm256_srli_epi32( (x), 12 ), _mm256_slli_epi32( (x), 32 - 12 ) )
+#define ROT8_256(x)  _mm256_shuffle_epi8( (x), _mm256_set_epi8( 12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1, 12, 15, 14, 13, 8, 11, 10, 9, 4, 7, 6, 5, 0, 3, 2, 1 ) )
+#define ROT7_256(x)  _mm256_or_si256( _mm256_srli_epi32( (x), 7 ), _mm256_slli_epi32( (x), 32 - 7 ) )
+
+#define G256(a, b, c, d, x, y) do \
+{ \
+  a = ADD256( ADD256( a, b ), x ); d = ROT16_256( XOR256( d, a ) ); \
+  c = ADD256( c, d );              b = ROT12_256( XOR256( b, c ) ); \
+  a = ADD256( ADD256( a, b ), y ); d = ROT8_256( XOR256( d, a ) );  \
+  c = ADD256( c, d );              b = ROT7_256( XOR256( b, c ) );  \
+} \
+while(0)
+
+BLAKE3_TARGET("avx2")
+static inline void round_fn8( __m256i v[16], const __m256i m[16], size_t r )
+{
+  const uint8_t *s = blake3_MSG_SCHEDULE[r];
+  G256( v[0], v[4], v[ 8], v[12], m[s[ 0]], m[s[ 1]] );
+  G256( v[1], v[5], v[ 9], v[13], m[s[ 2]], m[s[ 3]] );
+  G256( v[2], v[6], v[10], v[14], m[s[ 4]], m[s[ 5]] );
+  G256( v[3], v[7], v[11], v[15], m[s[ 6]], m[s[ 7]] );
+  G256( v[0], v[5], v[10], v[15], m[s[ 8]], m[s[ 9]] );
+  G256( v[1], v[6], v[11], v[12], m[s[10]], m[s[11]] );
+  G256( v[2], v[7], v[ 8], v[13], m[s[12]], m[s[13]] );
+  G256( v[3], v[4], v[ 9], v[14], m[s[14]], m[s[15]] );
+}
+
+BLAKE3_TARGET("avx2")
+static inline void transpose_vecs8( __m256i vecs[DEGREE] )
+{
+  // Interleave 32-bit lanes. The low unpack is lanes 00/11/44/55, and the high is 22/33/66/77.
+  __m256i ab_0145 = _mm256_unpacklo_epi32( vecs[0], vecs[1] );
+  __m256i ab_2367 = _mm256_unpackhi_epi32( vecs[0], vecs[1] );
+  __m256i cd_0145 = _mm256_unpacklo_epi32( vecs[2], vecs[3] );
+  __m256i cd_2367 = _mm256_unpackhi_epi32( vecs[2], vecs[3] );
+  __m256i ef_0145 = _mm256_unpacklo_epi32( vecs[4], vecs[5] );
+  __m256i ef_2367 = _mm256_unpackhi_epi32( vecs[4], vecs[5] );
+  __m256i gh_0145 = _mm256_unpacklo_epi32( vecs[6], vecs[7] );
+  __m256i gh_2367 = _mm256_unpackhi_epi32( vecs[6], vecs[7] );
+
+  // Interleave 64-bit lanes. The low unpack is lanes 00/22 and the high is 11/33.
+  __m256i abcd_04 = _mm256_unpacklo_epi64( ab_0145, cd_0145 );
+  __m256i abcd_15 = _mm256_unpackhi_epi64( ab_0145, cd_0145 );
+  __m256i abcd_26 = _mm256_unpacklo_epi64( ab_2367, cd_2367 );
+  __m256i abcd_37 = _mm256_unpackhi_epi64( ab_2367, cd_2367 );
+  __m256i efgh_04 = _mm256_unpacklo_epi64( ef_0145, gh_0145 );
+  __m256i efgh_15 = _mm256_unpackhi_epi64( ef_0145, gh_0145 );
+  __m256i efgh_26 = _mm256_unpacklo_epi64( ef_2367, gh_2367 );
+  __m256i efgh_37 = _mm256_unpackhi_epi64( ef_2367, gh_2367 );
+
+  // Interleave 128-bit lanes.
+  vecs[0] = _mm256_permute2x128_si256( abcd_04, efgh_04, 0x20 );
+  vecs[1] = _mm256_permute2x128_si256( abcd_15, efgh_15, 0x20 );
+  vecs[2] = _mm256_permute2x128_si256( abcd_26, efgh_26, 0x20 );
+  vecs[3] = _mm256_permute2x128_si256( abcd_37, efgh_37, 0x20 );
+  vecs[4] = _mm256_permute2x128_si256( abcd_04, efgh_04, 0x31 );
+  vecs[5] = _mm256_permute2x128_si256( abcd_15, efgh_15, 0x31 );
+  vecs[6] = _mm256_permute2x128_si256( abcd_26, efgh_26, 0x31 );
+  vecs[7] = _mm256_permute2x128_si256( abcd_37, efgh_37, 0x31 );
+}
+
+BLAKE3_TARGET("avx2")
+static inline void transpose_msg_vecs8( const uint8_t *const *inputs, size_t block_offset, __m256i out[16] )
+{
+  for( size_t i = 0; i < 2; ++i )
+  {
+    for( size_t j = 0; j < DEGREE; ++j )
+      out[8 * i + j] = _mm256_loadu_si256( ( const __m256i * )&inputs[j][block_offset + 32 * i] );
+    transpose_vecs8( &out[8 * i] );
+  }
+}
+
+BLAKE3_TARGET("avx2")
+static inline void load_counters8( uint64_t counter, bool increment_counter, __m256i *out_lo, __m256i *out_hi )
+{
+  const __m256i mask = _mm256_set1_epi32( -( int32_t )increment_counter );
+  const __m256i add0 = _mm256_set_epi32( 7, 6, 5, 4, 3, 2, 1, 0 );
+  const __m256i add1 = _mm256_and_si256( mask, add0 );
+  __m256i l = _mm256_add_epi32( _mm256_set1_epi32( ( int32_t )counter ), add1 );
+  __m256i carry = _mm256_cmpgt_epi32( _mm256_xor_si256( add1, _mm256_set1_epi32( 0x80000000 ) ), _mm256_xor_si256( l, _mm256_set1_epi32( 0x80000000 ) ) );
+  __m256i h = _mm256_sub_epi32( _mm256_set1_epi32( ( int32_t )( counter >> 32 ) ), carry );
+  *out_lo = l;
+  *out_hi = h;
+}
+
+BLAKE3_TARGET("avx2")
+static void blake3_hash8_avx2( const uint8_t *const *inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  __m256i h_vecs[8];
+  for( size_t i = 0; i < 8; ++i )
+    h_vecs[i] = _mm256_set1_epi32( ( int32_t )key[i] );
+
+  __m256i counter_low_vec, counter_high_vec;
+  load_counters8( counter, increment_counter, &counter_low_vec, &counter_high_vec );
+  uint8_t block_flags = flags | flags_start;
+
+  for( size_t block = 0; block < blocks; ++block )
+  {
+    if( block + 1 == blocks )
+      block_flags |= flags_end;
+
+    __m256i msg_vecs[16];
+    transpose_msg_vecs8( inputs, block * BLAKE3_BLOCK_LEN, msg_vecs );
+
+    __m256i v[16] =
+    {
+      h_vecs[0], h_vecs[1], h_vecs[2], h_vecs[3],
+      h_vecs[4], h_vecs[5], h_vecs[6], h_vecs[7],
+      _mm256_set1_epi32( ( int32_t )blake3_IV[0] ), _mm256_set1_epi32( ( int32_t )blake3_IV[1] ),
+      _mm256_set1_epi32( ( int32_t )blake3_IV[2] ), _mm256_set1_epi32( ( int32_t )blake3_IV[3] ),
+      counter_low_vec, counter_high_vec,
+      _mm256_set1_epi32( ( int32_t )BLAKE3_BLOCK_LEN ), _mm256_set1_epi32( ( int32_t )block_flags )
+    };
+
+    for( size_t r = 0; r < 7; ++r )
+      round_fn8( v, msg_vecs, r );
+
+    for( size_t i = 0; i < 8; ++i )
+      h_vecs[i] = XOR256( v[i], v[i + 8] );
+
+    block_flags = flags;
+  }
+
+  transpose_vecs8( h_vecs );
+  for( size_t i = 0; i < DEGREE; ++i )
+    _mm256_storeu_si256( ( __m256i * )&out[i * BLAKE3_OUT_LEN], h_vecs[i] );
+}
+
+BLAKE3_TARGET("avx2")
+static void blake3_hash_many_avx2( const uint8_t *const *inputs, size_t num_inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  while( num_inputs >= DEGREE )
+  {
+    blake3_hash8_avx2( inputs, blocks, key, counter, increment_counter, flags, flags_start, flags_end, out );
+    if( increment_counter )
+      counter += DEGREE;
+    inputs += DEGREE;
+    num_inputs -= DEGREE;
+    out = &out[DEGREE * BLAKE3_OUT_LEN];
+  }
+  blake3_hash_many_sse41( inputs, num_inputs, blocks, key, counter, increment_counter, flags, flags_start, flags_end, out );
+}
+
+#undef G256
+#undef ROT7_256
+#undef ROT8_256
+#undef ROT12_256
+#undef ROT16_256
+#undef XOR256
+#undef ADD256
+#undef DEGREE
+
+#endif /*BLAKE3_HAVE_X86*/
+
+/*------------------------------------*/
+/* Dispatch */
+/*------------------------------------*/
+
+typedef void ( *blake3_hash_many_fn )( const uint8_t *const *inputs, size_t num_inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out );
+
+static blake3_hash_many_fn g_blake3_hash_many = blake3_hash_many_ref;
+static size_t g_blake3_simd_degree = 1;
+static blake3_impl g_blake3_impl = BLAKE3_IMPL_REF;
+
+static inline void blake3_hash_many( const uint8_t *const *inputs, size_t num_inputs, size_t blocks, const uint32_t key[8], uint64_t counter, bool increment_counter, uint8_t flags, uint8_t flags_start, uint8_t flags_end, uint8_t *out )
+{
+  g_blake3_hash_many( inputs, num_inputs, blocks, key, counter, increment_counter, flags, flags_start, flags_end, out );
+}
+
+static inline size_t blake3_simd_degree( void )
+{
+  return g_blake3_simd_degree;
+}
+
+/* must be called before any other thread starts hashing, the CPU support is *not* verified here */
+int MUtils::Hash::Internal::Blake3Impl::blake3_select_impl( const blake3_impl impl )
+{
+  switch( impl )
+  {
+  case BLAKE3_IMPL_REF:
+    g_blake3_hash_many = blake3_hash_many_ref;
+    g_blake3_simd_degree = 1;
+    break;
+#if defined(BLAKE3_HAVE_X86)
+  case BLAKE3_IMPL_SSE41:
+    g_blake3_hash_many = blake3_hash_many_sse41;
+    g_blake3_simd_degree = 4;
+    break;
+  case BLAKE3_IMPL_AVX2:
+    g_blake3_hash_many = blake3_hash_many_avx2;
+    g_blake3_simd_degree = 8;
+    break;
+#endif
+  default:
+    return -1;
+  }
+
+  g_blake3_impl = impl;
+  return 0;
+}
+
+MUtils::Hash::Internal::Blake3Impl::blake3_impl MUtils::Hash::Internal::Blake3Impl::blake3_current_impl( void )
+{
+  return g_blake3_impl;
+}
+
+/*------------------------------------*/
+/* blake3.c */
+/*------------------------------------*/
+
+typedef struct __output_t
+{
+  uint32_t input_cv[8];
+  uint64_t counter;
+  uint8_t  block[BLAKE3_BLOCK_LEN];
+  uint8_t  block_len;
+  uint8_t  flags;
+} output_t;
+
+static inline void chunk_state_init( blake3_chunk_state *self, const uint32_t key[8], uint8_t flags )
+{
+  memcpy( self->cv, key, BLAKE3_KEY_LEN );
+  self->chunk_counter = 0;
+  memset( self->buf, 0, BLAKE3_BLOCK_LEN );
+  self->buf_len = 0;
+  self->blocks_compressed = 0;
+  self->flags = flags;
+}
+
+static inline void chunk_state_reset( blake3_chunk_state *self, const uint32_t key[8], uint64_t chunk_counter )
+{
+  memcpy( self->cv, key, BLAKE3_KEY_LEN );
+  self->chunk_counter = chunk_counter;
+  self->blocks_compressed = 0;
+  memset( self->buf, 0, BLAKE3_BLOCK_LEN );
+  self->buf_len = 0;
+}
+
+static inline size_t chunk_state_len( const blake3_chunk_state *self )
+{
+  return ( BLAKE3_BLOCK_LEN * ( size_t )self->blocks_compressed ) + ( ( size_t )self->buf_len );
+}
+
+static inline size_t chunk_state_fill_buf( blake3_chunk_state *self, const uint8_t *input, size_t input_len )
+{
+  size_t take = BLAKE3_BLOCK_LEN - ( ( size_t )self->buf_len );
+  if( take > input_len )
+    take = input_len;
+  uint8_t *dest = self->buf + ( ( size_t )self->buf_len );
+  memcpy( dest, input, take );
+  self->buf_len += ( uint8_t )take;
+  return take;
+}
+
+static inline uint8_t chunk_state_maybe_start_flag( const blake3_chunk_state *self )
+{
+  return ( self->blocks_compressed == 0 ) ? CHUNK_START : 0;
+}
+
+static inline output_t make_output( const uint32_t input_cv[8], const uint8_t block[BLAKE3_BLOCK_LEN], uint8_t block_len, uint64_t counter, uint8_t flags )
+{
+  output_t ret;
+  memcpy( ret.input_cv, input_cv, 32 );
+  memcpy( ret.block, block, BLAKE3_BLOCK_LEN );
+  ret.block_len = block_len;
+  ret.counter = counter;
+  ret.flags = flags;
+  return ret;
+}
+
+static inline void output_chaining_value( const output_t *self, uint8_t cv[32] )
+{
+  uint32_t cv_words[8];
+  memcpy( cv_words, self->input_cv, 32 );
+  blake3_compress_in_place( cv_words, self->block, self->block_len, self->counter, self->flags );
+  store_cv_words( cv, cv_words );
+}
+
+static inline void output_root_bytes( const output_t *self, uint64_t seek, uint8_t *out, size_t out_len )
+{
+  uint64_t output_block_counter = seek / 64;
+  size_t offset_within_block = ( size_t )( seek % 64 );
+  uint8_t wide_buf[64];
+  while( out_len > 0 )
+  {
+    blake3_compress_xof( self->input_cv, self->block, self->block_len, output_block_counter, self->flags | ROOT, wide_buf );
+    size_t available_bytes = 64 - offset_within_block;
+    size_t memcpy_len = ( out_len > available_bytes ) ? available_bytes : out_len;
+    memcpy( out, wide_buf + offset_within_block, memcpy_len );
+    out += memcpy_len;
+    out_len -= memcpy_len;
+    output_block_counter += 1;
+    offset_within_block = 0;
+  }
+}
+
+static inline void chunk_state_update( blake3_chunk_state *self, const uint8_t *input, size_t input_len )
+{
+  if( self->buf_len > 0 )
+  {
+    size_t take = chunk_state_fill_buf( self, input, input_len );
+    input += take;
+    input_len -= take;
+    if( input_len > 0 )
+    {
+      blake3_compress_in_place( self->cv, self->buf, BLAKE3_BLOCK_LEN, self->chunk_counter, self->flags | chunk_state_maybe_start_flag( self ) );
+      self->blocks_compressed += 1;
+      self->buf_len = 0;
+      memset( self->buf, 0, BLAKE3_BLOCK_LEN );
+    }
+  }
+
+  while( input_len > BLAKE3_BLOCK_LEN )
+  {
+    blake3_compress_in_place( self->cv, input, BLAKE3_BLOCK_LEN, self->chunk_counter, self->flags | chunk_state_maybe_start_flag( self ) );
+    self->blocks_compressed += 1;
+    input += BLAKE3_BLOCK_LEN;
+    input_len -= BLAKE3_BLOCK_LEN;
+  }
+
+  chunk_state_fill_buf( self, input, input_len );
+}
+
+static inline output_t chunk_state_output( const blake3_chunk_state *self )
+{
+  uint8_t block_flags = self->flags | chunk_state_maybe_start_flag( self ) | CHUNK_END;
+  return make_output( self->cv, self->buf, self->buf_len, self->chunk_counter, block_flags );
+}
+
+static inline output_t parent_output( const uint8_t block[BLAKE3_BLOCK_LEN], const uint32_t key[8], uint8_t flags )
+{
+  return make_output( key, block, BLAKE3_BLOCK_LEN, 0, flags | PARENT );
+}
+
+/* Given some input larger than one chunk, return the number of bytes that should go in the left subtree. This is the largest power-of-2 number of chunks that leaves at least 1 byte for the right subtree. */
+static inline size_t left_len( size_t content_len )
+{
+  size_t full_chunks = ( content_len - 1 ) / BLAKE3_CHUNK_LEN;
+  return ( size_t )round_down_to_power_of_2( full_chunks ) * BLAKE3_CHUNK_LEN;
+}
+
+/* Use SIMD parallelism to hash up to MAX_SIMD_DEGREE chunks at the same time on a single thread. Write out the chunk chaining values and return the number of chunks hashed. These chunks are never the root and never empty; those cases use a different codepath. */
+static inline size_t compress_chunks_parallel( const uint8_t *input, size_t input_len, const uint32_t key[8], uint64_t chunk_counter, uint8_t flags, uint8_t *out )
+{
+  const uint8_t *chunks_array[MAX_SIMD_DEGREE];
+  size_t input_position = 0;
+  size_t chunks_array_len = 0;
+  while( input_len - input_position >= BLAKE3_CHUNK_LEN )
+  {
+    chunks_array[chunks_array_len] = &input[input_position];
+    input_position += BLAKE3_CHUNK_LEN;
+    chunks_array_len += 1;
+  }
+
+  blake3_hash_many( chunks_array, chunks_array_len, BLAKE3_CHUNK_LEN / BLAKE3_BLOCK_LEN, key, chunk_counter, true, flags, CHUNK_START, CHUNK_END, out );
+
+  // Hash the remaining partial chunk, if there is one. Note that the empty chunk (meaning the empty message) is a different codepath.
+  if( input_len > input_position )
+  {
+    uint64_t counter = chunk_counter + ( uint64_t )chunks_array_len;
+    blake3_chunk_state chunk_state;
+    chunk_state_init( &chunk_state, key, flags );
+    chunk_state.chunk_counter = counter;
+    chunk_state_update( &chunk_state, &input[input_position], input_len - input_position );
+    output_t output = chunk_state_output( &chunk_state );
+    output_chaining_value( &output, &out[chunks_array_len * BLAKE3_OUT_LEN] );
+    return chunks_array_len + 1;
+  }
+  else
+  {
+    return chunks_array_len;
+  }
+}
+
+/* Use SIMD parallelism to hash up to MAX_SIMD_DEGREE parents at the same time on a single thread. Write out the parent chaining values and return the number of parents hashed. (If there's an odd input chaining value left over, return it as an additional output.) These parents are never the root and never empty; those cases use a different codepath. */
+static inline size_t compress_parents_parallel( const uint8_t *child_chaining_values, size_t num_chaining_values, const uint32_t key[8], uint8_t flags, uint8_t *out )
+{
+  const uint8_t *parents_array[MAX_SIMD_DEGREE_OR_2];
+  size_t parents_array_len = 0;
+  while( num_chaining_values - ( 2 * parents_array_len ) >= 2 )
+  {
+    parents_array[parents_array_len] = &child_chaining_values[2 * parents_array_len * BLAKE3_OUT_LEN];
+    parents_array_len += 1;
+  }
+
+  blake3_hash_many( parents_array, parents_array_len, 1, key, 0, false, flags | PARENT, 0, 0, out );
+
+  // If there's an odd child left over, it becomes an output.
+  if( num_chaining_values > 2 * parents_array_len )
+  {
+    memcpy( &out[parents_array_len * BLAKE3_OUT_LEN], &child_chaining_values[2 * parents_array_len * BLAKE3_OUT_LEN], BLAKE3_OUT_LEN );
+    return parents_array_len + 1;
+  }
+  else
+  {
+    return parents_array_len;
+  }
+}
+
+/* The wide helper function returns (writes out) an array of chaining values and returns the length of that array. The number of chaining values returned is the dynamically detected SIMD degree, at most MAX_SIMD_DEGREE. Or fewer, if the input is shorter than that many chunks. The reason for maintaining a wide array of chaining values going back up the tree, is to allow the implementation to hash as many parents in parallel as possible. */
+static size_t compress_subtree_wide( const uint8_t *input, size_t input_len, const uint32_t key[8], uint64_t chunk_counter, uint8_t flags, uint8_t *out )
+{
+  // Note that the single chunk case does *not* bump the SIMD degree up to 2 when it is 1.
+  if( input_len <= blake3_simd_degree() * BLAKE3_CHUNK_LEN )
+  {
+    return compress_chunks_parallel( input, input_len, key, chunk_counter, flags, out );
+  }
+
+  // With more than simd_degree chunks, we need to recurse. Start by dividing the input into left and right subtrees.
+  size_t left_input_len = left_len( input_len );
+  size_t right_input_len = input_len - left_input_len;
+  const uint8_t *right_input = &input[left_input_len];
+  uint64_t right_chunk_counter = chunk_counter + ( uint64_t )( left_input_len / BLAKE3_CHUNK_LEN );
+
+  // Make space for the child outputs. Here we use MAX_SIMD_DEGREE_OR_2 to account for the special case of returning 2 outputs when the SIMD degree is 1.
+  uint8_t cv_array[2 * MAX_SIMD_DEGREE_OR_2 * BLAKE3_OUT_LEN];
+  size_t degree = blake3_simd_degree();
+  if( left_input_len > BLAKE3_CHUNK_LEN && degree == 1 )
+  {
+    // The special case: We always use a degree of at least two, to make sure there are two outputs. Except, as noted above, at the chunk level, where we allow degree=1.
+    degree = 2;
+  }
+  uint8_t *right_cvs = &cv_array[degree * BLAKE3_OUT_LEN];
+
+  // Recurse!
+  size_t left_n = compress_subtree_wide( input, left_input_len, key, chunk_counter, flags, cv_array );
+  size_t right_n = compress_subtree_wide( right_input, right_input_len, key, right_chunk_counter, flags, right_cvs );
+
+  // The special case again. If simd_degree=1, then we'll have left_n=1 and right_n=1. Rather than compressing them into a single output, return them directly, to make sure we always have at least two outputs.
+  if( left_n == 1 )
+  {
+    memcpy( out, cv_array, 2 * BLAKE3_OUT_LEN );
+    return 2;
+  }
+
+  // Otherwise, do one layer of parent node compression.
+  size_t num_chaining_values = left_n + right_n;
+  return compress_parents_parallel( cv_array, num_chaining_values, key, flags, out );
+}
+
+/* Hash a subtree with compress_subtree_wide(), and then condense the resulting list of chaining values down to a single parent node. Don't compress that last parent node, however. Instead, return its message bytes (the concatenated chaining values of its children). This is necessary when the first call to update() supplies a complete subtree, because the topmost parent node of that subtree could end up being the root. It's also necessary for extended output in the general case. As with compress_subtree_wide(), this function is not used on inputs of 1 chunk or less. That's a different codepath. */
+static inline void compress_subtree_to_parent_node( const uint8_t *input, size_t input_len, const uint32_t key[8], uint64_t chunk_counter, uint8_t flags, uint8_t out[2 * BLAKE3_OUT_LEN] )
+{
+  uint8_t cv_array[MAX_SIMD_DEGREE_OR_2 * BLAKE3_OUT_LEN];
+  size_t num_cvs = compress_subtree_wide( input, input_len, key, chunk_counter, flags, cv_array );
+
+  // If MAX_SIMD_DEGREE is greater than 2 and there's enough input, compress_subtree_wide() returns more than 2 chaining values. Condense them into 2 by forming parent nodes repeatedly.
+  uint8_t out_array[MAX_SIMD_DEGREE_OR_2 * BLAKE3_OUT_LEN / 2];
+  while( num_cvs > 2 )
+  {
+    num_cvs = compress_parents_parallel( cv_array, num_cvs, key, flags, out_array );
+    memcpy( cv_array, out_array, num_cvs * BLAKE3_OUT_LEN );
+  }
+  memcpy( out, cv_array, 2 * BLAKE3_OUT_LEN );
+}
+
+/*------------------------------------*/
+/* Multi-threading */
+/*------------------------------------*/
+
+typedef struct __subtree_job_t
+{
+  const uint8_t  *input;
+  size_t          part_len;
+  const uint32_t *key;
+  uint64_t        chunk_counter;
+  uint8_t         flags;
+  uint8_t        *out;
+} subtree_job_t;
+
+/* computes the (non-root) chaining value of the index-th part, each part is a complete subtree of at least two chunks */
+static void compress_subtree_task( void *arg, const size_t index )
+{
+  const subtree_job_t *const job = ( const subtree_job_t * )arg;
+  uint8_t cv_pair[2 * BLAKE3_OUT_LEN];
+  compress_subtree_to_parent_node( job->input + ( index * job->part_len ), job->part_len, job->key, job->chunk_counter + ( uint64_t )( index * ( job->part_len / BLAKE3_CHUNK_LEN ) ), job->flags, cv_pair );
+  output_t output = parent_output( cv_pair, job->key, job->flags );
+  output_chaining_value( &output, &job->out[index * BLAKE3_OUT_LEN] );
+}
+
+/* Same as compress_subtree_to_parent_node(), but splits the subtree into a power-of-2 number of equally sized parts that are hashed via the "parallel" callback. The input length must be a power of 2 multiple of BLAKE3_CHUNK_LEN. */
+static void compress_subtree_to_parent_node_mt( const uint8_t *input, size_t input_len, const uint32_t key[8], uint64_t chunk_counter, uint8_t flags, uint8_t out[2 * BLAKE3_OUT_LEN], blake3_parallel_fn parallel )
+{
+  size_t num_parts = input_len / PARALLEL_MIN_BYTES;
+  if( num_parts > PARALLEL_MAX_TASKS )
+    num_parts = PARALLEL_MAX_TASKS;
+
+  uint8_t cv_array[PARALLEL_MAX_TASKS * BLAKE3_OUT_LEN];
+  subtree_job_t job = { input, input_len / num_parts, key, chunk_counter, flags, cv_array };
+  parallel( compress_subtree_task, &job, num_parts );
+
+  // Now condense the chaining values of the parts into 2, the parts are complete subtrees, so every level has an even number of nodes
+  const uint8_t *parents_array[PARALLEL_MAX_TASKS / 2];
+  uint8_t out_array[PARALLEL_MAX_TASKS * BLAKE3_OUT_LEN / 2];
+  while( num_parts > 2 )
+  {
+    for( size_t i = 0; i < num_parts / 2; ++i )
+      parents_array[i] = &cv_array[2 * i * BLAKE3_OUT_LEN];
+    blake3_hash_many( parents_array, num_parts / 2, 1, key, 0, false, flags | PARENT, 0, 0, out_array );
+    num_parts /= 2;
+    memcpy( cv_array, out_array, num_parts * BLAKE3_OUT_LEN );
+  }
+  memcpy( out, cv_array, 2 * BLAKE3_OUT_LEN );
+}
+
+/*------------------------------------*/
+/* Hasher */
+/*------------------------------------*/
+
+static inline void hasher_init_base( blake3_hasher *self, const uint32_t key[8], uint8_t flags )
+{
+  memcpy( self->key, key, BLAKE3_KEY_LEN );
+  chunk_state_init( &self->chunk, key, flags );
+  self->cv_stack_len = 0;
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_init( blake3_hasher *self )
+{
+  hasher_init_base( self, blake3_IV, 0 );
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_init_keyed( blake3_hasher *self, const uint8_t key[BLAKE3_KEY_LEN] )
+{
+  uint32_t key_words[8];
+  load_key_words( key, key_words );
+  hasher_init_base( self, key_words, KEYED_HASH );
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_init_derive_key_raw( blake3_hasher *self, const void *context, size_t context_len )
+{
+  blake3_hasher context_hasher;
+  hasher_init_base( &context_hasher, blake3_IV, DERIVE_KEY_CONTEXT );
+  blake3_hasher_update( &context_hasher, context, context_len, NULL );
+  uint8_t context_key[BLAKE3_KEY_LEN];
+  blake3_hasher_finalize( &context_hasher, context_key, BLAKE3_KEY_LEN );
+  uint32_t context_key_words[8];
+  load_key_words( context_key, context_key_words );
+  hasher_init_base( self, context_key_words, DERIVE_KEY_MATERIAL );
+}
+
+/* As described in hasher_push_cv() below, we do "lazy merging", delaying merges until right before the next CV is about to be added. This is different from the reference implementation. Another difference is that we aren't always merging 1 chunk at a time. Instead, each CV might represent any power-of-two number of chunks, as long as the smaller-above-larger stack order is maintained. Instead of the "count the trailing 0-bits" algorithm described in the spec, we use a "count the total number of 1-bits" variant that doesn't require us to retain the subtree size of the CV on top of the stack. The principle is the same: each CV that should remain in the stack is represented by a 1-bit in the total number of chunks (or bytes) so far. */
+static inline void hasher_merge_cv_stack( blake3_hasher *self, uint64_t total_len )
+{
+  size_t post_merge_stack_len = ( size_t )popcnt( total_len );
+  while( self->cv_stack_len > post_merge_stack_len )
+  {
+    uint8_t *parent_node = &self->cv_stack[( self->cv_stack_len - 2 ) * BLAKE3_OUT_LEN];
+    output_t output = parent_output( parent_node, self->key, self->chunk.flags );
+    output_chaining_value( &output, parent_node );
+    self->cv_stack_len -= 1;
+  }
+}
+
+/* In reference_impl.rs, we merge the new CV with existing CVs from the stack before pushing it. We can do that because we know more input is coming, so we know none of the merges are root. This setting is different. We want to feed as much input as possible to compress_subtree_wide(), without setting aside anything for the chunk_state. If the user gives us 64 KiB, we want to parallelize over all 64 KiB at once as a single subtree, if at all possible. This leads to two problems: 1) This 64 KiB input might be the only call that ever gets made to update. In this case, the root node of the 64 KiB subtree would be the root node of the whole tree, and it would need to be ROOT finalized. We can't compress it until we know. 2) This 64 KiB input might complete a larger tree, whose root node is similarly going to be the root of the whole tree. For example, maybe we have 196 KiB (that is, 128 + 64) hashed so far. We can't compress the node at the root of the 256 KiB subtree until we know how to finalize it. The second problem is solved with "lazy merging". That is, when we're about to add a CV to the stack, we don't merge it with anything first, as the reference impl does. Instead we do merges using the *previous* CV that was added, which is sitting on top of the stack, and we put the new CV (unmerged) on top of the stack afterwards. This guarantees that we never merge the root node until finalize(). Solving the first problem requires an additional tool, compress_subtree_to_parent_node(). That function always returns the top *two* chaining values of the subtree it's compressing. We then do lazy merging with each of them separately, so that the second CV will always remain unmerged. (That also helps us support extendable output when we're hashing an input all-at-once.) */
+static inline void hasher_push_cv( blake3_hasher *self, uint8_t new_cv[BLAKE3_OUT_LEN], uint64_t chunk_counter )
+{
+  hasher_merge_cv_stack( self, chunk_counter );
+  memcpy( &self->cv_stack[self->cv_stack_len * BLAKE3_OUT_LEN], new_cv, BLAKE3_OUT_LEN );
+  self->cv_stack_len += 1;
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_update( blake3_hasher *self, const void *input, size_t input_len, blake3_parallel_fn parallel )
+{
+  // Explicitly checking for zero avoids causing UB by passing a null pointer to memcpy. This comes up in practice with things like: std::vector<uint8_t> v; blake3_hasher_update(&hasher, v.data(), v.size());
+  if( input_len == 0 )
+    return;
+
+  const uint8_t *input_bytes = ( const uint8_t * )input;
+
+  // If we have some partial chunk bytes in the internal chunk_state, we need to finish that chunk first.
+  if( chunk_state_len( &self->chunk ) > 0 )
+  {
+    size_t take = BLAKE3_CHUNK_LEN - chunk_state_len( &self->chunk );
+    if( take > input_len )
+      take = input_len;
+    chunk_state_update( &self->chunk, input_bytes, take );
+    input_bytes += take;
+    input_len -= take;
+    // If we've filled the current chunk and there's more coming, finalize this chunk and proceed. In this case we know it's not the root.
+    if( input_len > 0 )
+    {
+      output_t output = chunk_state_output( &self->chunk );
+      uint8_t chunk_cv[32];
+      output_chaining_value( &output, chunk_cv );
+      hasher_push_cv( self, chunk_cv, self->chunk.chunk_counter );
+      chunk_state_reset( &self->chunk, self->key, self->chunk.chunk_counter + 1 );
+    }
+    else
+    {
+      return;
+    }
+  }
+
+  // Now the chunk_state is clear, and we have more input. If there's more than a single chunk (so, definitely not the root chunk), hash the largest whole subtree we can, with the full benefits of SIMD parallelism (and multi-threading, if a "parallel" callback was given). Two restrictions:
+  // - The subtree has to be a power-of-2 number of chunks. Only subtrees along the right edge can be incomplete, and we don't know where the right edge is going to be until we get to finalize().
+  // - The subtree must evenly divide the total number of chunks up until this point (if total is not 0). If the current incomplete subtree is only waiting for 1 more chunk, we can't hash a subtree of 4 chunks. We have to complete the current subtree first.
+  // Because we might need to break up the input to form powers of 2, or to evenly divide what we already have, this part runs in a loop.
+  while( input_len > BLAKE3_CHUNK_LEN )
+  {
+    uint64_t subtree_len = round_down_to_power_of_2( input_len );
+    uint64_t count_so_far = self->chunk.chunk_counter * BLAKE3_CHUNK_LEN;
+    // Shrink the subtree_len until it evenly divides the count so far. We know that subtree_len itself is a power of 2, so we can use a bitmasking trick instead of an actual remainder operation. (Note that if the caller consistently passes power-of-2 inputs of the same size, as is hopefully typical, this loop condition will always fail, and subtree_len will always be the full length of the input.)
+    while( ( ( ( uint64_t )( subtree_len - 1 ) ) & count_so_far ) != 0 )
+      subtree_len /= 2;
+    // The shrunken subtree_len might now be 1 chunk long. If so, hash that one chunk by itself. Otherwise, compress the subtree into a pair of CVs.
+    uint64_t subtree_chunks = subtree_len / BLAKE3_CHUNK_LEN;
+    if( subtree_len <= BLAKE3_CHUNK_LEN )
+    {
+      blake3_chunk_state chunk_state;
+      chunk_state_init( &chunk_state, self->key, self->chunk.flags );
+      chunk_state.chunk_counter = self->chunk.chunk_counter;
+      chunk_state_update( &chunk_state, input_bytes, ( size_t )subtree_len );
+      output_t output = chunk_state_output( &chunk_state );
+      uint8_t cv[BLAKE3_OUT_LEN];
+      output_chaining_value( &output, cv );
+      hasher_push_cv( self, cv, chunk_state.chunk_counter );
+    }
+    else
+    {
+      // This is the high-performance happy path, though getting here depends on the caller giving us a long enough input.
+      uint8_t cv_pair[2 * BLAKE3_OUT_LEN];
+      if( parallel && ( subtree_len >= 2 * PARALLEL_MIN_BYTES ) )
+        compress_subtree_to_parent_node_mt( input_bytes, ( size_t )subtree_len, self->key, self->chunk.chunk_counter, self->chunk.flags, cv_pair, parallel );
+      else
+        compress_subtree_to_parent_node( input_bytes, ( size_t )subtree_len, self->key, self->chunk.chunk_counter, self->chunk.flags, cv_pair );
+      hasher_push_cv( self, cv_pair, self->chunk.chunk_counter );
+      hasher_push_cv( self, &cv_pair[BLAKE3_OUT_LEN], self->chunk.chunk_counter + ( subtree_chunks / 2 ) );
+    }
+    self->chunk.chunk_counter += subtree_chunks;
+    input_bytes += subtree_len;
+    input_len -= ( size_t )subtree_len;
+  }
+
+  // If there's any remaining input less than a full chunk, add it to the chunk state. In that case, also do a final merge loop to make sure the subtree stack doesn't contain any unmerged pairs. The remaining input means we know these merges are non-root. This merge loop isn't strictly necessary here, because hasher_push_chunk_cv() already does its own merge loop, but it simplifies blake3_hasher_finalize() below.
+  if( input_len > 0 )
+  {
+    chunk_state_update( &self->chunk, input_bytes, input_len );
+    hasher_merge_cv_stack( self, self->chunk.chunk_counter );
+  }
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_finalize( const blake3_hasher *self, uint8_t *out, size_t out_len )
+{
+  blake3_hasher_finalize_seek( self, 0, out, out_len );
+}
+
+void MUtils::Hash::Internal::Blake3Impl::blake3_hasher_finalize_seek( const blake3_hasher *self, uint64_t seek, uint8_t *out, size_t out_len )
+{
+  // Explicitly checking for zero avoids causing UB by passing a null pointer to memcpy.
+  if( out_len == 0 )
+    return;
+
+  // If the subtree stack is empty, then the current chunk is the root.
+  if( self->cv_stack_len == 0 )
+  {
+    output_t output = chunk_state_output( &self->chunk );
+    output_root_bytes( &output, seek, out, out_len );
+    return;
+  }
+
+  // If there are any bytes in the chunk state, finalize that chunk and do a roll-up merge between that chunk hash and every subtree in the stack. In this case, the extra merge loop at the end of blake3_hasher_update() guarantees that none of the subtrees in the stack need to be merged with each other first. Otherwise, if there are no bytes in the chunk state, then the top of the stack is a chunk hash, and we start the merge from that.
+  output_t output;
+  size_t cvs_remaining;
+  if( chunk_state_len( &self->chunk ) > 0 )
+  {
+    cvs_remaining = self->cv_stack_len;
+    output = chunk_state_output( &self->chunk );
+  }
+  else
+  {
+    // There are always at least 2 CVs in the stack in this case.
+    cvs_remaining = self->cv_stack_len - 2;
+    output = parent_output( &self->cv_stack[cvs_remaining * 32], self->key, self->chunk.flags );
+  }
+
+  while( cvs_remaining > 0 )
+  {
+    cvs_remaining -= 1;
+    uint8_t parent_block[BLAKE3_BLOCK_LEN];
+    memcpy( parent_block, &self->cv_stack[cvs_remaining * 32], 32 );
+    output_chaining_value( &output, &parent_block[32] );
+    output = parent_output( parent_block, self->key, self->chunk.flags );
+  }
+
+  output_root_bytes( &output, seek, out, out_len );
+}
@@ -0,0 +1,56 @@
+/* crc32c.c -- compute CRC-32C using the Intel crc32 instruction
+ * Copyright (C) 2013, 2021 Mark Adler
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the author be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Mark Adler
+ * madler@alumni.caltech.edu
+ */
+#pragma once
+#ifndef __CRC32C_H__
+#define __CRC32C_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		namespace Internal
+		{
+			namespace CRC32CImpl
+			{
+				// CRC computation implementations (CRC32C_IMPL_SSE42 uses the crc32 instruction on three interleaved streams)
+				enum crc32c_impl
+				{
+					CRC32C_IMPL_REF   = 0,
+					CRC32C_IMPL_SSE42 = 1
+				};
+
+				// Dispatch API (also builds the lookup tables, so it must be called once before crc32c_update() is used)
+				int crc32c_select_impl( const crc32c_impl impl );
+				crc32c_impl crc32c_current_impl( void );
+
+				// Streaming API (start with crc = 0, the returned value is the CRC-32C of all data so far)
+				uint32_t crc32c_update( uint32_t crc, const void *buf, size_t len );
+			}
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,346 @@
+/* crc32c.c -- compute CRC-32C using the Intel crc32 instruction
+ * Copyright (C) 2013, 2021 Mark Adler
+ *
+ * This software is provided 'as-is', without any express or implied
+ * warranty.  In no event will the author be held liable for any damages
+ * arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose,
+ * including commercial applications, and to alter it and redistribute it
+ * freely, subject to the following restrictions:
+ *
+ * 1. The origin of this software must not be misrepresented; you must not
+ *    claim that you wrote the original software. If you use this software
+ *    in a product, an acknowledgment in the product documentation would be
+ *    appreciated but is not required.
+ * 2. Altered source versions must be plainly marked as such, and must not be
+ *    misrepresented as being the original software.
+ * 3. This notice may not be removed or altered from any source distribution.
+ *
+ * Mark Adler
+ * madler@alumni.caltech.edu
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/crc32c.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define CRC32C_HAVE_X86 1
+#include <nmmintrin.h>
+#endif
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CRC32C_HAVE_X64 1
+#endif
+
+#if defined(__GNUC__)
+#define CRC32C_TARGET(X) __attribute__((target(X)))
+#else
+#define CRC32C_TARGET(X)
+#endif
+
+using namespace MUtils::Hash::Internal::CRC32CImpl;
+
+/* CRC-32C (iSCSI) polynomial in reversed bit order */
+#define POLY 0x82f63b78U
+
+/* block sizes for the three interleaved crc32 streams, must be powers of two */
+#define LONG  8192
+#define SHORT 256
+
+static uint32_t crc32c_table[8][256];
+static uint32_t crc32c_long[4][256];
+static uint32_t crc32c_short[4][256];
+
+static inline uint64_t load64( const uint8_t *src )
+{
+  return ( ( uint64_t )( src[0] ) <<  0 ) | ( ( uint64_t )( src[1] ) <<  8 ) |
+         ( ( uint64_t )( src[2] ) << 16 ) | ( ( uint64_t )( src[3] ) << 24 ) |
+         ( ( uint64_t )( src[4] ) << 32 ) | ( ( uint64_t )( src[5] ) << 40 ) |
+         ( ( uint64_t )( src[6] ) << 48 ) | ( ( uint64_t )( src[7] ) << 56 );
+}
+
+/*------------------------------------*/
+/* software version */
+/*------------------------------------*/
+
+/* construct table for software CRC-32C calculation, slicing by eight bytes */
+static void crc32c_init_sw( void )
+{
+  for( uint32_t n = 0; n < 256; n++ )
+  {
+    uint32_t crc = n;
+    for( int k = 0; k < 8; k++ )
+    {
+      crc = ( crc & 1 ) ? ( crc >> 1 ) ^ POLY : ( crc >> 1 );
+    }
+    crc32c_table[0][n] = crc;
+  }
+  for( uint32_t n = 0; n < 256; n++ )
+  {
+    uint32_t crc = crc32c_table[0][n];
+    for( int k = 1; k < 8; k++ )
+    {
+      crc = crc32c_table[0][crc & 0xff] ^ ( crc >> 8 );
+      crc32c_table[k][n] = crc;
+    }
+  }
+}
+
+static uint32_t crc32c_sw( uint32_t crci, const void *buf, size_t len )
+{
+  const uint8_t *next = ( const uint8_t * )buf;
+  uint64_t crc = crci ^ 0xffffffffU;
+
+  while( len >= 8 )
+  {
+    crc ^= load64( next );
+    crc = crc32c_table[7][ crc        & 0xff] ^ crc32c_table[6][( crc >>  8 ) & 0xff] ^
+          crc32c_table[5][( crc >> 16 ) & 0xff] ^ crc32c_table[4][( crc >> 24 ) & 0xff] ^
+          crc32c_table[3][( crc >> 32 ) & 0xff] ^ crc32c_table[2][( crc >> 40 ) & 0xff] ^
+          crc32c_table[1][( crc >> 48 ) & 0xff] ^ crc32c_table[0][  crc >> 56        ];
+    next += 8;
+    len -= 8;
+  }
+  while( len )
+  {
+    crc = crc32c_table[0][( crc ^ *next++ ) & 0xff] ^ ( crc >> 8 );
+    len--;
+  }
+
+  return ( uint32_t )crc ^ 0xffffffffU;
+}
+
+/*------------------------------------*/
+/* zeros operators */
+/*------------------------------------*/
+
+/* multiply a matrix times a vector over the Galois field of two elements, GF(2) */
+static inline uint32_t gf2_matrix_times( const uint32_t *mat, uint32_t vec )
+{
+  uint32_t sum = 0;
+  while( vec )
+  {
+    if( vec & 1 )
+    {
+      sum ^= *mat;
+    }
+    vec >>= 1;
+    mat++;
+  }
+  return sum;
+}
+
+/* multiply a matrix by itself over GF(2), "square" and "mat" must not overlap */
+static inline void gf2_matrix_square( uint32_t *square, const uint32_t *mat )
+{
+  for( int n = 0; n < 32; n++ )
+  {
+    square[n] = gf2_matrix_times( mat, mat[n] );
+  }
+}
+
+/* construct an operator to apply "len" zeros to a crc, "len" must be a power of two */
+static void crc32c_zeros_op( uint32_t *even, size_t len )
+{
+  uint32_t odd[32];
+
+  /* put operator for one zero bit in odd */
+  odd[0] = POLY;
+  uint32_t row = 1;
+  for( int n = 1; n < 32; n++ )
+  {
+    odd[n] = row;
+    row <<= 1;
+  }
+
+  /* put operator for two zero bits in even, then four zero bits in odd */
+  gf2_matrix_square( even, odd );
+  gf2_matrix_square( odd, even );
+
+  /* first square will put the operator for one zero byte (eight zero bits) in even, then keep squaring */
+  do
+  {
+    gf2_matrix_square( even, odd );
+    len >>= 1;
+    if( len == 0 )
+    {
+      return;
+    }
+    gf2_matrix_square( odd, even );
+    len >>= 1;
+  }
+  while( len );
+
+  /* answer ended up in odd, copy to even */
+  memcpy( even, odd, sizeof( odd ) );
+}
+
+/* take a length and build four lookup tables for applying the zeros operator for that length, byte-by-byte on the operand */
+static void crc32c_zeros( uint32_t zeros[][256], size_t len )
+{
+  uint32_t op[32];
+  crc32c_zeros_op( op, len );
+  for( uint32_t n = 0; n < 256; n++ )
+  {
+    zeros[0][n] = gf2_matrix_times( op, n );
+    zeros[1][n] = gf2_matrix_times( op, n << 8 );
+    zeros[2][n] = gf2_matrix_times( op, n << 16 );
+    zeros[3][n] = gf2_matrix_times( op, n << 24 );
+  }
+}
+
+/* apply the zeros operator table to crc */
+static inline uint32_t crc32c_shift( const uint32_t zeros[][256], const uint32_t crc )
+{
+  return zeros[0][crc & 0xff] ^ zeros[1][( crc >> 8 ) & 0xff] ^ zeros[2][( crc >> 16 ) & 0xff] ^ zeros[3][crc >> 24];
+}
+
+/*------------------------------------*/
+/* hardware version */
+/*------------------------------------*/
+
+#if defined(CRC32C_HAVE_X86)
+
+#if defined(CRC32C_HAVE_X64)
+typedef uint64_t crc32c_word_t;
+CRC32C_TARGET("sse4.2")
+static inline uint32_t crc32c_step( const uint32_t crc, const uint8_t *next )
+{
+  uint64_t word;
+  memcpy( &word, next, sizeof( word ) );
+  return ( uint32_t )_mm_crc32_u64( crc, word );
+}
+#else
+typedef uint32_t crc32c_word_t;
+CRC32C_TARGET("sse4.2")
+static inline uint32_t crc32c_step( const uint32_t crc, const uint8_t *next )
+{
+  uint32_t word;
+  memcpy( &word, next, sizeof( word ) );
+  return _mm_crc32_u32( crc, word );
+}
+#endif
+
+/* compute CRC-32C using the SSE4.2 crc32 instruction: three independent streams hide the latency of the instruction */
+CRC32C_TARGET("sse4.2")
+static uint32_t crc32c_hw( uint32_t crc, const void *buf, size_t len )
+{
+  const uint8_t *next = ( const uint8_t * )buf;
+  uint32_t crc0 = crc ^ 0xffffffffU;
+
+  /* compute the crc for up to seven leading bytes to bring the data pointer to an eight-byte boundary */
+  while( len && ( ( uintptr_t )next & 7 ) != 0 )
+  {
+    crc0 = _mm_crc32_u8( crc0, *next );
+    next++;
+    len--;
+  }
+
+  /* compute the crc on sets of LONG*3 bytes, executing three independent crc instructions, each on LONG bytes */
+  while( len >= LONG * 3 )
+  {
+    uint32_t crc1 = 0, crc2 = 0;
+    const uint8_t *const end = next + LONG;
+    do
+    {
+      crc0 = crc32c_step( crc0, next );
+      crc1 = crc32c_step( crc1, next + LONG );
+      crc2 = crc32c_step( crc2, next + LONG + LONG );
+      next += sizeof( crc32c_word_t );
+    }
+    while( next < end );
+    crc0 = crc32c_shift( crc32c_long, crc0 ) ^ crc1;
+    crc0 = crc32c_shift( crc32c_long, crc0 ) ^ crc2;
+    next += LONG * 2;
+    len -= LONG * 3;
+  }
+
+  /* do the same thing, but now on SHORT*3 blocks for the remaining data less than a LONG*3 block */
+  while( len >= SHORT * 3 )
+  {
+    uint32_t crc1 = 0, crc2 = 0;
+    const uint8_t *const end = next + SHORT;
+    do
+    {
+      crc0 = crc32c_step( crc0, next );
+      crc1 = crc32c_step( crc1, next + SHORT );
+      crc2 = crc32c_step( crc2, next + SHORT + SHORT );
+      next += sizeof( crc32c_word_t );
+    }
+    while( next < end );
+    crc0 = crc32c_shift( crc32c_short, crc0 ) ^ crc1;
+    crc0 = crc32c_shift( crc32c_short, crc0 ) ^ crc2;
+    next += SHORT * 2;
+    len -= SHORT * 3;
+  }
+
+  /* compute the crc on the remaining words, then bytes */
+  while( len >= sizeof( crc32c_word_t ) )
+  {
+    crc0 = crc32c_step( crc0, next );
+    next += sizeof( crc32c_word_t );
+    len -= sizeof( crc32c_word_t );
+  }
+  while( len )
+  {
+    crc0 = _mm_crc32_u8( crc0, *next );
+    next++;
+    len--;
+  }
+
+  return crc0 ^ 0xffffffffU;
+}
+
+#endif //CRC32C_HAVE_X86
+
+/*------------------------------------*/
+/* dispatch */
+/*------------------------------------*/
+
+typedef uint32_t ( *crc32c_fn )( uint32_t crc, const void *buf, size_t len );
+
+static crc32c_fn g_crc32c_fn = crc32c_sw;
+static crc32c_impl g_crc32c_impl = CRC32C_IMPL_REF;
+static bool g_crc32c_tables = false;
+
+/* must be called before any other thread starts hashing, the CPU support is *not* verified here */
+int MUtils::Hash::Internal::CRC32CImpl::crc32c_select_impl( const crc32c_impl impl )
+{
+  if( !g_crc32c_tables )
+  {
+    crc32c_init_sw();
+    crc32c_zeros( crc32c_long, LONG );
+    crc32c_zeros( crc32c_short, SHORT );
+    g_crc32c_tables = true;
+  }
+
+  switch( impl )
+  {
+  case CRC32C_IMPL_REF:
+    g_crc32c_fn = crc32c_sw;
+    break;
+#if defined(CRC32C_HAVE_X86)
+  case CRC32C_IMPL_SSE42:
+    g_crc32c_fn = crc32c_hw;
+    break;
+#endif
+  default:
+    return -1;
+  }
+
+  g_crc32c_impl = impl;
+  return 0;
+}
+
+MUtils::Hash::Internal::CRC32CImpl::crc32c_impl MUtils::Hash::Internal::CRC32CImpl::crc32c_current_impl( void )
+{
+  return g_crc32c_impl;
+}
+
+uint32_t MUtils::Hash::Internal::CRC32CImpl::crc32c_update( uint32_t crc, const void *buf, size_t len )
+{
+  return g_crc32c_fn( crc, buf, len );
+}
@@ -18,6 +18,27 @@
 **                                                                        **
 ***************************************************************************/
 
+#include <string.h>
+#include <stdlib.h>
+
+#if defined(_M_X64) || defined(_M_ARM64) || defined(__x86_64__) || defined(__aarch64__)
+#define KECCAK_OPT64 1 /*use the 64-Bit optimized permutation on 64-Bit targets*/
+#endif
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define KECCAK_MB_HAVE_AVX2 1
+#if !(defined(_MSC_VER) && (_MSC_VER < 1911))
+#define KECCAK_MB_HAVE_AVX512 1 /*requires VS2017 15.3 or later*/
+#endif
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define KECCAK_MB_TARGET(X) __attribute__((target(X)))
+#else
+#define KECCAK_MB_TARGET(X)
+#endif
+
 namespace MUtils {
 namespace Hash {
 namespace Internal {
@@ -295,9 +316,436 @@ void KeccakAbsorb(unsigned char *state, const unsigned char *data, unsigned int
 void KeccakExtract1024bits(const unsigned char *state, unsigned char *data);
 #endif
 void KeccakExtract(const unsigned char *state, unsigned char *data, unsigned int laneCount);
+void KeccakImportState(unsigned char *state, const unsigned char *data);
+
+#endif
+
+
+// ================================================================================
+// =================== KeccakF-1600 implementation selection
+// ================================================================================
+
+
+/*
+On 64-Bit targets, the permutation works on native 64-Bit lanes, fully unrolled
+and with lane complementing ("opt64"). On 32-Bit targets, the bit-interleaved
+32-Bit implementation ("opt32") is used. The state layout differs between the two,
+but the sponge code only ever accesses the state through the interface above.
+*/
+
+#ifdef KECCAK_OPT64
+
+// ================================================================================
+// =================== KeccakF-1600-opt64-settings.h
+// ================================================================================
+
+
+#define Unrolling 24
+#define UseBebigokimisa
+
+
+// ================================================================================
+// =================== KeccakF-1600-64.macros
+// ================================================================================
+
+
+/*
+The Keccak sponge function, designed by Guido Bertoni, Joan Daemen,
+Michaël Peeters and Gilles Van Assche. For more information, feedback or
+questions, please refer to our website: http://keccak.noekeon.org/
+
+Implementation by the designers,
+hereby denoted as "the implementer".
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+#if defined(_MSC_VER)
+#define ROL64(a, offset) _rotl64(a, offset)
+#else
+#define ROL64(a, offset) ((((UINT64)a) << offset) ^ (((UINT64)a) >> (64-offset)))
+#endif
+
+#define declareABCDE \
+    UINT64 Aba, Abe, Abi, Abo, Abu, Aga, Age, Agi, Ago, Agu, Aka, Ake, Aki, Ako, Aku, Ama, Ame, Ami, Amo, Amu, Asa, Ase, Asi, Aso, Asu; \
+    UINT64 Bba, Bbe, Bbi, Bbo, Bbu, Bga, Bge, Bgi, Bgo, Bgu, Bka, Bke, Bki, Bko, Bku, Bma, Bme, Bmi, Bmo, Bmu, Bsa, Bse, Bsi, Bso, Bsu; \
+    UINT64 Ca, Ce, Ci, Co, Cu; \
+    UINT64 Da, De, Di, Do, Du; \
+    UINT64 Eba, Ebe, Ebi, Ebo, Ebu, Ega, Ege, Egi, Ego, Egu, Eka, Eke, Eki, Eko, Eku, Ema, Eme, Emi, Emo, Emu, Esa, Ese, Esi, Eso, Esu;
+
+#define prepareTheta \
+    Ca = Aba^Aga^Aka^Ama^Asa; \
+    Ce = Abe^Age^Ake^Ame^Ase; \
+    Ci = Abi^Agi^Aki^Ami^Asi; \
+    Co = Abo^Ago^Ako^Amo^Aso; \
+    Cu = Abu^Agu^Aku^Amu^Asu;
+
+// --- Lane complementing ("bebigokimisa"): lanes be, bi, go, ki, mi and sa are stored complemented,
+// --- which replaces most of the NOT operations in chi
+// --- Code for round, with prepare-theta for the next round
+// --- using A for the input and E for the output
+#define thetaRhoPiChiIotaPrepareTheta(i, A, E) \
+    Da = Cu^ROL64(Ce, 1); \
+    De = Ca^ROL64(Ci, 1); \
+    Di = Ce^ROL64(Co, 1); \
+    Do = Ci^ROL64(Cu, 1); \
+    Du = Co^ROL64(Ca, 1); \
+\
+    A##ba ^= Da; \
+    Bba = A##ba; \
+    A##ge ^= De; \
+    Bbe = ROL64(A##ge, 44); \
+    A##ki ^= Di; \
+    Bbi = ROL64(A##ki, 43); \
+    A##mo ^= Do; \
+    Bbo = ROL64(A##mo, 21); \
+    A##su ^= Du; \
+    Bbu = ROL64(A##su, 14); \
+    E##ba =   Bba ^(  Bbe |  Bbi ); \
+    E##ba ^= KeccakF1600RoundConstants[i]; \
+    Ca = E##ba; \
+    E##be =   Bbe ^((~Bbi)|  Bbo ); \
+    Ce = E##be; \
+    E##bi =   Bbi ^(  Bbo &  Bbu ); \
+    Ci = E##bi; \
+    E##bo =   Bbo ^(  Bbu |  Bba ); \
+    Co = E##bo; \
+    E##bu =   Bbu ^(  Bba &  Bbe ); \
+    Cu = E##bu; \
+\
+    A##bo ^= Do; \
+    Bga = ROL64(A##bo, 28); \
+    A##gu ^= Du; \
+    Bge = ROL64(A##gu, 20); \
+    A##ka ^= Da; \
+    Bgi = ROL64(A##ka, 3); \
+    A##me ^= De; \
+    Bgo = ROL64(A##me, 45); \
+    A##si ^= Di; \
+    Bgu = ROL64(A##si, 61); \
+    E##ga =   Bga ^(  Bge |  Bgi ); \
+    Ca ^= E##ga; \
+    E##ge =   Bge ^(  Bgi &  Bgo ); \
+    Ce ^= E##ge; \
+    E##gi =   Bgi ^(  Bgo |(~Bgu)); \
+    Ci ^= E##gi; \
+    E##go =   Bgo ^(  Bgu |  Bga ); \
+    Co ^= E##go; \
+    E##gu =   Bgu ^(  Bga &  Bge ); \
+    Cu ^= E##gu; \
+\
+    A##be ^= De; \
+    Bka = ROL64(A##be, 1); \
+    A##gi ^= Di; \
+    Bke = ROL64(A##gi, 6); \
+    A##ko ^= Do; \
+    Bki = ROL64(A##ko, 25); \
+    A##mu ^= Du; \
+    Bko = ROL64(A##mu, 8); \
+    A##sa ^= Da; \
+    Bku = ROL64(A##sa, 18); \
+    E##ka =   Bka ^(  Bke |  Bki ); \
+    Ca ^= E##ka; \
+    E##ke =   Bke ^(  Bki &  Bko ); \
+    Ce ^= E##ke; \
+    E##ki =   Bki ^((~Bko)&  Bku ); \
+    Ci ^= E##ki; \
+    E##ko = (~Bko)^(  Bku |  Bka ); \
+    Co ^= E##ko; \
+    E##ku =   Bku ^(  Bka &  Bke ); \
+    Cu ^= E##ku; \
+\
+    A##bu ^= Du; \
+    Bma = ROL64(A##bu, 27); \
+    A##ga ^= Da; \
+    Bme = ROL64(A##ga, 36); \
+    A##ke ^= De; \
+    Bmi = ROL64(A##ke, 10); \
+    A##mi ^= Di; \
+    Bmo = ROL64(A##mi, 15); \
+    A##so ^= Do; \
+    Bmu = ROL64(A##so, 56); \
+    E##ma =   Bma ^(  Bme &  Bmi ); \
+    Ca ^= E##ma; \
+    E##me =   Bme ^(  Bmi |  Bmo ); \
+    Ce ^= E##me; \
+    E##mi =   Bmi ^((~Bmo)|  Bmu ); \
+    Ci ^= E##mi; \
+    E##mo = (~Bmo)^(  Bmu &  Bma ); \
+    Co ^= E##mo; \
+    E##mu =   Bmu ^(  Bma |  Bme ); \
+    Cu ^= E##mu; \
+\
+    A##bi ^= Di; \
+    Bsa = ROL64(A##bi, 62); \
+    A##go ^= Do; \
+    Bse = ROL64(A##go, 55); \
+    A##ku ^= Du; \
+    Bsi = ROL64(A##ku, 39); \
+    A##ma ^= Da; \
+    Bso = ROL64(A##ma, 41); \
+    A##se ^= De; \
+    Bsu = ROL64(A##se, 2); \
+    E##sa =   Bsa ^((~Bse)&  Bsi ); \
+    Ca ^= E##sa; \
+    E##se = (~Bse)^(  Bsi |  Bso ); \
+    Ce ^= E##se; \
+    E##si =   Bsi ^(  Bso &  Bsu ); \
+    Ci ^= E##si; \
+    E##so =   Bso ^(  Bsu |  Bsa ); \
+    Co ^= E##so; \
+    E##su =   Bsu ^(  Bsa &  Bse ); \
+    Cu ^= E##su;
+
+#define copyFromState(X, state) \
+    X##ba = state[ 0]; \
+    X##be = state[ 1]; \
+    X##bi = state[ 2]; \
+    X##bo = state[ 3]; \
+    X##bu = state[ 4]; \
+    X##ga = state[ 5]; \
+    X##ge = state[ 6]; \
+    X##gi = state[ 7]; \
+    X##go = state[ 8]; \
+    X##gu = state[ 9]; \
+    X##ka = state[10]; \
+    X##ke = state[11]; \
+    X##ki = state[12]; \
+    X##ko = state[13]; \
+    X##ku = state[14]; \
+    X##ma = state[15]; \
+    X##me = state[16]; \
+    X##mi = state[17]; \
+    X##mo = state[18]; \
+    X##mu = state[19]; \
+    X##sa = state[20]; \
+    X##se = state[21]; \
+    X##si = state[22]; \
+    X##so = state[23]; \
+    X##su = state[24];
+
+#define copyToState(state, X) \
+    state[ 0] = X##ba; \
+    state[ 1] = X##be; \
+    state[ 2] = X##bi; \
+    state[ 3] = X##bo; \
+    state[ 4] = X##bu; \
+    state[ 5] = X##ga; \
+    state[ 6] = X##ge; \
+    state[ 7] = X##gi; \
+    state[ 8] = X##go; \
+    state[ 9] = X##gu; \
+    state[10] = X##ka; \
+    state[11] = X##ke; \
+    state[12] = X##ki; \
+    state[13] = X##ko; \
+    state[14] = X##ku; \
+    state[15] = X##ma; \
+    state[16] = X##me; \
+    state[17] = X##mi; \
+    state[18] = X##mo; \
+    state[19] = X##mu; \
+    state[20] = X##sa; \
+    state[21] = X##se; \
+    state[22] = X##si; \
+    state[23] = X##so; \
+    state[24] = X##su;
+
+
+// ================================================================================
+// =================== KeccakF-1600-opt64.c
+// ================================================================================
+
+
+/*
+The Keccak sponge function, designed by Guido Bertoni, Joan Daemen,
+Michaël Peeters and Gilles Van Assche. For more information, feedback or
+questions, please refer to our website: http://keccak.noekeon.org/
+
+Implementation by the designers,
+hereby denoted as "the implementer".
+
+To the extent possible under law, the implementer has waived all copyright
+and related or neighboring rights to the source code in this file.
+http://creativecommons.org/publicdomain/zero/1.0/
+*/
+
+#if (PLATFORM_BYTE_ORDER != IS_LITTLE_ENDIAN)
+#error "The 64-Bit optimized implementation requires a little-endian platform!"
+#endif
+
+static const UINT64 KeccakF1600RoundConstants[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+void KeccakPermutationOnWords(UINT64 *state)
+{
+    declareABCDE
+
+    copyFromState(A, state)
+    prepareTheta
+    thetaRhoPiChiIotaPrepareTheta( 0, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 1, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 2, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 3, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 4, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 5, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 6, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 7, E, A)
+    thetaRhoPiChiIotaPrepareTheta( 8, A, E)
+    thetaRhoPiChiIotaPrepareTheta( 9, E, A)
+    thetaRhoPiChiIotaPrepareTheta(10, A, E)
+    thetaRhoPiChiIotaPrepareTheta(11, E, A)
+    thetaRhoPiChiIotaPrepareTheta(12, A, E)
+    thetaRhoPiChiIotaPrepareTheta(13, E, A)
+    thetaRhoPiChiIotaPrepareTheta(14, A, E)
+    thetaRhoPiChiIotaPrepareTheta(15, E, A)
+    thetaRhoPiChiIotaPrepareTheta(16, A, E)
+    thetaRhoPiChiIotaPrepareTheta(17, E, A)
+    thetaRhoPiChiIotaPrepareTheta(18, A, E)
+    thetaRhoPiChiIotaPrepareTheta(19, E, A)
+    thetaRhoPiChiIotaPrepareTheta(20, A, E)
+    thetaRhoPiChiIotaPrepareTheta(21, E, A)
+    thetaRhoPiChiIotaPrepareTheta(22, A, E)
+    thetaRhoPiChiIotaPrepareTheta(23, E, A)
+    copyToState(state, A)
+}
+
+void KeccakPermutationOnWordsAfterXoring(UINT64 *state, const UINT8 *input, unsigned int laneCount)
+{
+    unsigned int i;
+    UINT64 lane;
+
+    for(i=0; i<laneCount; i++) {
+        memcpy(&lane, input + 8*i, 8);
+        state[i] ^= lane;
+    }
+    KeccakPermutationOnWords(state);
+}
+
+void KeccakInitialize()
+{
+}
+
+void KeccakInitializeState(unsigned char *state)
+{
+    memset(state, 0, 200);
+    ((UINT64*)state)[ 1] = ~(UINT64)0;
+    ((UINT64*)state)[ 2] = ~(UINT64)0;
+    ((UINT64*)state)[ 8] = ~(UINT64)0;
+    ((UINT64*)state)[12] = ~(UINT64)0;
+    ((UINT64*)state)[17] = ~(UINT64)0;
+    ((UINT64*)state)[20] = ~(UINT64)0;
+}
+
+void KeccakPermutation(unsigned char *state)
+{
+    KeccakPermutationOnWords((UINT64*)state);
+}
+
+#ifdef ProvideFast576
+void KeccakAbsorb576bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 9);
+}
+#endif
+
+#ifdef ProvideFast832
+void KeccakAbsorb832bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 13);
+}
+#endif
+
+#ifdef ProvideFast1024
+void KeccakAbsorb1024bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 16);
+}
+#endif
+
+#ifdef ProvideFast1088
+void KeccakAbsorb1088bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 17);
+}
+#endif
+
+#ifdef ProvideFast1152
+void KeccakAbsorb1152bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 18);
+}
+#endif
 
+#ifdef ProvideFast1344
+void KeccakAbsorb1344bits(unsigned char *state, const unsigned char *data)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, 21);
+}
 #endif
 
+void KeccakAbsorb(unsigned char *state, const unsigned char *data, unsigned int laneCount)
+{
+    KeccakPermutationOnWordsAfterXoring((UINT64*)state, data, laneCount);
+}
+
+#ifdef ProvideFast1024
+void KeccakExtract1024bits(const unsigned char *state, unsigned char *data)
+{
+    memcpy(data, state, 128);
+    ((UINT64*)data)[ 1] = ~((UINT64*)data)[ 1];
+    ((UINT64*)data)[ 2] = ~((UINT64*)data)[ 2];
+    ((UINT64*)data)[ 8] = ~((UINT64*)data)[ 8];
+    ((UINT64*)data)[12] = ~((UINT64*)data)[12];
+}
+#endif
+
+void KeccakExtract(const unsigned char *state, unsigned char *data, unsigned int laneCount)
+{
+    memcpy(data, state, laneCount*8);
+    if (laneCount > 1) {
+        ((UINT64*)data)[ 1] = ~((UINT64*)data)[ 1];
+        if (laneCount > 2) {
+            ((UINT64*)data)[ 2] = ~((UINT64*)data)[ 2];
+            if (laneCount > 8) {
+                ((UINT64*)data)[ 8] = ~((UINT64*)data)[ 8];
+                if (laneCount > 12) {
+                    ((UINT64*)data)[12] = ~((UINT64*)data)[12];
+                    if (laneCount > 17) {
+                        ((UINT64*)data)[17] = ~((UINT64*)data)[17];
+                        if (laneCount > 20) {
+                            ((UINT64*)data)[20] = ~((UINT64*)data)[20];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Inverse of KeccakExtract() with laneCount = 25, i.e. sets the state from all 25 lanes in canonical form */
+void KeccakImportState(unsigned char *state, const unsigned char *data)
+{
+    memcpy(state, data, 200);
+    ((UINT64*)state)[ 1] = ~((UINT64*)state)[ 1];
+    ((UINT64*)state)[ 2] = ~((UINT64*)state)[ 2];
+    ((UINT64*)state)[ 8] = ~((UINT64*)state)[ 8];
+    ((UINT64*)state)[12] = ~((UINT64*)state)[12];
+    ((UINT64*)state)[17] = ~((UINT64*)state)[17];
+    ((UINT64*)state)[20] = ~((UINT64*)state)[20];
+}
+
+#else // !KECCAK_OPT64
+
 
 // ================================================================================
 // =================== KeccakF-1600-opt32-settings.h
@@ -1558,6 +2006,30 @@ void KeccakExtract(const unsigned char *state, unsigned char *data, unsigned int
 #endif
 }
 
+/* Inverse of KeccakExtract() with laneCount = 25, i.e. sets the state from all 25 lanes in canonical form */
+void KeccakImportState(unsigned char *state, const unsigned char *data)
+{
+    memset(state, 0, 200);
+    xorLanesIntoState(25, (UINT32*)state, data)
+#ifdef UseBebigokimisa
+    ((UINT32*)state)[ 2] = ~((UINT32*)state)[ 2];
+    ((UINT32*)state)[ 3] = ~((UINT32*)state)[ 3];
+    ((UINT32*)state)[ 4] = ~((UINT32*)state)[ 4];
+    ((UINT32*)state)[ 5] = ~((UINT32*)state)[ 5];
+    ((UINT32*)state)[16] = ~((UINT32*)state)[16];
+    ((UINT32*)state)[17] = ~((UINT32*)state)[17];
+    ((UINT32*)state)[24] = ~((UINT32*)state)[24];
+    ((UINT32*)state)[25] = ~((UINT32*)state)[25];
+    ((UINT32*)state)[34] = ~((UINT32*)state)[34];
+    ((UINT32*)state)[35] = ~((UINT32*)state)[35];
+    ((UINT32*)state)[40] = ~((UINT32*)state)[40];
+    ((UINT32*)state)[41] = ~((UINT32*)state)[41];
+#endif
+}
+
+
+#endif // KECCAK_OPT64
+
 
 // ================================================================================
 // =================== KeccakSponge.c
@@ -1998,6 +2470,269 @@ HashReturn Hash(int hashbitlen, const BitSequence *data, DataLength databitlen,
 }
 
 
+// ================================================================================
+// =================== KeccakF-1600 multi-buffer
+// ================================================================================
+
+/*
+Runs 4 (AVX2) or 8 (AVX-512) independent Keccak[r, c] sponges side by side,
+one sponge per 64-bit SIMD lane. Word i of the sliced state holds word i of
+every sponge, so the permutation is simply the plain 64-bit KeccakF-1600
+applied to vectors. Whenever a message has been completed, its lane is
+refilled with the next pending message, so that all lanes keep busy.
+
+The sliced state is stored as lanes[i * laneCount + k], i.e. word i of sponge k.
+*/
+
+typedef enum { MULTI_SCALAR = 1, MULTI_AVX2 = 4, MULTI_AVX512 = 8 } MultiImpl;
+enum { KeccakMultiMaxLanes = 8 };
+
+typedef void (*KeccakMultiPermutation)(UINT64 *lanes);
+
+static const UINT64 KeccakF1600RoundConstants_int64[24] =
+{
+    0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808AULL, 0x8000000080008000ULL,
+    0x000000000000808BULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+    0x000000000000008AULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000AULL,
+    0x000000008000808BULL, 0x800000000000008BULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+    0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800AULL, 0x800000008000000AULL,
+    0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+};
+
+#define KeccakMultiRound \
+	C0 = XOR5(A00, A05, A10, A15, A20); C1 = XOR5(A01, A06, A11, A16, A21); C2 = XOR5(A02, A07, A12, A17, A22); \
+	C3 = XOR5(A03, A08, A13, A18, A23); C4 = XOR5(A04, A09, A14, A19, A24); \
+	D0 = XOR(C4, ROL(C1, 1)); D1 = XOR(C0, ROL(C2, 1)); D2 = XOR(C1, ROL(C3, 1)); D3 = XOR(C2, ROL(C4, 1)); D4 = XOR(C3, ROL(C0, 1)); \
+	B00 = XOR(A00, D0); B10 = ROL(XOR(A01, D1), 1); B20 = ROL(XOR(A02, D2), 62); B05 = ROL(XOR(A03, D3), 28); B15 = ROL(XOR(A04, D4), 27); \
+	B16 = ROL(XOR(A05, D0), 36); B01 = ROL(XOR(A06, D1), 44); B11 = ROL(XOR(A07, D2), 6); B21 = ROL(XOR(A08, D3), 55); B06 = ROL(XOR(A09, D4), 20); \
+	B07 = ROL(XOR(A10, D0), 3); B17 = ROL(XOR(A11, D1), 10); B02 = ROL(XOR(A12, D2), 43); B12 = ROL(XOR(A13, D3), 25); B22 = ROL(XOR(A14, D4), 39); \
+	B23 = ROL(XOR(A15, D0), 41); B08 = ROL(XOR(A16, D1), 45); B18 = ROL(XOR(A17, D2), 15); B03 = ROL(XOR(A18, D3), 21); B13 = ROL(XOR(A19, D4), 8); \
+	B14 = ROL(XOR(A20, D0), 18); B24 = ROL(XOR(A21, D1), 2); B09 = ROL(XOR(A22, D2), 61); B19 = ROL(XOR(A23, D3), 56); B04 = ROL(XOR(A24, D4), 14); \
+	A00 = CHI(B00, B01, B02); A01 = CHI(B01, B02, B03); A02 = CHI(B02, B03, B04); A03 = CHI(B03, B04, B00); A04 = CHI(B04, B00, B01); \
+	A05 = CHI(B05, B06, B07); A06 = CHI(B06, B07, B08); A07 = CHI(B07, B08, B09); A08 = CHI(B08, B09, B05); A09 = CHI(B09, B05, B06); \
+	A10 = CHI(B10, B11, B12); A11 = CHI(B11, B12, B13); A12 = CHI(B12, B13, B14); A13 = CHI(B13, B14, B10); A14 = CHI(B14, B10, B11); \
+	A15 = CHI(B15, B16, B17); A16 = CHI(B16, B17, B18); A17 = CHI(B17, B18, B19); A18 = CHI(B18, B19, B15); A19 = CHI(B19, B15, B16); \
+	A20 = CHI(B20, B21, B22); A21 = CHI(B21, B22, B23); A22 = CHI(B22, B23, B24); A23 = CHI(B23, B24, B20); A24 = CHI(B24, B20, B21); \
+	A00 = XOR(A00, RC); \
+
+#define KeccakMultiDeclare(V) \
+    V A00, A01, A02, A03, A04, A05, A06, A07, A08, A09, A10, A11, A12, A13, A14, A15, A16, A17, A18, A19, A20, A21, A22, A23, A24; \
+    V B00, B01, B02, B03, B04, B05, B06, B07, B08, B09, B10, B11, B12, B13, B14, B15, B16, B17, B18, B19, B20, B21, B22, B23, B24; \
+    V C0, C1, C2, C3, C4, D0, D1, D2, D3, D4;
+
+#define KeccakMultiTransfer(OP) \
+    OP(A00,  0); OP(A01,  1); OP(A02,  2); OP(A03,  3); OP(A04,  4); \
+    OP(A05,  5); OP(A06,  6); OP(A07,  7); OP(A08,  8); OP(A09,  9); \
+    OP(A10, 10); OP(A11, 11); OP(A12, 12); OP(A13, 13); OP(A14, 14); \
+    OP(A15, 15); OP(A16, 16); OP(A17, 17); OP(A18, 18); OP(A19, 19); \
+    OP(A20, 20); OP(A21, 21); OP(A22, 22); OP(A23, 23); OP(A24, 24);
+
+#ifdef KECCAK_MB_HAVE_AVX2
+
+KECCAK_MB_TARGET("avx2")
+static void KeccakF1600_x4_AVX2(UINT64 *lanes)
+{
+    #define XOR(a, b) _mm256_xor_si256((a), (b))
+    #define XOR5(a, b, c, d, e) XOR(XOR(XOR((a), (b)), XOR((c), (d))), (e))
+    #define ROL(a, n) _mm256_or_si256(_mm256_slli_epi64((a), (n)), _mm256_srli_epi64((a), 64 - (n)))
+    #define CHI(a, b, c) XOR((a), _mm256_andnot_si256((b), (c)))
+    #define LOAD(X, i) X = _mm256_loadu_si256((const __m256i*)(lanes + 4 * (i)))
+    #define STORE(X, i) _mm256_storeu_si256((__m256i*)(lanes + 4 * (i)), X)
+
+    KeccakMultiDeclare(__m256i)
+    KeccakMultiTransfer(LOAD)
+    for (unsigned int round = 0; round < 24; ++round)
+    {
+        const __m256i RC = _mm256_broadcastq_epi64(_mm_loadl_epi64((const __m128i*)&KeccakF1600RoundConstants_int64[round]));
+        KeccakMultiRound
+    }
+    KeccakMultiTransfer(STORE)
+
+    #undef XOR
+    #undef XOR5
+    #undef ROL
+    #undef CHI
+    #undef LOAD
+    #undef STORE
+}
+
+#endif //KECCAK_MB_HAVE_AVX2
+
+#ifdef KECCAK_MB_HAVE_AVX512
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized" /*GCC 12 warns about the undefined "__Y" operand inside _mm512_rol_epi64()*/
+#endif
+
+KECCAK_MB_TARGET("avx512f")
+static void KeccakF1600_x8_AVX512(UINT64 *lanes)
+{
+    #define XOR(a, b) _mm512_xor_si512((a), (b))
+    #define XOR5(a, b, c, d, e) _mm512_ternarylogic_epi64(_mm512_ternarylogic_epi64((a), (b), (c), 0x96), (d), (e), 0x96)
+    #define ROL(a, n) _mm512_rol_epi64((a), (n))
+    #define CHI(a, b, c) _mm512_ternarylogic_epi64((a), (b), (c), 0xD2) /*a ^ (~b & c)*/
+    #define LOAD(X, i) X = _mm512_loadu_si512((const void*)(lanes + 8 * (i)))
+    #define STORE(X, i) _mm512_storeu_si512((void*)(lanes + 8 * (i)), X)
+
+    KeccakMultiDeclare(__m512i)
+    KeccakMultiTransfer(LOAD)
+    for (unsigned int round = 0; round < 24; ++round)
+    {
+        const __m512i RC = _mm512_set1_epi64((long long)KeccakF1600RoundConstants_int64[round]);
+        KeccakMultiRound
+    }
+    KeccakMultiTransfer(STORE)
+
+    #undef XOR
+    #undef XOR5
+    #undef ROL
+    #undef CHI
+    #undef LOAD
+    #undef STORE
+}
+
+#if defined(__GNUC__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif //KECCAK_MB_HAVE_AVX512
+
+#undef KeccakMultiRound
+#undef KeccakMultiDeclare
+#undef KeccakMultiTransfer
+
+/*
+Copies the next block of (prefix || data), starting at *offset, into block.
+Returns 1 if this was the final, padded block of the message; 0 otherwise.
+*/
+static int KeccakMultiNextBlock(UINT8 *block, const unsigned int rateInBytes, const BitSequence *prefix, const DataLength prefixLen, const BitSequence *data, const DataLength dataLen, DataLength *offset)
+{
+    const DataLength remaining = prefixLen + dataLen - *offset;
+    const unsigned int blockLen = (remaining >= rateInBytes) ? rateInBytes : (unsigned int)remaining;
+    unsigned int done = 0;
+
+    if ((*offset < prefixLen) && (blockLen > 0)) {
+        done = ((prefixLen - *offset) < blockLen) ? (unsigned int)(prefixLen - *offset) : blockLen;
+        memcpy(block, prefix + *offset, done);
+    }
+    if (done < blockLen)
+        memcpy(block + done, data + (*offset + done - prefixLen), blockLen - done);
+    *offset += blockLen;
+
+    if (blockLen == rateInBytes)
+        return 0;
+
+    // Keccak padding (pad10*1), byte-aligned messages only
+    memset(block + blockLen, 0, rateInBytes - blockLen);
+    block[blockLen] |= 0x01;
+    block[rateInBytes - 1] |= 0x80;
+    return 1;
+}
+
+static HashReturn KeccakMultiHashLanes(const unsigned int laneCount, KeccakMultiPermutation permute, const unsigned int rateInBytes, const unsigned int hashInBytes,
+    const BitSequence *prefix, const DataLength prefixLen, const unsigned int count, const BitSequence *const *data, const DataLength *dataLen, BitSequence *const *hashval)
+{
+    UINT64 lanes[25 * KeccakMultiMaxLanes];
+    UINT8 block[KeccakMaximumRateInBytes];
+    unsigned int job[KeccakMultiMaxLanes];
+    DataLength offset[KeccakMultiMaxLanes];
+    int active[KeccakMultiMaxLanes], last[KeccakMultiMaxLanes];
+    unsigned int next = 0, running = 0, i, k;
+
+    memset(lanes, 0, sizeof(lanes));
+    for(k = 0; k < laneCount; k++) {
+        active[k] = (next < count);
+        if (active[k]) {
+            job[k] = next++;
+            offset[k] = 0;
+            running++;
+        }
+    }
+
+    while(running > 0) {
+        for(k = 0; k < laneCount; k++) {
+            if (!active[k])
+                continue;
+            last[k] = KeccakMultiNextBlock(block, rateInBytes, prefix, prefixLen, data[job[k]], dataLen[job[k]], &offset[k]);
+            for(i = 0; i < rateInBytes / 8; i++) {
+                const UINT8 *const src = block + 8 * i;
+                lanes[i * laneCount + k] ^=
+                    ((UINT64)src[0]      ) | ((UINT64)src[1] <<  8) | ((UINT64)src[2] << 16) | ((UINT64)src[3] << 24) |
+                    ((UINT64)src[4] << 32) | ((UINT64)src[5] << 40) | ((UINT64)src[6] << 48) | ((UINT64)src[7] << 56);
+            }
+        }
+        permute(lanes);
+        for(k = 0; k < laneCount; k++) {
+            if ((!active[k]) || (!last[k]))
+                continue;
+            for(i = 0; i < hashInBytes; i++)
+                hashval[job[k]][i] = (UINT8)(lanes[(i / 8) * laneCount + k] >> (8 * (i % 8)));
+            for(i = 0; i < 25; i++)
+                lanes[i * laneCount + k] = 0;
+            active[k] = (next < count);
+            if (active[k]) {
+                job[k] = next++;
+                offset[k] = 0;
+            }
+            else {
+                running--;
+            }
+        }
+    }
+    return SUCCESS;
+}
+
+/**
+  * Function to compute the hashes of multiple independent messages with the Keccak[r, c] sponge function.
+  * Each message is prepended by the same (optional) prefix, i.e. hashval[i] = Keccak(prefix || data[i]).
+  * @param  hashbitlen  The desired number of output bits.
+  * @param  impl        The implementation to use. The caller is responsible for checking the CPU features!
+  * @param  prefix      Pointer to the common prefix, may be NULL if @a prefixLen is zero.
+  * @param  prefixLen   The length of the common prefix, in bytes.
+  * @param  count       The number of messages.
+  * @param  data        Array of @a count pointers to the input messages.
+  * @param  dataLen     Array of @a count message lengths, in bytes (not bits).
+  * @param  hashval     Array of @a count pointers to the output buffers, each one hashbitlen/8 bytes in size.
+  * @pre    The value of hashbitlen must be one of 224, 256, 384 and 512.
+  * @return SUCCESS if successful, BAD_HASHLEN if the value of hashbitlen is incorrect.
+  */
+HashReturn HashMulti(int hashbitlen, MultiImpl impl, const BitSequence *prefix, DataLength prefixLen, unsigned int count, const BitSequence *const *data, const DataLength *dataLen, BitSequence *const *hashval)
+{
+    unsigned int rate;
+    switch(hashbitlen) {
+        case 224: rate = 1152; break;
+        case 256: rate = 1088; break;
+        case 384: rate =  832; break;
+        case 512: rate =  576; break;
+        default: return BAD_HASHLEN;
+    }
+
+#ifdef KECCAK_MB_HAVE_AVX512
+    if (impl == MULTI_AVX512)
+        return KeccakMultiHashLanes(8, KeccakF1600_x8_AVX512, rate / 8, hashbitlen / 8, prefix, prefixLen, count, data, dataLen, hashval);
+#endif
+#ifdef KECCAK_MB_HAVE_AVX2
+    if (impl == MULTI_AVX2)
+        return KeccakMultiHashLanes(4, KeccakF1600_x4_AVX2, rate / 8, hashbitlen / 8, prefix, prefixLen, count, data, dataLen, hashval);
+#endif
+
+    // No SIMD available, use the single-buffer implementation
+    for(unsigned int i = 0; i < count; i++) {
+        hashState state;
+        HashReturn result = Init(&state, hashbitlen);
+        if ((result == SUCCESS) && (prefixLen > 0))
+            result = Update(&state, prefix, prefixLen * 8);
+        if (result == SUCCESS)
+            result = Update(&state, data[i], dataLen[i] * 8);
+        if (result == SUCCESS)
+            result = Final(&state, hashval[i]);
+        if (result != SUCCESS)
+            return result;
+    }
+    return SUCCESS;
+}
+
 } // end of namespace KeccakImpl
 } // end of namespace Internal
 } // end of namespace Hash
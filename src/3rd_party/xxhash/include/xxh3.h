@@ -0,0 +1,99 @@
+/*
+ * xxHash - Extremely Fast Hash algorithm
+ * Copyright (C) 2012-2021 Yann Collet
+ *
+ * BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * You can contact the author at:
+ *   - xxHash homepage: https://www.xxhash.com
+ *   - xxHash source repository: https://github.com/Cyan4973/xxHash
+ */
+#pragma once
+#ifndef __XXH3_H__
+#define __XXH3_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		namespace Internal
+		{
+			namespace XXH3Impl
+			{
+				enum xxh3_constant
+				{
+					XXH3_SECRET_SIZE = 192,
+					XXH3_STRIPE_LEN  = 64,
+					XXH3_BUFFER_SIZE = 256,
+					XXH3_ACC_NB      = 8
+				};
+
+				typedef struct __xxh3_128
+				{
+					uint64_t low64;
+					uint64_t high64;
+				} xxh3_128_t;
+
+				typedef struct __xxh3_state
+				{
+					uint64_t acc[XXH3_ACC_NB];
+					uint8_t  secret[XXH3_SECRET_SIZE];  // derived from the seed, only used for inputs longer than 240 bytes
+					uint8_t  buffer[XXH3_BUFFER_SIZE];
+					uint32_t buffered;
+					uint32_t stripes_so_far;
+					uint64_t total_len;
+					uint64_t seed;
+				} xxh3_state;
+
+				// Stripe accumulation implementations
+				enum xxh3_impl
+				{
+					XXH3_IMPL_REF  = 0,
+					XXH3_IMPL_SSE2 = 1,
+					XXH3_IMPL_AVX2 = 2
+				};
+
+				// Dispatch API
+				int xxh3_select_impl( const xxh3_impl impl );
+				xxh3_impl xxh3_current_impl( void );
+
+				// Streaming API (the 64-Bit and the 128-Bit variant share the same state, only the final step differs)
+				void xxh3_reset( xxh3_state *S, const uint64_t seed );
+				void xxh3_update( xxh3_state *S, const uint8_t *in, size_t inlen );
+				uint64_t xxh3_digest_64( const xxh3_state *S );
+				xxh3_128_t xxh3_digest_128( const xxh3_state *S );
+
+				// Simple API
+				uint64_t xxh3_64( const void *in, const size_t inlen, const uint64_t seed );
+			}
+		}
+	}
+}
+
+#endif
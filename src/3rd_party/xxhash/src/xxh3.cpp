@@ -0,0 +1,754 @@
+/*
+ * xxHash - Extremely Fast Hash algorithm
+ * Copyright (C) 2012-2021 Yann Collet
+ *
+ * BSD 2-Clause License (https://www.opensource.org/licenses/bsd-license.php)
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions are
+ * met:
+ *
+ *    * Redistributions of source code must retain the above copyright
+ *      notice, this list of conditions and the following disclaimer.
+ *    * Redistributions in binary form must reproduce the above
+ *      copyright notice, this list of conditions and the following disclaimer
+ *      in the documentation and/or other materials provided with the
+ *      distribution.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+ * A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT
+ * OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+ * LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *
+ * You can contact the author at:
+ *   - xxHash homepage: https://www.xxhash.com
+ *   - xxHash source repository: https://github.com/Cyan4973/xxHash
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "../include/xxh3.h"
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define XXH3_HAVE_X86 1
+#include <emmintrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define XXH3_TARGET(X) __attribute__((target(X)))
+#else
+#define XXH3_TARGET(X)
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#pragma intrinsic(_umul128)
+#endif
+
+using namespace MUtils::Hash::Internal::XXH3Impl;
+
+/*------------------------------------*/
+/* constants */
+/*------------------------------------*/
+
+#define PRIME32_1 0x9E3779B1U
+#define PRIME32_2 0x85EBCA77U
+#define PRIME32_3 0xC2B2AE3DU
+
+#define PRIME64_1 0x9E3779B185EBCA87ULL
+#define PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define PRIME64_3 0x165667B19E3779F9ULL
+#define PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define PRIME64_5 0x27D4EB2F165667C5ULL
+
+#define PRIME_MX1 0x165667919E3779F9ULL
+#define PRIME_MX2 0x9FB21C651E98DF25ULL
+
+#define XXH3_MIDSIZE_MAX 240
+#define XXH3_MIDSIZE_STARTOFFSET 3
+#define XXH3_MIDSIZE_LASTOFFSET 17
+#define XXH3_SECRET_SIZE_MIN 136
+#define XXH3_SECRET_CONSUME_RATE 8
+#define XXH3_SECRET_LASTACC_START 7
+#define XXH3_SECRET_MERGEACCS_START 11
+#define XXH3_STRIPES_PER_BLOCK ( ( XXH3_SECRET_SIZE - XXH3_STRIPE_LEN ) / XXH3_SECRET_CONSUME_RATE )
+#define XXH3_SECRET_LIMIT ( XXH3_SECRET_SIZE - XXH3_STRIPE_LEN )
+
+static const uint8_t kSecret[XXH3_SECRET_SIZE] =
+{
+  0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+  0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+  0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+  0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+  0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+  0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+  0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+  0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+  0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+  0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+  0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+  0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+};
+
+static const uint64_t kInitAcc[XXH3_ACC_NB] =
+{
+  PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3,
+  PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1
+};
+
+/*------------------------------------*/
+/* helpers */
+/*------------------------------------*/
+
+static inline uint32_t readLE32( const void *src )
+{
+  const uint8_t *p = ( const uint8_t * )src;
+  return ( ( uint32_t )( p[0] ) <<  0 ) | ( ( uint32_t )( p[1] ) <<  8 ) |
+         ( ( uint32_t )( p[2] ) << 16 ) | ( ( uint32_t )( p[3] ) << 24 );
+}
+
+static inline uint64_t readLE64( const void *src )
+{
+  const uint8_t *p = ( const uint8_t * )src;
+  return ( ( uint64_t )( p[0] ) <<  0 ) | ( ( uint64_t )( p[1] ) <<  8 ) |
+         ( ( uint64_t )( p[2] ) << 16 ) | ( ( uint64_t )( p[3] ) << 24 ) |
+         ( ( uint64_t )( p[4] ) << 32 ) | ( ( uint64_t )( p[5] ) << 40 ) |
+         ( ( uint64_t )( p[6] ) << 48 ) | ( ( uint64_t )( p[7] ) << 56 );
+}
+
+static inline void writeLE64( void *dst, uint64_t w )
+{
+  uint8_t *p = ( uint8_t * )dst;
+  for( size_t i = 0; i < 8; ++i, w >>= 8 )
+  {
+    p[i] = ( uint8_t )( w );
+  }
+}
+
+static inline uint32_t rotl32( const uint32_t x, const int r )
+{
+  return ( x << r ) | ( x >> ( 32 - r ) );
+}
+
+static inline uint64_t rotl64( const uint64_t x, const int r )
+{
+  return ( x << r ) | ( x >> ( 64 - r ) );
+}
+
+static inline uint32_t swap32( const uint32_t x )
+{
+  return ( ( x << 24 ) & 0xff000000U ) | ( ( x <<  8 ) & 0x00ff0000U ) |
+         ( ( x >>  8 ) & 0x0000ff00U ) | ( ( x >> 24 ) & 0x000000ffU );
+}
+
+static inline uint64_t swap64( const uint64_t x )
+{
+  return ( ( uint64_t )swap32( ( uint32_t )x ) << 32 ) | ( uint64_t )swap32( ( uint32_t )( x >> 32 ) );
+}
+
+static inline xxh3_128_t mult64to128( const uint64_t lhs, const uint64_t rhs )
+{
+  xxh3_128_t r128;
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 product = ( unsigned __int128 )lhs * ( unsigned __int128 )rhs;
+  r128.low64  = ( uint64_t )( product );
+  r128.high64 = ( uint64_t )( product >> 64 );
+#elif defined(_MSC_VER) && defined(_M_X64)
+  r128.low64 = _umul128( lhs, rhs, &r128.high64 );
+#else
+  const uint64_t lo_lo = ( lhs & 0xFFFFFFFFULL ) * ( rhs & 0xFFFFFFFFULL );
+  const uint64_t hi_lo = ( lhs >> 32 ) * ( rhs & 0xFFFFFFFFULL );
+  const uint64_t lo_hi = ( lhs & 0xFFFFFFFFULL ) * ( rhs >> 32 );
+  const uint64_t hi_hi = ( lhs >> 32 ) * ( rhs >> 32 );
+  const uint64_t cross = ( lo_lo >> 32 ) + ( hi_lo & 0xFFFFFFFFULL ) + lo_hi;
+  r128.high64 = ( hi_lo >> 32 ) + ( cross >> 32 ) + hi_hi;
+  r128.low64  = ( cross << 32 ) | ( lo_lo & 0xFFFFFFFFULL );
+#endif
+  return r128;
+}
+
+static inline uint64_t mul128_fold64( const uint64_t lhs, const uint64_t rhs )
+{
+  const xxh3_128_t product = mult64to128( lhs, rhs );
+  return product.low64 ^ product.high64;
+}
+
+static inline uint64_t xorshift64( const uint64_t v64, const int shift )
+{
+  return v64 ^ ( v64 >> shift );
+}
+
+static inline uint64_t xxh64_avalanche( uint64_t h64 )
+{
+  h64 ^= h64 >> 33;
+  h64 *= PRIME64_2;
+  h64 ^= h64 >> 29;
+  h64 *= PRIME64_3;
+  h64 ^= h64 >> 32;
+  return h64;
+}
+
+static inline uint64_t xxh3_avalanche( uint64_t h64 )
+{
+  h64 = xorshift64( h64, 37 );
+  h64 *= PRIME_MX1;
+  h64 = xorshift64( h64, 32 );
+  return h64;
+}
+
+static inline uint64_t xxh3_rrmxmx( uint64_t h64, const uint64_t len )
+{
+  h64 ^= rotl64( h64, 49 ) ^ rotl64( h64, 24 );
+  h64 *= PRIME_MX2;
+  h64 ^= ( h64 >> 35 ) + len;
+  h64 *= PRIME_MX2;
+  return xorshift64( h64, 28 );
+}
+
+/*------------------------------------*/
+/* short inputs, 64-Bit */
+/*------------------------------------*/
+
+static inline uint64_t xxh3_len_1to3_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const uint8_t  c1 = input[0];
+  const uint8_t  c2 = input[len >> 1];
+  const uint8_t  c3 = input[len - 1];
+  const uint32_t combined = ( ( uint32_t )c1 << 16 ) | ( ( uint32_t )c2 << 24 ) | ( ( uint32_t )c3 << 0 ) | ( ( uint32_t )len << 8 );
+  const uint64_t bitflip = ( readLE32( secret ) ^ readLE32( secret + 4 ) ) + seed;
+  const uint64_t keyed = ( uint64_t )combined ^ bitflip;
+  return xxh64_avalanche( keyed );
+}
+
+static inline uint64_t xxh3_len_4to8_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  seed ^= ( uint64_t )swap32( ( uint32_t )seed ) << 32;
+  const uint32_t input1 = readLE32( input );
+  const uint32_t input2 = readLE32( input + len - 4 );
+  const uint64_t bitflip = ( readLE64( secret + 8 ) ^ readLE64( secret + 16 ) ) - seed;
+  const uint64_t input64 = input2 + ( ( ( uint64_t )input1 ) << 32 );
+  const uint64_t keyed = input64 ^ bitflip;
+  return xxh3_rrmxmx( keyed, len );
+}
+
+static inline uint64_t xxh3_len_9to16_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const uint64_t bitflip1 = ( readLE64( secret + 24 ) ^ readLE64( secret + 32 ) ) + seed;
+  const uint64_t bitflip2 = ( readLE64( secret + 40 ) ^ readLE64( secret + 48 ) ) - seed;
+  const uint64_t input_lo = readLE64( input ) ^ bitflip1;
+  const uint64_t input_hi = readLE64( input + len - 8 ) ^ bitflip2;
+  const uint64_t acc = len + swap64( input_lo ) + input_hi + mul128_fold64( input_lo, input_hi );
+  return xxh3_avalanche( acc );
+}
+
+static inline uint64_t xxh3_len_0to16_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  if( len >  8 ) return xxh3_len_9to16_64( input, len, secret, seed );
+  if( len >= 4 ) return xxh3_len_4to8_64( input, len, secret, seed );
+  if( len )      return xxh3_len_1to3_64( input, len, secret, seed );
+  return xxh64_avalanche( seed ^ ( readLE64( secret + 56 ) ^ readLE64( secret + 64 ) ) );
+}
+
+static inline uint64_t xxh3_mix16B( const uint8_t *input, const uint8_t *secret, uint64_t seed )
+{
+  const uint64_t input_lo = readLE64( input );
+  const uint64_t input_hi = readLE64( input + 8 );
+  return mul128_fold64( input_lo ^ ( readLE64( secret ) + seed ), input_hi ^ ( readLE64( secret + 8 ) - seed ) );
+}
+
+static inline uint64_t xxh3_len_17to128_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  uint64_t acc = len * PRIME64_1;
+  if( len > 32 )
+  {
+    if( len > 64 )
+    {
+      if( len > 96 )
+      {
+        acc += xxh3_mix16B( input + 48, secret + 96, seed );
+        acc += xxh3_mix16B( input + len - 64, secret + 112, seed );
+      }
+      acc += xxh3_mix16B( input + 32, secret + 64, seed );
+      acc += xxh3_mix16B( input + len - 48, secret + 80, seed );
+    }
+    acc += xxh3_mix16B( input + 16, secret + 32, seed );
+    acc += xxh3_mix16B( input + len - 32, secret + 48, seed );
+  }
+  acc += xxh3_mix16B( input + 0, secret + 0, seed );
+  acc += xxh3_mix16B( input + len - 16, secret + 16, seed );
+  return xxh3_avalanche( acc );
+}
+
+static uint64_t xxh3_len_129to240_64( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const size_t nbRounds = len / 16;
+  uint64_t acc = len * PRIME64_1;
+  for( size_t i = 0; i < 8; ++i )
+  {
+    acc += xxh3_mix16B( input + ( 16 * i ), secret + ( 16 * i ), seed );
+  }
+  acc = xxh3_avalanche( acc );
+  for( size_t i = 8; i < nbRounds; ++i )
+  {
+    acc += xxh3_mix16B( input + ( 16 * i ), secret + ( 16 * ( i - 8 ) ) + XXH3_MIDSIZE_STARTOFFSET, seed );
+  }
+  acc += xxh3_mix16B( input + len - 16, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET, seed );
+  return xxh3_avalanche( acc );
+}
+
+static uint64_t xxh3_short_64( const uint8_t *input, size_t len, uint64_t seed )
+{
+  if( len <= 16 ) return xxh3_len_0to16_64( input, len, kSecret, seed );
+  if( len <= 128 ) return xxh3_len_17to128_64( input, len, kSecret, seed );
+  return xxh3_len_129to240_64( input, len, kSecret, seed );
+}
+
+/*------------------------------------*/
+/* short inputs, 128-Bit */
+/*------------------------------------*/
+
+static inline xxh3_128_t xxh3_len_1to3_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const uint8_t  c1 = input[0];
+  const uint8_t  c2 = input[len >> 1];
+  const uint8_t  c3 = input[len - 1];
+  const uint32_t combinedl = ( ( uint32_t )c1 << 16 ) | ( ( uint32_t )c2 << 24 ) | ( ( uint32_t )c3 << 0 ) | ( ( uint32_t )len << 8 );
+  const uint32_t combinedh = rotl32( swap32( combinedl ), 13 );
+  const uint64_t bitflipl = ( readLE32( secret ) ^ readLE32( secret + 4 ) ) + seed;
+  const uint64_t bitfliph = ( readLE32( secret + 8 ) ^ readLE32( secret + 12 ) ) - seed;
+  xxh3_128_t h128;
+  h128.low64  = xxh64_avalanche( ( uint64_t )combinedl ^ bitflipl );
+  h128.high64 = xxh64_avalanche( ( uint64_t )combinedh ^ bitfliph );
+  return h128;
+}
+
+static inline xxh3_128_t xxh3_len_4to8_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  seed ^= ( uint64_t )swap32( ( uint32_t )seed ) << 32;
+  const uint32_t input_lo = readLE32( input );
+  const uint32_t input_hi = readLE32( input + len - 4 );
+  const uint64_t input_64 = input_lo + ( ( uint64_t )input_hi << 32 );
+  const uint64_t bitflip = ( readLE64( secret + 16 ) ^ readLE64( secret + 24 ) ) + seed;
+  const uint64_t keyed = input_64 ^ bitflip;
+  xxh3_128_t m128 = mult64to128( keyed, PRIME64_1 + ( len << 2 ) );
+  m128.high64 += ( m128.low64 << 1 );
+  m128.low64  ^= ( m128.high64 >> 3 );
+  m128.low64   = xorshift64( m128.low64, 35 );
+  m128.low64  *= PRIME_MX2;
+  m128.low64   = xorshift64( m128.low64, 28 );
+  m128.high64  = xxh3_avalanche( m128.high64 );
+  return m128;
+}
+
+static inline xxh3_128_t xxh3_len_9to16_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const uint64_t bitflipl = ( readLE64( secret + 32 ) ^ readLE64( secret + 40 ) ) - seed;
+  const uint64_t bitfliph = ( readLE64( secret + 48 ) ^ readLE64( secret + 56 ) ) + seed;
+  const uint64_t input_lo = readLE64( input );
+  uint64_t input_hi = readLE64( input + len - 8 );
+  xxh3_128_t m128 = mult64to128( input_lo ^ input_hi ^ bitflipl, PRIME64_1 );
+  m128.low64 += ( uint64_t )( len - 1 ) << 54;
+  input_hi ^= bitfliph;
+  m128.high64 += input_hi + ( uint64_t )( ( uint32_t )input_hi ) * ( uint64_t )( PRIME32_2 - 1 );
+  m128.low64 ^= swap64( m128.high64 );
+  xxh3_128_t h128 = mult64to128( m128.low64, PRIME64_2 );
+  h128.high64 += m128.high64 * PRIME64_2;
+  h128.low64   = xxh3_avalanche( h128.low64 );
+  h128.high64  = xxh3_avalanche( h128.high64 );
+  return h128;
+}
+
+static inline xxh3_128_t xxh3_len_0to16_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  if( len >  8 ) return xxh3_len_9to16_128( input, len, secret, seed );
+  if( len >= 4 ) return xxh3_len_4to8_128( input, len, secret, seed );
+  if( len )      return xxh3_len_1to3_128( input, len, secret, seed );
+  xxh3_128_t h128;
+  h128.low64  = xxh64_avalanche( seed ^ readLE64( secret + 64 ) ^ readLE64( secret + 72 ) );
+  h128.high64 = xxh64_avalanche( seed ^ readLE64( secret + 80 ) ^ readLE64( secret + 88 ) );
+  return h128;
+}
+
+static inline void xxh3_mix32B( xxh3_128_t *acc, const uint8_t *input_1, const uint8_t *input_2, const uint8_t *secret, uint64_t seed )
+{
+  acc->low64  += xxh3_mix16B( input_1, secret + 0, seed );
+  acc->low64  ^= readLE64( input_2 ) + readLE64( input_2 + 8 );
+  acc->high64 += xxh3_mix16B( input_2, secret + 16, seed );
+  acc->high64 ^= readLE64( input_1 ) + readLE64( input_1 + 8 );
+}
+
+static inline xxh3_128_t xxh3_finish_128( const xxh3_128_t acc, size_t len, uint64_t seed )
+{
+  xxh3_128_t h128;
+  h128.low64  = acc.low64 + acc.high64;
+  h128.high64 = ( acc.low64 * PRIME64_1 ) + ( acc.high64 * PRIME64_4 ) + ( ( len - seed ) * PRIME64_2 );
+  h128.low64  = xxh3_avalanche( h128.low64 );
+  h128.high64 = ( uint64_t )0 - xxh3_avalanche( h128.high64 );
+  return h128;
+}
+
+static inline xxh3_128_t xxh3_len_17to128_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  xxh3_128_t acc;
+  acc.low64  = len * PRIME64_1;
+  acc.high64 = 0;
+  if( len > 32 )
+  {
+    if( len > 64 )
+    {
+      if( len > 96 )
+      {
+        xxh3_mix32B( &acc, input + 48, input + len - 64, secret + 96, seed );
+      }
+      xxh3_mix32B( &acc, input + 32, input + len - 48, secret + 64, seed );
+    }
+    xxh3_mix32B( &acc, input + 16, input + len - 32, secret + 32, seed );
+  }
+  xxh3_mix32B( &acc, input, input + len - 16, secret, seed );
+  return xxh3_finish_128( acc, len, seed );
+}
+
+static xxh3_128_t xxh3_len_129to240_128( const uint8_t *input, size_t len, const uint8_t *secret, uint64_t seed )
+{
+  const size_t nbRounds = len / 32;
+  xxh3_128_t acc;
+  acc.low64  = len * PRIME64_1;
+  acc.high64 = 0;
+  for( size_t i = 0; i < 4; ++i )
+  {
+    xxh3_mix32B( &acc, input + ( 32 * i ), input + ( 32 * i ) + 16, secret + ( 32 * i ), seed );
+  }
+  acc.low64  = xxh3_avalanche( acc.low64 );
+  acc.high64 = xxh3_avalanche( acc.high64 );
+  for( size_t i = 4; i < nbRounds; ++i )
+  {
+    xxh3_mix32B( &acc, input + ( 32 * i ), input + ( 32 * i ) + 16, secret + XXH3_MIDSIZE_STARTOFFSET + ( 32 * ( i - 4 ) ), seed );
+  }
+  xxh3_mix32B( &acc, input + len - 16, input + len - 32, secret + XXH3_SECRET_SIZE_MIN - XXH3_MIDSIZE_LASTOFFSET - 16, ( uint64_t )0 - seed );
+  return xxh3_finish_128( acc, len, seed );
+}
+
+static xxh3_128_t xxh3_short_128( const uint8_t *input, size_t len, uint64_t seed )
+{
+  if( len <= 16 ) return xxh3_len_0to16_128( input, len, kSecret, seed );
+  if( len <= 128 ) return xxh3_len_17to128_128( input, len, kSecret, seed );
+  return xxh3_len_129to240_128( input, len, kSecret, seed );
+}
+
+/*------------------------------------*/
+/* long inputs: stripe accumulation */
+/*------------------------------------*/
+
+/* accumulates "nbStripes" consecutive stripes, the secret advances by XXH3_SECRET_CONSUME_RATE bytes per stripe */
+typedef void ( *xxh3_accumulate_fn )( uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t nbStripes );
+typedef void ( *xxh3_scramble_fn )( uint64_t *acc, const uint8_t *secret );
+
+static void xxh3_accumulate_ref( uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t nbStripes )
+{
+  for( size_t n = 0; n < nbStripes; ++n, input += XXH3_STRIPE_LEN, secret += XXH3_SECRET_CONSUME_RATE )
+  {
+    for( size_t i = 0; i < XXH3_ACC_NB; ++i )
+    {
+      const uint64_t data_val = readLE64( input + ( 8 * i ) );
+      const uint64_t data_key = data_val ^ readLE64( secret + ( 8 * i ) );
+      acc[i ^ 1] += data_val;
+      acc[i] += ( uint64_t )( ( uint32_t )data_key ) * ( data_key >> 32 );
+    }
+  }
+}
+
+static void xxh3_scramble_ref( uint64_t *acc, const uint8_t *secret )
+{
+  for( size_t i = 0; i < XXH3_ACC_NB; ++i )
+  {
+    uint64_t acc64 = acc[i];
+    acc64 = xorshift64( acc64, 47 );
+    acc64 ^= readLE64( secret + ( 8 * i ) );
+    acc64 *= PRIME32_1;
+    acc[i] = acc64;
+  }
+}
+
+#if defined(XXH3_HAVE_X86)
+
+/* the SIMD kernels assume a little-endian host, which is implied by x86 */
+
+XXH3_TARGET("sse2")
+static void xxh3_accumulate_sse2( uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t nbStripes )
+{
+  __m128i xacc[4];
+  for( size_t i = 0; i < 4; ++i )
+  {
+    xacc[i] = _mm_loadu_si128( ( const __m128i * )( acc + ( 2 * i ) ) );
+  }
+  for( size_t n = 0; n < nbStripes; ++n, input += XXH3_STRIPE_LEN, secret += XXH3_SECRET_CONSUME_RATE )
+  {
+    for( size_t i = 0; i < 4; ++i )
+    {
+      const __m128i data_vec    = _mm_loadu_si128( ( const __m128i * )( input + ( 16 * i ) ) );
+      const __m128i key_vec     = _mm_loadu_si128( ( const __m128i * )( secret + ( 16 * i ) ) );
+      const __m128i data_key    = _mm_xor_si128( data_vec, key_vec );
+      const __m128i data_key_lo = _mm_shuffle_epi32( data_key, _MM_SHUFFLE( 0, 3, 0, 1 ) );
+      const __m128i product     = _mm_mul_epu32( data_key, data_key_lo );
+      const __m128i data_swap   = _mm_shuffle_epi32( data_vec, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+      xacc[i] = _mm_add_epi64( product, _mm_add_epi64( xacc[i], data_swap ) );
+    }
+  }
+  for( size_t i = 0; i < 4; ++i )
+  {
+    _mm_storeu_si128( ( __m128i * )( acc + ( 2 * i ) ), xacc[i] );
+  }
+}
+
+XXH3_TARGET("sse2")
+static void xxh3_scramble_sse2( uint64_t *acc, const uint8_t *secret )
+{
+  const __m128i prime32 = _mm_set1_epi32( ( int )PRIME32_1 );
+  for( size_t i = 0; i < 4; ++i )
+  {
+    const __m128i acc_vec     = _mm_loadu_si128( ( const __m128i * )( acc + ( 2 * i ) ) );
+    const __m128i data_vec    = _mm_xor_si128( acc_vec, _mm_srli_epi64( acc_vec, 47 ) );
+    const __m128i key_vec     = _mm_loadu_si128( ( const __m128i * )( secret + ( 16 * i ) ) );
+    const __m128i data_key    = _mm_xor_si128( data_vec, key_vec );
+    const __m128i data_key_hi = _mm_shuffle_epi32( data_key, _MM_SHUFFLE( 0, 3, 0, 1 ) );
+    const __m128i prod_lo     = _mm_mul_epu32( data_key, prime32 );
+    const __m128i prod_hi     = _mm_mul_epu32( data_key_hi, prime32 );
+    _mm_storeu_si128( ( __m128i * )( acc + ( 2 * i ) ), _mm_add_epi64( prod_lo, _mm_slli_epi64( prod_hi, 32 ) ) );
+  }
+}
+
+XXH3_TARGET("avx2")
+static void xxh3_accumulate_avx2( uint64_t *acc, const uint8_t *input, const uint8_t *secret, size_t nbStripes )
+{
+  __m256i xacc[2];
+  for( size_t i = 0; i < 2; ++i )
+  {
+    xacc[i] = _mm256_loadu_si256( ( const __m256i * )( acc + ( 4 * i ) ) );
+  }
+  for( size_t n = 0; n < nbStripes; ++n, input += XXH3_STRIPE_LEN, secret += XXH3_SECRET_CONSUME_RATE )
+  {
+    for( size_t i = 0; i < 2; ++i )
+    {
+      const __m256i data_vec    = _mm256_loadu_si256( ( const __m256i * )( input + ( 32 * i ) ) );
+      const __m256i key_vec     = _mm256_loadu_si256( ( const __m256i * )( secret + ( 32 * i ) ) );
+      const __m256i data_key    = _mm256_xor_si256( data_vec, key_vec );
+      const __m256i data_key_lo = _mm256_shuffle_epi32( data_key, _MM_SHUFFLE( 0, 3, 0, 1 ) );
+      const __m256i product     = _mm256_mul_epu32( data_key, data_key_lo );
+      const __m256i data_swap   = _mm256_shuffle_epi32( data_vec, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+      xacc[i] = _mm256_add_epi64( product, _mm256_add_epi64( xacc[i], data_swap ) );
+    }
+  }
+  for( size_t i = 0; i < 2; ++i )
+  {
+    _mm256_storeu_si256( ( __m256i * )( acc + ( 4 * i ) ), xacc[i] );
+  }
+}
+
+XXH3_TARGET("avx2")
+static void xxh3_scramble_avx2( uint64_t *acc, const uint8_t *secret )
+{
+  const __m256i prime32 = _mm256_set1_epi32( ( int )PRIME32_1 );
+  for( size_t i = 0; i < 2; ++i )
+  {
+    const __m256i acc_vec     = _mm256_loadu_si256( ( const __m256i * )( acc + ( 4 * i ) ) );
+    const __m256i data_vec    = _mm256_xor_si256( acc_vec, _mm256_srli_epi64( acc_vec, 47 ) );
+    const __m256i key_vec     = _mm256_loadu_si256( ( const __m256i * )( secret + ( 32 * i ) ) );
+    const __m256i data_key    = _mm256_xor_si256( data_vec, key_vec );
+    const __m256i data_key_hi = _mm256_shuffle_epi32( data_key, _MM_SHUFFLE( 0, 3, 0, 1 ) );
+    const __m256i prod_lo     = _mm256_mul_epu32( data_key, prime32 );
+    const __m256i prod_hi     = _mm256_mul_epu32( data_key_hi, prime32 );
+    _mm256_storeu_si256( ( __m256i * )( acc + ( 4 * i ) ), _mm256_add_epi64( prod_lo, _mm256_slli_epi64( prod_hi, 32 ) ) );
+  }
+}
+
+#endif //XXH3_HAVE_X86
+
+static xxh3_accumulate_fn g_xxh3_accumulate = xxh3_accumulate_ref;
+static xxh3_scramble_fn g_xxh3_scramble = xxh3_scramble_ref;
+static xxh3_impl g_xxh3_impl = XXH3_IMPL_REF;
+
+/* must be called before any other thread starts hashing, the CPU support is *not* verified here */
+int MUtils::Hash::Internal::XXH3Impl::xxh3_select_impl( const xxh3_impl impl )
+{
+  switch( impl )
+  {
+  case XXH3_IMPL_REF:
+    g_xxh3_accumulate = xxh3_accumulate_ref;
+    g_xxh3_scramble = xxh3_scramble_ref;
+    break;
+#if defined(XXH3_HAVE_X86)
+  case XXH3_IMPL_SSE2:
+    g_xxh3_accumulate = xxh3_accumulate_sse2;
+    g_xxh3_scramble = xxh3_scramble_sse2;
+    break;
+  case XXH3_IMPL_AVX2:
+    g_xxh3_accumulate = xxh3_accumulate_avx2;
+    g_xxh3_scramble = xxh3_scramble_avx2;
+    break;
+#endif
+  default:
+    return -1;
+  }
+
+  g_xxh3_impl = impl;
+  return 0;
+}
+
+MUtils::Hash::Internal::XXH3Impl::xxh3_impl MUtils::Hash::Internal::XXH3Impl::xxh3_current_impl( void )
+{
+  return g_xxh3_impl;
+}
+
+/* consumes "nbStripes" full stripes, scrambling the accumulators at the end of each block */
+static void xxh3_consume_stripes( uint64_t *acc, uint32_t *stripesSoFar, const uint8_t *input, size_t nbStripes, const uint8_t *secret )
+{
+  while( nbStripes > 0 )
+  {
+    const size_t stripesToEnd = XXH3_STRIPES_PER_BLOCK - *stripesSoFar;
+    const size_t n = ( nbStripes < stripesToEnd ) ? nbStripes : stripesToEnd;
+    g_xxh3_accumulate( acc, input, secret + ( *stripesSoFar * XXH3_SECRET_CONSUME_RATE ), n );
+    input += n * XXH3_STRIPE_LEN;
+    nbStripes -= n;
+    if( ( *stripesSoFar += ( uint32_t )n ) >= XXH3_STRIPES_PER_BLOCK )
+    {
+      g_xxh3_scramble( acc, secret + XXH3_SECRET_LIMIT );
+      *stripesSoFar = 0;
+    }
+  }
+}
+
+static uint64_t xxh3_merge_accs( const uint64_t *acc, const uint8_t *secret, uint64_t start )
+{
+  uint64_t result64 = start;
+  for( size_t i = 0; i < 4; ++i )
+  {
+    result64 += mul128_fold64( acc[2 * i] ^ readLE64( secret + ( 16 * i ) ), acc[( 2 * i ) + 1] ^ readLE64( secret + ( 16 * i ) + 8 ) );
+  }
+  return xxh3_avalanche( result64 );
+}
+
+/*------------------------------------*/
+/* streaming API */
+/*------------------------------------*/
+
+void MUtils::Hash::Internal::XXH3Impl::xxh3_reset( xxh3_state *S, const uint64_t seed )
+{
+  memcpy( S->acc, kInitAcc, sizeof( S->acc ) );
+  if( seed )
+  {
+    for( size_t i = 0; i < XXH3_SECRET_SIZE; i += 16 )
+    {
+      writeLE64( S->secret + i, readLE64( kSecret + i ) + seed );
+      writeLE64( S->secret + i + 8, readLE64( kSecret + i + 8 ) - seed );
+    }
+  }
+  else
+  {
+    memcpy( S->secret, kSecret, XXH3_SECRET_SIZE );
+  }
+  S->buffered = 0;
+  S->stripes_so_far = 0;
+  S->total_len = 0;
+  S->seed = seed;
+}
+
+void MUtils::Hash::Internal::XXH3Impl::xxh3_update( xxh3_state *S, const uint8_t *in, size_t inlen )
+{
+  S->total_len += inlen;
+
+  /* fill in tmp buffer, at least one byte always remains buffered for the final stripe */
+  if( ( size_t )S->buffered + inlen <= XXH3_BUFFER_SIZE )
+  {
+    memcpy( S->buffer + S->buffered, in, inlen );
+    S->buffered += ( uint32_t )inlen;
+    return;
+  }
+
+  if( S->buffered )
+  {
+    const size_t loadSize = XXH3_BUFFER_SIZE - S->buffered;
+    memcpy( S->buffer + S->buffered, in, loadSize );
+    in += loadSize;
+    inlen -= loadSize;
+    xxh3_consume_stripes( S->acc, &S->stripes_so_far, S->buffer, XXH3_BUFFER_SIZE / XXH3_STRIPE_LEN, S->secret );
+    S->buffered = 0;
+  }
+
+  /* consume the bulk directly from the input, the last consumed stripe is kept for digest's catch-up */
+  if( inlen > XXH3_BUFFER_SIZE )
+  {
+    const size_t nbStripes = ( inlen - 1 ) / XXH3_STRIPE_LEN;
+    xxh3_consume_stripes( S->acc, &S->stripes_so_far, in, nbStripes, S->secret );
+    in += nbStripes * XXH3_STRIPE_LEN;
+    inlen -= nbStripes * XXH3_STRIPE_LEN;
+    memcpy( S->buffer + XXH3_BUFFER_SIZE - XXH3_STRIPE_LEN, in - XXH3_STRIPE_LEN, XXH3_STRIPE_LEN );
+  }
+
+  memcpy( S->buffer, in, inlen );
+  S->buffered = ( uint32_t )inlen;
+}
+
+static void xxh3_digest_long( const xxh3_state *S, uint64_t *acc )
+{
+  memcpy( acc, S->acc, sizeof( S->acc ) );
+  if( S->buffered >= XXH3_STRIPE_LEN )
+  {
+    uint32_t stripesSoFar = S->stripes_so_far;
+    xxh3_consume_stripes( acc, &stripesSoFar, S->buffer, ( S->buffered - 1 ) / XXH3_STRIPE_LEN, S->secret );
+    g_xxh3_accumulate( acc, S->buffer + S->buffered - XXH3_STRIPE_LEN, S->secret + XXH3_SECRET_LIMIT - XXH3_SECRET_LASTACC_START, 1 );
+  }
+  else
+  {
+    uint8_t lastStripe[XXH3_STRIPE_LEN];
+    const size_t catchupSize = XXH3_STRIPE_LEN - S->buffered;
+    memcpy( lastStripe, S->buffer + XXH3_BUFFER_SIZE - catchupSize, catchupSize );
+    memcpy( lastStripe + catchupSize, S->buffer, S->buffered );
+    g_xxh3_accumulate( acc, lastStripe, S->secret + XXH3_SECRET_LIMIT - XXH3_SECRET_LASTACC_START, 1 );
+  }
+}
+
+uint64_t MUtils::Hash::Internal::XXH3Impl::xxh3_digest_64( const xxh3_state *S )
+{
+  if( S->total_len > XXH3_MIDSIZE_MAX )
+  {
+    uint64_t acc[XXH3_ACC_NB];
+    xxh3_digest_long( S, acc );
+    return xxh3_merge_accs( acc, S->secret + XXH3_SECRET_MERGEACCS_START, S->total_len * PRIME64_1 );
+  }
+  return xxh3_short_64( S->buffer, ( size_t )S->total_len, S->seed );
+}
+
+xxh3_128_t MUtils::Hash::Internal::XXH3Impl::xxh3_digest_128( const xxh3_state *S )
+{
+  if( S->total_len > XXH3_MIDSIZE_MAX )
+  {
+    uint64_t acc[XXH3_ACC_NB];
+    xxh3_digest_long( S, acc );
+    xxh3_128_t h128;
+    h128.low64  = xxh3_merge_accs( acc, S->secret + XXH3_SECRET_MERGEACCS_START, S->total_len * PRIME64_1 );
+    h128.high64 = xxh3_merge_accs( acc, S->secret + XXH3_SECRET_SIZE - XXH3_STRIPE_LEN - XXH3_SECRET_MERGEACCS_START, ~( S->total_len * PRIME64_2 ) );
+    return h128;
+  }
+  return xxh3_short_128( S->buffer, ( size_t )S->total_len, S->seed );
+}
+
+uint64_t MUtils::Hash::Internal::XXH3Impl::xxh3_64( const void *in, const size_t inlen, const uint64_t seed )
+{
+  if( inlen <= XXH3_MIDSIZE_MAX )
+  {
+    return xxh3_short_64( ( const uint8_t * )in, inlen, seed );
+  }
+  xxh3_state state;
+  xxh3_reset( &state, seed );
+  xxh3_update( &state, ( const uint8_t * )in, inlen );
+  return xxh3_digest_64( &state );
+}
@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//Linux API
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE 1
+#endif
+#include <sched.h>
+#include <unistd.h>
+
+//ASM
+#if defined(__i386__) || defined(__x86_64__)
+#include <cpuid.h>
+#define MUTILS_CPUID_X86 1
+#endif
+
+//MUtils
+#include <MUtils/CPUFeatures.h>
+
+//CRT
+#include <string.h>
+#include <strings.h>
+
+#ifdef MUTILS_CPUID_X86
+
+#define MY_CPUID(X,Y) __cpuid_count(((uint32_t)(Y)), 0U, (X)[0], (X)[1], (X)[2], (X)[3])
+#define CHECK_VENDOR(X,Y,Z) (strcasecmp((X), (Y)) ? 0U : (Z));
+#define CHECK_FLAG(X,Y,Z) (((X) & (Y)) ? (Z) : 0U)
+
+static inline quint64 my_xgetbv(const quint32 index)
+{
+	quint32 eax, edx;
+	__asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(index));
+	return (quint64(edx) << 32) | quint64(eax);
+}
+
+#endif //MUTILS_CPUID_X86
+
+MUtils::CPUFetaures::cpu_info_t MUtils::CPUFetaures::detect(void)
+{
+	cpu_info_t features;
+
+	//Initialize variables to zero
+	memset(&features, 0, sizeof(cpu_info_t));
+
+#ifdef MUTILS_CPUID_X86
+	static const quint32 FLAGS_X64 = (FLAG_MMX | FLAG_SSE | FLAG_SSE2);
+
+	uint32_t cpuInfo[4];
+	memset(&cpuInfo[0], 0, sizeof(cpuInfo));
+
+	//Detect the CPU identifier string
+	MY_CPUID(&cpuInfo[0], 0);
+	const uint32_t max_basic_cap = cpuInfo[0];
+	memcpy(&features.idstr[0U * sizeof(uint32_t)], &cpuInfo[1], sizeof(uint32_t));
+	memcpy(&features.idstr[1U * sizeof(uint32_t)], &cpuInfo[3], sizeof(uint32_t));
+	memcpy(&features.idstr[2U * sizeof(uint32_t)], &cpuInfo[2], sizeof(uint32_t));
+	features.idstr[3U * sizeof(uint32_t)] = '\0';
+	features.vendor |= CHECK_VENDOR(features.idstr, "GenuineIntel", VENDOR_INTEL);
+	features.vendor |= CHECK_VENDOR(features.idstr, "AuthenticAMD", VENDOR_AMD);
+
+	//Detect the CPU model and feature flags
+	if(max_basic_cap >= 1)
+	{
+		MY_CPUID(&cpuInfo[0], 1);
+		features.features |= CHECK_FLAG(cpuInfo[3], 0x00008000, FLAG_CMOV);
+		features.features |= CHECK_FLAG(cpuInfo[3], 0x00800000, FLAG_MMX);
+		features.features |= CHECK_FLAG(cpuInfo[3], 0x02000000, FLAG_SSE);
+		features.features |= CHECK_FLAG(cpuInfo[3], 0x04000000, FLAG_SSE2);
+		features.features |= CHECK_FLAG(cpuInfo[2], 0x00000001, FLAG_SSE3);
+		features.features |= CHECK_FLAG(cpuInfo[2], 0x00000200, FLAG_SSSE3);
+		features.features |= CHECK_FLAG(cpuInfo[2], 0x00080000, FLAG_SSE41);
+		features.features |= CHECK_FLAG(cpuInfo[2], 0x00100000, FLAG_SSE42);
+
+		//Check for AVX
+		if ((cpuInfo[2] & 0x18000000) == 0x18000000)
+		{
+			if((my_xgetbv(0) & 0x6ULL) == 0x6ULL) /*AVX requires OS support!*/
+			{
+				features.features |= FLAG_AVX;
+				features.features |= CHECK_FLAG(cpuInfo[2], 0x00001000, FLAG_FMA3);
+			}
+		}
+
+		//Compute the CPU stepping, model and family
+		features.stepping = cpuInfo[0] & 0xf;
+		features.model    = ((cpuInfo[0] >> 4) & 0xf) + (((cpuInfo[0] >> 16) & 0xf) << 4);
+		features.family   = ((cpuInfo[0] >> 8) & 0xf) + ((cpuInfo[0] >> 20) & 0xff);
+	}
+
+	//Detect extended feature flags
+	if (max_basic_cap >= 7)
+	{
+		MY_CPUID(&cpuInfo[0], 7);
+		if (features.features & FLAG_AVX)
+		{
+			features.features |= CHECK_FLAG(cpuInfo[1], 0x00000020, FLAG_AVX2);
+			if((my_xgetbv(0) & 0xE6ULL) == 0xE6ULL) /*AVX-512 requires OS support!*/
+			{
+				features.features |= CHECK_FLAG(cpuInfo[1], 0x00010000, FLAG_AVX512F);
+			}
+		}
+	}
+
+	//Read the CPU "brand" string
+	if (max_basic_cap > 0)
+	{
+		MY_CPUID(&cpuInfo[0], 0x80000000);
+		const uint32_t max_extended_cap = qBound(0x80000000U, cpuInfo[0], 0x80000004U);
+		if (max_extended_cap >= 0x80000001)
+		{
+			MY_CPUID(&cpuInfo[0], 0x80000001);
+			features.features |= CHECK_FLAG(cpuInfo[2], 0x00000020, FLAG_LZCNT);
+			for (uint32_t i = 0x80000002; i <= max_extended_cap; ++i)
+			{
+				MY_CPUID(&cpuInfo[0], i);
+				memcpy(&features.brand[(i - 0x80000002) * sizeof(cpuInfo)], &cpuInfo[0], sizeof(cpuInfo));
+			}
+			features.brand[sizeof(features.brand) - 1] = '\0';
+		}
+	}
+
+	//Detect 64-Bit processors
+#if defined(__x86_64__)
+	features.x64 = true;
+	features.features |= FLAGS_X64; /*x86_64 implies SSE2*/
+#endif
+
+	//Make sure that (at least) the MMX flag has been set!
+	if (!(features.features & FLAG_MMX))
+	{
+		qWarning("Warning: CPU does not seem to support MMX. Take care!\n");
+		features.features = 0;
+	}
+#else
+	//Non-x86 processors (e.g. aarch64): No vendor, model or feature flags are reported, so the portable code paths will be used
+#endif //MUTILS_CPUID_X86
+
+	//Count the number of available(!) CPU cores
+	cpu_set_t procAffinity;
+	CPU_ZERO(&procAffinity);
+	if(sched_getaffinity(0, sizeof(cpu_set_t), &procAffinity) == 0)
+	{
+		features.count = CPU_COUNT(&procAffinity);
+	}
+	if(features.count < 1)
+	{
+		const long cpuCount = sysconf(_SC_NPROCESSORS_ONLN);
+		features.count = qBound(1L, cpuCount, 64L);
+	}
+
+	return features;
+}
@@ -96,6 +96,10 @@ MUtils::CPUFetaures::cpu_info_t MUtils::CPUFetaures::detect(void)
 		if (features.features & FLAG_AVX)
 		{
 			features.features |= CHECK_FLAG(cpuInfo[1], 0x00000020, FLAG_AVX2);
+			if((_xgetbv(0) & 0xE6ui64) == 0xE6ui64) /*AVX-512 requires OS support!*/
+			{
+				features.features |= CHECK_FLAG(cpuInfo[1], 0x00010000, FLAG_AVX512F);
+			}
 		}
 	}
 
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Minimal replacement for the parts of Global.cpp that are required by the portable (CMake) build
+ * of the Hash subsystem on Linux. The full Global.cpp depends on the Win32 API and is not used there.
+ */
+
+//Linux API
+#include <unistd.h>
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+
+//CRT
+#include <cstdio>
+#include <cstdlib>
+
+///////////////////////////////////////////////////////////////////////////////
+// TEMP FOLDER
+///////////////////////////////////////////////////////////////////////////////
+
+static QString g_temp_folder;
+static QMutex  g_temp_folder_lock;
+
+static bool remove_directory_helper(const QString &path)
+{
+	QDir directory(path);
+	const QFileInfoList entries = directory.entryInfoList(QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot);
+	for (QFileInfoList::ConstIterator iter = entries.constBegin(); iter != entries.constEnd(); ++iter)
+	{
+		if (iter->isDir() && (!iter->isSymLink()))
+		{
+			remove_directory_helper(iter->absoluteFilePath());
+		}
+		else
+		{
+			QFile::remove(iter->absoluteFilePath());
+		}
+	}
+	return directory.rmdir(path);
+}
+
+static void temp_folder_cleaup(void)
+{
+	QMutexLocker lock(&g_temp_folder_lock);
+	if (!g_temp_folder.isEmpty())
+	{
+		if (!remove_directory_helper(g_temp_folder))
+		{
+			fprintf(stderr, "Warning: Not all temporary files could be removed!\n");
+		}
+		g_temp_folder.clear();
+	}
+}
+
+const QString &MUtils::temp_folder(void)
+{
+	QMutexLocker lock(&g_temp_folder_lock);
+	if (g_temp_folder.isEmpty())
+	{
+		QDir baseDir(QDir::tempPath());
+		for (int i = 0; i < 32; i++)
+		{
+			const QString postfix = QString("mutils_%1_%2").arg(quint64(getpid())).arg(quint64(next_rand_u32()), 8, 16, QLatin1Char('0'));
+			if ((!baseDir.exists(postfix)) && baseDir.mkdir(postfix))
+			{
+				g_temp_folder = QFileInfo(baseDir.absoluteFilePath(postfix)).canonicalFilePath();
+				atexit(temp_folder_cleaup);
+				break;
+			}
+		}
+	}
+	return g_temp_folder;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// RANDOM
+///////////////////////////////////////////////////////////////////////////////
+
+quint32 MUtils::next_rand_u32(void)
+{
+	quint32 rnd = 0;
+	FILE *const urandom = fopen("/dev/urandom", "rb");
+	if (urandom)
+	{
+		if (fread(&rnd, sizeof(quint32), 1, urandom) != 1)
+		{
+			rnd = 0;
+		}
+		fclose(urandom);
+	}
+	return rnd ? rnd : (quint32(rand()) ^ (quint32(getpid()) << 16));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZER
+///////////////////////////////////////////////////////////////////////////////
+
+unsigned int MUtils::Internal::MUTILS_INITIALIZER(const unsigned int interfaceId)
+{
+	if(interfaceId != ((unsigned int)MUTILS_INTERFACE))
+	{
+		fprintf(stderr, "ERROR: MUtils library initialization has failed!\n");
+		for(;;) _exit(1);
+	}
+
+	volatile unsigned int _result = MUTILS_INTERFACE;
+	return _result;
+}
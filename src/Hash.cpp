@@ -26,24 +26,249 @@
 //Hash Functions
 #include "Hash_Keccak.h"
 #include "Hash_Blake2.h"
+#include "Hash_Blake3.h"
+#include "Hash_Fast.h"
+
+//Qt
+#include <QScopedPointer>
+#include <QThread>
+#include <QSemaphore>
+#include <QMutex>
+
+//CRT
+#include <limits>
 
 // ==========================================================================
 // Abstract Hash Class
 // ==========================================================================
 
+QByteArray MUtils::Hash::Hash::finalize(void)
+{
+	quint8 buffer[DIGEST_MAX_SIZE];
+	const size_t length = finalize_into(buffer, DIGEST_MAX_SIZE);
+	return QByteArray((const char*)buffer, int(length));
+}
+
+size_t MUtils::Hash::Hash::finalize_hex_into(char *const out, const size_t len)
+{
+	quint8 buffer[DIGEST_MAX_SIZE];
+	const size_t length = finalize_into(buffer, DIGEST_MAX_SIZE);
+	return to_hex_into(buffer, length, out, len);
+}
+
+QByteArray MUtils::Hash::Hash::finalize_xof(const quint32 length)
+{
+	QByteArray result(int(length), '\0');
+	finalize_xof_into((quint8*)result.data(), length);
+	return result;
+}
+
+void MUtils::Hash::Hash::finalize_xof_into(quint8 *const /*out*/, const size_t /*len*/)
+{
+	MUTILS_THROW("Hash algorithm does not support variable-length output!");
+}
+
+QByteArray MUtils::Hash::Hash::serialize(void) const
+{
+	MUTILS_THROW("Hash algorithm does not support state serialization!");
+}
+
+bool MUtils::Hash::Hash::deserialize(const QByteArray& /*state*/)
+{
+	MUTILS_THROW("Hash algorithm does not support state serialization!");
+}
+
+static const qint64 FILE_MAP_WINDOW  = 33554432; //32 MiB
+static const qint64 FILE_BUFFER_SIZE = 4194304;  // 4 MiB
+
 bool MUtils::Hash::Hash::update(QFile &file)
 {
-	while (!file.atEnd())
+	return update(file, file.pos());
+}
+
+bool MUtils::Hash::Hash::update(QFile &file, const qint64 offset, const qint64 length)
+{
+	if ((offset < 0) || (offset != file.pos()))
+	{
+		if (file.isSequential() || (offset < 0) || (!file.seek(offset)))
+		{
+			qWarning("Failed to seek to the requested file offset!");
+			return false;
+		}
+	}
+
+	qint64 remaining = (length >= 0) ? length : std::numeric_limits<qint64>::max();
+
+	//Regular files are memory-mapped window by window, so the pages are fed into process() without an intermediate copy
+	if (!file.isSequential())
+	{
+		const qint64 fileEnd = offset + qMin(qMax(file.size() - offset, qint64(0)), remaining);
+		qint64 position = offset;
+		while (position < fileEnd)
+		{
+			const qint64 chunkSize = qMin(fileEnd - position, FILE_MAP_WINDOW);
+			uchar *const view = file.map(position, chunkSize);
+			if (!view)
+			{
+				break; /*mapping not supported, fall back to buffered I/O*/
+			}
+			const bool success = process(view, quint32(chunkSize));
+			file.unmap(view);
+			if (!success)
+			{
+				return false;
+			}
+			position += chunkSize;
+		}
+		if (!file.seek(position))
+		{
+			return false;
+		}
+		remaining -= (position - offset);
+		if (position >= fileEnd)
+		{
+			return true;
+		}
+	}
+
+	//Pipes, sockets and files that can not be mapped are read into a single re-used buffer
+	QScopedArrayPointer<quint8> buffer(new quint8[FILE_BUFFER_SIZE]);
+	while ((remaining > 0) && (!file.atEnd()))
 	{
-		const QByteArray data = file.read(4194304i64);
-		if (data.isEmpty() || (!update(data)))
+		const qint64 chunkSize = file.read(reinterpret_cast<char*>(buffer.data()), qMin(remaining, FILE_BUFFER_SIZE));
+		if ((chunkSize <= 0) || (!process(buffer.data(), quint32(chunkSize))))
 		{
 			return false;
 		}
+		remaining -= chunkSize;
 	}
 	return true;
 }
 
+// ==========================================================================
+// Asynchronous Read-Ahead
+// ==========================================================================
+
+namespace
+{
+	class ReadAheadThread : public QThread
+	{
+	public:
+		ReadAheadThread(QFile &file, const quint32 bufferSize, const quint32 queueDepth)
+		:
+			m_file(file),
+			m_bufferSize(bufferSize),
+			m_queueDepth(queueDepth),
+			m_storage(new quint8[size_t(bufferSize) * queueDepth]),
+			m_length(new qint64[queueDepth]),
+			m_free(int(queueDepth))
+		{
+		}
+
+		~ReadAheadThread(void)
+		{
+			abort();
+			wait();
+		}
+
+		//Consumer side: blocks until buffer #index has been filled; returns its length, 0 on EOF or -1 on error
+		qint64 acquire(const quint32 index, const quint8 *&data)
+		{
+			m_used.acquire();
+			data = m_storage.data() + (size_t(index) * m_bufferSize);
+			return m_length[index];
+		}
+
+		//Consumer side: hands buffer #index back to the reader
+		void release(void)
+		{
+			m_free.release();
+		}
+
+		void abort(void)
+		{
+			if (m_abort.testAndSetOrdered(0, 1))
+			{
+				m_free.release(int(m_queueDepth)); /*wake up the reader, if it is waiting for a free buffer*/
+			}
+		}
+
+	protected:
+		virtual void run(void)
+		{
+			for (quint32 index = 0; ; index = (index + 1) % m_queueDepth)
+			{
+				m_free.acquire();
+				if (m_abort)
+				{
+					return;
+				}
+				qint64 length = 0;
+				if (!m_file.atEnd())
+				{
+					length = m_file.read(reinterpret_cast<char*>(m_storage.data() + (size_t(index) * m_bufferSize)), m_bufferSize);
+					if (length <= 0)
+					{
+						length = -1;
+					}
+				}
+				m_length[index] = length;
+				m_used.release();
+				if (length <= 0)
+				{
+					return;
+				}
+			}
+		}
+
+	private:
+		QFile &m_file;
+		const quint32 m_bufferSize;
+		const quint32 m_queueDepth;
+		QScopedArrayPointer<quint8> m_storage;
+		QScopedArrayPointer<qint64> m_length;
+		QSemaphore m_free, m_used;
+		QAtomicInt m_abort;
+	};
+}
+
+bool MUtils::Hash::Hash::update_stream(QFile &file, const quint32 bufferSize, const quint32 queueDepth, const progress_callback_t callback, void *const userData)
+{
+	const quint32 length = qBound(4096U, bufferSize, 268435456U);
+	const quint32 depth  = qBound(2U, queueDepth, qMax(2U, 1073741824U / length)); /*at most 1 GiB in total*/
+
+	const qint64 total = file.isSequential() ? 0 : qMax(file.size() - file.pos(), qint64(0));
+	qint64 done = 0;
+
+	ReadAheadThread reader(file, length, depth);
+	reader.start();
+
+	for (quint32 index = 0; ; index = (index + 1) % depth)
+	{
+		const quint8 *data = NULL;
+		const qint64 chunkSize = reader.acquire(index, data);
+		if (chunkSize <= 0)
+		{
+			return (chunkSize == 0);
+		}
+		if (!process(data, quint32(chunkSize)))
+		{
+			return false;
+		}
+		reader.release();
+		done += chunkSize;
+		if (callback)
+		{
+			const double progress = (total > 0) ? qBound(0.0, double(done) / double(total), 1.0) : 0.0;
+			if (!callback(progress, userData))
+			{
+				qWarning("Hash computation was aborted by user!");
+				return false;
+			}
+		}
+	}
+}
+
 // ==========================================================================
 // Hash Factory
 // ==========================================================================
@@ -60,9 +285,224 @@ MUtils::Hash::Hash *MUtils::Hash::create(const quint16 &hashId, const char *cons
 		return Keccak::create(Keccak::hb384, key);
 	case HASH_KECCAK_512:
 		return Keccak::create(Keccak::hb512, key);
+	case HASH_SHA3_224:
+		return new SHA3(SHA3::sha3_224, key);
+	case HASH_SHA3_256:
+		return new SHA3(SHA3::sha3_256, key);
+	case HASH_SHA3_384:
+		return new SHA3(SHA3::sha3_384, key);
+	case HASH_SHA3_512:
+		return new SHA3(SHA3::sha3_512, key);
+	case HASH_SHAKE_128:
+		return new SHA3(SHA3::shake128, key);
+	case HASH_SHAKE_256:
+		return new SHA3(SHA3::shake256, key);
 	case HASH_BLAKE2_512:
 		return new Blake2(key);
+	case HASH_BLAKE2BP_512:
+		return new Blake2bp(key);
+	case HASH_BLAKE2SP_256:
+		return new Blake2sp(key);
+	case HASH_BLAKE3:
+		return new Blake3(key, Blake3::hash);
+	case HASH_BLAKE3_DERIVE_KEY:
+		return new Blake3(key, Blake3::derive_key);
+	case HASH_XXH3_64:
+		return new XXH3(XXH3::hb64, key);
+	case HASH_XXH3_128:
+		return new XXH3(XXH3::hb128, key);
+	case HASH_CRC32C:
+		return new CRC32C(key);
 	default:
 		MUTILS_THROW_FMT("Hash algorithm 0x%02X is unknown!", quint32(hashId));
 	}
 }
+
+MUtils::Hash::Hash *MUtils::Hash::create(const quint16 &hashId, const QByteArray &key)
+{
+	switch (hashId)
+	{
+	case HASH_BLAKE3:
+		return new Blake3((const quint8*)key.constData(), size_t(key.size()), Blake3::hash);
+	case HASH_BLAKE3_DERIVE_KEY:
+		return new Blake3((const quint8*)key.constData(), size_t(key.size()), Blake3::derive_key);
+	default:
+		if (key.contains('\0'))
+		{
+			MUTILS_THROW_FMT("Hash algorithm 0x%02X does not support keys with NULL characters!", quint32(hashId));
+		}
+		return create(hashId, key.isEmpty() ? NULL : key.constData());
+	}
+}
+
+size_t MUtils::Hash::digest_size(const quint16 &hashId)
+{
+	switch (hashId)
+	{
+	case HASH_KECCAK_224:
+	case HASH_SHA3_224:
+		return 28U;
+	case HASH_KECCAK_256:
+	case HASH_SHA3_256:
+	case HASH_SHAKE_128:
+	case HASH_BLAKE2SP_256:
+	case HASH_BLAKE3:
+	case HASH_BLAKE3_DERIVE_KEY:
+		return 32U;
+	case HASH_KECCAK_384:
+	case HASH_SHA3_384:
+		return 48U;
+	case HASH_KECCAK_512:
+	case HASH_SHA3_512:
+	case HASH_SHAKE_256:
+	case HASH_BLAKE2_512:
+	case HASH_BLAKE2BP_512:
+		return 64U;
+	case HASH_XXH3_64:
+		return 8U;
+	case HASH_XXH3_128:
+		return 16U;
+	case HASH_CRC32C:
+		return 4U;
+	default:
+		MUTILS_THROW_FMT("Hash algorithm 0x%02X is unknown!", quint32(hashId));
+	}
+}
+
+size_t MUtils::Hash::compute(const quint16 &hashId, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen, const char *const key)
+{
+	switch (hashId)
+	{
+	case HASH_KECCAK_224:
+		return Keccak::compute(Keccak::hb224, key, data, len, out, outLen);
+	case HASH_KECCAK_256:
+		return Keccak::compute(Keccak::hb256, key, data, len, out, outLen);
+	case HASH_KECCAK_384:
+		return Keccak::compute(Keccak::hb384, key, data, len, out, outLen);
+	case HASH_KECCAK_512:
+		return Keccak::compute(Keccak::hb512, key, data, len, out, outLen);
+	case HASH_SHA3_224:
+		return SHA3::compute(SHA3::sha3_224, key, data, len, out, outLen);
+	case HASH_SHA3_256:
+		return SHA3::compute(SHA3::sha3_256, key, data, len, out, outLen);
+	case HASH_SHA3_384:
+		return SHA3::compute(SHA3::sha3_384, key, data, len, out, outLen);
+	case HASH_SHA3_512:
+		return SHA3::compute(SHA3::sha3_512, key, data, len, out, outLen);
+	case HASH_SHAKE_128:
+		return SHA3::compute(SHA3::shake128, key, data, len, out, outLen);
+	case HASH_SHAKE_256:
+		return SHA3::compute(SHA3::shake256, key, data, len, out, outLen);
+	case HASH_BLAKE2_512:
+		return Blake2::compute(key, data, len, out, outLen);
+	case HASH_BLAKE2BP_512:
+		return Blake2bp::compute(key, data, len, out, outLen);
+	case HASH_BLAKE2SP_256:
+		return Blake2sp::compute(key, data, len, out, outLen);
+	case HASH_BLAKE3:
+		return Blake3::compute(Blake3::hash, key, data, len, out, outLen);
+	case HASH_BLAKE3_DERIVE_KEY:
+		return Blake3::compute(Blake3::derive_key, key, data, len, out, outLen);
+	case HASH_XXH3_64:
+		return XXH3::compute(XXH3::hb64, key, data, len, out, outLen);
+	case HASH_XXH3_128:
+		return XXH3::compute(XXH3::hb128, key, data, len, out, outLen);
+	case HASH_CRC32C:
+		return CRC32C::compute(key, data, len, out, outLen);
+	default:
+		MUTILS_THROW_FMT("Hash algorithm 0x%02X is unknown!", quint32(hashId));
+	}
+}
+
+size_t MUtils::Hash::compute(const quint16 &hashId, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen, const QByteArray &key)
+{
+	switch (hashId)
+	{
+	case HASH_BLAKE3:
+		return Blake3::compute(Blake3::hash, (const quint8*)key.constData(), size_t(key.size()), data, len, out, outLen);
+	case HASH_BLAKE3_DERIVE_KEY:
+		return Blake3::compute(Blake3::derive_key, (const quint8*)key.constData(), size_t(key.size()), data, len, out, outLen);
+	default:
+		if (key.contains('\0'))
+		{
+			MUTILS_THROW_FMT("Hash algorithm 0x%02X does not support keys with NULL characters!", quint32(hashId));
+		}
+		return compute(hashId, data, len, out, outLen, key.isEmpty() ? NULL : key.constData());
+	}
+}
+
+// ==========================================================================
+// Hash Pool
+// ==========================================================================
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class HashPool_Private
+		{
+			friend class HashPool;
+
+		protected:
+			quint16 hashId;
+			QByteArray key;
+			bool hasKey;
+			QMutex lock;
+			QList<Hash*> idle;
+		};
+	}
+}
+
+MUtils::Hash::HashPool::HashPool(const quint16 &hashId, const char *const key)
+:
+	p(new HashPool_Private())
+{
+	p->hashId = hashId;
+	p->hasKey = (key != NULL);
+	if(key)
+	{
+		p->key = QByteArray(key);
+	}
+
+	//Fail early, if the hash algorithm identifier is unknown
+	try
+	{
+		release(create(hashId, key));
+	}
+	catch(...)
+	{
+		delete p;
+		throw;
+	}
+}
+
+MUtils::Hash::HashPool::~HashPool(void)
+{
+	while(!p->idle.isEmpty())
+	{
+		delete p->idle.takeLast();
+	}
+	delete p;
+}
+
+MUtils::Hash::Hash *MUtils::Hash::HashPool::acquire(void)
+{
+	{
+		QMutexLocker locker(&p->lock);
+		if(!p->idle.isEmpty())
+		{
+			return p->idle.takeLast();
+		}
+	}
+	return create(p->hashId, p->hasKey ? p->key.constData() : NULL);
+}
+
+void MUtils::Hash::HashPool::release(Hash *const hash)
+{
+	if(hash)
+	{
+		hash->reset();
+		QMutexLocker locker(&p->lock);
+		p->idle.append(hash);
+	}
+}
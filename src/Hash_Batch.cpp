@@ -0,0 +1,306 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Hash.h>
+#include <MUtils/CPUFeatures.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Hash_Keccak.h"
+
+//Qt
+#include <QThread>
+#include <QMutex>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <QList>
+#include <QPair>
+#include <QScopedPointer>
+
+//CRT
+#include <algorithm>
+
+static const qint64 SMALL_FILE_SIZE  =   1048576; //Files up to 1 MiB are grouped into batches
+static const qint64 BATCH_MAX_SIZE   =   4194304; //Maximum accumulated size of one batch
+static const int    BATCH_MAX_FILES  =        64; //Maximum number of files in one batch
+static const qint64 STREAM_FILE_SIZE = 268435456; //Files from 256 MiB are hashed using the read-ahead path
+
+namespace
+{
+	typedef QPair<qint64, int> file_entry_t; //(size, index)
+
+	//A task is a contiguous range of entries (one big file or a batch of small files)
+	typedef struct
+	{
+		int first;
+		int count;
+	}
+	batch_task_t;
+
+	typedef struct
+	{
+		const QStringList *files;
+		const file_entry_t *entries;
+		QByteArray *results;
+		quint16 hashId;
+		bool asHex;
+		const char *key;
+	}
+	batch_context_t;
+
+	class WorkQueue
+	{
+	public:
+		void push(const batch_task_t &task)
+		{
+			QMutexLocker lock(&m_lock);
+			m_tasks.append(task);
+		}
+
+		//The owner takes from the front, where the biggest tasks are
+		bool take(batch_task_t &task)
+		{
+			QMutexLocker lock(&m_lock);
+			if (m_tasks.isEmpty())
+			{
+				return false;
+			}
+			task = m_tasks.takeFirst();
+			return true;
+		}
+
+		//Thieves take from the back, where the smallest tasks are
+		bool steal(batch_task_t &task)
+		{
+			QMutexLocker lock(&m_lock);
+			if (m_tasks.isEmpty())
+			{
+				return false;
+			}
+			task = m_tasks.takeLast();
+			return true;
+		}
+
+	private:
+		QMutex m_lock;
+		QList<batch_task_t> m_tasks;
+	};
+
+	class BatchWorker : public QThread
+	{
+	public:
+		BatchWorker(const batch_context_t &context, WorkQueue *const queues, const int queueCount, const int index)
+		:
+			m_context(context), m_queues(queues), m_queueCount(queueCount), m_index(index)
+		{
+		}
+
+	protected:
+		virtual void run(void)
+		{
+			batch_task_t task;
+			while (nextTask(task))
+			{
+				for (int i = task.first; i < task.first + task.count; ++i)
+				{
+					const int fileIndex = m_context.entries[i].second;
+					m_context.results[fileIndex] = hashFile(m_context.files->at(fileIndex), m_context.entries[i].first);
+				}
+			}
+		}
+
+	private:
+		bool nextTask(batch_task_t &task)
+		{
+			if (m_queues[m_index].take(task))
+			{
+				return true;
+			}
+			for (int i = 1; i < m_queueCount; ++i)
+			{
+				if (m_queues[(m_index + i) % m_queueCount].steal(task))
+				{
+					return true;
+				}
+			}
+			return false;
+		}
+
+		QByteArray hashFile(const QString &fileName, const qint64 fileSize)
+		{
+			try
+			{
+				QFile file(fileName);
+				if (file.open(QIODevice::ReadOnly))
+				{
+					//Each worker re-uses a single instance for all of its files
+					if (m_hash.isNull())
+					{
+						m_hash.reset(MUtils::Hash::create(m_context.hashId, m_context.key));
+					}
+					else
+					{
+						m_hash->reset();
+					}
+					const bool success = (fileSize >= STREAM_FILE_SIZE) ? m_hash->update_stream(file) : m_hash->update(file);
+					if (success)
+					{
+						return m_hash->digest(m_context.asHex);
+					}
+				}
+			}
+			catch (const std::exception &error)
+			{
+				qWarning("Failed to hash file: %s", error.what());
+			}
+			catch (...)
+			{
+				qWarning("Failed to hash file: unknown exception!");
+			}
+			return QByteArray();
+		}
+
+		const batch_context_t &m_context;
+		WorkQueue *const m_queues;
+		const int m_queueCount;
+		const int m_index;
+		QScopedPointer<MUtils::Hash::Hash> m_hash;
+	};
+}
+
+MUtils::Hash::DigestMap MUtils::Hash::hash_files(const QStringList &files, const quint16 &hashId, const quint32 &threads, const bool bAsHex, const char *const key)
+{
+	//Validate the algorithm identifier on the calling thread (throws, if the identifier is unknown)
+	delete create(hashId, key);
+
+	DigestMap digests;
+	if (files.isEmpty())
+	{
+		return digests;
+	}
+
+	//Sort by size, biggest files first, so that the expensive work gets started early
+	QVector<file_entry_t> entries;
+	entries.reserve(files.count());
+	for (int i = 0; i < files.count(); ++i)
+	{
+		entries.append(qMakePair(QFileInfo(files.at(i)).size(), i));
+	}
+	std::stable_sort(entries.begin(), entries.end(), qGreater<file_entry_t>());
+
+	//Create the tasks: one per big file, small files are grouped into batches
+	QList<batch_task_t> tasks;
+	for (int i = 0; i < entries.count(); )
+	{
+		batch_task_t task = { i, 1 };
+		if (entries[i].first <= SMALL_FILE_SIZE)
+		{
+			qint64 batchSize = entries[i].first;
+			while ((i + task.count < entries.count()) && (task.count < BATCH_MAX_FILES) && (batchSize + entries[i + task.count].first <= BATCH_MAX_SIZE))
+			{
+				batchSize += entries[i + task.count].first;
+				task.count++;
+			}
+		}
+		tasks.append(task);
+		i += task.count;
+	}
+
+	//Distribute the tasks round-robin, idle workers will steal from the others
+	const int workerCount = qBound(1, int((threads > 0) ? threads : CPUFetaures::detect().count), tasks.count());
+	QVector<QByteArray> results(files.count());
+	QScopedArrayPointer<WorkQueue> queues(new WorkQueue[workerCount]);
+	for (int i = 0; i < tasks.count(); ++i)
+	{
+		queues[i % workerCount].push(tasks.at(i));
+	}
+
+	const batch_context_t context = { &files, entries.constData(), results.data(), hashId, bAsHex, key };
+	QList<BatchWorker*> workers;
+	for (int i = 0; i < workerCount; ++i)
+	{
+		workers.append(new BatchWorker(context, queues.data(), workerCount, i));
+		workers.last()->start();
+	}
+	while (!workers.isEmpty())
+	{
+		BatchWorker *const worker = workers.takeFirst();
+		worker->wait();
+		delete worker;
+	}
+
+	for (int i = 0; i < files.count(); ++i)
+	{
+		digests.insert(files.at(i), results.at(i));
+	}
+	return digests;
+}
+
+QList<QByteArray> MUtils::Hash::hash_messages(const QList<QByteArray> &messages, const quint16 &hashId, const bool bAsHex, const char *const key)
+{
+	QList<QByteArray> digests;
+
+	//Keccak has a dedicated multi-buffer implementation
+	bool multi = true;
+	Keccak::HashBits hashBits = Keccak::hb256;
+	switch (hashId)
+	{
+		case HASH_KECCAK_224: hashBits = Keccak::hb224; break;
+		case HASH_KECCAK_256: hashBits = Keccak::hb256; break;
+		case HASH_KECCAK_384: hashBits = Keccak::hb384; break;
+		case HASH_KECCAK_512: hashBits = Keccak::hb512; break;
+		default: multi = false;
+	}
+
+	if (multi)
+	{
+		if (!Keccak::hashMulti(hashBits, messages, digests, key))
+		{
+			MUTILS_THROW("Keccak multi-buffer hashing has failed!");
+		}
+		if (bAsHex)
+		{
+			for (QList<QByteArray>::Iterator iter = digests.begin(); iter != digests.end(); ++iter)
+			{
+				*iter = to_hex(*iter);
+			}
+		}
+		return digests;
+	}
+
+	//All other algorithms: one instance, which is reset for each message
+	QScopedPointer<Hash> hash(create(hashId, key));
+	for (QList<QByteArray>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); ++iter)
+	{
+		if (iter != messages.constBegin())
+		{
+			hash->reset();
+		}
+		if (!hash->update(*iter))
+		{
+			MUTILS_THROW("Failed to process the message!");
+		}
+		digests.append(hash->digest(bAsHex));
+	}
+	return digests;
+}
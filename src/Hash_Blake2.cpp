@@ -36,15 +36,80 @@
 
 //MUtils
 #include <MUtils/Exception.h>
+#include <MUtils/CPUFeatures.h>
 
 //Internal
+#include "Hash_Parallel.h"
+#include "Hash_State.h"
+#include "Hash_Memory.h"
 #include "3rd_party/blake2/include/blake2.h"
 
-#include <malloc.h>
+//Qt
+#include <QMutex>
+
 #include <string.h>
 #include <stdexcept>
 
 static const size_t HASH_SIZE = 64;
+static const size_t HASH_SIZE_S = 32;
+
+//Hand the leaves of BLAKE2bp/BLAKE2sp to the thread pool only if each leaf gets at least this much input
+static const quint32 PARALLEL_THRESHOLD = 65536U;
+
+static QMutex     g_blake2_impl_lock;
+static QAtomicInt g_blake2_impl_init;
+
+static void blake2_select_impl(void)
+{
+	QMutexLocker lock(&g_blake2_impl_lock);
+	if(!g_blake2_impl_init)
+	{
+		using namespace MUtils::Hash::Internal::Blake2Impl;
+		const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+		if(cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+		{
+			blake2b_select_impl(BLAKE2B_IMPL_AVX2);
+		}
+		else if(cpuInfo.features & MUtils::CPUFetaures::FLAG_SSE41)
+		{
+			blake2b_select_impl(BLAKE2B_IMPL_SSE41);
+		}
+		else
+		{
+			blake2b_select_impl(BLAKE2B_IMPL_REF);
+		}
+		g_blake2_impl_init.ref();
+	}
+}
+
+bool MUtils::Hash::Internal::blake2_select_kernel(const kernel_t kernel)
+{
+	using namespace MUtils::Hash::Internal::Blake2Impl;
+	if(kernel == KERNEL_AUTO)
+	{
+		g_blake2_impl_init.fetchAndStoreOrdered(0);
+		blake2_select_impl();
+		return true;
+	}
+
+	blake2b_impl impl;
+	quint32 required;
+	switch(kernel)
+	{
+		case KERNEL_REF:   impl = BLAKE2B_IMPL_REF;   required = 0U;                                break;
+		case KERNEL_SSE41: impl = BLAKE2B_IMPL_SSE41; required = MUtils::CPUFetaures::FLAG_SSE41; break;
+		case KERNEL_AVX2:  impl = BLAKE2B_IMPL_AVX2;  required = MUtils::CPUFetaures::FLAG_AVX2;  break;
+		default: return false;
+	}
+
+	QMutexLocker lock(&g_blake2_impl_lock);
+	if(((MUtils::CPUFetaures::detect().features & required) != required) || (blake2b_select_impl(impl) != 0))
+	{
+		return false;
+	}
+	g_blake2_impl_init.fetchAndStoreOrdered(1);
+	return true;
+}
 
 class MUtils::Hash::Blake2_Context
 {
@@ -52,21 +117,30 @@ class MUtils::Hash::Blake2_Context
 
 	Blake2_Context(void)
 	{
-		if(!(state = (MUtils::Hash::Internal::Blake2Impl::blake2b_state*) _aligned_malloc(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state), HASH_SIZE)))
+		if(!(state = (MUtils::Hash::Internal::Blake2Impl::blake2b_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state), HASH_SIZE)))
+		{
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		if(!(init_state = (MUtils::Hash::Internal::Blake2Impl::blake2b_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state), HASH_SIZE)))
 		{
+			MUtils::Hash::Internal::free_aligned(state);
 			MUTILS_THROW("Aligend malloc has failed!");
 		}
 		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
 	}
 
 	~Blake2_Context(void)
 	{
 		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
-		_aligned_free(state);
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
+		MUtils::Hash::Internal::free_aligned(state);
+		MUtils::Hash::Internal::free_aligned(init_state);
 	}
 
 private:
 	MUtils::Hash::Internal::Blake2Impl::blake2b_state *state;
+	MUtils::Hash::Internal::Blake2Impl::blake2b_state *init_state; //copy of the state right after initialization, used by reinit()
 };
 
 MUtils::Hash::Blake2::Blake2(const char *const key)
@@ -74,6 +148,11 @@ MUtils::Hash::Blake2::Blake2(const char *const key)
 	m_context(new Blake2_Context()),
 	m_finalized(false)
 {
+	if(!g_blake2_impl_init)
+	{
+		blake2_select_impl();
+	}
+
 	if(key && key[0])
 	{
 		blake2b_init_key(m_context->state, HASH_SIZE, key, (uint8_t)strlen(key));
@@ -82,6 +161,8 @@ MUtils::Hash::Blake2::Blake2(const char *const key)
 	{
 		blake2b_init(m_context->state, HASH_SIZE);
 	}
+
+	memcpy(m_context->init_state, m_context->state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
 }
 
 MUtils::Hash::Blake2::~Blake2(void)
@@ -107,13 +188,370 @@ bool MUtils::Hash::Blake2::process(const quint8 *const data, const quint32 len)
 	return true;
 }
 
-QByteArray MUtils::Hash::Blake2::finalize(void)
+void MUtils::Hash::Blake2::reinit(void)
+{
+	memcpy(m_context->state, m_context->init_state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2b_state));
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::Blake2::finalize_into(quint8 *const out, const size_t len)
 {
-	QByteArray result(HASH_SIZE, '\0');
-	if(blake2b_final(m_context->state, (uint8_t*) result.data(), result.size()) != 0)
+	if(len < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE2 output buffer is too small!");
+	}
+	if(blake2b_final(m_context->state, out, HASH_SIZE) != 0)
 	{
 		MUTILS_THROW("BLAKE2 internal error!");
 	}
 	m_finalized = true;
-	return result;
+	return HASH_SIZE;
+}
+
+QByteArray MUtils::Hash::Blake2::serialize(void) const
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("BLAKE2 was already finalized!");
+	}
+
+	const Internal::Blake2Impl::blake2b_state *const state = m_context->state;
+	Internal::StateWriter writer(HASH_BLAKE2_512);
+	for(size_t i = 0; i < 8U; ++i)
+	{
+		writer.put_u64(state->h[i]);
+	}
+	for(size_t i = 0; i < 2U; ++i)
+	{
+		writer.put_u64(state->t[i]);
+		writer.put_u64(state->f[i]);
+	}
+	writer.put_u32(quint32(state->buflen));
+	writer.put_bytes(state->buf, sizeof(state->buf));
+	writer.put_u8(state->last_node);
+
+	return writer.finish();
+}
+
+bool MUtils::Hash::Blake2::deserialize(const QByteArray &data)
+{
+	Internal::StateReader reader(data, HASH_BLAKE2_512);
+	quint8 buf[2U * Internal::Blake2Impl::BLAKE2B_BLOCKBYTES];
+	quint64 h[8], t[2], f[2];
+	quint32 buflen = 0;
+	quint8 lastNode = 0;
+
+	bool success = reader.isValid();
+	for(size_t i = 0; success && (i < 8U); ++i)
+	{
+		success = reader.get_u64(h[i]);
+	}
+	for(size_t i = 0; success && (i < 2U); ++i)
+	{
+		success = reader.get_u64(t[i]) && reader.get_u64(f[i]);
+	}
+	success = success && reader.get_u32(buflen) && reader.get_bytes(buf, sizeof(buf)) && reader.get_u8(lastNode) && reader.atEnd();
+
+	if(!(success && (buflen <= sizeof(buf))))
+	{
+		qWarning("Failed to restore the BLAKE2 state!");
+		return false;
+	}
+
+	Internal::Blake2Impl::blake2b_state *const state = m_context->state;
+	for(size_t i = 0; i < 8U; ++i)
+	{
+		state->h[i] = h[i];
+	}
+	for(size_t i = 0; i < 2U; ++i)
+	{
+		state->t[i] = t[i];
+		state->f[i] = f[i];
+	}
+	memcpy(state->buf, buf, sizeof(state->buf));
+	state->buflen = buflen;
+	state->last_node = lastNode;
+
+	memset(buf, 0, sizeof(buf));
+	m_finalized = false;
+	return true;
+}
+
+size_t MUtils::Hash::Blake2::compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(!g_blake2_impl_init)
+	{
+		blake2_select_impl();
+	}
+
+	if(outLen < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE2 output buffer is too small!");
+	}
+
+	Blake2Impl::blake2b_state state;
+	const int error = (key && key[0])
+		? blake2b_init_key(&state, HASH_SIZE, key, (uint8_t)strlen(key))
+		: blake2b_init(&state, HASH_SIZE);
+	if((error != 0) || (blake2b_update(&state, data, len) != 0) || (blake2b_final(&state, out, HASH_SIZE) != 0))
+	{
+		MUTILS_THROW("BLAKE2 internal error!");
+	}
+
+	memset(&state, 0, sizeof(Blake2Impl::blake2b_state));
+	return HASH_SIZE;
+}
+
+// ==========================================================================
+// BLAKE2bp (tree mode, 4 leaves)
+// ==========================================================================
+
+class MUtils::Hash::Blake2bp_Context
+{
+	friend Blake2bp;
+
+	Blake2bp_Context(void)
+	{
+		if(!(state = (MUtils::Hash::Internal::Blake2Impl::blake2bp_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state), HASH_SIZE)))
+		{
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		if(!(init_state = (MUtils::Hash::Internal::Blake2Impl::blake2bp_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state), HASH_SIZE)))
+		{
+			MUtils::Hash::Internal::free_aligned(state);
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+	}
+
+	~Blake2bp_Context(void)
+	{
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+		MUtils::Hash::Internal::free_aligned(state);
+		MUtils::Hash::Internal::free_aligned(init_state);
+	}
+
+private:
+	MUtils::Hash::Internal::Blake2Impl::blake2bp_state *state;
+	MUtils::Hash::Internal::Blake2Impl::blake2bp_state *init_state; //copy of the state right after initialization, used by reinit()
+};
+
+MUtils::Hash::Blake2bp::Blake2bp(const char *const key)
+:
+	m_context(new Blake2bp_Context()),
+	m_finalized(false)
+{
+	if(!g_blake2_impl_init)
+	{
+		blake2_select_impl();
+	}
+
+	const int error = (key && key[0])
+		? blake2bp_init_key(m_context->state, HASH_SIZE, key, (uint8_t)strlen(key))
+		: blake2bp_init(m_context->state, HASH_SIZE);
+	if(error != 0)
+	{
+		delete m_context;
+		MUTILS_THROW("BLAKE2bp initialization has failed!");
+	}
+
+	memcpy(m_context->init_state, m_context->state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+}
+
+MUtils::Hash::Blake2bp::~Blake2bp(void)
+{
+	delete m_context;
+}
+
+bool MUtils::Hash::Blake2bp::process(const quint8 *const data, const quint32 len)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(m_finalized)
+	{
+		MUTILS_THROW("BLAKE2bp was already finalized!");
+	}
+
+	if(data && (len > 0))
+	{
+		const Blake2Impl::blake2_parallel_fn parallel = (len >= Blake2Impl::BLAKE2BP_PARALLELISM * PARALLEL_THRESHOLD) ? parallel_for : NULL;
+		if(blake2bp_update(m_context->state, data, len, parallel) != 0)
+		{
+			MUTILS_THROW("BLAKE2bp internal error!");
+		}
+	}
+
+	return true;
+}
+
+void MUtils::Hash::Blake2bp::reinit(void)
+{
+	memcpy(m_context->state, m_context->init_state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2bp_state));
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::Blake2bp::finalize_into(quint8 *const out, const size_t len)
+{
+	if(len < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE2bp output buffer is too small!");
+	}
+	if(blake2bp_final(m_context->state, out, HASH_SIZE) != 0)
+	{
+		MUTILS_THROW("BLAKE2bp internal error!");
+	}
+	m_finalized = true;
+	return HASH_SIZE;
+}
+
+size_t MUtils::Hash::Blake2bp::compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(!g_blake2_impl_init)
+	{
+		blake2_select_impl();
+	}
+
+	if(outLen < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE2bp output buffer is too small!");
+	}
+
+	Blake2Impl::blake2bp_state state;
+	const int error = (key && key[0])
+		? blake2bp_init_key(&state, HASH_SIZE, key, (uint8_t)strlen(key))
+		: blake2bp_init(&state, HASH_SIZE);
+	if((error != 0) || (blake2bp_update(&state, data, len, (len >= Blake2Impl::BLAKE2BP_PARALLELISM * PARALLEL_THRESHOLD) ? parallel_for : NULL) != 0) || (blake2bp_final(&state, out, HASH_SIZE) != 0))
+	{
+		MUTILS_THROW("BLAKE2bp internal error!");
+	}
+
+	memset(&state, 0, sizeof(Blake2Impl::blake2bp_state));
+	return HASH_SIZE;
+}
+
+// ==========================================================================
+// BLAKE2sp (tree mode, 8 leaves)
+// ==========================================================================
+
+class MUtils::Hash::Blake2sp_Context
+{
+	friend Blake2sp;
+
+	Blake2sp_Context(void)
+	{
+		if(!(state = (MUtils::Hash::Internal::Blake2Impl::blake2sp_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state), HASH_SIZE)))
+		{
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		if(!(init_state = (MUtils::Hash::Internal::Blake2Impl::blake2sp_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state), HASH_SIZE)))
+		{
+			MUtils::Hash::Internal::free_aligned(state);
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+	}
+
+	~Blake2sp_Context(void)
+	{
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+		MUtils::Hash::Internal::free_aligned(state);
+		MUtils::Hash::Internal::free_aligned(init_state);
+	}
+
+private:
+	MUtils::Hash::Internal::Blake2Impl::blake2sp_state *state;
+	MUtils::Hash::Internal::Blake2Impl::blake2sp_state *init_state; //copy of the state right after initialization, used by reinit()
+};
+
+MUtils::Hash::Blake2sp::Blake2sp(const char *const key)
+:
+	m_context(new Blake2sp_Context()),
+	m_finalized(false)
+{
+	const int error = (key && key[0])
+		? blake2sp_init_key(m_context->state, HASH_SIZE_S, key, (uint8_t)strlen(key))
+		: blake2sp_init(m_context->state, HASH_SIZE_S);
+	if(error != 0)
+	{
+		delete m_context;
+		MUTILS_THROW("BLAKE2sp initialization has failed!");
+	}
+
+	memcpy(m_context->init_state, m_context->state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+}
+
+MUtils::Hash::Blake2sp::~Blake2sp(void)
+{
+	delete m_context;
+}
+
+bool MUtils::Hash::Blake2sp::process(const quint8 *const data, const quint32 len)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(m_finalized)
+	{
+		MUTILS_THROW("BLAKE2sp was already finalized!");
+	}
+
+	if(data && (len > 0))
+	{
+		const Blake2Impl::blake2_parallel_fn parallel = (len >= Blake2Impl::BLAKE2SP_PARALLELISM * PARALLEL_THRESHOLD) ? parallel_for : NULL;
+		if(blake2sp_update(m_context->state, data, len, parallel) != 0)
+		{
+			MUTILS_THROW("BLAKE2sp internal error!");
+		}
+	}
+
+	return true;
+}
+
+void MUtils::Hash::Blake2sp::reinit(void)
+{
+	memcpy(m_context->state, m_context->init_state, sizeof(MUtils::Hash::Internal::Blake2Impl::blake2sp_state));
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::Blake2sp::finalize_into(quint8 *const out, const size_t len)
+{
+	if(len < HASH_SIZE_S)
+	{
+		MUTILS_THROW("BLAKE2sp output buffer is too small!");
+	}
+	if(blake2sp_final(m_context->state, out, HASH_SIZE_S) != 0)
+	{
+		MUTILS_THROW("BLAKE2sp internal error!");
+	}
+	m_finalized = true;
+	return HASH_SIZE_S;
+}
+
+size_t MUtils::Hash::Blake2sp::compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(outLen < HASH_SIZE_S)
+	{
+		MUTILS_THROW("BLAKE2sp output buffer is too small!");
+	}
+
+	Blake2Impl::blake2sp_state state;
+	const int error = (key && key[0])
+		? blake2sp_init_key(&state, HASH_SIZE_S, key, (uint8_t)strlen(key))
+		: blake2sp_init(&state, HASH_SIZE_S);
+	if((error != 0) || (blake2sp_update(&state, data, len, (len >= Blake2Impl::BLAKE2SP_PARALLELISM * PARALLEL_THRESHOLD) ? parallel_for : NULL) != 0) || (blake2sp_final(&state, out, HASH_SIZE_S) != 0))
+	{
+		MUTILS_THROW("BLAKE2sp internal error!");
+	}
+
+	memset(&state, 0, sizeof(Blake2Impl::blake2sp_state));
+	return HASH_SIZE_S;
 }
@@ -54,12 +54,55 @@ namespace MUtils
 			Blake2(const char *const key = NULL);
 			virtual ~Blake2(void);
 
+			static size_t compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
 		private:
 			Blake2_Context *const m_context;
 			bool m_finalized;
 
 			virtual bool process(const quint8 *const data, const quint32 len);
-			virtual QByteArray finalize(void);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+			virtual QByteArray serialize(void) const;
+			virtual bool deserialize(const QByteArray &data);
+		};
+
+		class MUTILS_API Blake2bp_Context;
+
+		class MUTILS_API Blake2bp : public Hash
+		{
+		public:
+			Blake2bp(const char *const key = NULL);
+			virtual ~Blake2bp(void);
+
+			static size_t compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		private:
+			Blake2bp_Context *const m_context;
+			bool m_finalized;
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+		};
+
+		class MUTILS_API Blake2sp_Context;
+
+		class MUTILS_API Blake2sp : public Hash
+		{
+		public:
+			Blake2sp(const char *const key = NULL);
+			virtual ~Blake2sp(void);
+
+			static size_t compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		private:
+			Blake2sp_Context *const m_context;
+			bool m_finalized;
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
 		};
 		
 	}
@@ -0,0 +1,294 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+   BLAKE3 reference source code package - C implementations
+
+   Written in 2019-2020 by Jack O'Connor, Samuel Neves, Jean-Philippe Aumasson
+   and Zooko Wilcox-O'Hearn
+
+   To the extent possible under law, the author(s) have dedicated all copyright
+   and related and neighboring rights to this software to the public domain
+   worldwide. This software is distributed without any warranty.
+
+   You should have received a copy of the CC0 Public Domain Dedication along with
+   this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#include "Hash_Blake3.h"
+
+//MUtils
+#include <MUtils/Exception.h>
+#include <MUtils/CPUFeatures.h>
+
+//Internal
+#include "Hash_Parallel.h"
+#include "Hash_Memory.h"
+#include "3rd_party/blake3/include/blake3.h"
+
+//Qt
+#include <QMutex>
+
+#include <string.h>
+#include <stdexcept>
+
+static const size_t HASH_SIZE = 32;
+
+//Hand the subtrees to the thread pool only if the input is at least this big
+static const quint32 PARALLEL_THRESHOLD = 262144U;
+
+static QMutex     g_blake3_impl_lock;
+static QAtomicInt g_blake3_impl_init;
+
+static void blake3_detect_impl(void)
+{
+	QMutexLocker lock(&g_blake3_impl_lock);
+	if(!g_blake3_impl_init)
+	{
+		using namespace MUtils::Hash::Internal::Blake3Impl;
+		const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+		if(cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+		{
+			blake3_select_impl(BLAKE3_IMPL_AVX2);
+		}
+		else if(cpuInfo.features & MUtils::CPUFetaures::FLAG_SSE41)
+		{
+			blake3_select_impl(BLAKE3_IMPL_SSE41);
+		}
+		else
+		{
+			blake3_select_impl(BLAKE3_IMPL_REF);
+		}
+		g_blake3_impl_init.ref();
+	}
+}
+
+bool MUtils::Hash::Internal::blake3_select_kernel(const kernel_t kernel)
+{
+	using namespace MUtils::Hash::Internal::Blake3Impl;
+	if(kernel == KERNEL_AUTO)
+	{
+		g_blake3_impl_init.fetchAndStoreOrdered(0);
+		blake3_detect_impl();
+		return true;
+	}
+
+	blake3_impl impl;
+	quint32 required;
+	switch(kernel)
+	{
+		case KERNEL_REF:   impl = BLAKE3_IMPL_REF;   required = 0U;                                break;
+		case KERNEL_SSE41: impl = BLAKE3_IMPL_SSE41; required = MUtils::CPUFetaures::FLAG_SSE41; break;
+		case KERNEL_AVX2:  impl = BLAKE3_IMPL_AVX2;  required = MUtils::CPUFetaures::FLAG_AVX2;  break;
+		default: return false;
+	}
+
+	QMutexLocker lock(&g_blake3_impl_lock);
+	if(((MUtils::CPUFetaures::detect().features & required) != required) || (blake3_select_impl(impl) != 0))
+	{
+		return false;
+	}
+	g_blake3_impl_init.fetchAndStoreOrdered(1);
+	return true;
+}
+
+//The key is taken as (pointer, length), so it may contain NULL characters; the context string of derive_key mode must not be empty
+static void blake3_init_state(MUtils::Hash::Internal::Blake3Impl::blake3_hasher *const S, const quint8 *const key, const size_t keyLen, const bool deriveKey)
+{
+	using namespace MUtils::Hash::Internal::Blake3Impl;
+
+	if(deriveKey)
+	{
+		blake3_hasher_init_derive_key_raw(S, key, keyLen);
+	}
+	else if(keyLen == BLAKE3_KEY_LEN)
+	{
+		blake3_hasher_init_keyed(S, (const uint8_t*)key);
+	}
+	else if(keyLen > 0)
+	{
+		//BLAKE3 requires a key of exactly 32 bytes, so other keys are hashed down to that size first
+		uint8_t keyHash[BLAKE3_KEY_LEN];
+		blake3_hasher_init(S);
+		blake3_hasher_update(S, key, keyLen, NULL);
+		blake3_hasher_finalize(S, keyHash, BLAKE3_KEY_LEN);
+		blake3_hasher_init_keyed(S, keyHash);
+		memset(keyHash, 0, BLAKE3_KEY_LEN);
+	}
+	else
+	{
+		blake3_hasher_init(S);
+	}
+}
+
+class MUtils::Hash::Blake3_Context
+{
+	friend Blake3;
+
+	Blake3_Context(void)
+	{
+		if(!(state = (MUtils::Hash::Internal::Blake3Impl::blake3_hasher*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher), 64)))
+		{
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		if(!(init_state = (MUtils::Hash::Internal::Blake3Impl::blake3_hasher*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher), 64)))
+		{
+			MUtils::Hash::Internal::free_aligned(state);
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher));
+	}
+
+	~Blake3_Context(void)
+	{
+		memset(state, 0, sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher));
+		memset(init_state, 0, sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher));
+		MUtils::Hash::Internal::free_aligned(state);
+		MUtils::Hash::Internal::free_aligned(init_state);
+	}
+
+private:
+	MUtils::Hash::Internal::Blake3Impl::blake3_hasher *state;
+	MUtils::Hash::Internal::Blake3Impl::blake3_hasher *init_state; //copy of the state right after initialization, used by reinit()
+};
+
+MUtils::Hash::Blake3::Blake3(const char *const key, const Mode mode)
+:
+	m_context(new Blake3_Context()),
+	m_finalized(false)
+{
+	init((const quint8*)key, key ? strlen(key) : 0U, mode);
+}
+
+MUtils::Hash::Blake3::Blake3(const quint8 *const key, const size_t keyLen, const Mode mode)
+:
+	m_context(new Blake3_Context()),
+	m_finalized(false)
+{
+	init(key, keyLen, mode);
+}
+
+void MUtils::Hash::Blake3::init(const quint8 *const key, const size_t keyLen, const Mode mode)
+{
+	using namespace MUtils::Hash::Internal::Blake3Impl;
+
+	if((mode == derive_key) && ((!key) || (keyLen < 1U)))
+	{
+		delete m_context; /*the destructor will not run*/
+		MUTILS_THROW("BLAKE3 derive_key mode requires a non-empty context string!");
+	}
+
+	if(!g_blake3_impl_init)
+	{
+		blake3_detect_impl();
+	}
+
+	blake3_init_state(m_context->state, key, keyLen, (mode == derive_key));
+	memcpy(m_context->init_state, m_context->state, sizeof(blake3_hasher));
+}
+
+MUtils::Hash::Blake3::~Blake3(void)
+{
+	delete m_context;
+}
+
+bool MUtils::Hash::Blake3::process(const quint8 *const data, const quint32 len)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if(m_finalized)
+	{
+		MUTILS_THROW("BLAKE3 was already finalized!");
+	}
+
+	if(data && (len > 0))
+	{
+		const Blake3Impl::blake3_parallel_fn parallel = (len >= PARALLEL_THRESHOLD) ? parallel_for : NULL;
+		blake3_hasher_update(m_context->state, data, len, parallel);
+	}
+
+	return true;
+}
+
+void MUtils::Hash::Blake3::reinit(void)
+{
+	memcpy(m_context->state, m_context->init_state, sizeof(MUtils::Hash::Internal::Blake3Impl::blake3_hasher));
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::Blake3::finalize_into(quint8 *const out, const size_t len)
+{
+	if(len < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE3 output buffer is too small!");
+	}
+
+	finalize_xof_into(out, HASH_SIZE);
+	return HASH_SIZE;
+}
+
+void MUtils::Hash::Blake3::finalize_xof_into(quint8 *const out, const size_t len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("BLAKE3 was already finalized!");
+	}
+
+	blake3_hasher_finalize(m_context->state, out, len);
+	m_finalized = true;
+}
+
+size_t MUtils::Hash::Blake3::compute(const Mode mode, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	return compute(mode, (const quint8*)key, key ? strlen(key) : 0U, data, len, out, outLen);
+}
+
+size_t MUtils::Hash::Blake3::compute(const Mode mode, const quint8 *const key, const size_t keyLen, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal;
+
+	if((mode == derive_key) && ((!key) || (keyLen < 1U)))
+	{
+		MUTILS_THROW("BLAKE3 derive_key mode requires a non-empty context string!");
+	}
+
+	if(!g_blake3_impl_init)
+	{
+		blake3_detect_impl();
+	}
+
+	if(outLen < HASH_SIZE)
+	{
+		MUTILS_THROW("BLAKE3 output buffer is too small!");
+	}
+
+	Blake3Impl::blake3_hasher state;
+	blake3_init_state(&state, key, keyLen, (mode == derive_key));
+	if(data && (len > 0))
+	{
+		blake3_hasher_update(&state, data, len, (len >= PARALLEL_THRESHOLD) ? parallel_for : NULL);
+	}
+	blake3_hasher_finalize(&state, out, HASH_SIZE);
+
+	memset(&state, 0, sizeof(Blake3Impl::blake3_hasher));
+	return HASH_SIZE;
+}
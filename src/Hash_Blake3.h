@@ -0,0 +1,76 @@
+///////////////////////////////////////////////////////////////////////////////
+// Simple x264 Launcher
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License along
+// with this program; if not, write to the Free Software Foundation, Inc.,
+// 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+//
+// http://www.gnu.org/licenses/gpl-2.0.txt
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+   BLAKE3 reference source code package - C implementations
+
+   Written in 2019-2020 by Jack O'Connor, Samuel Neves, Jean-Philippe Aumasson
+   and Zooko Wilcox-O'Hearn
+
+   To the extent possible under law, the author(s) have dedicated all copyright
+   and related and neighboring rights to this software to the public domain
+   worldwide. This software is distributed without any warranty.
+
+   You should have received a copy of the CC0 Public Domain Dedication along with
+   this software. If not, see <http://creativecommons.org/publicdomain/zero/1.0/>.
+*/
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Hash.h>
+
+//Qt
+#include <QByteArray>
+#include <QFile>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class MUTILS_API Blake3_Context;
+
+		class MUTILS_API Blake3 : public Hash
+		{
+		public:
+			enum Mode {hash, derive_key};
+
+			Blake3(const char *const key = NULL, const Mode mode = hash);
+			Blake3(const quint8 *const key, const size_t keyLen, const Mode mode = hash);
+			virtual ~Blake3(void);
+
+			static size_t compute(const Mode mode, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+			static size_t compute(const Mode mode, const quint8 *const key, const size_t keyLen, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		private:
+			Blake3_Context *const m_context;
+			bool m_finalized;
+
+			void init(const quint8 *const key, const size_t keyLen, const Mode mode);
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+			virtual void finalize_xof_into(quint8 *const out, const size_t len);
+		};
+	}
+}
@@ -0,0 +1,602 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Hash.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Hash_State.h"
+
+//Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QPair>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QScopedPointer>
+
+//Platform
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN 1
+#include <Windows.h>
+#else
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+#endif
+
+static const char *const CACHE_FILE_NAME = "MUtilsHashCache.log";
+static const char *const LOCK_FILE_NAME = "MUtilsHashCache.lock";
+static const quint32 MAX_PATH_LENGTH = 65536U;
+static const int COMPACT_MIN_STALE = 1024; //Compact on open, if the log contains at least that many superseded records...
+static const int COMPACT_MIN_RATIO = 2;    //...and at least twice as many records as there are current entries
+
+namespace
+{
+	typedef struct
+	{
+		quint64 size;
+		quint64 mtime;
+		quint64 fileId;
+		quint64 volumeId;
+	}
+	file_stamp_t;
+
+	typedef struct
+	{
+		file_stamp_t stamp;
+		QByteArray digest; //raw bytes
+	}
+	cache_entry_t;
+
+	typedef QPair<QString, quint16> cache_key_t;
+
+	//Advisory lock on a separate lock file, which is never replaced: Appending to the log takes a shared lock, replacing or truncating the log takes an exclusive lock
+	class LogLock
+	{
+	public:
+		LogLock(const QString &lockFile, const bool exclusive, const bool wait)
+		:
+			m_locked(false)
+		{
+#if defined(_WIN32)
+			m_handle = CreateFileW((LPCWSTR) QDir::toNativeSeparators(lockFile).utf16(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+			if (m_handle != INVALID_HANDLE_VALUE)
+			{
+				OVERLAPPED overlapped;
+				memset(&overlapped, 0, sizeof(OVERLAPPED));
+				m_locked = (LockFileEx(m_handle, (exclusive ? LOCKFILE_EXCLUSIVE_LOCK : 0U) | (wait ? 0U : LOCKFILE_FAIL_IMMEDIATELY), 0U, 1U, 0U, &overlapped) != FALSE);
+			}
+#else
+			m_handle = open(QFile::encodeName(lockFile).constData(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+			if (m_handle >= 0)
+			{
+				int result;
+				do
+				{
+					result = flock(m_handle, (exclusive ? LOCK_EX : LOCK_SH) | (wait ? 0 : LOCK_NB));
+				}
+				while ((result != 0) && (errno == EINTR));
+				m_locked = (result == 0);
+			}
+#endif
+		}
+
+		~LogLock(void)
+		{
+#if defined(_WIN32)
+			if (m_handle != INVALID_HANDLE_VALUE)
+			{
+				if (m_locked)
+				{
+					OVERLAPPED overlapped;
+					memset(&overlapped, 0, sizeof(OVERLAPPED));
+					UnlockFileEx(m_handle, 0U, 1U, 0U, &overlapped);
+				}
+				CloseHandle(m_handle);
+			}
+#else
+			if (m_handle >= 0)
+			{
+				close(m_handle); /*releases the lock*/
+			}
+#endif
+		}
+
+		bool isLocked(void) const
+		{
+			return m_locked;
+		}
+
+	private:
+		LogLock(const LogLock&) { throw "Constructor is disabled!"; }
+		LogLock &operator=(const LogLock&) { throw "Assignment operator is disabled!"; }
+
+#if defined(_WIN32)
+		HANDLE m_handle;
+#else
+		int m_handle;
+#endif
+		bool m_locked;
+	};
+}
+
+static inline bool operator==(const file_stamp_t &a, const file_stamp_t &b)
+{
+	return (a.size == b.size) && (a.mtime == b.mtime) && (a.fileId == b.fileId) && (a.volumeId == b.volumeId);
+}
+
+//Query size, modification time and file identifier; the content of the file is not accessed
+static bool get_file_stamp(const QString &filePath, file_stamp_t &stamp)
+{
+#if defined(_WIN32)
+	const HANDLE handle = CreateFileW((LPCWSTR) QDir::toNativeSeparators(filePath).utf16(), 0, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS, NULL);
+	if (handle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	BY_HANDLE_FILE_INFORMATION info;
+	const BOOL success = GetFileInformationByHandle(handle, &info);
+	CloseHandle(handle);
+	if ((!success) || (info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+	{
+		return false;
+	}
+	stamp.size     = (quint64(info.nFileSizeHigh) << 32) | quint64(info.nFileSizeLow);
+	stamp.mtime    = (quint64(info.ftLastWriteTime.dwHighDateTime) << 32) | quint64(info.ftLastWriteTime.dwLowDateTime);
+	stamp.fileId   = (quint64(info.nFileIndexHigh) << 32) | quint64(info.nFileIndexLow);
+	stamp.volumeId = quint64(info.dwVolumeSerialNumber);
+	return true;
+#else
+	struct stat info;
+	if ((stat(QFile::encodeName(filePath).constData(), &info) != 0) || (!S_ISREG(info.st_mode)))
+	{
+		return false;
+	}
+	stamp.size     = quint64(info.st_size);
+#if defined(__APPLE__)
+	stamp.mtime    = (quint64(info.st_mtimespec.tv_sec) * 1000000000U) + quint64(info.st_mtimespec.tv_nsec);
+#else
+	stamp.mtime    = (quint64(info.st_mtim.tv_sec) * 1000000000U) + quint64(info.st_mtim.tv_nsec);
+#endif
+	stamp.fileId   = quint64(info.st_ino);
+	stamp.volumeId = quint64(info.st_dev);
+	return true;
+#endif
+}
+
+//Atomically replaces the target file with the source file, so that other processes see either the old or the new file, but never a missing one
+static bool replace_file(const QString &source, const QString &target)
+{
+#if defined(_WIN32)
+	return (MoveFileExW((LPCWSTR) QDir::toNativeSeparators(source).utf16(), (LPCWSTR) QDir::toNativeSeparators(target).utf16(), MOVEFILE_REPLACE_EXISTING) != FALSE);
+#else
+	return (rename(QFile::encodeName(source).constData(), QFile::encodeName(target).constData()) == 0);
+#endif
+}
+
+static QString cache_path(const QString &filePath)
+{
+	const QFileInfo info(filePath);
+	const QString canonicalPath = info.canonicalFilePath();
+	return canonicalPath.isEmpty() ? info.absoluteFilePath() : canonicalPath;
+}
+
+static QByteArray make_record(const QString &path, const quint16 hashId, const cache_entry_t &entry)
+{
+	const QByteArray pathUtf8 = path.toUtf8();
+	MUtils::Hash::Internal::StateWriter writer(hashId);
+	writer.put_u64(entry.stamp.size);
+	writer.put_u64(entry.stamp.mtime);
+	writer.put_u64(entry.stamp.fileId);
+	writer.put_u64(entry.stamp.volumeId);
+	writer.put_u32(quint32(pathUtf8.size()));
+	writer.put_bytes((const quint8*) pathUtf8.constData(), size_t(pathUtf8.size()));
+	writer.put_u8(quint8(entry.digest.size()));
+	writer.put_bytes((const quint8*) entry.digest.constData(), size_t(entry.digest.size()));
+	return writer.finish();
+}
+
+static bool parse_record(const QByteArray &record, const quint16 hashId, QString &path, cache_entry_t &entry)
+{
+	MUtils::Hash::Internal::StateReader reader(record, hashId, true); /*invalid records are reported by the caller*/
+	quint32 pathLength = 0;
+	quint8 digestLength = 0;
+	if (!(reader.get_u64(entry.stamp.size) && reader.get_u64(entry.stamp.mtime) && reader.get_u64(entry.stamp.fileId) && reader.get_u64(entry.stamp.volumeId) && reader.get_u32(pathLength)))
+	{
+		return false;
+	}
+	if ((pathLength < 1U) || (pathLength > MAX_PATH_LENGTH))
+	{
+		return false;
+	}
+	QByteArray pathUtf8(int(pathLength), '\0');
+	if (!(reader.get_bytes((quint8*) pathUtf8.data(), pathLength) && reader.get_u8(digestLength) && (digestLength == MUtils::Hash::digest_size(hashId))))
+	{
+		return false;
+	}
+	entry.digest.resize(digestLength);
+	if (!(reader.get_bytes((quint8*) entry.digest.data(), digestLength) && reader.atEnd()))
+	{
+		return false;
+	}
+	path = QString::fromUtf8(pathUtf8.constData(), pathUtf8.size());
+	return true;
+}
+
+static bool is_valid_hash_id(const quint16 hashId)
+{
+	try
+	{
+		MUtils::Hash::digest_size(hashId);
+		return true;
+	}
+	catch (...)
+	{
+		return false;
+	}
+}
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class HashCache_Private
+		{
+			friend class HashCache;
+
+		protected:
+			bool lookup(const cache_key_t &key, const file_stamp_t &stamp, QByteArray &digest) const
+			{
+				const QHash<cache_key_t, cache_entry_t>::ConstIterator iter = entries.constFind(key);
+				if ((iter != entries.constEnd()) && (iter->stamp == stamp))
+				{
+					digest = iter->digest;
+					return true;
+				}
+				return false;
+			}
+
+			void insert(const cache_key_t &key, const cache_entry_t &entry)
+			{
+				entries.insert(key, entry);
+				recordCount++;
+				if (logFile.isEmpty())
+				{
+					return; /*cache is disabled, the warning was issued by the constructor*/
+				}
+				const QByteArray record = make_record(key.first, key.second, entry);
+				const LogLock logLock(lockFile, false, true);
+				QFile file(logFile);
+				if (!(file.open(QIODevice::WriteOnly | QIODevice::Append) && (file.write(record) == qint64(record.size()))))
+				{
+					qWarning("Failed to append to the hash cache log!");
+				}
+			}
+
+			void load(void)
+			{
+				QByteArray data;
+				{
+					QFile file(logFile);
+					if (!file.open(QIODevice::ReadOnly))
+					{
+						return; /*no log yet*/
+					}
+					data = file.readAll();
+				}
+
+				const quint8 *const ptr = (const quint8*) data.constData();
+				const size_t size = size_t(data.size());
+				size_t pos = 0;
+				int invalidCount = 0;
+				while (pos < size)
+				{
+					quint16 hashId = 0;
+					const size_t recordSize = Internal::StateReader::peek(ptr + pos, size - pos, hashId);
+					if (recordSize < 1U)
+					{
+						qWarning("Hash cache log is truncated, ignoring the remainder!");
+						break;
+					}
+					QString path;
+					cache_entry_t entry;
+					if (is_valid_hash_id(hashId) && parse_record(QByteArray::fromRawData(data.constData() + pos, int(recordSize)), hashId, path, entry))
+					{
+						entries.insert(qMakePair(path, hashId), entry);
+					}
+					else
+					{
+						invalidCount++;
+					}
+					recordCount++;
+					pos += recordSize;
+				}
+				if (invalidCount > 0)
+				{
+					qWarning("Hash cache log contains %d invalid record(s), ignoring them!", invalidCount);
+				}
+			}
+
+			//Re-reads the log under the exclusive lock, so that records appended by other processes are preserved, then rewrites it
+			bool compact(const bool dropStale, const bool wait)
+			{
+				const LogLock logLock(lockFile, true, wait);
+				if (!logLock.isLocked())
+				{
+					return false; /*log is in use*/
+				}
+
+				entries.clear();
+				recordCount = 0;
+				load();
+
+				if (dropStale)
+				{
+					QList<cache_key_t> stale;
+					for (QHash<cache_key_t, cache_entry_t>::ConstIterator iter = entries.constBegin(); iter != entries.constEnd(); ++iter)
+					{
+						file_stamp_t stamp;
+						if (!(get_file_stamp(iter.key().first, stamp) && (stamp == iter->stamp)))
+						{
+							stale.append(iter.key());
+						}
+					}
+					for (QList<cache_key_t>::ConstIterator iter = stale.constBegin(); iter != stale.constEnd(); ++iter)
+					{
+						entries.remove(*iter);
+					}
+				}
+
+				return rewrite();
+			}
+
+			bool rewrite(void)
+			{
+				const QString tempFile = logFile + QLatin1String(".tmp");
+				{
+					QFile file(tempFile);
+					if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+					{
+						return false;
+					}
+					for (QHash<cache_key_t, cache_entry_t>::ConstIterator iter = entries.constBegin(); iter != entries.constEnd(); ++iter)
+					{
+						const QByteArray record = make_record(iter.key().first, iter.key().second, iter.value());
+						if (file.write(record) != qint64(record.size()))
+						{
+							file.close();
+							QFile::remove(tempFile);
+							return false;
+						}
+					}
+					file.close();
+				}
+				if (!replace_file(tempFile, logFile))
+				{
+					QFile::remove(tempFile);
+					return false;
+				}
+				recordCount = entries.count();
+				return true;
+			}
+
+			QString logFile, lockFile; //both are empty, if the cache is disabled (not persistent)
+			QHash<cache_key_t, cache_entry_t> entries;
+			int recordCount;
+			mutable QMutex lock;
+		};
+	}
+}
+
+// ==========================================================================
+// Hash Cache
+// ==========================================================================
+
+MUtils::Hash::HashCache::HashCache(const QString &directory)
+:
+	p(new HashCache_Private())
+{
+	p->recordCount = 0;
+
+	if (directory.isEmpty())
+	{
+		delete p;
+		MUTILS_THROW("Hash cache directory must not be empty!");
+	}
+
+	if (!QDir().mkpath(directory))
+	{
+		qWarning("Hash cache directory is not available, cache is disabled and will not persist!");
+		return; /*leave the log file empty*/
+	}
+
+	p->logFile = QDir(directory).absoluteFilePath(QLatin1String(CACHE_FILE_NAME));
+	p->lockFile = QDir(directory).absoluteFilePath(QLatin1String(LOCK_FILE_NAME));
+	p->load();
+	if ((p->recordCount - p->entries.count() >= COMPACT_MIN_STALE) && (p->recordCount >= COMPACT_MIN_RATIO * p->entries.count()))
+	{
+		p->compact(false, false); /*skipped, if another process is using the log right now*/
+	}
+}
+
+MUtils::Hash::HashCache::~HashCache(void)
+{
+	delete p;
+}
+
+QByteArray MUtils::Hash::HashCache::digest(const QString &filePath, const quint16 &hashId, const bool bAsHex)
+{
+	//Validate the algorithm identifier (throws, if the identifier is unknown)
+	digest_size(hashId);
+
+	file_stamp_t stamp;
+	if (!get_file_stamp(filePath, stamp))
+	{
+		return QByteArray();
+	}
+
+	const cache_key_t key = qMakePair(cache_path(filePath), hashId);
+	QByteArray result;
+	{
+		QMutexLocker locker(&p->lock);
+		if (p->lookup(key, stamp, result))
+		{
+			return bAsHex ? to_hex(result) : result;
+		}
+	}
+
+	//Cache miss: hash the file, but only remember the digest if the file was not modified in the meantime
+	QFile file(filePath);
+	QScopedPointer<Hash> hash(create(hashId));
+	if (!(file.open(QIODevice::ReadOnly) && hash->update(file)))
+	{
+		return QByteArray();
+	}
+	file.close();
+	result = hash->digest(false);
+
+	file_stamp_t stampAfter;
+	if (get_file_stamp(filePath, stampAfter) && (stampAfter == stamp))
+	{
+		const cache_entry_t entry = { stamp, result };
+		QMutexLocker locker(&p->lock);
+		p->insert(key, entry);
+	}
+	return bAsHex ? to_hex(result) : result;
+}
+
+MUtils::Hash::DigestMap MUtils::Hash::HashCache::digests(const QStringList &files, const quint16 &hashId, const quint32 &threads, const bool bAsHex)
+{
+	//Validate the algorithm identifier (throws, if the identifier is unknown)
+	digest_size(hashId);
+
+	DigestMap results;
+	QStringList missing;
+	QHash<QString, QPair<cache_key_t, file_stamp_t> > pending;
+	{
+		QMutexLocker locker(&p->lock);
+		for (QStringList::ConstIterator iter = files.constBegin(); iter != files.constEnd(); ++iter)
+		{
+			file_stamp_t stamp;
+			if (!get_file_stamp(*iter, stamp))
+			{
+				results.insert(*iter, QByteArray());
+				continue;
+			}
+			const cache_key_t key = qMakePair(cache_path(*iter), hashId);
+			QByteArray digest;
+			if (p->lookup(key, stamp, digest))
+			{
+				results.insert(*iter, bAsHex ? to_hex(digest) : digest);
+			}
+			else if (!pending.contains(*iter))
+			{
+				missing.append(*iter);
+				pending.insert(*iter, qMakePair(key, stamp));
+			}
+		}
+	}
+
+	if (!missing.isEmpty())
+	{
+		const DigestMap computed = hash_files(missing, hashId, threads, false);
+		QMutexLocker locker(&p->lock);
+		for (DigestMap::ConstIterator iter = computed.constBegin(); iter != computed.constEnd(); ++iter)
+		{
+			const QPair<cache_key_t, file_stamp_t> &info = pending[iter.key()];
+			file_stamp_t stampAfter;
+			if ((!iter.value().isEmpty()) && get_file_stamp(iter.key(), stampAfter) && (stampAfter == info.second))
+			{
+				const cache_entry_t entry = { info.second, iter.value() };
+				p->insert(info.first, entry);
+			}
+			results.insert(iter.key(), bAsHex ? to_hex(iter.value()) : iter.value());
+		}
+	}
+
+	return results;
+}
+
+bool MUtils::Hash::HashCache::lookup(const QString &filePath, const quint16 &hashId, QByteArray &digest, const bool bAsHex) const
+{
+	file_stamp_t stamp;
+	if (!get_file_stamp(filePath, stamp))
+	{
+		return false;
+	}
+
+	QMutexLocker locker(&p->lock);
+	if (p->lookup(qMakePair(cache_path(filePath), hashId), stamp, digest))
+	{
+		if (bAsHex)
+		{
+			digest = to_hex(digest);
+		}
+		return true;
+	}
+	return false;
+}
+
+bool MUtils::Hash::HashCache::compact(void)
+{
+	QMutexLocker locker(&p->lock);
+	if (p->logFile.isEmpty())
+	{
+		return false;
+	}
+
+	return p->compact(true, true);
+}
+
+void MUtils::Hash::HashCache::clear(void)
+{
+	QMutexLocker locker(&p->lock);
+	p->entries.clear();
+	p->recordCount = 0;
+	if (!p->logFile.isEmpty())
+	{
+		const LogLock logLock(p->lockFile, true, true);
+		QFile file(p->logFile);
+		if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+		{
+			qWarning("Failed to truncate the hash cache log!");
+		}
+	}
+}
+
+quint32 MUtils::Hash::HashCache::count(void) const
+{
+	QMutexLocker locker(&p->lock);
+	return quint32(p->entries.count());
+}
+
+QString MUtils::Hash::HashCache::logFile(void) const
+{
+	return p->logFile;
+}
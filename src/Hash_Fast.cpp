@@ -0,0 +1,367 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "Hash_Fast.h"
+
+//MUtils
+#include <MUtils/Exception.h>
+#include <MUtils/CPUFeatures.h>
+
+//Internal
+#include "Hash_Memory.h"
+#include "3rd_party/xxhash/include/xxh3.h"
+#include "3rd_party/crc32c/include/crc32c.h"
+
+//Qt
+#include <QMutex>
+
+#include <string.h>
+#include <stdexcept>
+
+static QMutex     g_fast_impl_lock;
+static QAtomicInt g_xxh3_impl_init;
+static QAtomicInt g_crc32c_impl_init;
+
+static void xxh3_detect_impl(void)
+{
+	QMutexLocker lock(&g_fast_impl_lock);
+	if(!g_xxh3_impl_init)
+	{
+		using namespace MUtils::Hash::Internal::XXH3Impl;
+		const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+		if(cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+		{
+			xxh3_select_impl(XXH3_IMPL_AVX2);
+		}
+		else if(cpuInfo.features & MUtils::CPUFetaures::FLAG_SSE2)
+		{
+			xxh3_select_impl(XXH3_IMPL_SSE2);
+		}
+		else
+		{
+			xxh3_select_impl(XXH3_IMPL_REF);
+		}
+		g_xxh3_impl_init.ref();
+	}
+}
+
+static void crc32c_detect_impl(void)
+{
+	QMutexLocker lock(&g_fast_impl_lock);
+	if(!g_crc32c_impl_init)
+	{
+		using namespace MUtils::Hash::Internal::CRC32CImpl;
+		const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+		if(cpuInfo.features & MUtils::CPUFetaures::FLAG_SSE42)
+		{
+			crc32c_select_impl(CRC32C_IMPL_SSE42);
+		}
+		else
+		{
+			crc32c_select_impl(CRC32C_IMPL_REF);
+		}
+		g_crc32c_impl_init.ref();
+	}
+}
+
+bool MUtils::Hash::Internal::xxh3_select_kernel(const kernel_t kernel)
+{
+	using namespace MUtils::Hash::Internal::XXH3Impl;
+	if(kernel == KERNEL_AUTO)
+	{
+		g_xxh3_impl_init.fetchAndStoreOrdered(0);
+		xxh3_detect_impl();
+		return true;
+	}
+
+	xxh3_impl impl;
+	quint32 required;
+	switch(kernel)
+	{
+		case KERNEL_REF:  impl = XXH3_IMPL_REF;  required = 0U;                               break;
+		case KERNEL_SSE2: impl = XXH3_IMPL_SSE2; required = MUtils::CPUFetaures::FLAG_SSE2; break;
+		case KERNEL_AVX2: impl = XXH3_IMPL_AVX2; required = MUtils::CPUFetaures::FLAG_AVX2; break;
+		default: return false;
+	}
+
+	QMutexLocker lock(&g_fast_impl_lock);
+	if(((MUtils::CPUFetaures::detect().features & required) != required) || (xxh3_select_impl(impl) != 0))
+	{
+		return false;
+	}
+	g_xxh3_impl_init.fetchAndStoreOrdered(1);
+	return true;
+}
+
+bool MUtils::Hash::Internal::crc32c_select_kernel(const kernel_t kernel)
+{
+	using namespace MUtils::Hash::Internal::CRC32CImpl;
+	if(kernel == KERNEL_AUTO)
+	{
+		g_crc32c_impl_init.fetchAndStoreOrdered(0);
+		crc32c_detect_impl();
+		return true;
+	}
+
+	crc32c_impl impl;
+	quint32 required;
+	switch(kernel)
+	{
+		case KERNEL_REF:   impl = CRC32C_IMPL_REF;   required = 0U;                                break;
+		case KERNEL_SSE42: impl = CRC32C_IMPL_SSE42; required = MUtils::CPUFetaures::FLAG_SSE42; break;
+		default: return false;
+	}
+
+	QMutexLocker lock(&g_fast_impl_lock);
+	if(((MUtils::CPUFetaures::detect().features & required) != required) || (crc32c_select_impl(impl) != 0))
+	{
+		return false;
+	}
+	g_crc32c_impl_init.fetchAndStoreOrdered(1);
+	return true;
+}
+
+static inline void store_be64(quint8 *const out, const quint64 value)
+{
+	for(size_t i = 0; i < 8U; ++i)
+	{
+		out[i] = quint8(value >> (56U - (8U * i)));
+	}
+}
+
+static inline void store_be32(quint8 *const out, const quint32 value)
+{
+	for(size_t i = 0; i < 4U; ++i)
+	{
+		out[i] = quint8(value >> (24U - (8U * i)));
+	}
+}
+
+//Use the canonical (big-endian) representation, as printed by the "xxhsum" tool
+static size_t xxh3_store_digest(const MUtils::Hash::Internal::XXH3Impl::xxh3_state *const state, const bool is128, quint8 *const out, const size_t len)
+{
+	using namespace MUtils::Hash::Internal::XXH3Impl;
+
+	if(len < (is128 ? 16U : 8U))
+	{
+		MUTILS_THROW("XXH3 output buffer is too small!");
+	}
+
+	if(is128)
+	{
+		const xxh3_128_t value = xxh3_digest_128(state);
+		store_be64(out, value.high64);
+		store_be64(out + 8, value.low64);
+		return 16U;
+	}
+
+	store_be64(out, xxh3_digest_64(state));
+	return 8U;
+}
+
+// ==========================================================================
+// XXH3
+// ==========================================================================
+
+class MUtils::Hash::XXH3_Context
+{
+	friend XXH3;
+
+	XXH3_Context(void)
+	{
+		if(!(state = (MUtils::Hash::Internal::XXH3Impl::xxh3_state*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::XXH3Impl::xxh3_state), 64)))
+		{
+			MUTILS_THROW("Aligend malloc has failed!");
+		}
+		memset(state, 0, sizeof(MUtils::Hash::Internal::XXH3Impl::xxh3_state));
+		seed = 0U;
+	}
+
+	~XXH3_Context(void)
+	{
+		memset(state, 0, sizeof(MUtils::Hash::Internal::XXH3Impl::xxh3_state));
+		MUtils::Hash::Internal::free_aligned(state);
+	}
+
+private:
+	MUtils::Hash::Internal::XXH3Impl::xxh3_state *state;
+	quint64 seed;
+};
+
+MUtils::Hash::XXH3::XXH3(const Variant variant, const char *const key)
+:
+	m_context(new XXH3_Context()),
+	m_variant(variant),
+	m_finalized(false)
+{
+	using namespace MUtils::Hash::Internal::XXH3Impl;
+
+	if(!g_xxh3_impl_init)
+	{
+		xxh3_detect_impl();
+	}
+
+	//XXH3 takes a 64-Bit seed, so the key is hashed down to the seed value
+	const size_t keyLen = key ? strlen(key) : 0U;
+	m_context->seed = (keyLen > 0) ? xxh3_64(key, keyLen, 0U) : 0U;
+	xxh3_reset(m_context->state, m_context->seed);
+}
+
+MUtils::Hash::XXH3::~XXH3(void)
+{
+	delete m_context;
+}
+
+bool MUtils::Hash::XXH3::process(const quint8 *const data, const quint32 len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("XXH3 was already finalized!");
+	}
+
+	if(data && (len > 0))
+	{
+		MUtils::Hash::Internal::XXH3Impl::xxh3_update(m_context->state, data, len);
+	}
+
+	return true;
+}
+
+void MUtils::Hash::XXH3::reinit(void)
+{
+	MUtils::Hash::Internal::XXH3Impl::xxh3_reset(m_context->state, m_context->seed);
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::XXH3::finalize_into(quint8 *const out, const size_t len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("XXH3 was already finalized!");
+	}
+
+	const size_t result = xxh3_store_digest(m_context->state, m_variant == hb128, out, len);
+	m_finalized = true;
+	return result;
+}
+
+size_t MUtils::Hash::XXH3::compute(const Variant variant, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal::XXH3Impl;
+
+	if(!g_xxh3_impl_init)
+	{
+		xxh3_detect_impl();
+	}
+
+	const size_t keyLen = key ? strlen(key) : 0U;
+	xxh3_state state;
+	xxh3_reset(&state, (keyLen > 0) ? xxh3_64(key, keyLen, 0U) : 0U);
+	if(data && (len > 0))
+	{
+		xxh3_update(&state, data, len);
+	}
+
+	return xxh3_store_digest(&state, variant == hb128, out, outLen);
+}
+
+// ==========================================================================
+// CRC32C
+// ==========================================================================
+
+MUtils::Hash::CRC32C::CRC32C(const char *const key)
+:
+	m_crc(0U),
+	m_initCrc(0U),
+	m_finalized(false)
+{
+	if(!g_crc32c_impl_init)
+	{
+		crc32c_detect_impl();
+	}
+
+	//The key (if any) is simply processed as a prefix of the message
+	if(key && key[0])
+	{
+		m_crc = m_initCrc = MUtils::Hash::Internal::CRC32CImpl::crc32c_update(m_crc, key, strlen(key));
+	}
+}
+
+bool MUtils::Hash::CRC32C::process(const quint8 *const data, const quint32 len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("CRC32C was already finalized!");
+	}
+
+	if(data && (len > 0))
+	{
+		m_crc = MUtils::Hash::Internal::CRC32CImpl::crc32c_update(m_crc, data, len);
+	}
+
+	return true;
+}
+
+void MUtils::Hash::CRC32C::reinit(void)
+{
+	m_crc = m_initCrc;
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::CRC32C::finalize_into(quint8 *const out, const size_t len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("CRC32C was already finalized!");
+	}
+	if(len < 4U)
+	{
+		MUTILS_THROW("CRC32C output buffer is too small!");
+	}
+
+	store_be32(out, m_crc);
+	m_finalized = true;
+	return 4U;
+}
+
+size_t MUtils::Hash::CRC32C::compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal::CRC32CImpl;
+
+	if(!g_crc32c_impl_init)
+	{
+		crc32c_detect_impl();
+	}
+
+	if(outLen < 4U)
+	{
+		MUTILS_THROW("CRC32C output buffer is too small!");
+	}
+
+	quint32 crc = (key && key[0]) ? crc32c_update(0U, key, strlen(key)) : 0U;
+	if(data && (len > 0))
+	{
+		crc = crc32c_update(crc, data, len);
+	}
+
+	store_be32(out, crc);
+	return 4U;
+}
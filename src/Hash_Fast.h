@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Hash.h>
+
+//Qt
+#include <QByteArray>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class MUTILS_API XXH3_Context;
+
+		class MUTILS_API XXH3 : public Hash
+		{
+		public:
+			enum Variant {hb64, hb128};
+
+			XXH3(const Variant variant, const char *const key = NULL);
+			virtual ~XXH3(void);
+
+			static size_t compute(const Variant variant, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		private:
+			XXH3_Context *const m_context;
+			const Variant m_variant;
+			bool m_finalized;
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+		};
+
+		class MUTILS_API CRC32C : public Hash
+		{
+		public:
+			CRC32C(const char *const key = NULL);
+			virtual ~CRC32C(void) {}
+
+			static size_t compute(const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		private:
+			quint32 m_crc, m_initCrc;
+			bool m_finalized;
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+		};
+	}
+}
@@ -0,0 +1,317 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Hash.h>
+#include <MUtils/CPUFeatures.h>
+#include <MUtils/Exception.h>
+
+//Qt
+#include <QMutex>
+
+//CRT
+#include <limits>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define HEX_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__GNUC__)
+#define HEX_TARGET(X) __attribute__((target(X)))
+#else
+#define HEX_TARGET(X)
+#endif
+
+static const char HEX_CHARS_LOWER[] = "0123456789abcdef";
+static const char HEX_CHARS_UPPER[] = "0123456789ABCDEF";
+
+// ==========================================================================
+// Reference Implementation
+// ==========================================================================
+
+static void hex_encode_ref(const quint8 *data, size_t len, char *out, const char *const chars)
+{
+	while (len--)
+	{
+		*out++ = chars[(*data) >> 4];
+		*out++ = chars[(*data++) & 0x0F];
+	}
+}
+
+//Returns the value of the hex digit, or a value greater than 0x0F, if the character is not a valid hex digit
+static inline quint32 hex_value(const quint8 c)
+{
+	const quint32 digit  = quint32(c) - quint32('0');
+	const quint32 letter = (quint32(c) | 0x20U) - quint32('a');
+	return (digit < 10U) ? digit : ((letter < 6U) ? (letter + 10U) : 0x100U);
+}
+
+static bool hex_decode_ref(const quint8 *hex, size_t len, quint8 *out)
+{
+	quint32 invalid = 0U;
+	for (; len >= 2U; len -= 2U, hex += 2U)
+	{
+		const quint32 hi = hex_value(hex[0]), lo = hex_value(hex[1]);
+		invalid |= (hi | lo);
+		*out++ = quint8((hi << 4) | (lo & 0x0F));
+	}
+	return (invalid < 0x10U);
+}
+
+// ==========================================================================
+// SIMD Implementation
+// ==========================================================================
+
+#if defined(HEX_HAVE_X86)
+
+HEX_TARGET("ssse3")
+static void hex_encode_ssse3(const quint8 *data, size_t len, char *out, const char *const chars)
+{
+	const __m128i lut  = _mm_loadu_si128((const __m128i*)chars);
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	for (; len >= 16U; len -= 16U, data += 16U, out += 32U)
+	{
+		const __m128i v  = _mm_loadu_si128((const __m128i*)data);
+		const __m128i hi = _mm_shuffle_epi8(lut, _mm_and_si128(_mm_srli_epi16(v, 4), mask));
+		const __m128i lo = _mm_shuffle_epi8(lut, _mm_and_si128(v, mask));
+		_mm_storeu_si128((__m128i*)(out +  0U), _mm_unpacklo_epi8(hi, lo));
+		_mm_storeu_si128((__m128i*)(out + 16U), _mm_unpackhi_epi8(hi, lo));
+	}
+	hex_encode_ref(data, len, out, chars);
+}
+
+HEX_TARGET("avx2")
+static void hex_encode_avx2(const quint8 *data, size_t len, char *out, const char *const chars)
+{
+	const __m256i lut  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)chars));
+	const __m256i mask = _mm256_set1_epi8(0x0F);
+	for (; len >= 32U; len -= 32U, data += 32U, out += 64U)
+	{
+		const __m256i v  = _mm256_loadu_si256((const __m256i*)data);
+		const __m256i hi = _mm256_shuffle_epi8(lut, _mm256_and_si256(_mm256_srli_epi16(v, 4), mask));
+		const __m256i lo = _mm256_shuffle_epi8(lut, _mm256_and_si256(v, mask));
+		const __m256i r0 = _mm256_unpacklo_epi8(hi, lo), r1 = _mm256_unpackhi_epi8(hi, lo); /*the unpack works within 128-Bit lanes*/
+		_mm256_storeu_si256((__m256i*)(out +  0U), _mm256_permute2x128_si256(r0, r1, 0x20));
+		_mm256_storeu_si256((__m256i*)(out + 32U), _mm256_permute2x128_si256(r0, r1, 0x31));
+	}
+	hex_encode_ssse3(data, len, out, chars);
+}
+
+//Converts 16 hex digits to their values; "invalid" receives 0xFF for each character that is not a hex digit
+HEX_TARGET("ssse3")
+static inline __m128i hex_values_ssse3(const __m128i c, __m128i &invalid)
+{
+	const __m128i digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+	const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+	const __m128i isDigit  = _mm_cmpeq_epi8(_mm_min_epu8(digit,  _mm_set1_epi8(9)), digit);
+	const __m128i isLetter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+	invalid = _mm_or_si128(invalid, _mm_andnot_si128(_mm_or_si128(isDigit, isLetter), _mm_set1_epi8(-1)));
+	return _mm_or_si128(_mm_and_si128(isDigit, digit), _mm_and_si128(isLetter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+}
+
+HEX_TARGET("ssse3")
+static bool hex_decode_ssse3(const quint8 *hex, size_t len, quint8 *out)
+{
+	const __m128i weights = _mm_set1_epi16(0x0110); /*(hi * 16) + (lo * 1)*/
+	__m128i invalid = _mm_setzero_si128();
+	for (; len >= 32U; len -= 32U, hex += 32U, out += 16U)
+	{
+		const __m128i v0 = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(hex +  0U)), invalid);
+		const __m128i v1 = hex_values_ssse3(_mm_loadu_si128((const __m128i*)(hex + 16U)), invalid);
+		_mm_storeu_si128((__m128i*)out, _mm_packus_epi16(_mm_maddubs_epi16(v0, weights), _mm_maddubs_epi16(v1, weights)));
+	}
+	const bool valid = (_mm_movemask_epi8(invalid) == 0);
+	return hex_decode_ref(hex, len, out) && valid;
+}
+
+HEX_TARGET("avx2")
+static inline __m256i hex_values_avx2(const __m256i c, __m256i &invalid)
+{
+	const __m256i digit  = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+	const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+	const __m256i isDigit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit,  _mm256_set1_epi8(9)), digit);
+	const __m256i isLetter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+	invalid = _mm256_or_si256(invalid, _mm256_andnot_si256(_mm256_or_si256(isDigit, isLetter), _mm256_set1_epi8(-1)));
+	return _mm256_or_si256(_mm256_and_si256(isDigit, digit), _mm256_and_si256(isLetter, _mm256_add_epi8(letter, _mm256_set1_epi8(10))));
+}
+
+HEX_TARGET("avx2")
+static bool hex_decode_avx2(const quint8 *hex, size_t len, quint8 *out)
+{
+	const __m256i weights = _mm256_set1_epi16(0x0110);
+	__m256i invalid = _mm256_setzero_si256();
+	for (; len >= 64U; len -= 64U, hex += 64U, out += 32U)
+	{
+		const __m256i v0 = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(hex +  0U)), invalid);
+		const __m256i v1 = hex_values_avx2(_mm256_loadu_si256((const __m256i*)(hex + 32U)), invalid);
+		const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(v0, weights), _mm256_maddubs_epi16(v1, weights)); /*the pack works within 128-Bit lanes*/
+		_mm256_storeu_si256((__m256i*)out, _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+	const bool valid = (_mm256_movemask_epi8(invalid) == 0);
+	return hex_decode_ssse3(hex, len, out) && valid;
+}
+
+#endif //HEX_HAVE_X86
+
+// ==========================================================================
+// Dispatch
+// ==========================================================================
+
+typedef void (*hex_encode_fn)(const quint8 *data, size_t len, char *out, const char *const chars);
+typedef bool (*hex_decode_fn)(const quint8 *hex, size_t len, quint8 *out);
+
+static QMutex     g_hex_impl_lock;
+static QAtomicInt g_hex_impl_init;
+
+static hex_encode_fn g_hex_encode = hex_encode_ref;
+static hex_decode_fn g_hex_decode = hex_decode_ref;
+
+static void hex_detect_impl(void)
+{
+	QMutexLocker lock(&g_hex_impl_lock);
+	if (!g_hex_impl_init)
+	{
+#if defined(HEX_HAVE_X86)
+		const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+		if (cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+		{
+			g_hex_encode = hex_encode_avx2;
+			g_hex_decode = hex_decode_avx2;
+		}
+		else if (cpuInfo.features & MUtils::CPUFetaures::FLAG_SSSE3)
+		{
+			g_hex_encode = hex_encode_ssse3;
+			g_hex_decode = hex_decode_ssse3;
+		}
+#endif
+		g_hex_impl_init.ref();
+	}
+}
+
+bool MUtils::Hash::Internal::hex_select_kernel(const kernel_t kernel)
+{
+	if (kernel == KERNEL_AUTO)
+	{
+		g_hex_impl_init.fetchAndStoreOrdered(0);
+		g_hex_encode = hex_encode_ref;
+		g_hex_decode = hex_decode_ref;
+		hex_detect_impl();
+		return true;
+	}
+
+	hex_encode_fn encode;
+	hex_decode_fn decode;
+	quint32 required;
+	switch (kernel)
+	{
+		case KERNEL_REF:   encode = hex_encode_ref;   decode = hex_decode_ref;   required = 0U;                                break;
+#if defined(HEX_HAVE_X86)
+		case KERNEL_SSSE3: encode = hex_encode_ssse3; decode = hex_decode_ssse3; required = MUtils::CPUFetaures::FLAG_SSSE3; break;
+		case KERNEL_AVX2:  encode = hex_encode_avx2;  decode = hex_decode_avx2;  required = MUtils::CPUFetaures::FLAG_AVX2;  break;
+#endif
+		default: return false;
+	}
+
+	QMutexLocker lock(&g_hex_impl_lock);
+	if ((MUtils::CPUFetaures::detect().features & required) != required)
+	{
+		return false;
+	}
+	g_hex_encode = encode;
+	g_hex_decode = decode;
+	g_hex_impl_init.fetchAndStoreOrdered(1);
+	return true;
+}
+
+// ==========================================================================
+// Public Functions
+// ==========================================================================
+
+size_t MUtils::Hash::to_hex_into(const quint8 *const data, const size_t len, char *const out, const size_t outLen, const bool bUpper)
+{
+	if ((len > (outLen / 2U)) || (len > (std::numeric_limits<size_t>::max() / 2U)))
+	{
+		MUTILS_THROW("Hex output buffer is too small!");
+	}
+	if (!g_hex_impl_init)
+	{
+		hex_detect_impl();
+	}
+	g_hex_encode(data, len, out, bUpper ? HEX_CHARS_UPPER : HEX_CHARS_LOWER);
+	return 2U * len;
+}
+
+QByteArray MUtils::Hash::to_hex(const QByteArray &data, const bool bUpper)
+{
+	QByteArray result;
+	result.resize(2 * data.size());
+	to_hex_into((const quint8*)data.constData(), size_t(data.size()), result.data(), size_t(result.size()), bUpper);
+	return result;
+}
+
+bool MUtils::Hash::from_hex_into(const char *const hex, const size_t len, quint8 *const out, const size_t outLen)
+{
+	if (len % 2U)
+	{
+		return false;
+	}
+	if ((len / 2U) > outLen)
+	{
+		MUTILS_THROW("Hex output buffer is too small!");
+	}
+	if (!g_hex_impl_init)
+	{
+		hex_detect_impl();
+	}
+	return g_hex_decode((const quint8*)hex, len, out);
+}
+
+QByteArray MUtils::Hash::from_hex(const QByteArray &hex)
+{
+	QByteArray result;
+	result.resize(hex.size() / 2);
+	if (!from_hex_into(hex.constData(), size_t(hex.size()), (quint8*)result.data(), size_t(result.size())))
+	{
+		return QByteArray();
+	}
+	return result;
+}
+
+bool MUtils::Hash::digest_equal(const quint8 *const a, const quint8 *const b, const size_t len)
+{
+	//Always look at all bytes, so that the run-time does not reveal the position of the first mismatch
+	volatile quint8 diff = 0U;
+	for (size_t i = 0; i < len; ++i)
+	{
+		diff = diff | quint8(a[i] ^ b[i]);
+	}
+	return (diff == 0U);
+}
+
+bool MUtils::Hash::digest_equal(const QByteArray &a, const QByteArray &b)
+{
+	if (a.size() != b.size())
+	{
+		return false; /*the length of a digest is not secret*/
+	}
+	return digest_equal((const quint8*)a.constData(), (const quint8*)b.constData(), size_t(a.size()));
+}
@@ -48,31 +48,76 @@
 
 //MUtils
 #include <MUtils/Exception.h>
+#include <MUtils/CPUFeatures.h>
+
+//Internal
+#include "Hash_State.h"
+#include "Hash_Memory.h"
 
 //Qt
 #include <QDebug>
+#include <QVector>
 
 //Implementation
 #include "3rd_party/keccak/include/keccak_impl.h"
 
+static QAtomicInt g_keccak_multi_impl;
+
+static MUtils::Hash::Internal::KeccakImpl::MultiImpl keccak_multi_impl(void)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+	if(const int impl = g_keccak_multi_impl)
+	{
+		return static_cast<MultiImpl>(impl);
+	}
+	const MUtils::CPUFetaures::cpu_info_t cpuInfo = MUtils::CPUFetaures::detect();
+	MultiImpl impl = MULTI_SCALAR;
+#ifdef KECCAK_MB_HAVE_AVX512
+	if(cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX512F)
+	{
+		impl = MULTI_AVX512;
+	}
+	else
+#endif
+	if(cpuInfo.features & MUtils::CPUFetaures::FLAG_AVX2)
+	{
+		impl = MULTI_AVX2;
+	}
+	g_keccak_multi_impl.fetchAndStoreOrdered(impl);
+	return impl;
+}
+
 MUtils::Hash::Keccak::Keccak()
 {
 	m_initialized = false;
-	m_state = (MUtils::Hash::Internal::KeccakImpl::hashState*) _aligned_malloc(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
+	m_hasInitState = false;
+	m_state = (MUtils::Hash::Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
 	if(!m_state)
 	{
-		MUTILS_THROW("_aligned_malloc() has failed, probably out of heap space!");
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
+	}
+	m_initState = (MUtils::Hash::Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
+	if(!m_initState)
+	{
+		MUtils::Hash::Internal::free_aligned(m_state);
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
 	}
 	memset(m_state, 0, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+	memset(m_initState, 0, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
 }
 
 MUtils::Hash::Keccak::~Keccak()
 {
 	if(m_state)
 	{
-		_aligned_free(m_state);
+		MUtils::Hash::Internal::free_aligned(m_state);
 		m_state = NULL;
 	}
+	if(m_initState)
+	{
+		MUtils::Hash::Internal::free_aligned(m_initState);
+		m_initState = NULL;
+	}
 }
 
 bool MUtils::Hash::Keccak::init(const HashBits hashBits)
@@ -101,7 +146,8 @@ bool MUtils::Hash::Keccak::init(const HashBits hashBits)
 		return false;
 	}
 	
-	m_initialized = true;
+	memcpy(m_initState, m_state, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+	m_initialized = m_hasInitState = true;
 	return true;
 }
 
@@ -114,7 +160,7 @@ bool MUtils::Hash::Keccak::process(const quint8 *const data, const quint32 len)
 		return false;
 	}
 	
-	if(MUtils::Hash::Internal::KeccakImpl::Update(m_state, (MUtils::Hash::Internal::KeccakImpl::BitSequence*)data, len*8U) != MUtils::Hash::Internal::KeccakImpl::SUCCESS)
+	if(MUtils::Hash::Internal::KeccakImpl::Update(m_state, (MUtils::Hash::Internal::KeccakImpl::BitSequence*)data, MUtils::Hash::Internal::KeccakImpl::DataLength(len) * 8U) != MUtils::Hash::Internal::KeccakImpl::SUCCESS)
 	{
 		qWarning("KeccakImpl::Update() has failed unexpectedly!");
 		m_initialized = false;
@@ -124,26 +170,142 @@ bool MUtils::Hash::Keccak::process(const quint8 *const data, const quint32 len)
 	return true;
 }
 
-QByteArray MUtils::Hash::Keccak::finalize(void)
+void MUtils::Hash::Keccak::reinit(void)
+{
+	if(!m_hasInitState)
+	{
+		MUTILS_THROW("MUtils::KeccakHash has not been initialized yet!");
+	}
+
+	memcpy(m_state, m_initState, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+	m_initialized = true;
+}
+
+size_t MUtils::Hash::Keccak::finalize_into(quint8 *const out, const size_t len)
 {
 	if(!m_initialized)
 	{
 		qWarning("MUtils::KeccakHash has not been initialized yet!");
-		return QByteArray();
+		return 0;
 	}
 
 	Q_ASSERT(m_state->fixedOutputLength > 0);
 	Q_ASSERT((m_state->fixedOutputLength % 8) == 0);
 
-	QByteArray hashResult(m_state->fixedOutputLength / 8, '\0');
-	if(MUtils::Hash::Internal::KeccakImpl::Final(m_state, (MUtils::Hash::Internal::KeccakImpl::BitSequence*)hashResult.data()) != MUtils::Hash::Internal::KeccakImpl::SUCCESS)
+	size_t hashLength = m_state->fixedOutputLength / 8;
+	if(len < hashLength)
+	{
+		MUTILS_THROW("Keccak output buffer is too small!");
+	}
+	if(MUtils::Hash::Internal::KeccakImpl::Final(m_state, (MUtils::Hash::Internal::KeccakImpl::BitSequence*)out) != MUtils::Hash::Internal::KeccakImpl::SUCCESS)
 	{
 		qWarning("KeccakImpl::Final() has failed unexpectedly!");
-		hashResult.clear();
+		hashLength = 0;
 	}
 
 	m_initialized = false;
-	return hashResult;
+	return hashLength;
+}
+
+//The permutation state is stored as 25 lanes in canonical form, so it does not depend on the 32-Bit or 64-Bit implementation
+static void keccak_save_state(MUtils::Hash::Internal::StateWriter &writer, const MUtils::Hash::Internal::KeccakImpl::hashState *const state)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+	unsigned char lanes[KeccakPermutationSizeInBytes];
+	KeccakExtract(state->state, lanes, 25U);
+	writer.put_bytes(lanes, sizeof(lanes));
+	writer.put_bytes(state->dataQueue, KeccakMaximumRateInBytes);
+	writer.put_u32(state->rate);
+	writer.put_u32(state->capacity);
+	writer.put_u32(state->bitsInQueue);
+	writer.put_u32(state->fixedOutputLength);
+	writer.put_u32(quint32(state->squeezing));
+	writer.put_u32(state->bitsAvailableForSqueezing);
+	memset(lanes, 0, sizeof(lanes));
+}
+
+static bool keccak_load_state(MUtils::Hash::Internal::StateReader &reader, MUtils::Hash::Internal::KeccakImpl::hashState *const state)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+	unsigned char lanes[KeccakPermutationSizeInBytes], dataQueue[KeccakMaximumRateInBytes];
+	quint32 rate = 0, capacity = 0, bitsInQueue = 0, fixedOutputLength = 0, squeezing = 0, bitsAvailableForSqueezing = 0;
+
+	const bool success = reader.get_bytes(lanes, sizeof(lanes)) && reader.get_bytes(dataQueue, sizeof(dataQueue))
+		&& reader.get_u32(rate) && reader.get_u32(capacity) && reader.get_u32(bitsInQueue) && reader.get_u32(fixedOutputLength)
+		&& reader.get_u32(squeezing) && reader.get_u32(bitsAvailableForSqueezing) && reader.atEnd();
+
+	//The sponge parameters must match the instance that the state is restored into
+	const bool valid = success && (rate == state->rate) && (capacity == state->capacity) && (fixedOutputLength == state->fixedOutputLength)
+		&& (bitsInQueue <= rate) && (squeezing <= 1U) && (bitsAvailableForSqueezing <= rate);
+
+	if(valid)
+	{
+		KeccakImportState(state->state, lanes);
+		memcpy(state->dataQueue, dataQueue, sizeof(dataQueue));
+		state->bitsInQueue = bitsInQueue;
+		state->squeezing = int(squeezing);
+		state->bitsAvailableForSqueezing = bitsAvailableForSqueezing;
+	}
+
+	memset(lanes, 0, sizeof(lanes));
+	memset(dataQueue, 0, sizeof(dataQueue));
+	return valid;
+}
+
+static quint16 keccak_hash_id(const unsigned int fixedOutputLength)
+{
+	switch(fixedOutputLength)
+	{
+		case 224: return MUtils::Hash::HASH_KECCAK_224;
+		case 256: return MUtils::Hash::HASH_KECCAK_256;
+		case 384: return MUtils::Hash::HASH_KECCAK_384;
+		case 512: return MUtils::Hash::HASH_KECCAK_512;
+		default: MUTILS_THROW("Invalid hash length!");
+	}
+}
+
+QByteArray MUtils::Hash::Keccak::serialize(void) const
+{
+	if(!m_initialized)
+	{
+		MUTILS_THROW("MUtils::KeccakHash has not been initialized yet!");
+	}
+
+	Internal::StateWriter writer(keccak_hash_id(m_state->fixedOutputLength));
+	keccak_save_state(writer, m_state);
+	return writer.finish();
+}
+
+bool MUtils::Hash::Keccak::deserialize(const QByteArray &data)
+{
+	if(!m_hasInitState)
+	{
+		MUTILS_THROW("MUtils::KeccakHash has not been initialized yet!");
+	}
+
+	//Start from the initial state, so that the sponge parameters are known even if the instance has been finalized already
+	Internal::KeccakImpl::hashState *const temp = (Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(Internal::KeccakImpl::hashState), 32);
+	if(!temp)
+	{
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
+	}
+	memcpy(temp, m_initState, sizeof(Internal::KeccakImpl::hashState));
+
+	Internal::StateReader reader(data, keccak_hash_id(temp->fixedOutputLength));
+	const bool success = reader.isValid() && keccak_load_state(reader, temp);
+	if(success)
+	{
+		memcpy(m_state, temp, sizeof(Internal::KeccakImpl::hashState));
+		m_initialized = true;
+	}
+	else
+	{
+		qWarning("Failed to restore the Keccak state!");
+	}
+
+	memset(temp, 0, sizeof(Internal::KeccakImpl::hashState));
+	MUtils::Hash::Internal::free_aligned(temp);
+	return success;
 }
 
 MUtils::Hash::Keccak *MUtils::Hash::Keccak::create(const HashBits hashBit, const char *const key)
@@ -156,10 +318,315 @@ MUtils::Hash::Keccak *MUtils::Hash::Keccak::create(const HashBits hashBit, const
 	if (key)
 	{
 		keccak->update(((const Internal::KeccakImpl::UINT8*)key), strlen(key));
+		memcpy(keccak->m_initState, keccak->m_state, sizeof(Internal::KeccakImpl::hashState));
 	}
 	return keccak;
 }
 
+size_t MUtils::Hash::Keccak::compute(const HashBits hashBits, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+
+	int hashBitLength = 0;
+	switch (hashBits)
+	{
+		case hb224: hashBitLength = 224; break;
+		case hb256: hashBitLength = 256; break;
+		case hb384: hashBitLength = 384; break;
+		case hb512: hashBitLength = 512; break;
+		default: MUTILS_THROW("Invalid hash length!");
+	}
+
+	if(outLen < size_t(hashBitLength / 8))
+	{
+		MUTILS_THROW("Keccak output buffer is too small!");
+	}
+
+	hashState state;
+	if(Init(&state, hashBitLength) != SUCCESS)
+	{
+		MUTILS_THROW("KeccakImpl::Init() has failed unexpectedly!");
+	}
+	if(key && key[0])
+	{
+		if(Update(&state, (const BitSequence*)key, DataLength(strlen(key)) * 8U) != SUCCESS)
+		{
+			MUTILS_THROW("KeccakImpl::Update() has failed unexpectedly!");
+		}
+	}
+	if(data && (len > 0))
+	{
+		if(Update(&state, (const BitSequence*)data, DataLength(len) * 8U) != SUCCESS)
+		{
+			MUTILS_THROW("KeccakImpl::Update() has failed unexpectedly!");
+		}
+	}
+	if(Final(&state, (BitSequence*)out) != SUCCESS)
+	{
+		MUTILS_THROW("KeccakImpl::Final() has failed unexpectedly!");
+	}
+
+	memset(&state, 0, sizeof(hashState));
+	return size_t(hashBitLength / 8);
+}
+
+bool MUtils::Hash::Keccak::hashMulti(const HashBits hashBits, const QList<QByteArray> &messages, QList<QByteArray> &digests, const char *const key)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+
+	int hashBitLength = 0;
+	switch (hashBits)
+	{
+		case hb224: hashBitLength = 224; break;
+		case hb256: hashBitLength = 256; break;
+		case hb384: hashBitLength = 384; break;
+		case hb512: hashBitLength = 512; break;
+		default: MUTILS_THROW("Invalid hash length!");
+	}
+
+	const int count = messages.count();
+	QVector<const BitSequence*> data(count);
+	QVector<DataLength> dataLen(count);
+	QVector<BitSequence*> hashval(count);
+
+	digests.clear();
+	for(int i = 0; i < count; ++i)
+	{
+		data[i] = reinterpret_cast<const BitSequence*>(messages.at(i).constData());
+		dataLen[i] = DataLength(messages.at(i).size());
+		digests.append(QByteArray(hashBitLength / 8, '\0'));
+	}
+	for(int i = 0; i < count; ++i)
+	{
+		hashval[i] = reinterpret_cast<BitSequence*>(digests[i].data());
+	}
+
+	const DataLength keyLen = key ? DataLength(strlen(key)) : 0U;
+	if(HashMulti(hashBitLength, keccak_multi_impl(), reinterpret_cast<const BitSequence*>(key), keyLen, unsigned(count), data.constData(), dataLen.constData(), hashval.constData()) != SUCCESS)
+	{
+		qWarning("KeccakImpl::HashMulti() has failed unexpectedly!");
+		digests.clear();
+		return false;
+	}
+
+	return true;
+}
+
+// ==========================================================================
+// SHA-3 (FIPS 202)
+// ==========================================================================
+
+static const struct
+{
+	unsigned int capacity;
+	unsigned int outputBits;
+	unsigned char suffix;
+	unsigned char suffixBits;
+	quint16 hashId;
+}
+SHA3_PARAMS[] =
+{
+	{  448U,  224U, 0x02, 2, MUtils::Hash::HASH_SHA3_224  }, /*SHA3-224: suffix "01"*/
+	{  512U,  256U, 0x02, 2, MUtils::Hash::HASH_SHA3_256  }, /*SHA3-256: suffix "01"*/
+	{  768U,  384U, 0x02, 2, MUtils::Hash::HASH_SHA3_384  }, /*SHA3-384: suffix "01"*/
+	{ 1024U,  512U, 0x02, 2, MUtils::Hash::HASH_SHA3_512  }, /*SHA3-512: suffix "01"*/
+	{  256U,  256U, 0x0F, 4, MUtils::Hash::HASH_SHAKE_128 }, /*SHAKE128: suffix "1111"*/
+	{  512U,  512U, 0x0F, 4, MUtils::Hash::HASH_SHAKE_256 }  /*SHAKE256: suffix "1111"*/
+};
+
+//Append the domain separation suffix; the sponge then adds the pad10*1 padding
+static void sha3_squeeze(MUtils::Hash::Internal::KeccakImpl::hashState *const state, const int variant, quint8 *const out, const size_t len)
+{
+	const unsigned char suffix = SHA3_PARAMS[variant].suffix;
+	if(MUtils::Hash::Internal::KeccakImpl::Absorb(state, &suffix, SHA3_PARAMS[variant].suffixBits) != 0)
+	{
+		MUTILS_THROW("KeccakImpl::Absorb() has failed unexpectedly!");
+	}
+	if(MUtils::Hash::Internal::KeccakImpl::Squeeze(state, (MUtils::Hash::Internal::KeccakImpl::BitSequence*)out, len * 8ULL) != 0)
+	{
+		MUTILS_THROW("KeccakImpl::Squeeze() has failed unexpectedly!");
+	}
+}
+
+MUtils::Hash::SHA3::SHA3(const Variant variant, const char *const key)
+:
+	m_variant(variant),
+	m_finalized(false)
+{
+	if((variant < sha3_224) || (variant > shake256))
+	{
+		MUTILS_THROW("Invalid SHA-3 variant!");
+	}
+	m_state = (MUtils::Hash::Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
+	if(!m_state)
+	{
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
+	}
+	m_initState = (MUtils::Hash::Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(MUtils::Hash::Internal::KeccakImpl::hashState), 32);
+	if(!m_initState)
+	{
+		MUtils::Hash::Internal::free_aligned(m_state);
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
+	}
+	memset(m_state, 0, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+	const unsigned int capacity = SHA3_PARAMS[variant].capacity;
+	if(MUtils::Hash::Internal::KeccakImpl::InitSponge(m_state, KeccakPermutationSize - capacity, capacity) != 0)
+	{
+		MUtils::Hash::Internal::free_aligned(m_state);
+		MUtils::Hash::Internal::free_aligned(m_initState);
+		MUTILS_THROW("KeccakImpl::InitSponge() has failed unexpectedly!");
+	}
+	if(key)
+	{
+		update(((const Internal::KeccakImpl::UINT8*)key), strlen(key));
+	}
+	memcpy(m_initState, m_state, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+}
+
+MUtils::Hash::SHA3::~SHA3()
+{
+	if(m_state)
+	{
+		memset(m_state, 0, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+		MUtils::Hash::Internal::free_aligned(m_state);
+		m_state = NULL;
+	}
+	if(m_initState)
+	{
+		memset(m_initState, 0, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+		MUtils::Hash::Internal::free_aligned(m_initState);
+		m_initState = NULL;
+	}
+}
+
+bool MUtils::Hash::SHA3::process(const quint8 *const data, const quint32 len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("SHA-3 was already finalized!");
+	}
+
+	if(MUtils::Hash::Internal::KeccakImpl::Absorb(m_state, (const MUtils::Hash::Internal::KeccakImpl::BitSequence*)data, len * 8ULL) != 0)
+	{
+		qWarning("KeccakImpl::Absorb() has failed unexpectedly!");
+		return false;
+	}
+
+	return true;
+}
+
+void MUtils::Hash::SHA3::reinit(void)
+{
+	memcpy(m_state, m_initState, sizeof(MUtils::Hash::Internal::KeccakImpl::hashState));
+	m_finalized = false;
+}
+
+size_t MUtils::Hash::SHA3::finalize_into(quint8 *const out, const size_t len)
+{
+	const size_t hashLength = SHA3_PARAMS[m_variant].outputBits / 8U;
+	if(len < hashLength)
+	{
+		MUTILS_THROW("SHA-3 output buffer is too small!");
+	}
+
+	finalize_xof_into(out, hashLength);
+	return hashLength;
+}
+
+void MUtils::Hash::SHA3::finalize_xof_into(quint8 *const out, const size_t len)
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("SHA-3 was already finalized!");
+	}
+	if((m_variant < shake128) && (len != SHA3_PARAMS[m_variant].outputBits / 8U))
+	{
+		MUTILS_THROW("SHA-3 does not support variable-length output, use SHAKE instead!");
+	}
+
+	sha3_squeeze(m_state, m_variant, out, len);
+	m_finalized = true;
+}
+
+QByteArray MUtils::Hash::SHA3::serialize(void) const
+{
+	if(m_finalized)
+	{
+		MUTILS_THROW("SHA-3 was already finalized!");
+	}
+
+	Internal::StateWriter writer(SHA3_PARAMS[m_variant].hashId);
+	keccak_save_state(writer, m_state);
+	return writer.finish();
+}
+
+bool MUtils::Hash::SHA3::deserialize(const QByteArray &data)
+{
+	Internal::KeccakImpl::hashState *const temp = (Internal::KeccakImpl::hashState*) MUtils::Hash::Internal::alloc_aligned(sizeof(Internal::KeccakImpl::hashState), 32);
+	if(!temp)
+	{
+		MUTILS_THROW("alloc_aligned() has failed, probably out of heap space!");
+	}
+	memcpy(temp, m_initState, sizeof(Internal::KeccakImpl::hashState));
+
+	Internal::StateReader reader(data, SHA3_PARAMS[m_variant].hashId);
+	const bool success = reader.isValid() && keccak_load_state(reader, temp) && (!temp->squeezing);
+	if(success)
+	{
+		memcpy(m_state, temp, sizeof(Internal::KeccakImpl::hashState));
+		m_finalized = false;
+	}
+	else
+	{
+		qWarning("Failed to restore the SHA-3 state!");
+	}
+
+	memset(temp, 0, sizeof(Internal::KeccakImpl::hashState));
+	MUtils::Hash::Internal::free_aligned(temp);
+	return success;
+}
+
+size_t MUtils::Hash::SHA3::compute(const Variant variant, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen)
+{
+	using namespace MUtils::Hash::Internal::KeccakImpl;
+
+	if((variant < sha3_224) || (variant > shake256))
+	{
+		MUTILS_THROW("Invalid SHA-3 variant!");
+	}
+
+	const size_t hashLength = SHA3_PARAMS[variant].outputBits / 8U;
+	if(outLen < hashLength)
+	{
+		MUTILS_THROW("SHA-3 output buffer is too small!");
+	}
+
+	hashState state;
+	const unsigned int capacity = SHA3_PARAMS[variant].capacity;
+	if(InitSponge(&state, KeccakPermutationSize - capacity, capacity) != 0)
+	{
+		MUTILS_THROW("KeccakImpl::InitSponge() has failed unexpectedly!");
+	}
+	if(key && key[0])
+	{
+		if(Absorb(&state, (const BitSequence*)key, strlen(key) * 8ULL) != 0)
+		{
+			MUTILS_THROW("KeccakImpl::Absorb() has failed unexpectedly!");
+		}
+	}
+	if(data && (len > 0))
+	{
+		if(Absorb(&state, (const BitSequence*)data, len * 8ULL) != 0)
+		{
+			MUTILS_THROW("KeccakImpl::Absorb() has failed unexpectedly!");
+		}
+	}
+
+	sha3_squeeze(&state, variant, out, hashLength);
+	memset(&state, 0, sizeof(hashState));
+	return hashLength;
+}
+
 bool MUtils::Hash::Keccak::selfTest(void)
 {
 	Keccak hash;
@@ -174,7 +641,7 @@ bool MUtils::Hash::Keccak::selfTest(void)
 			QByteArray result = hash.finalize();
 			if(!result.isEmpty())
 			{
-				passed[0] = (_stricmp(result.toHex().constData(), "310aee6b30c47350576ac2873fa89fd190cdc488442f3ef654cf23fe") == 0);
+				passed[0] = (qstricmp(result.toHex().constData(), "310aee6b30c47350576ac2873fa89fd190cdc488442f3ef654cf23fe") == 0);
 				if(!passed[0]) qWarning("MUtils::KeccakHash self-test: Test #1 failed !!!");
 			}
 		}
@@ -187,7 +654,7 @@ bool MUtils::Hash::Keccak::selfTest(void)
 			QByteArray result = hash.finalize();
 			if(!result.isEmpty())
 			{
-				passed[1] = (_stricmp(result.toHex().constData(), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15") == 0);
+				passed[1] = (qstricmp(result.toHex().constData(), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15") == 0);
 				if(!passed[1]) qWarning("MUtils::KeccakHash self-test: Test #2 failed !!!");
 			}
 		}
@@ -200,7 +667,7 @@ bool MUtils::Hash::Keccak::selfTest(void)
 			QByteArray result = hash.finalize();
 			if(!result.isEmpty())
 			{
-				passed[2] = (_stricmp(result.toHex().constData(), "283990fa9d5fb731d786c5bbee94ea4db4910f18c62c03d173fc0a5e494422e8a0b3da7574dae7fa0baf005e504063b3") == 0);
+				passed[2] = (qstricmp(result.toHex().constData(), "283990fa9d5fb731d786c5bbee94ea4db4910f18c62c03d173fc0a5e494422e8a0b3da7574dae7fa0baf005e504063b3") == 0);
 				if(!passed[2]) qWarning("MUtils::KeccakHash self-test: Test #3 failed !!!");
 			}
 		}
@@ -213,7 +680,7 @@ bool MUtils::Hash::Keccak::selfTest(void)
 			QByteArray result = hash.finalize();
 			if(!result.isEmpty())
 			{
-				passed[3] = (_stricmp(result.toHex().constData(), "d135bb84d0439dbac432247ee573a23ea7d3c9deb2a968eb31d47c4fb45f1ef4422d6c531b5b9bd6f449ebcc449ea94d0a8f05f62130fda612da53c79659f609") == 0);
+				passed[3] = (qstricmp(result.toHex().constData(), "d135bb84d0439dbac432247ee573a23ea7d3c9deb2a968eb31d47c4fb45f1ef4422d6c531b5b9bd6f449ebcc449ea94d0a8f05f62130fda612da53c79659f609") == 0);
 				if(!passed[3]) qWarning("MUtils::KeccakHash self-test: Test #4 failed !!!");
 			}
 		}
@@ -54,6 +54,7 @@
 #include <QString>
 #include <QByteArray>
 #include <QFile>
+#include <QList>
 
 namespace MUtils
 {
@@ -107,14 +108,45 @@ namespace MUtils
 			bool init(const HashBits hashBits=hb256);
 
 			static Keccak *create(const HashBits hashBits = hb256, const char *const key = NULL);
+			static size_t compute(const HashBits hashBits, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
 			static bool selfTest(void);
+			static bool hashMulti(const HashBits hashBits, const QList<QByteArray> &messages, QList<QByteArray> &digests, const char *const key = NULL);
 
 		protected:
 			bool m_initialized;
+			bool m_hasInitState;
 			Internal::KeccakImpl::hashState *m_state;
+			Internal::KeccakImpl::hashState *m_initState;
 
 			virtual bool process(const quint8 *const data, const quint32 len);
-			virtual QByteArray finalize(void);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+			virtual QByteArray serialize(void) const;
+			virtual bool deserialize(const QByteArray &data);
+		};
+
+		class MUTILS_API SHA3 : public Hash
+		{
+		public:
+			enum Variant {sha3_224, sha3_256, sha3_384, sha3_512, shake128, shake256};
+
+			SHA3(const Variant variant, const char *const key = NULL);
+			virtual ~SHA3();
+
+			static size_t compute(const Variant variant, const char *const key, const quint8 *const data, const size_t len, quint8 *const out, const size_t outLen);
+
+		protected:
+			const Variant m_variant;
+			bool m_finalized;
+			Internal::KeccakImpl::hashState *m_state;
+			Internal::KeccakImpl::hashState *m_initState;
+
+			virtual bool process(const quint8 *const data, const quint32 len);
+			virtual void reinit(void);
+			virtual size_t finalize_into(quint8 *const out, const size_t len);
+			virtual void finalize_xof_into(quint8 *const out, const size_t len);
+			virtual QByteArray serialize(void) const;
+			virtual bool deserialize(const QByteArray &data);
 		};
 	}
 };
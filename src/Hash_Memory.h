@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//CRT
+#if defined(_MSC_VER) || defined(__MINGW32__)
+#include <malloc.h>
+#else
+#include <stdlib.h>
+#endif
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		namespace Internal
+		{
+			//Allocates a block of memory with the given alignment (must be a power of two); returns NULL on failure
+			static inline void *alloc_aligned(const size_t size, const size_t alignment)
+			{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+				return _aligned_malloc(size, alignment);
+#else
+				void *ptr = NULL;
+				return (posix_memalign(&ptr, (alignment < sizeof(void*)) ? sizeof(void*) : alignment, size) == 0) ? ptr : NULL;
+#endif
+			}
+
+			//Releases a block of memory that was allocated with alloc_aligned()
+			static inline void free_aligned(void *const ptr)
+			{
+#if defined(_MSC_VER) || defined(__MINGW32__)
+				_aligned_free(ptr);
+#else
+				free(ptr);
+#endif
+			}
+		}
+	}
+}
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Hash.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Hash_Parallel.h"
+
+//Qt
+#include <QVector>
+
+//CRT
+#include <exception>
+
+static const quint32 PARALLEL_MIN_SIZE = 65536U; //Smaller chunks are not worth the thread hand-off
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class MultiHash_Private
+		{
+			friend class MultiHash;
+
+		protected:
+			QList<quint16> hashIds;
+			QVector<Hash*> hashes;
+			QVector<char> results;
+			QVector<std::exception_ptr> errors;
+			size_t digestSize;
+			bool parallel;
+		};
+	}
+}
+
+namespace
+{
+	typedef struct
+	{
+		MUtils::Hash::Hash *const *hashes;
+		char *results;
+		std::exception_ptr *errors;
+		const quint8 *data;
+		quint32 len;
+	}
+	multi_task_t;
+
+	static void multi_update(void *arg, const size_t index)
+	{
+		multi_task_t *const task = reinterpret_cast<multi_task_t*>(arg);
+		try
+		{
+			task->results[index] = task->hashes[index]->update(task->data, task->len) ? 1 : 0;
+		}
+		catch(...)
+		{
+			task->errors[index] = std::current_exception(); //re-thrown on the calling thread
+			task->results[index] = 0;
+		}
+	}
+}
+
+MUtils::Hash::MultiHash::MultiHash(const QList<quint16> &hashIds, const bool bParallel, const char *const key)
+:
+	p(new MultiHash_Private())
+{
+	if(hashIds.isEmpty())
+	{
+		delete p;
+		MUTILS_THROW("List of hash algorithm identifiers must not be empty!");
+	}
+
+	p->hashIds = hashIds;
+	p->parallel = bParallel;
+	p->results.resize(hashIds.count());
+	p->errors.resize(hashIds.count());
+	p->digestSize = 0;
+
+	try
+	{
+		for(QList<quint16>::ConstIterator iter = hashIds.constBegin(); iter != hashIds.constEnd(); ++iter)
+		{
+			p->hashes.append(create(*iter, key));
+			p->digestSize += MUtils::Hash::digest_size(*iter);
+		}
+	}
+	catch(...)
+	{
+		for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+		{
+			delete (*iter);
+		}
+		delete p;
+		throw;
+	}
+}
+
+MUtils::Hash::MultiHash::~MultiHash(void)
+{
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		delete (*iter);
+	}
+	delete p;
+}
+
+const QList<quint16> &MUtils::Hash::MultiHash::hashIds(void) const
+{
+	return p->hashIds;
+}
+
+size_t MUtils::Hash::MultiHash::digest_size(void) const
+{
+	return p->digestSize;
+}
+
+bool MUtils::Hash::MultiHash::process(const quint8 *const data, const quint32 len)
+{
+	const int count = p->hashes.count();
+
+	if(p->parallel && (count > 1) && (len >= PARALLEL_MIN_SIZE))
+	{
+		multi_task_t task = { p->hashes.constData(), p->results.data(), p->errors.data(), data, len };
+		Internal::parallel_for(multi_update, &task, size_t(count));
+		for(int i = 0; i < count; ++i)
+		{
+			if(p->errors[i])
+			{
+				const std::exception_ptr error = p->errors[i];
+				p->errors.fill(std::exception_ptr());
+				std::rethrow_exception(error); //same behavior as in sequential mode
+			}
+		}
+		for(int i = 0; i < count; ++i)
+		{
+			if(!p->results[i])
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool success = true;
+	for(int i = 0; i < count; ++i)
+	{
+		if(!p->hashes[i]->update(data, len))
+		{
+			success = false;
+		}
+	}
+	return success;
+}
+
+void MUtils::Hash::MultiHash::reinit(void)
+{
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		(*iter)->reset();
+	}
+}
+
+QList<QByteArray> MUtils::Hash::MultiHash::digests(const bool bAsHex)
+{
+	QList<QByteArray> result;
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		result.append((*iter)->digest(bAsHex));
+	}
+	return result;
+}
+
+QByteArray MUtils::Hash::MultiHash::finalize(void)
+{
+	QByteArray result;
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		result.append((*iter)->digest(false));
+	}
+	return result;
+}
+
+size_t MUtils::Hash::MultiHash::finalize_into(quint8 *const out, const size_t len)
+{
+	if(len < p->digestSize)
+	{
+		MUTILS_THROW("MultiHash output buffer is too small!");
+	}
+
+	size_t offset = 0;
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		offset += (*iter)->digest_into(out + offset, len - offset);
+	}
+	return offset;
+}
+
+size_t MUtils::Hash::MultiHash::finalize_hex_into(char *const out, const size_t len)
+{
+	if(len < 2U * p->digestSize)
+	{
+		MUTILS_THROW("MultiHash output buffer is too small!");
+	}
+
+	size_t offset = 0;
+	for(QVector<Hash*>::ConstIterator iter = p->hashes.constBegin(); iter != p->hashes.constEnd(); ++iter)
+	{
+		offset += (*iter)->digest_hex_into(out + offset, len - offset);
+	}
+	return offset;
+}
@@ -0,0 +1,93 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "Hash_Parallel.h"
+
+//Qt
+#include <QThreadPool>
+#include <QRunnable>
+#include <QSemaphore>
+
+namespace
+{
+	class ParallelTask : public QRunnable
+	{
+	public:
+		ParallelTask(MUtils::Hash::Internal::parallel_task_t task, void *const arg, const size_t index, QSemaphore *const done)
+		:
+			m_task(task), m_arg(arg), m_index(index), m_done(done)
+		{
+			setAutoDelete(true);
+		}
+
+	protected:
+		virtual void run(void)
+		{
+			m_task(m_arg, m_index);
+			m_done->release();
+		}
+
+	private:
+		const MUtils::Hash::Internal::parallel_task_t m_task;
+		void *const m_arg;
+		const size_t m_index;
+		QSemaphore *const m_done;
+	};
+}
+
+void MUtils::Hash::Internal::parallel_for(parallel_task_t task, void *arg, const size_t count)
+{
+	if(count < 2)
+	{
+		if(count > 0)
+		{
+			task(arg, 0);
+		}
+		return;
+	}
+
+	QSemaphore done;
+	QThreadPool *const pool = QThreadPool::globalInstance();
+	int pending = 0;
+
+	//Hand off tasks #1 to #N-1, but never wait for a free thread (we may be running inside the pool ourselves!)
+	for(size_t i = 1; i < count; ++i)
+	{
+		ParallelTask *const runnable = new ParallelTask(task, arg, i, &done);
+		if(pool->tryStart(runnable))
+		{
+			++pending;
+		}
+		else
+		{
+			delete runnable;
+			task(arg, i);
+		}
+	}
+
+	//Task #0 always runs on the calling thread
+	task(arg, 0);
+
+	if(pending > 0)
+	{
+		done.acquire(pending);
+	}
+}
@@ -0,0 +1,219 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "Hash_State.h"
+
+//MUtils
+#include <MUtils/Hash.h>
+
+#include <string.h>
+
+static const char STATE_MAGIC[4] = { 'M', 'U', 'H', 'S' };
+static const size_t STATE_HEADER_SIZE = 12U;
+static const size_t STATE_TRAILER_SIZE = 4U;
+
+static inline void store_le(quint8 *const out, const quint64 value, const size_t len)
+{
+	for(size_t i = 0; i < len; ++i)
+	{
+		out[i] = quint8(value >> (8U * i));
+	}
+}
+
+static inline quint64 load_le(const quint8 *const in, const size_t len)
+{
+	quint64 value = 0;
+	for(size_t i = 0; i < len; ++i)
+	{
+		value |= quint64(in[i]) << (8U * i);
+	}
+	return value;
+}
+
+static quint32 state_checksum(const quint8 *const data, const size_t len)
+{
+	quint8 crc[4];
+	MUtils::Hash::compute(MUtils::Hash::HASH_CRC32C, data, len, crc, sizeof(crc));
+	return quint32(crc[0]) << 24 | quint32(crc[1]) << 16 | quint32(crc[2]) << 8 | quint32(crc[3]);
+}
+
+// ==========================================================================
+// State Writer
+// ==========================================================================
+
+MUtils::Hash::Internal::StateWriter::StateWriter(const quint16 hashId)
+:
+	m_hashId(hashId)
+{
+}
+
+void MUtils::Hash::Internal::StateWriter::put_u8(const quint8 value)
+{
+	m_payload.append(char(value));
+}
+
+void MUtils::Hash::Internal::StateWriter::put_u32(const quint32 value)
+{
+	quint8 buffer[4];
+	store_le(buffer, value, sizeof(buffer));
+	put_bytes(buffer, sizeof(buffer));
+}
+
+void MUtils::Hash::Internal::StateWriter::put_u64(const quint64 value)
+{
+	quint8 buffer[8];
+	store_le(buffer, value, sizeof(buffer));
+	put_bytes(buffer, sizeof(buffer));
+}
+
+void MUtils::Hash::Internal::StateWriter::put_bytes(const quint8 *const data, const size_t len)
+{
+	m_payload.append((const char*)data, int(len));
+}
+
+QByteArray MUtils::Hash::Internal::StateWriter::finish(void) const
+{
+	const size_t payloadSize = size_t(m_payload.size());
+	QByteArray result(int(STATE_HEADER_SIZE + payloadSize + STATE_TRAILER_SIZE), '\0');
+	quint8 *const ptr = (quint8*) result.data();
+
+	memcpy(ptr, STATE_MAGIC, sizeof(STATE_MAGIC));
+	store_le(ptr + 4U, STATE_FORMAT_VERSION, 2U);
+	store_le(ptr + 6U, m_hashId, 2U);
+	store_le(ptr + 8U, payloadSize, 4U);
+	memcpy(ptr + STATE_HEADER_SIZE, m_payload.constData(), payloadSize);
+	store_le(ptr + STATE_HEADER_SIZE + payloadSize, state_checksum(ptr, STATE_HEADER_SIZE + payloadSize), 4U);
+
+	return result;
+}
+
+// ==========================================================================
+// State Reader
+// ==========================================================================
+
+//Returns the reason why the serialized state is invalid, or NULL if it is valid
+static const char *state_error(const quint8 *const data, const size_t size, const quint16 hashId)
+{
+	if(size < STATE_HEADER_SIZE + STATE_TRAILER_SIZE)
+	{
+		return "is truncated";
+	}
+	if(memcmp(data, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0)
+	{
+		return "has an invalid signature";
+	}
+	if(load_le(data + 4U, 2U) != MUtils::Hash::Internal::STATE_FORMAT_VERSION)
+	{
+		return "has an unsupported format version";
+	}
+	if(load_le(data + 6U, 2U) != hashId)
+	{
+		return "belongs to a different hash algorithm";
+	}
+	if(load_le(data + 8U, 4U) != quint64(size - STATE_HEADER_SIZE - STATE_TRAILER_SIZE))
+	{
+		return "has an invalid size";
+	}
+	if(load_le(data + size - STATE_TRAILER_SIZE, 4U) != state_checksum(data, size - STATE_TRAILER_SIZE))
+	{
+		return "is corrupted (checksum mismatch)";
+	}
+	return NULL;
+}
+
+MUtils::Hash::Internal::StateReader::StateReader(const QByteArray &state, const quint16 hashId, const bool quiet)
+:
+	m_data((const quint8*) state.constData()),
+	m_pos(STATE_HEADER_SIZE),
+	m_end(0),
+	m_valid(false)
+{
+	const size_t size = size_t(state.size());
+	if(const char *const error = state_error(m_data, size, hashId))
+	{
+		if(!quiet)
+		{
+			qWarning("Serialized hash state %s!", error);
+		}
+		return;
+	}
+
+	m_end = size - STATE_TRAILER_SIZE;
+	m_valid = true;
+}
+
+bool MUtils::Hash::Internal::StateReader::get_u8(quint8 &value)
+{
+	if(!m_valid || (m_end - m_pos < 1U))
+	{
+		return false;
+	}
+	value = m_data[m_pos++];
+	return true;
+}
+
+bool MUtils::Hash::Internal::StateReader::get_u32(quint32 &value)
+{
+	if(!m_valid || (m_end - m_pos < 4U))
+	{
+		return false;
+	}
+	value = quint32(load_le(m_data + m_pos, 4U));
+	m_pos += 4U;
+	return true;
+}
+
+bool MUtils::Hash::Internal::StateReader::get_u64(quint64 &value)
+{
+	if(!m_valid || (m_end - m_pos < 8U))
+	{
+		return false;
+	}
+	value = load_le(m_data + m_pos, 8U);
+	m_pos += 8U;
+	return true;
+}
+
+bool MUtils::Hash::Internal::StateReader::get_bytes(quint8 *const data, const size_t len)
+{
+	if(!m_valid || (m_end - m_pos < len))
+	{
+		return false;
+	}
+	memcpy(data, m_data + m_pos, len);
+	m_pos += len;
+	return true;
+}
+
+size_t MUtils::Hash::Internal::StateReader::peek(const quint8 *const data, const size_t len, quint16 &hashId)
+{
+	if((len < STATE_HEADER_SIZE + STATE_TRAILER_SIZE) || (memcmp(data, STATE_MAGIC, sizeof(STATE_MAGIC)) != 0) || (load_le(data + 4U, 2U) != STATE_FORMAT_VERSION))
+	{
+		return 0;
+	}
+	const quint64 size = STATE_HEADER_SIZE + load_le(data + 8U, 4U) + STATE_TRAILER_SIZE;
+	if(size > quint64(len))
+	{
+		return 0;
+	}
+	hashId = quint16(load_le(data + 6U, 2U));
+	return size_t(size);
+}
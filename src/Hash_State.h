@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Qt
+#include <QByteArray>
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		namespace Internal
+		{
+			//Serialized states are wrapped as: "MUHS" magic, format version (u16), hash algorithm identifier (u16), payload size (u32), payload, CRC-32C of all preceding bytes (u32)
+			//All integers are stored in little-endian byte order, so a state can be restored on a different platform or with a different SIMD implementation
+			static const quint16 STATE_FORMAT_VERSION = 1U;
+
+			class StateWriter
+			{
+			public:
+				StateWriter(const quint16 hashId);
+
+				void put_u8(const quint8 value);
+				void put_u32(const quint32 value);
+				void put_u64(const quint64 value);
+				void put_bytes(const quint8 *const data, const size_t len);
+
+				QByteArray finish(void) const;
+
+			private:
+				const quint16 m_hashId;
+				QByteArray m_payload;
+			};
+
+			class StateReader
+			{
+			public:
+				StateReader(const QByteArray &state, const quint16 hashId, const bool quiet = false); //quiet: do not warn, if the state is invalid
+
+				bool isValid(void) const { return m_valid; }
+				bool atEnd(void) const { return m_valid && (m_pos == m_end); }
+
+				bool get_u8(quint8 &value);
+				bool get_u32(quint32 &value);
+				bool get_u64(quint64 &value);
+				bool get_bytes(quint8 *const data, const size_t len);
+
+				//Returns the total size of the serialized state at the beginning of the buffer (which may hold further data), or zero if the header is invalid or the state is truncated
+				static size_t peek(const quint8 *const data, const size_t len, quint16 &hashId);
+
+			private:
+				const quint8 *m_data;
+				size_t m_pos, m_end;
+				bool m_valid;
+			};
+		}
+	}
+}
@@ -0,0 +1,490 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Hash.h>
+#include <MUtils/CPUFeatures.h>
+#include <MUtils/Exception.h>
+
+//Internal
+#include "Hash_State.h"
+
+//Qt
+#include <QThread>
+#include <QFile>
+#include <QFileInfo>
+#include <QVector>
+#include <QScopedPointer>
+
+//CRT
+#include <limits>
+#include <string.h>
+
+static const quint8  LEAF_PREFIX    = 0x00;       //Domain separation between leaves and inner nodes (as in RFC 6962)
+static const quint8  NODE_PREFIX    = 0x01;
+static const quint32 MIN_CHUNK_SIZE = 4096U;
+static const quint32 MAX_CHUNK_SIZE = 1073741824U;
+
+namespace MUtils
+{
+	namespace Hash
+	{
+		class HashTree_Private
+		{
+			friend class HashTree;
+
+		protected:
+			const char *keyPtr(void) const { return hasKey ? key.constData() : NULL; }
+
+			quint16 hashId;
+			quint32 chunkSize;
+			size_t digestSize;
+			QByteArray key;
+			bool hasKey;
+			qint64 fileSize;
+			quint32 chunkCount;
+			QByteArray leaves; //all leaf digests, concatenated
+			QByteArray root;
+		};
+	}
+}
+
+namespace
+{
+	typedef struct
+	{
+		const QString *filePath;
+		qint64 fileSize;
+		quint32 chunkSize;
+		quint16 hashId;
+		const char *key;
+		size_t digestSize;
+		const quint32 *indices; //chunks to be hashed; if NULL, chunks 0 to count-1
+		int count;
+		quint8 *output;         //receives count digests, in the order of the indices
+	}
+	tree_job_t;
+
+	class TreeWorker : public QThread
+	{
+	public:
+		TreeWorker(const tree_job_t &job, QAtomicInt &next, QAtomicInt &failed)
+		:
+			m_job(job), m_next(next), m_failed(failed)
+		{
+		}
+
+	protected:
+		virtual void run(void)
+		{
+			try
+			{
+				if (!hashChunks())
+				{
+					m_failed.ref();
+				}
+			}
+			catch (const std::exception &error)
+			{
+				qWarning("Failed to hash chunk: %s", error.what());
+				m_failed.ref();
+			}
+			catch (...)
+			{
+				qWarning("Failed to hash chunk: unknown exception!");
+				m_failed.ref();
+			}
+		}
+
+	private:
+		//Each worker uses its own QFile and Hash instance; the chunks are handed out via a shared counter
+		bool hashChunks(void)
+		{
+			QFile file(*m_job.filePath);
+			if (!file.open(QIODevice::ReadOnly))
+			{
+				qWarning("Failed to open file for hashing!");
+				return false;
+			}
+
+			QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(m_job.hashId, m_job.key));
+			for (;;)
+			{
+				const int k = m_next.fetchAndAddOrdered(1);
+				if ((k >= m_job.count) || (!!m_failed))
+				{
+					return true;
+				}
+				const qint64 offset = qint64(m_job.indices ? m_job.indices[k] : quint32(k)) * m_job.chunkSize;
+				const qint64 length = qBound(qint64(0), m_job.fileSize - offset, qint64(m_job.chunkSize));
+				hash->reset();
+				if (!(hash->update(&LEAF_PREFIX, 1U) && hash->update(file, offset, length) && (file.pos() == offset + length)))
+				{
+					qWarning("Failed to read chunk from file!");
+					return false;
+				}
+				hash->digest_into(m_job.output + (size_t(k) * m_job.digestSize), m_job.digestSize);
+			}
+		}
+
+		const tree_job_t &m_job;
+		QAtomicInt &m_next;
+		QAtomicInt &m_failed;
+	};
+}
+
+static bool tree_hash_chunks(const tree_job_t &job, const quint32 &threads)
+{
+	if (job.count < 1)
+	{
+		return true;
+	}
+
+	QAtomicInt next, failed;
+	const int workerCount = qBound(1, int((threads > 0) ? threads : MUtils::CPUFetaures::detect().count), job.count);
+	QList<TreeWorker*> workers;
+	for (int i = 0; i < workerCount; ++i)
+	{
+		workers.append(new TreeWorker(job, next, failed));
+		workers.last()->start();
+	}
+	while (!workers.isEmpty())
+	{
+		TreeWorker *const worker = workers.takeFirst();
+		worker->wait();
+		delete worker;
+	}
+
+	return !failed;
+}
+
+//An empty file consists of a single (empty) chunk; returns zero, if the leaf digests would not fit into a QByteArray
+static quint32 tree_chunk_count(const qint64 fileSize, const quint32 chunkSize, const size_t digestSize)
+{
+	const qint64 count = qMax(qint64(1), (fileSize + chunkSize - 1) / chunkSize);
+	if (count > qint64(std::numeric_limits<int>::max() / digestSize))
+	{
+		qWarning("File is too big for the chosen chunk size!");
+		return 0;
+	}
+	return quint32(count);
+}
+
+//Combines the leaves pair-wise, level by level; an unpaired node is passed on to the next level unchanged
+static QByteArray tree_compute_root(const quint16 hashId, const size_t digestSize, const char *const key, const QByteArray &leaves)
+{
+	QByteArray level(leaves);
+	quint8 *const ptr = (quint8*) level.data();
+	quint8 node[1U + 2U * MUtils::Hash::DIGEST_MAX_SIZE];
+	node[0] = NODE_PREFIX;
+
+	size_t count = size_t(leaves.size()) / digestSize;
+	while (count > 1U)
+	{
+		size_t out = 0;
+		for (size_t i = 0; i < count; i += 2U, ++out)
+		{
+			if (i + 1U < count)
+			{
+				memcpy(node + 1U, ptr + (i * digestSize), 2U * digestSize);
+				MUtils::Hash::compute(hashId, node, 1U + (2U * digestSize), ptr + (out * digestSize), digestSize, key);
+			}
+			else
+			{
+				memmove(ptr + (out * digestSize), ptr + (i * digestSize), digestSize);
+			}
+		}
+		count = out;
+	}
+
+	return level.left(int(digestSize));
+}
+
+// ==========================================================================
+// Hash Tree
+// ==========================================================================
+
+MUtils::Hash::HashTree::HashTree(const quint16 &hashId, const quint32 &chunkSize, const char *const key)
+:
+	p(new HashTree_Private())
+{
+	if ((chunkSize < MIN_CHUNK_SIZE) || (chunkSize > MAX_CHUNK_SIZE))
+	{
+		delete p;
+		MUTILS_THROW("Chunk size is out of range!");
+	}
+
+	try
+	{
+		p->digestSize = digest_size(hashId);
+	}
+	catch (...)
+	{
+		delete p;
+		throw;
+	}
+
+	p->hashId = hashId;
+	p->chunkSize = chunkSize;
+	p->hasKey = (key != NULL);
+	if (key)
+	{
+		p->key = QByteArray(key);
+	}
+	p->fileSize = 0;
+	p->chunkCount = 0;
+}
+
+MUtils::Hash::HashTree::~HashTree(void)
+{
+	delete p;
+}
+
+bool MUtils::Hash::HashTree::build(const QString &filePath, const quint32 &threads)
+{
+	const QFileInfo info(filePath);
+	const qint64 fileSize = info.size();
+	const quint32 chunkCount = (info.exists() && info.isFile()) ? tree_chunk_count(fileSize, p->chunkSize, p->digestSize) : 0U;
+
+	QByteArray leaves(int(chunkCount * p->digestSize), '\0');
+	const tree_job_t job = { &filePath, fileSize, p->chunkSize, p->hashId, p->keyPtr(), p->digestSize, NULL, int(chunkCount), (quint8*) leaves.data() };
+	if ((chunkCount < 1U) || (!tree_hash_chunks(job, threads)))
+	{
+		p->fileSize = 0;
+		p->chunkCount = 0;
+		p->leaves.clear();
+		p->root.clear();
+		return false;
+	}
+
+	p->fileSize = fileSize;
+	p->chunkCount = chunkCount;
+	p->leaves = leaves;
+	p->root = tree_compute_root(p->hashId, p->digestSize, p->keyPtr(), p->leaves);
+	return true;
+}
+
+bool MUtils::Hash::HashTree::update(const QString &filePath, const qint64 &offset, const qint64 &length, const quint32 &threads)
+{
+	if (p->chunkCount < 1U)
+	{
+		return build(filePath, threads);
+	}
+	if ((offset < 0) || (length < 0))
+	{
+		qWarning("Invalid range specified!");
+		return false;
+	}
+
+	const QFileInfo info(filePath);
+	const qint64 fileSize = info.size();
+	const quint32 chunkCount = (info.exists() && info.isFile()) ? tree_chunk_count(fileSize, p->chunkSize, p->digestSize) : 0U;
+	if (chunkCount < 1U)
+	{
+		return build(filePath, threads);
+	}
+
+	//Collect the dirty chunks: those overlapping with the modified range, plus the "tail" if the file size has changed
+	QVector<quint32> dirty;
+	quint32 tailFirst = chunkCount;
+	if (fileSize != p->fileSize)
+	{
+		tailFirst = qMin(p->chunkCount, chunkCount) - 1U;
+	}
+	if ((length > 0) && (offset < fileSize))
+	{
+		const quint32 first = quint32(offset / p->chunkSize);
+		const quint32 last  = quint32(qMin(offset + length - 1, fileSize - 1) / p->chunkSize);
+		for (quint32 i = first; (i <= last) && (i < tailFirst); ++i)
+		{
+			dirty.append(i);
+		}
+	}
+	for (quint32 i = tailFirst; i < chunkCount; ++i)
+	{
+		dirty.append(i);
+	}
+
+	QByteArray digests(int(dirty.count() * p->digestSize), '\0');
+	const tree_job_t job = { &filePath, fileSize, p->chunkSize, p->hashId, p->keyPtr(), p->digestSize, dirty.constData(), dirty.count(), (quint8*) digests.data() };
+	if (!tree_hash_chunks(job, threads))
+	{
+		p->fileSize = 0;
+		p->chunkCount = 0;
+		p->leaves.clear();
+		p->root.clear();
+		return false;
+	}
+
+	p->leaves.resize(int(chunkCount * p->digestSize));
+	for (int k = 0; k < dirty.count(); ++k)
+	{
+		memcpy(p->leaves.data() + (size_t(dirty[k]) * p->digestSize), digests.constData() + (size_t(k) * p->digestSize), p->digestSize);
+	}
+
+	p->fileSize = fileSize;
+	p->chunkCount = chunkCount;
+	p->root = tree_compute_root(p->hashId, p->digestSize, p->keyPtr(), p->leaves);
+	return true;
+}
+
+bool MUtils::Hash::HashTree::verify(const QString &filePath, QList<quint32> &mismatched, const quint32 &threads) const
+{
+	mismatched.clear();
+	if (p->chunkCount < 1U)
+	{
+		qWarning("Hash tree is empty, nothing to verify!");
+		return false;
+	}
+
+	const QFileInfo info(filePath);
+	const qint64 fileSize = info.size();
+	const quint32 chunkCount = (info.exists() && info.isFile()) ? tree_chunk_count(fileSize, p->chunkSize, p->digestSize) : 0U;
+	if (chunkCount < 1U)
+	{
+		return false;
+	}
+
+	QByteArray digests(int(chunkCount * p->digestSize), '\0');
+	const tree_job_t job = { &filePath, fileSize, p->chunkSize, p->hashId, p->keyPtr(), p->digestSize, NULL, int(chunkCount), (quint8*) digests.data() };
+	if (!tree_hash_chunks(job, threads))
+	{
+		return false;
+	}
+
+	const quint32 maxCount = qMax(chunkCount, p->chunkCount);
+	for (quint32 i = 0; i < maxCount; ++i)
+	{
+		if ((i >= chunkCount) || (i >= p->chunkCount) || (memcmp(digests.constData() + (size_t(i) * p->digestSize), p->leaves.constData() + (size_t(i) * p->digestSize), p->digestSize) != 0))
+		{
+			mismatched.append(i);
+		}
+	}
+	return true;
+}
+
+bool MUtils::Hash::HashTree::save(const QString &sidecarPath) const
+{
+	if (p->chunkCount < 1U)
+	{
+		qWarning("Hash tree is empty, nothing to save!");
+		return false;
+	}
+
+	Internal::StateWriter writer(p->hashId);
+	writer.put_u32(p->chunkSize);
+	writer.put_u64(quint64(p->fileSize));
+	writer.put_u32(p->chunkCount);
+	writer.put_u32(quint32(p->digestSize));
+	writer.put_bytes((const quint8*) p->leaves.constData(), size_t(p->leaves.size()));
+	const QByteArray data = writer.finish();
+
+	QFile file(sidecarPath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		qWarning("Failed to open sidecar file for writing!");
+		return false;
+	}
+	const bool success = (file.write(data) == qint64(data.size())) && file.flush();
+	file.close();
+	return success;
+}
+
+bool MUtils::Hash::HashTree::load(const QString &sidecarPath)
+{
+	QByteArray data;
+	{
+		QFile file(sidecarPath);
+		if (!file.open(QIODevice::ReadOnly))
+		{
+			qWarning("Failed to open sidecar file for reading!");
+			return false;
+		}
+		data = file.readAll();
+		file.close();
+	}
+
+	Internal::StateReader reader(data, p->hashId);
+	quint32 chunkSize = 0, chunkCount = 0, digestSize = 0;
+	quint64 fileSize = 0;
+	bool success = reader.isValid() && reader.get_u32(chunkSize) && reader.get_u64(fileSize) && reader.get_u32(chunkCount) && reader.get_u32(digestSize);
+	success = success && (chunkSize >= MIN_CHUNK_SIZE) && (chunkSize <= MAX_CHUNK_SIZE) && (digestSize == p->digestSize) && (fileSize <= quint64(std::numeric_limits<qint64>::max()));
+	success = success && (chunkCount > 0U) && (chunkCount == tree_chunk_count(qint64(fileSize), chunkSize, p->digestSize));
+
+	QByteArray leaves;
+	if (success)
+	{
+		leaves.resize(int(chunkCount * p->digestSize));
+		success = reader.get_bytes((quint8*) leaves.data(), size_t(leaves.size())) && reader.atEnd();
+	}
+	if (!success)
+	{
+		qWarning("Failed to load the hash tree from sidecar file!");
+		return false;
+	}
+
+	p->chunkSize = chunkSize;
+	p->fileSize = qint64(fileSize);
+	p->chunkCount = chunkCount;
+	p->leaves = leaves;
+	p->root = tree_compute_root(p->hashId, p->digestSize, p->keyPtr(), p->leaves);
+	return true;
+}
+
+bool MUtils::Hash::HashTree::isEmpty(void) const
+{
+	return (p->chunkCount < 1U);
+}
+
+quint16 MUtils::Hash::HashTree::hashId(void) const
+{
+	return p->hashId;
+}
+
+quint32 MUtils::Hash::HashTree::chunkSize(void) const
+{
+	return p->chunkSize;
+}
+
+qint64 MUtils::Hash::HashTree::fileSize(void) const
+{
+	return p->fileSize;
+}
+
+quint32 MUtils::Hash::HashTree::chunkCount(void) const
+{
+	return p->chunkCount;
+}
+
+QByteArray MUtils::Hash::HashTree::leaf(const quint32 &index, const bool bAsHex) const
+{
+	if (index >= p->chunkCount)
+	{
+		MUTILS_THROW("Chunk index is out of range!");
+	}
+	const QByteArray digest = p->leaves.mid(int(index * p->digestSize), int(p->digestSize));
+	return bAsHex ? to_hex(digest) : digest;
+}
+
+QByteArray MUtils::Hash::HashTree::root(const bool bAsHex) const
+{
+	return bAsHex ? to_hex(p->root) : p->root;
+}
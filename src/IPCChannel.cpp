@@ -21,9 +21,12 @@
 
 //MUtils
 #include <MUtils/IPCChannel.h>
+#include <MUtils/IPCChannelNotifier.h>
 #include <MUtils/Exception.h>
+#include <MUtils/OSSupport.h>
 
 //Internal
+#include "IPCChannel_Sync.h"
 #include "3rd_party/adler32/include/adler32.h"
 
 //Qt includes
@@ -34,89 +37,112 @@
 #include <QWriteLocker>
 #include <QCryptographicHash>
 #include <QStringList>
+#include <QElapsedTimer>
+#include <QThread>
 //CRT
 #include <cassert>
 
 ///////////////////////////////////////////////////////////////////////////////
-// UTILITIES
+// TYPES
 ///////////////////////////////////////////////////////////////////////////////
 
 namespace MUtils
 {
 	namespace Internal
 	{
+		static const size_t HDR_LEN = 40;
+		static const quint32 IPC_RING_SIZE = 1048576U; //must be a power of two
+		static const quint32 IPC_LAYOUT_VERSION = 8;
+		static const quint32 IPC_MAX_SUBSCRIBERS = 64;
+		static const quint32 IPC_SPIN_COUNT = 1024;
+		static const qint32 IPC_POLL_INTERVAL = 2;
 		static const quint32 ADLER_SEED = 0x5D90C356;
+		static const quint32 IPC_MARK_COMMITTED = 1U;
+		static const quint32 IPC_MARK_RELEASED = 2U;
+		static const quint32 IPC_MARK_PENDING = 3U;
+		static const quint64 IPC_RECORD_FILLER = quint64(1) << 63; //set in the timestamp of a filler record, see FILL_RANGE()
 
-		template<class T>
-		static inline void UPDATE_CHECKSUM(T &data)
+		typedef struct
 		{
-			data.checksum = Internal::adler32(ADLER_SEED, &data.payload, sizeof(data.payload));
+			quint32 length;    //length of the payload, in bytes
+			quint32 checksum;  //Adler-32 of the payload
+			quint64 timestamp; //ring position of the record
 		}
+		ipc_record_t;
 
-		template<class T>
-		static inline bool VERIFY_CHECKSUM(const T &data)
+		typedef struct
 		{
-			return (data.checksum == Internal::adler32(ADLER_SEED, &data.payload, sizeof(data.payload)));
+			quint32 command_id;
+			quint32 flags;
+			quint32 buffer;
+			quint32 buffer_size;
+			quint32 param_count;
 		}
-	}
-}
-
-///////////////////////////////////////////////////////////////////////////////
-// TYPES
-///////////////////////////////////////////////////////////////////////////////
-
-namespace MUtils
-{
-	namespace Internal
-	{
-		static const size_t HDR_LEN = 40;
-		static const size_t IPC_SLOTS = 128;
+		ipc_record_data_t; //followed by "param_count" times: quint32 length + UTF-8 characters
 
 		typedef struct
 		{
-			quint64 counter;
-			quint32 pos_wr;
-			quint32 pos_rd;
+			ipc_word_t pos;         //free-running position in the ring (bytes), only ever advanced by the owning side
+			ipc_word_t waiters;     //number of threads that are sleeping until "pos" changes
+			ipc_word_t wakeup;      //incremented on every wake-up (futex word)
+			quint32    padding[13]; //one cache line per cursor, so that the producer and the consumer do not contend
 		}
-		ipc_status_data_t;
+		ipc_cursor_t;
 
 		typedef struct
 		{
-			ipc_status_data_t payload;
-			quint32           checksum;
+			ipc_word_t mark;        //mark of the range that starts in this slot, see COMMIT_RANGE()
+			ipc_word_t owner;       //process ID of the sender (reader) that has reserved (claimed) the range
 		}
-		ipc_status_t;
+		ipc_range_t;
 
 		typedef struct
 		{
-			char    values[MUtils::IPCChannel::MAX_PARAM_CNT][MUtils::IPCChannel::MAX_PARAM_LEN];
-			quint32 count;
+			ipc_word_t active;      //process ID of the subscriber that owns the slot, or zero
+			ipc_word_t pos;         //position of the next record to be read by this subscriber
+			ipc_word_t overflows;   //number of times this subscriber has fallen behind the senders
+			quint32    padding[13];
 		}
-		ipc_msg_data_params_t;
+		ipc_subscriber_t;
 
 		typedef struct
 		{
-			quint32               command_id;
-			quint32               flags;
-			ipc_msg_data_params_t params;
-			quint64               timestamp;
+			char             header[HDR_LEN];
+			quint32          mode;
+			quint32          buffers;      //non-zero, if the channel has been created with shared buffers
+			quint32          reserved[4];
+			ipc_cursor_t     cursor_wr;    //end of the committed records
+			ipc_cursor_t     cursor_rd;    //end of the released records (not used in MODE_PUBSUB)
+			ipc_cursor_t     cursor_res;   //end of the reserved records (MODE_MPMC and MODE_PUBSUB only)
+			ipc_cursor_t     cursor_claim; //end of the claimed records (MODE_MPMC only)
+			ipc_subscriber_t subscribers[IPC_MAX_SUBSCRIBERS]; //MODE_PUBSUB only
+			ipc_range_t      ranges[IPC_RING_SIZE / 8U];       //one per 8-byte slot of the ring (MODE_MPMC and MODE_PUBSUB only)
+			quint8           data[IPC_RING_SIZE];
 		}
-		ipc_msg_data_t;
+		ipc_t;
 
 		typedef struct
 		{
-			ipc_msg_data_t payload;
-			quint32        checksum;
+			quint32 command_id;
+			quint32 flags;
+			quint32 buffer;
+			quint32 buffer_size;
+			QList<QByteArray> params;
+			quint32 length;
 		}
-		ipc_msg_t;
+		ipc_pending_t;
+
+		static const size_t IPC_POOL_HDR_LEN = 4096;
+		static const quint32 IPC_BUFFER_SENT = 0xFFFFFFFFU;
 
 		typedef struct
 		{
-			char         header[HDR_LEN];
-			ipc_status_t status;
-			ipc_msg_t    data[IPC_SLOTS];
+			ipc_cursor_t released;                                //"pos" is incremented whenever a buffer has been released
+			ipc_word_t   state[MUtils::IPCChannel::BUFFER_COUNT]; //process ID of the owner, IPC_BUFFER_SENT while in flight, or zero
+			quint8       reserved[IPC_POOL_HDR_LEN - sizeof(ipc_cursor_t) - (sizeof(ipc_word_t) * MUtils::IPCChannel::BUFFER_COUNT)];
+			quint8       data[MUtils::IPCChannel::BUFFER_COUNT][MUtils::IPCChannel::BUFFER_SIZE];
 		}
-		ipc_t;
+		ipc_pool_t;
 	}
 }
 
@@ -142,327 +168,1647 @@ static QString MAKE_ID(const QString &applicationId, const unsigned int &appVers
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// PRIVATE DATA
+// RING BUFFER
 ///////////////////////////////////////////////////////////////////////////////
 
-namespace MUtils
-{
-	class IPCChannel_Private
-	{
-		friend class IPCChannel;
+/*
+ * Messages are stored as variable-length records: an "ipc_record_t" header, followed by the payload. Records are aligned to 8 bytes
+ * and may wrap around the end of the ring, so the copy and checksum costs only depend on the actual size of the message.
+ */
 
-	protected:
-		QAtomicInt initialized;
-		QScopedPointer<QSharedMemory> sharedmem;
-		QScopedPointer<QSystemSemaphore> semaphore_rd;
-		QScopedPointer<QSystemSemaphore> semaphore_wr;
-		QReadWriteLock lock;
-	};
+static inline quint32 RECORD_SIZE(const quint32 &length)
+{
+	return (quint32(sizeof(MUtils::Internal::ipc_record_t)) + length + 7U) & (~7U);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// CONSTRUCTOR & DESTRUCTOR
-///////////////////////////////////////////////////////////////////////////////
+static void RING_WRITE(quint8 *const ring, const quint32 &pos, const void *const data, const quint32 &len)
+{
+	const quint32 offset = pos & (MUtils::Internal::IPC_RING_SIZE - 1U);
+	const quint32 head = qMin(len, MUtils::Internal::IPC_RING_SIZE - offset);
+	memcpy(ring + offset, data, head);
+	if(head < len)
+	{
+		memcpy(ring, reinterpret_cast<const quint8*>(data) + head, len - head);
+	}
+}
 
-MUtils::IPCChannel::IPCChannel(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId)
-:
-	p(new IPCChannel_Private()),
-	m_applicationId(applicationId),
-	m_channelId(channelId),
-	m_appVersionNo(appVersionNo),
-	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, channelId, "header").toLatin1(), QCryptographicHash::Sha1).toHex())
+static void RING_READ(const quint8 *const ring, const quint32 &pos, void *const data, const quint32 &len)
 {
-	if(m_headerStr.length() != Internal::HDR_LEN)
+	const quint32 offset = pos & (MUtils::Internal::IPC_RING_SIZE - 1U);
+	const quint32 head = qMin(len, MUtils::Internal::IPC_RING_SIZE - offset);
+	memcpy(data, ring + offset, head);
+	if(head < len)
 	{
-		MUTILS_THROW("Invalid header length has been detected!");
+		memcpy(reinterpret_cast<quint8*>(data) + head, ring, len - head);
 	}
 }
 
-MUtils::IPCChannel::~IPCChannel(void)
+//Converts the message into its serialized form (outside of any lock); fails, if the message is too large
+static bool PREPARE_MESSAGE(MUtils::Internal::ipc_pending_t &message, const quint32 &command, const quint32 &flags, const QStringList &params, const quint32 &buffer = quint32(MUtils::IPCChannel::NO_BUFFER), const quint32 &buffer_size = 0)
 {
-	if(MUTILS_BOOLIFY(p->initialized))
+	if(quint32(params.count()) > MUtils::IPCChannel::MAX_PARAM_CNT)
 	{
-		if(p->sharedmem->isAttached())
+		return false;
+	}
+
+	message.command_id = command;
+	message.flags = flags;
+	message.buffer = buffer;
+	message.buffer_size = (buffer != MUtils::IPCChannel::NO_BUFFER) ? buffer_size : 0U;
+	message.params.clear();
+	message.length = sizeof(MUtils::Internal::ipc_record_data_t);
+
+	for(QStringList::ConstIterator iter = params.constBegin(); iter != params.constEnd(); ++iter)
+	{
+		message.params.append(iter->trimmed().toUtf8());
+		message.length += quint32(sizeof(quint32)) + quint32(message.params.last().size());
+		if(message.length > MUtils::IPCChannel::MAX_MESSAGE_LEN)
 		{
-			p->sharedmem->detach();
+			return false;
 		}
 	}
 
-	delete p;
+	return true;
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// INITIALIZATION
-///////////////////////////////////////////////////////////////////////////////
-
-int MUtils::IPCChannel::initialize(void)
+//Writes the message to the ring at the given position; the caller must make sure that RECORD_SIZE(message.length) bytes are free
+static void WRITE_MESSAGE(quint8 *const ring, const quint32 &pos, const MUtils::Internal::ipc_pending_t &message)
 {
-	QWriteLocker writeLock(&p->lock);
-	
-	if(MUTILS_BOOLIFY(p->initialized))
+	using namespace MUtils::Internal;
+
+	ipc_record_data_t data;
+	data.command_id = message.command_id;
+	data.flags = message.flags;
+	data.buffer = message.buffer;
+	data.buffer_size = message.buffer_size;
+	data.param_count = quint32(message.params.count());
+
+	quint32 offset = pos + quint32(sizeof(ipc_record_t));
+	quint32 checksum = ADLER_SEED;
+
+	RING_WRITE(ring, offset, &data, sizeof(ipc_record_data_t));
+	checksum = adler32(checksum, &data, sizeof(ipc_record_data_t));
+	offset += sizeof(ipc_record_data_t);
+
+	for(QList<QByteArray>::ConstIterator iter = message.params.constBegin(); iter != message.params.constEnd(); ++iter)
 	{
-		return RET_ALREADY_INITIALIZED;
+		const quint32 len = quint32(iter->size());
+		RING_WRITE(ring, offset, &len, sizeof(quint32));
+		checksum = adler32(checksum, &len, sizeof(quint32));
+		RING_WRITE(ring, offset + quint32(sizeof(quint32)), iter->constData(), len);
+		checksum = adler32(checksum, iter->constData(), len);
+		offset += quint32(sizeof(quint32)) + len;
 	}
 
-	p->sharedmem.   reset(new QSharedMemory   (MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "sharedmem"), 0));
-	p->semaphore_rd.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_rd"), 0));
-	p->semaphore_wr.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_wr"), 0));
+	ipc_record_t record;
+	record.length = message.length;
+	record.checksum = checksum;
+	record.timestamp = pos;
+	RING_WRITE(ring, pos, &record, sizeof(ipc_record_t));
+}
 
-	if(p->semaphore_rd->error() != QSystemSemaphore::NoError)
+static bool PARSE_MESSAGE(const quint8 *const payload, const quint32 &length, MUtils::IPCChannel::ipc_message_t &message)
+{
+	using namespace MUtils::Internal;
+
+	if(length < sizeof(ipc_record_data_t))
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		return false;
 	}
 
-	if(p->semaphore_wr->error() != QSystemSemaphore::NoError)
+	ipc_record_data_t data;
+	memcpy(&data, payload, sizeof(ipc_record_data_t));
+	if((data.param_count > MUtils::IPCChannel::MAX_PARAM_CNT) || ((data.buffer != MUtils::IPCChannel::NO_BUFFER) && ((data.buffer >= MUtils::IPCChannel::BUFFER_COUNT) || (data.buffer_size > MUtils::IPCChannel::BUFFER_SIZE))))
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		return false;
 	}
-	
-	if(!p->sharedmem->create(sizeof(Internal::ipc_t)))
+
+	QStringList values;
+	quint32 offset = sizeof(ipc_record_data_t);
+	for(quint32 i = 0; i < data.param_count; i++)
 	{
-		if(p->sharedmem->error() == QSharedMemory::AlreadyExists)
+		quint32 len;
+		if(length - offset < sizeof(quint32))
 		{
-			if(!p->sharedmem->attach())
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			if(p->sharedmem->error() != QSharedMemory::NoError)
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			if(p->sharedmem->size() < sizeof(Internal::ipc_t))
-			{
-				qWarning("Failed to attach to shared memory: Size verification has failed!");
-				return RET_FAILURE;
-			}
-			if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
-			{
-				if(memcmp(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN) != 0)
-				{
-					qWarning("Failed to attach to shared memory: Header verification has failed!");
-					return RET_FAILURE;
-				}
-			}
-			else
-			{
-				const QString errorMessage = p->sharedmem->errorString();
-				qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
-				return RET_FAILURE;
-			}
-			p->initialized.ref();
-			return RET_SUCCESS_SLAVE;
+			return false;
 		}
-		else
+		memcpy(&len, payload + offset, sizeof(quint32));
+		offset += sizeof(quint32);
+		if(length - offset < len)
 		{
-			const QString errorMessage = p->sharedmem->errorString();
-			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
-			return RET_FAILURE;
+			return false;
 		}
+		values.append(QString::fromUtf8(reinterpret_cast<const char*>(payload + offset), int(len)));
+		offset += len;
 	}
-	
-	if(p->sharedmem->error() != QSharedMemory::NoError)
+
+	message.command = data.command_id;
+	message.flags = data.flags;
+	message.buffer = data.buffer;
+	message.buffer_size = (data.buffer != MUtils::IPCChannel::NO_BUFFER) ? data.buffer_size : 0U;
+	message.params.append(values);
+	return true;
+}
+
+//Returns true, if the senders may have overwritten the ring at the given position already (MODE_PUBSUB only)
+static inline bool IS_OVERRUN(const MUtils::Internal::ipc_word_t *const cursor_res, const quint32 &pos)
+{
+	return cursor_res && ((MUtils::Internal::ipc_load(cursor_res) - pos) > MUtils::Internal::IPC_RING_SIZE);
+}
+
+//Reads the record at the given position; returns the number of bytes to be consumed, which may be *all* pending bytes, if the ring is corrupted
+//If "cursor_res" is given, the record is always copied and validated afterwards; returns zero, if the record was overwritten while reading
+static quint32 READ_MESSAGE(const quint8 *const ring, const quint32 &pos, const quint32 &used, bool &success, MUtils::IPCChannel::ipc_message_t &message, const MUtils::Internal::ipc_word_t *const cursor_res = NULL)
+{
+	using namespace MUtils::Internal;
+
+	success = false;
+
+	ipc_record_t record;
+	RING_READ(ring, pos, &record, sizeof(ipc_record_t));
+	if((record.timestamp == (quint64(pos) | IPC_RECORD_FILLER)) && (record.length <= MUtils::IPCChannel::MAX_MESSAGE_LEN) && (RECORD_SIZE(record.length) <= used))
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		return RECORD_SIZE(record.length); /*the records of a sender that has died, silently skipped*/
 	}
-
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+	if((record.timestamp != pos) || (record.length > MUtils::IPCChannel::MAX_MESSAGE_LEN) || (RECORD_SIZE(record.length) > used))
 	{
-		memset(ptr, 0, sizeof(Internal::ipc_t));
-		memcpy(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN);
-		UPDATE_CHECKSUM(ptr->status);
+		if(IS_OVERRUN(cursor_res, pos))
+		{
+			return 0;
+		}
+		qWarning("Corrupted IPC ring detected -> discarding all pending messages!");
+		return used;
 	}
-	else
+
+	const quint32 offset = (pos + quint32(sizeof(ipc_record_t))) & (IPC_RING_SIZE - 1U);
+	QByteArray buffer;
+	const quint8 *payload = ring + offset;
+	if(cursor_res || (offset + record.length > IPC_RING_SIZE))
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		buffer.resize(int(record.length)); /*the record wraps around (or may be overwritten), so it has to be copied*/
+		RING_READ(ring, offset, buffer.data(), record.length);
+		payload = reinterpret_cast<const quint8*>(buffer.constData());
+		if(cursor_res)
+		{
+			ipc_fence();
+			if(IS_OVERRUN(cursor_res, pos))
+			{
+				return 0;
+			}
+		}
 	}
 
-	if(!p->semaphore_wr->release(Internal::IPC_SLOTS))
+	if((adler32(ADLER_SEED, payload, record.length) == record.checksum) && PARSE_MESSAGE(payload, record.length, message))
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
-		return RET_FAILURE;
+		success = true;
+	}
+	else
+	{
+		qWarning("Malformed or corrupted IPC message, will be ignored!");
 	}
-	
-	//qDebug("IPC KEY #1: %s", MUTILS_UTF8(p->sharedmem->key()));
-	//qDebug("IPC KEY #2: %s", MUTILS_UTF8(p->semaphore_rd->key()));
-	//qDebug("IPC KEY #3: %s", MUTILS_UTF8(p->semaphore_wr->key()));
 
-	p->initialized.ref();
-	return RET_SUCCESS_MASTER;
+	return RECORD_SIZE(record.length);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-// SEND MESSAGE
+// LOCK-FREE CURSORS
 ///////////////////////////////////////////////////////////////////////////////
 
-bool MUtils::IPCChannel::send(const quint32 &command, const quint32 &flags, const QStringList &params)
+/*
+ * The producer side owns "cursor_wr" and the consumer side owns "cursor_rd"; each side only ever reads the other side's cursor.
+ * In MODE_LOCKED, a side is made up of all senders (or readers), which are serialized via the shared memory lock; in MODE_SPSC, there
+ * is no lock at all. The system semaphores (or, on Linux, a futex) are touched only if one side actually has to sleep.
+ */
+
+//Blocks until the cursor has moved away from the given position, or until the timeout (negative means infinite) has expired; may return spuriously
+static void WAIT_CURSOR(MUtils::Internal::ipc_cursor_t *const cursor, const quint32 &position, QSystemSemaphore *const semaphore, const qint32 &timeout_ms)
 {
-	bool success = false;
-	QReadLocker readLock(&p->lock);
+	using namespace MUtils::Internal;
 
-	if(!p->initialized)
+	for(quint32 spin = 0; spin < IPC_SPIN_COUNT; ++spin)
 	{
-		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+		if(ipc_load(&cursor->pos) != position)
+		{
+			return;
+		}
+		ipc_pause();
 	}
 
-	if(!p->semaphore_wr->acquire())
+	if(timeout_ms == 0)
 	{
-		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to acquire system semaphore: %s", MUTILS_UTF8(errorMessage));
-		return false;
+		return;
 	}
 
-	if(!p->sharedmem->lock())
+#if !defined(__linux__)
+	if(timeout_ms > 0)
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
-		return false;
+		MUtils::OS::sleep_ms(qMin(timeout_ms, IPC_POLL_INTERVAL)); /*QSystemSemaphore can not wait with a timeout, so we have to poll*/
+		return;
 	}
+#endif
 
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+	const quint32 wakeup = ipc_load(&cursor->wakeup);
+	ipc_fetch_add(&cursor->waiters, 1U);
+	ipc_fence();
+	if(ipc_load(&cursor->pos) == position)
 	{
-		if(VERIFY_CHECKSUM(ptr->status))
-		{
-			Internal::ipc_msg_t ipc_msg;
-			memset(&ipc_msg, 0, sizeof(Internal::ipc_msg_t));
-
-			ipc_msg.payload.command_id = command;
-			ipc_msg.payload.flags = flags;
-			if(!params.isEmpty())
-			{
-				const quint32 param_count = qMin(MAX_PARAM_CNT, (quint32)params.count());
-				for(quint32 i = 0; i < param_count; i++)
-				{
-					strncpy_s(ipc_msg.payload.params.values[i], MAX_PARAM_LEN, MUTILS_UTF8(params[i].trimmed()), _TRUNCATE);
-				}
-				ipc_msg.payload.params.count = param_count;
-			}
-			ipc_msg.payload.timestamp = ptr->status.payload.counter++;
-			UPDATE_CHECKSUM(ipc_msg);
-
-			memcpy(&ptr->data[ptr->status.payload.pos_wr], &ipc_msg, sizeof(Internal::ipc_msg_t));
-			ptr->status.payload.pos_wr = (ptr->status.payload.pos_wr + 1) % Internal::IPC_SLOTS;
-			UPDATE_CHECKSUM(ptr->status);
-
-			success = true;
-		}
-		else
+#if defined(__linux__)
+		Q_UNUSED(semaphore);
+		ipc_futex_wait(&cursor->wakeup, wakeup, timeout_ms);
+#else
+		Q_UNUSED(wakeup);
+		if(!semaphore->acquire())
 		{
-			qWarning("Corrupted IPC status detected -> skipping!");
+			const QString errorMessage = semaphore->errorString();
+			qWarning("Failed to acquire system semaphore: %s", MUTILS_UTF8(errorMessage));
 		}
+#endif
 	}
-	else
-	{
-		qWarning("Shared memory pointer is NULL -> unable to write data!");
-	}
+	ipc_fetch_add(&cursor->waiters, quint32(-1));
+}
 
-	if(!p->sharedmem->unlock())
-	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
-	}
+//Wakes up the threads that are sleeping on the cursor, if any; the caller must have updated the cursor and issued a full fence
+static void NOTIFY_CURSOR(MUtils::Internal::ipc_cursor_t *const cursor, QSystemSemaphore *const semaphore)
+{
+	using namespace MUtils::Internal;
 
-	if(!p->semaphore_rd->release())
+	if(const quint32 waiters = ipc_load(&cursor->waiters))
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		ipc_fetch_add(&cursor->wakeup, 1U);
+#if defined(__linux__)
+		Q_UNUSED(semaphore);
+		Q_UNUSED(waiters);
+		ipc_futex_wake(&cursor->wakeup);
+#else
+		if(!semaphore->release(int(waiters)))
+		{
+			const QString errorMessage = semaphore->errorString();
+			qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		}
+#endif
 	}
+}
 
-	return success;
+//Moves the cursor to the given position and wakes up the other side, if it is sleeping
+static void ADVANCE_CURSOR(MUtils::Internal::ipc_cursor_t *const cursor, const quint32 &position, QSystemSemaphore *const semaphore)
+{
+	using namespace MUtils::Internal;
+
+	ipc_store(&cursor->pos, position);
+	ipc_fence();
+	NOTIFY_CURSOR(cursor, semaphore);
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// READ MESSAGE
-///////////////////////////////////////////////////////////////////////////////
+/*
+ * Records that have been reserved (claimed) by several threads are committed (released) out of order: the owner stores a mark in the
+ * slot of the first record of its range, then whoever finds the range at the cursor marked, clears the mark and moves the cursor on.
+ * A mark holds the upper bits of the position, the size of the range and the kind of mark, so a stale mark is never mistaken for a new one.
+ * Nobody ever waits for another thread to commit. Right after its CAS, the owner marks its range as pending and stores its process ID
+ * next to the mark; a thread that is about to wait skips a pending range whose owner has died, so that a crashed process can not stall
+ * the channel. Only if the owner dies between its CAS and the pending mark, the cursor will not move any further.
+ */
 
-bool MUtils::IPCChannel::read(quint32 &command, quint32 &flags, QStringList &params)
+static inline MUtils::Internal::ipc_range_t *RANGE_AT(MUtils::Internal::ipc_t *const ptr, const quint32 &position)
 {
-	bool success = false;
-	QReadLocker readLock(&p->lock);
-	command = 0;
-	params.clear();
+	return &ptr->ranges[(position & (MUtils::Internal::IPC_RING_SIZE - 1U)) >> 3];
+}
 
-	if(!p->initialized)
-	{
-		MUTILS_THROW("Shared memory for IPC not initialized yet.");
-	}
+static inline quint32 MAKE_MARK(const quint32 &position, const quint32 &next_position, const quint32 &kind)
+{
+	return (position & (~(MUtils::Internal::IPC_RING_SIZE - 1U))) | ((next_position - position) >> 1) | kind;
+}
+
+static inline quint32 MARK_SIZE(const quint32 &value)
+{
+	return (value & (MUtils::Internal::IPC_RING_SIZE - 4U)) << 1;
+}
 
-	Internal::ipc_msg_t ipc_msg;
-	memset(&ipc_msg, 0, sizeof(Internal::ipc_msg_t));
+//Returns true, if the range is pending and its owner no longer exists
+static bool IS_STALE(const MUtils::Internal::ipc_range_t *const range, const quint32 &value)
+{
+	using namespace MUtils::Internal;
 
-	if(!p->semaphore_rd->acquire())
+	if((value & 3U) != IPC_MARK_PENDING)
 	{
-		const QString errorMessage = p->semaphore_rd->errorString();
-		qWarning("Failed to acquire system semaphore: %s", MUTILS_UTF8(errorMessage));
 		return false;
 	}
 
-	if(!p->sharedmem->lock())
+	const quint32 owner = ipc_load(&range->owner);
+	return (owner != 0U) && (owner != MUtils::OS::process_id()) && (!ipc_process_alive(owner));
+}
+
+//Overwrites the given range with filler records, which are skipped by the readers
+static void FILL_RANGE(quint8 *const ring, const quint32 &position, const quint32 &next_position)
+{
+	using namespace MUtils::Internal;
+
+	for(quint32 pos = position; pos != next_position;)
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
-		return false;
+		quint32 size = qMin(next_position - pos, RECORD_SIZE(MUtils::IPCChannel::MAX_MESSAGE_LEN));
+		if((next_position - pos != size) && (next_position - pos - size < quint32(sizeof(ipc_record_t))))
+		{
+			size -= 8U; /*the last filler record must be able to hold a header*/
+		}
+		ipc_record_t record;
+		record.length = size - quint32(sizeof(ipc_record_t));
+		record.checksum = 0U;
+		record.timestamp = quint64(pos) | IPC_RECORD_FILLER;
+		RING_WRITE(ring, pos, &record, sizeof(ipc_record_t));
+		pos += size;
 	}
+}
 
-	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+//Marks the given range as reserved (claimed) by this process; must be called right after the CAS that has reserved (claimed) it
+static void RESERVE_RANGE(MUtils::Internal::ipc_t *const ptr, const quint32 &position, const quint32 &next_position)
+{
+	using namespace MUtils::Internal;
+
+	ipc_range_t *const range = RANGE_AT(ptr, position);
+	ipc_store(&range->owner, MUtils::OS::process_id());
+	ipc_store(&range->mark, MAKE_MARK(position, next_position, IPC_MARK_PENDING));
+}
+
+//Moves the cursor over all consecutive ranges that carry the given mark, but not beyond the limit, then wakes up the other side
+//If "recover" is true, pending ranges whose owner has died are skipped as well; the records of a dead sender are replaced by fillers
+static void ADVANCE_MARKED(MUtils::Internal::ipc_t *const ptr, MUtils::Internal::ipc_cursor_t *const cursor, const MUtils::Internal::ipc_word_t *const limit, const quint32 &kind, QSystemSemaphore *const semaphore, const bool &recover = false)
+{
+	using namespace MUtils::Internal;
+
+	bool advanced = false;
+	for(;;)
 	{
-		if(VERIFY_CHECKSUM(ptr->status))
+		const quint32 current = ipc_load(&cursor->pos);
+		if(current == ipc_load(limit))
 		{
-			memcpy(&ipc_msg, &ptr->data[ptr->status.payload.pos_rd], sizeof(Internal::ipc_msg_t));
-			ptr->status.payload.pos_rd = (ptr->status.payload.pos_rd + 1) % Internal::IPC_SLOTS;
-			UPDATE_CHECKSUM(ptr->status);
-
-			if(VERIFY_CHECKSUM(ipc_msg) || (ipc_msg.payload.timestamp < ptr->status.payload.counter))
+			break;
+		}
+		ipc_range_t *const range = RANGE_AT(ptr, current);
+		const quint32 value = ipc_load(&range->mark);
+		if((value & (~(IPC_RING_SIZE - 1U))) != (current & (~(IPC_RING_SIZE - 1U))))
+		{
+			break; /*not marked yet, the owner will move the cursor on*/
+		}
+		if((value & 3U) != kind)
+		{
+			if(!(recover && IS_STALE(range, value) && ipc_cas(&range->mark, value, 0U)))
 			{
-				command = ipc_msg.payload.command_id;
-				flags = ipc_msg.payload.flags;
-				const quint32 param_count = qMin(ipc_msg.payload.params.count, MAX_PARAM_CNT);
-				char temp[MAX_PARAM_LEN];
-				for(quint32 i = 0; i < param_count; i++)
-				{
-					strncpy_s(temp, MAX_PARAM_LEN, ipc_msg.payload.params.values[i], _TRUNCATE);
-					params.append(QString::fromUtf8(temp));
-				}
-				success = true;
+				break; /*still pending; or another thread was faster*/
 			}
-			else
+			qWarning("IPC records were %s by a process that no longer exists -> skipped!", (kind == IPC_MARK_COMMITTED) ? "reserved" : "claimed");
+			if(kind == IPC_MARK_COMMITTED)
 			{
-				qWarning("Malformed or corrupted IPC message, will be ignored!");
+				FILL_RANGE(ptr->data, current, current + MARK_SIZE(value));
 			}
 		}
-		else
+		else if(!ipc_cas(&range->mark, value, 0U))
 		{
-			qWarning("Corrupted IPC status detected -> skipping!");
+			break; /*another thread was faster*/
 		}
-	}
-	else
-	{
-		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		ipc_store(&cursor->pos, current + MARK_SIZE(value));
+		ipc_fence();
+		advanced = true;
 	}
 
-	if(!p->sharedmem->unlock())
+	if(advanced)
 	{
-		const QString errorMessage = p->sharedmem->errorString();
-		qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
+		NOTIFY_CURSOR(cursor, semaphore);
 	}
+}
 
-	if(!p->semaphore_wr->release())
+//Marks the given range as committed (released), then moves the cursor on as far as possible; never blocks
+static void COMMIT_RANGE(MUtils::Internal::ipc_t *const ptr, MUtils::Internal::ipc_cursor_t *const cursor, const MUtils::Internal::ipc_word_t *const limit, const quint32 &position, const quint32 &next_position, const quint32 &kind, QSystemSemaphore *const semaphore)
+{
+	using namespace MUtils::Internal;
+
+	ipc_store(&RANGE_AT(ptr, position)->mark, MAKE_MARK(position, next_position, kind));
+	ipc_fence();
+	ADVANCE_MARKED(ptr, cursor, limit, kind, semaphore);
+}
+
+//Warns, if the cursor has not moved during a timed wait, even though records have been reserved (claimed) beyond it
+static void CHECK_STALLED(const MUtils::Internal::ipc_cursor_t *const cursor, const MUtils::Internal::ipc_word_t *const limit, const quint32 &position, const qint32 &timeout_ms)
+{
+	using namespace MUtils::Internal;
+
+	if((timeout_ms > 0) && (ipc_load(&cursor->pos) == position) && (ipc_load(limit) != position))
+	{
+		qWarning("IPC channel has not moved for %d ms, a process may have died while holding records!", timeout_ms);
+	}
+}
+
+//Wakes up all threads that are sleeping on the cursor, even though it has not moved
+static void INTERRUPT_CURSOR(MUtils::Internal::ipc_cursor_t *const cursor, QSystemSemaphore *const semaphore)
+{
+	using namespace MUtils::Internal;
+
+	ipc_fetch_add(&cursor->wakeup, 1U);
+#if defined(__linux__)
+	Q_UNUSED(semaphore);
+	ipc_futex_wake(&cursor->wakeup);
+#else
+	if(const quint32 waiters = ipc_load(&cursor->waiters))
+	{
+		if(!semaphore->release(int(waiters)))
+		{
+			const QString errorMessage = semaphore->errorString();
+			qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		}
+	}
+#endif
+}
+
+static inline qint32 REMAINING_TIME(const QElapsedTimer &timer, const qint32 &timeout_ms)
+{
+	if(timeout_ms < 0)
+	{
+		return -1;
+	}
+	const qint64 elapsed = timer.elapsed();
+	return (elapsed < qint64(timeout_ms)) ? qint32(qint64(timeout_ms) - elapsed) : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PRIVATE DATA
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class IPCChannel_Private
+	{
+		friend class IPCChannel;
+		friend class IPCChannelNotifier_Thread;
+		friend void Internal::ipc_abandon_next(IPCChannel *const channel);
+
+	protected:
+		bool lock_ring(void)
+		{
+			if((mode == IPCChannel::MODE_LOCKED) && (!sharedmem->lock()))
+			{
+				const QString errorMessage = sharedmem->errorString();
+				qWarning("Failed to lock shared memory: %s", MUTILS_UTF8(errorMessage));
+				return false;
+			}
+			return true;
+		}
+
+		void unlock_ring(void)
+		{
+			if((mode == IPCChannel::MODE_LOCKED) && (!sharedmem->unlock()))
+			{
+				const QString errorMessage = sharedmem->errorString();
+				qFatal("Failed to unlock shared memory: %s", MUTILS_UTF8(errorMessage));
+			}
+		}
+
+		bool write_messages(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms);
+		bool write_messages_cas(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms);
+		int read_messages(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms);
+		int read_messages_cas(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms);
+		int read_messages_sub(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms);
+		quint32 read_position(const Internal::ipc_t *const ptr) const;
+		void recover(Internal::ipc_t *const ptr);
+		bool attach_pool(void);
+		bool check_buffer(const quint32 &handle, const quint32 &size);
+		bool write_buffers(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms);
+		void accept_buffers(QList<IPCChannel::ipc_message_t> &messages, const int &first);
+		bool release_buffer(const quint32 &handle);
+
+		//In MODE_PUBSUB, every channel instance owns one of the subscriber slots; if all slots are taken, slots whose owner has died are reclaimed
+		bool subscribe(void)
+		{
+			Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+			const quint32 pid = MUtils::OS::process_id();
+			for(quint32 i = 0; i < Internal::IPC_MAX_SUBSCRIBERS; ++i)
+			{
+				if(Internal::ipc_cas(&ptr->subscribers[i].active, 0U, pid))
+				{
+					return subscribe_slot(ptr, i);
+				}
+			}
+			for(quint32 i = 0; i < Internal::IPC_MAX_SUBSCRIBERS; ++i)
+			{
+				const quint32 owner = Internal::ipc_load(&ptr->subscribers[i].active);
+				if((owner != 0U) && (owner != pid) && (!Internal::ipc_process_alive(owner)) && Internal::ipc_cas(&ptr->subscribers[i].active, owner, pid))
+				{
+					qWarning("IPC subscriber slot #%u was owned by a process that no longer exists -> reclaimed!", i);
+					return subscribe_slot(ptr, i);
+				}
+			}
+			return false;
+		}
+
+		bool subscribe_slot(Internal::ipc_t *const ptr, const quint32 &index)
+		{
+			Internal::ipc_store(&ptr->subscribers[index].overflows, 0U);
+			Internal::ipc_store(&ptr->subscribers[index].pos, Internal::ipc_load(&ptr->cursor_wr.pos));
+			subscriber = qint32(index);
+			return true;
+		}
+
+		void unsubscribe(void)
+		{
+			if(subscriber >= 0)
+			{
+				Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+				Internal::ipc_store(&ptr->subscribers[subscriber].active, 0U);
+				subscriber = -1;
+			}
+		}
+
+		Internal::ipc_pool_t *get_pool(void)
+		{
+			if(pool.isNull())
+			{
+				qWarning("Shared buffers have not been enabled for this IPC channel!");
+				return NULL;
+			}
+			return reinterpret_cast<Internal::ipc_pool_t*>(pool->data());
+		}
+
+		QAtomicInt initialized;
+		IPCChannel::ipc_mode_t mode;
+		bool buffers;
+		QAtomicInt abandon_next;
+		QScopedPointer<QSharedMemory> sharedmem;
+		QScopedPointer<QSystemSemaphore> semaphore_rd;
+		QScopedPointer<QSystemSemaphore> semaphore_wr;
+		QReadWriteLock lock;
+		qint32 subscriber;
+		QMutex subscriber_lock;
+		QString pool_key[2];
+		QScopedPointer<QSharedMemory> pool;
+		QScopedPointer<QSystemSemaphore> semaphore_pool;
+	};
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CONSTRUCTOR & DESTRUCTOR
+///////////////////////////////////////////////////////////////////////////////
+
+MUtils::IPCChannel::IPCChannel(const QString &applicationId, const quint32 &appVersionNo, const QString &channelId, const ipc_mode_t &mode, const bool &sharedBuffers)
+:
+	p(new IPCChannel_Private()),
+	m_applicationId(applicationId),
+	m_channelId(channelId),
+	m_appVersionNo(appVersionNo),
+	m_headerStr(QCryptographicHash::hash(MAKE_ID(applicationId, appVersionNo, channelId, QString("header.%1").arg(Internal::IPC_LAYOUT_VERSION)).toLatin1(), QCryptographicHash::Sha1).toHex())
+{
+	if(m_headerStr.length() != Internal::HDR_LEN)
+	{
+		MUTILS_THROW("Invalid header length has been detected!");
+	}
+	if((mode != MODE_LOCKED) && (mode != MODE_SPSC) && (mode != MODE_MPMC) && (mode != MODE_PUBSUB))
+	{
+		MUTILS_THROW("Invalid IPC channel mode has been specified!");
+	}
+	if((mode == MODE_PUBSUB) && sharedBuffers)
+	{
+		MUTILS_THROW("Shared buffers are not available in MODE_PUBSUB!");
+	}
+	p->mode = mode;
+	p->buffers = sharedBuffers;
+	p->subscriber = -1;
+}
+
+MUtils::IPCChannel::~IPCChannel(void)
+{
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		if(p->sharedmem->isAttached())
+		{
+			p->unsubscribe();
+			p->sharedmem->detach();
+		}
+		if((!p->pool.isNull()) && p->pool->isAttached())
+		{
+			p->pool->detach();
+		}
+	}
+
+	delete p;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INITIALIZATION
+///////////////////////////////////////////////////////////////////////////////
+
+int MUtils::IPCChannel::initialize(void)
+{
+	QWriteLocker writeLock(&p->lock);
+	
+	if(MUTILS_BOOLIFY(p->initialized))
+	{
+		return RET_ALREADY_INITIALIZED;
+	}
+
+	p->sharedmem.   reset(new QSharedMemory   (MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "sharedmem"), 0));
+	p->semaphore_rd.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_rd"), 0));
+	p->semaphore_wr.reset(new QSystemSemaphore(MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_wr"), 0));
+	p->pool_key[0] = MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, QString("bufpool.%1").arg(Internal::IPC_LAYOUT_VERSION));
+	p->pool_key[1] = MAKE_ID(m_applicationId, m_appVersionNo, m_channelId, "semaph_pl");
+
+	if(p->semaphore_rd->error() != QSystemSemaphore::NoError)
+	{
+		const QString errorMessage = p->semaphore_rd->errorString();
+		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+
+	if(p->semaphore_wr->error() != QSystemSemaphore::NoError)
 	{
 		const QString errorMessage = p->semaphore_wr->errorString();
-		qWarning("Failed to release system semaphore: %s", MUTILS_UTF8(errorMessage));
+		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+	
+	if(!p->sharedmem->create(sizeof(Internal::ipc_t)))
+	{
+		if(p->sharedmem->error() == QSharedMemory::AlreadyExists)
+		{
+			if(!p->sharedmem->attach())
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			if(p->sharedmem->error() != QSharedMemory::NoError)
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to attach to shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			if(p->sharedmem->size() < sizeof(Internal::ipc_t))
+			{
+				qWarning("Failed to attach to shared memory: Size verification has failed!");
+				return RET_FAILURE;
+			}
+			if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+			{
+				if(memcmp(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN) != 0)
+				{
+					qWarning("Failed to attach to shared memory: Header verification has failed!");
+					return RET_FAILURE;
+				}
+				if(ptr->mode != quint32(p->mode))
+				{
+					qWarning("Failed to attach to shared memory: The channel was created with a different mode!");
+					return RET_FAILURE;
+				}
+				if(ptr->buffers != quint32(p->buffers ? 1U : 0U))
+				{
+					qWarning("Failed to attach to shared memory: The channel was created %s shared buffers!", p->buffers ? "without" : "with");
+					return RET_FAILURE;
+				}
+			}
+			else
+			{
+				const QString errorMessage = p->sharedmem->errorString();
+				qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+				return RET_FAILURE;
+			}
+			if((p->mode == MODE_PUBSUB) && (!p->subscribe()))
+			{
+				qWarning("Failed to subscribe to the channel: Too many subscribers!");
+				return RET_FAILURE;
+			}
+			if(p->buffers && (!p->attach_pool()))
+			{
+				return RET_FAILURE;
+			}
+			p->initialized.ref();
+			return RET_SUCCESS_SLAVE;
+		}
+		else
+		{
+			const QString errorMessage = p->sharedmem->errorString();
+			qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+			return RET_FAILURE;
+		}
+	}
+	
+	if(p->sharedmem->error() != QSharedMemory::NoError)
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to create shared memory: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+
+	if(Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(p->sharedmem->data()))
+	{
+		memset(ptr, 0, sizeof(Internal::ipc_t));
+		memcpy(&ptr->header[0], m_headerStr.constData(), Internal::HDR_LEN);
+		ptr->mode = quint32(p->mode);
+		ptr->buffers = p->buffers ? 1U : 0U;
+	}
+	else
+	{
+		const QString errorMessage = p->sharedmem->errorString();
+		qWarning("Failed to access shared memory: %s", MUTILS_UTF8(errorMessage));
+		return RET_FAILURE;
+	}
+
+	if((p->mode == MODE_PUBSUB) && (!p->subscribe()))
+	{
+		qWarning("Failed to subscribe to the channel: Too many subscribers!");
+		return RET_FAILURE;
+	}
+
+	if(p->buffers && (!p->attach_pool()))
+	{
+		return RET_FAILURE;
 	}
 
-	return success;
+	//qDebug("IPC KEY #1: %s", MUTILS_UTF8(p->sharedmem->key()));
+	//qDebug("IPC KEY #2: %s", MUTILS_UTF8(p->semaphore_rd->key()));
+	//qDebug("IPC KEY #3: %s", MUTILS_UTF8(p->semaphore_wr->key()));
+
+	p->initialized.ref();
+	return RET_SUCCESS_MASTER;
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+// SEND MESSAGE
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::send(const quint32 &command, const quint32 &flags, const QStringList &params, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	QList<Internal::ipc_pending_t> messages;
+	messages.append(Internal::ipc_pending_t());
+	if(!PREPARE_MESSAGE(messages.last(), command, flags, params))
+	{
+		qWarning("IPC message exceeds the maximum size -> unable to send!");
+		return false;
+	}
+
+	return p->write_messages(messages, timeout_ms);
+}
+
+bool MUtils::IPCChannel::send_batch(const QList<ipc_message_t> &messages)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	QList<Internal::ipc_pending_t> pending;
+	pending.reserve(messages.count());
+	for(QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); ++iter)
+	{
+		if((iter->buffer != NO_BUFFER) && (!p->check_buffer(iter->buffer, iter->buffer_size)))
+		{
+			return false;
+		}
+		pending.append(Internal::ipc_pending_t());
+		if(!PREPARE_MESSAGE(pending.last(), iter->command, iter->flags, iter->params, iter->buffer, iter->buffer_size))
+		{
+			qWarning("IPC message exceeds the maximum size -> unable to send!");
+			return false;
+		}
+	}
+
+	return pending.isEmpty() || p->write_buffers(pending, -1);
+}
+
+bool MUtils::IPCChannel_Private::write_messages(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms)
+{
+	if((mode == IPCChannel::MODE_MPMC) || (mode == IPCChannel::MODE_PUBSUB))
+	{
+		return write_messages_cas(messages, timeout_ms);
+	}
+
+	Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+	if(!ptr)
+	{
+		qWarning("Shared memory pointer is NULL -> unable to write data!");
+		return false;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<Internal::ipc_pending_t>::ConstIterator iter = messages.constBegin();
+	while(iter != messages.constEnd())
+	{
+		if(!lock_ring())
+		{
+			return false;
+		}
+
+		const quint32 pos_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+		const quint32 pos_rd = Internal::ipc_load(&ptr->cursor_rd.pos);
+		if(pos_wr - pos_rd > Internal::IPC_RING_SIZE)
+		{
+			unlock_ring();
+			qWarning("Corrupted IPC status detected -> skipping!");
+			return false;
+		}
+
+		//Write as many messages as currently fit into the ring, then wake up the readers only once
+		quint32 pos = pos_wr;
+		while(iter != messages.constEnd())
+		{
+			const quint32 record_size = RECORD_SIZE(iter->length);
+			if(Internal::IPC_RING_SIZE - (pos - pos_rd) < record_size)
+			{
+				break;
+			}
+			WRITE_MESSAGE(ptr->data, pos, *iter);
+			pos += record_size;
+			++iter;
+		}
+
+		if(pos != pos_wr)
+		{
+			ADVANCE_CURSOR(&ptr->cursor_wr, pos, semaphore_rd.data());
+			unlock_ring();
+			continue;
+		}
+
+		unlock_ring();
+
+		const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+		if(remaining == 0)
+		{
+			return false;
+		}
+
+		WAIT_CURSOR(&ptr->cursor_rd, pos_rd, semaphore_wr.data(), remaining);
+	}
+
+	return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// READ MESSAGE
+///////////////////////////////////////////////////////////////////////////////
+
+bool MUtils::IPCChannel::read(quint32 &command, quint32 &flags, QStringList &params, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+	command = 0;
+	params.clear();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	QList<ipc_message_t> messages;
+	if(p->read_messages(messages, 1U, timeout_ms) > 0)
+	{
+		p->accept_buffers(messages, 0);
+		command = messages.first().command;
+		flags = messages.first().flags;
+		params = messages.first().params;
+		if(messages.first().buffer != NO_BUFFER)
+		{
+			qWarning("IPC message with a shared buffer has been read via read(), releasing the buffer!");
+			p->release_buffer(messages.first().buffer);
+		}
+		return true;
+	}
+
+	return false;
+}
+
+bool MUtils::IPCChannel::read(ipc_message_t &message, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+	message = ipc_message_t();
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	QList<ipc_message_t> messages;
+	if(p->read_messages(messages, 1U, timeout_ms) > 0)
+	{
+		p->accept_buffers(messages, 0);
+		message = messages.first();
+		return true;
+	}
+
+	return false;
+}
+
+int MUtils::IPCChannel::read_batch(QList<ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	const int first = messages.count();
+	const int result = (max_count > 0U) ? p->read_messages(messages, max_count, timeout_ms) : 0;
+	if(result > 0)
+	{
+		p->accept_buffers(messages, first);
+	}
+
+	return result;
+}
+
+int MUtils::IPCChannel_Private::read_messages(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms)
+{
+	if(mode == IPCChannel::MODE_MPMC)
+	{
+		return read_messages_cas(messages, max_count, timeout_ms);
+	}
+	if(mode == IPCChannel::MODE_PUBSUB)
+	{
+		return read_messages_sub(messages, max_count, timeout_ms);
+	}
+
+	Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+	if(!ptr)
+	{
+		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		return -1;
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for(;;)
+	{
+		if(!lock_ring())
+		{
+			return -1;
+		}
+
+		const quint32 pos_rd = Internal::ipc_load(&ptr->cursor_rd.pos);
+		const quint32 pos_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+		if(pos_wr - pos_rd > Internal::IPC_RING_SIZE)
+		{
+			ADVANCE_CURSOR(&ptr->cursor_rd, pos_wr, semaphore_wr.data());
+			unlock_ring();
+			qWarning("Corrupted IPC status detected -> skipping!");
+			return -1;
+		}
+
+		//Consume as many messages as are pending (up to the limit), then wake up the senders only once
+		int count = 0;
+		quint32 pos = pos_rd;
+		while((pos != pos_wr) && (quint32(count) < max_count))
+		{
+			IPCChannel::ipc_message_t message;
+			bool success;
+			pos += READ_MESSAGE(ptr->data, pos, pos_wr - pos, success, message);
+			if(success)
+			{
+				messages.append(message);
+				++count;
+			}
+		}
+
+		if(pos != pos_rd)
+		{
+			ADVANCE_CURSOR(&ptr->cursor_rd, pos, semaphore_wr.data());
+		}
+
+		unlock_ring();
+
+		if(count > 0)
+		{
+			return count;
+		}
+
+		const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+		if(remaining == 0)
+		{
+			return 0;
+		}
+
+		WAIT_CURSOR(&ptr->cursor_wr, pos_wr, semaphore_rd.data(), remaining);
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// MULTI-PRODUCER/MULTI-CONSUMER AND PUBLISH/SUBSCRIBE
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * In MODE_MPMC and MODE_PUBSUB, senders reserve space by advancing "cursor_res" with CAS, write their records without any lock and then
+ * commit them, which advances "cursor_wr" in reservation order. In MODE_MPMC, readers claim records by advancing "cursor_claim" with CAS,
+ * and release them, which advances "cursor_rd" in claim order; that is what the senders wait for. In MODE_PUBSUB, every subscriber has
+ * its own cursor and nobody waits for the subscribers; a subscriber that falls behind by more than the ring size skips to the newest record.
+ * Senders and readers only ever wait for free space or for new records, so the timeout is always honored. Before they go to sleep, they
+ * skip the records that have been reserved (claimed) by a process that has died, see recover().
+ */
+
+bool MUtils::IPCChannel_Private::write_messages_cas(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms)
+{
+	Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+	if(!ptr)
+	{
+		qWarning("Shared memory pointer is NULL -> unable to write data!");
+		return false;
+	}
+
+	const bool broadcast = (mode == IPCChannel::MODE_PUBSUB);
+	Internal::ipc_cursor_t *const cursor_limit = broadcast ? (&ptr->cursor_wr) : (&ptr->cursor_rd);
+	QSystemSemaphore *const semaphore_limit = broadcast ? semaphore_rd.data() : semaphore_wr.data();
+
+	const quint32 start_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+	const quint32 start_rd = Internal::ipc_load(&ptr->cursor_rd.pos);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QList<Internal::ipc_pending_t>::ConstIterator iter = messages.constBegin();
+	while(iter != messages.constEnd())
+	{
+		const quint32 pos_res = Internal::ipc_load(&ptr->cursor_res.pos);
+		const quint32 pos_limit = Internal::ipc_load(&cursor_limit->pos);
+		if(pos_res - pos_limit > Internal::IPC_RING_SIZE)
+		{
+			if(pos_res != Internal::ipc_load(&ptr->cursor_res.pos))
+			{
+				continue; /*another sender was faster*/
+			}
+			qWarning("Corrupted IPC status detected -> skipping!");
+			return false;
+		}
+
+		//Reserve space for as many messages as currently fit into the ring
+		const quint32 space = Internal::IPC_RING_SIZE - (pos_res - pos_limit);
+		quint32 total = 0;
+		QList<Internal::ipc_pending_t>::ConstIterator last = iter;
+		while((last != messages.constEnd()) && (RECORD_SIZE(last->length) <= space - total))
+		{
+			total += RECORD_SIZE(last->length);
+			++last;
+		}
+
+		if(total == 0)
+		{
+			const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+			if(remaining == 0)
+			{
+				CHECK_STALLED(&ptr->cursor_wr, &ptr->cursor_res.pos, start_wr, timeout_ms);
+				if(!broadcast)
+				{
+					CHECK_STALLED(&ptr->cursor_rd, &ptr->cursor_claim.pos, start_rd, timeout_ms);
+				}
+				return false;
+			}
+			recover(ptr);
+			WAIT_CURSOR(cursor_limit, pos_limit, semaphore_limit, remaining);
+			continue;
+		}
+
+		if(!Internal::ipc_cas(&ptr->cursor_res.pos, pos_res, pos_res + total))
+		{
+			continue;
+		}
+
+		RESERVE_RANGE(ptr, pos_res, pos_res + total);
+
+		quint32 pos = pos_res;
+		for(; iter != last; ++iter)
+		{
+			WRITE_MESSAGE(ptr->data, pos, *iter);
+			pos += RECORD_SIZE(iter->length);
+		}
+
+		if(abandon_next.testAndSetOrdered(1, 0))
+		{
+			return true; /*see Internal::ipc_abandon_next()*/
+		}
+
+		COMMIT_RANGE(ptr, &ptr->cursor_wr, &ptr->cursor_res.pos, pos_res, pos, Internal::IPC_MARK_COMMITTED, semaphore_rd.data());
+	}
+
+	return true;
+}
+
+int MUtils::IPCChannel_Private::read_messages_cas(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms)
+{
+	Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+	if(!ptr)
+	{
+		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		return -1;
+	}
+
+	const quint32 start_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for(;;)
+	{
+		const quint32 pos_claim = Internal::ipc_load(&ptr->cursor_claim.pos);
+		const quint32 pos_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+		if(pos_claim == pos_wr)
+		{
+			const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+			if(remaining == 0)
+			{
+				CHECK_STALLED(&ptr->cursor_wr, &ptr->cursor_res.pos, start_wr, timeout_ms);
+				return 0;
+			}
+			recover(ptr);
+			WAIT_CURSOR(&ptr->cursor_wr, pos_wr, semaphore_rd.data(), remaining);
+			continue;
+		}
+
+		//Find the end of the records to be claimed; the headers may be stale, if another reader was faster, but then the CAS will fail
+		quint32 pos = pos_claim, count = 0;
+		while((pos != pos_wr) && (count < max_count))
+		{
+			Internal::ipc_record_t record;
+			RING_READ(ptr->data, pos, &record, sizeof(Internal::ipc_record_t));
+			if(((record.timestamp & (~Internal::IPC_RECORD_FILLER)) != pos) || (record.length > IPCChannel::MAX_MESSAGE_LEN) || (RECORD_SIZE(record.length) > pos_wr - pos))
+			{
+				break;
+			}
+			pos += RECORD_SIZE(record.length);
+			++count;
+		}
+
+		if(pos == pos_claim)
+		{
+			if((pos_wr - pos_claim > Internal::IPC_RING_SIZE) || (pos_claim != Internal::ipc_load(&ptr->cursor_claim.pos)))
+			{
+				continue;
+			}
+			pos = pos_wr; /*corrupted record, the remaining messages will be discarded*/
+		}
+
+		if(!Internal::ipc_cas(&ptr->cursor_claim.pos, pos_claim, pos))
+		{
+			continue;
+		}
+
+		RESERVE_RANGE(ptr, pos_claim, pos);
+
+		if(abandon_next.testAndSetOrdered(1, 0))
+		{
+			return 0; /*see Internal::ipc_abandon_next()*/
+		}
+
+		//The claimed records can not be overwritten, until they have been released
+		int result = 0;
+		for(quint32 offset = pos_claim; offset != pos;)
+		{
+			IPCChannel::ipc_message_t message;
+			bool success;
+			offset += READ_MESSAGE(ptr->data, offset, pos - offset, success, message);
+			if(success)
+			{
+				messages.append(message);
+				++result;
+			}
+		}
+
+		COMMIT_RANGE(ptr, &ptr->cursor_rd, &ptr->cursor_claim.pos, pos_claim, pos, Internal::IPC_MARK_RELEASED, semaphore_wr.data());
+
+		if(result > 0)
+		{
+			return result;
+		}
+	}
+}
+
+int MUtils::IPCChannel_Private::read_messages_sub(QList<IPCChannel::ipc_message_t> &messages, const quint32 &max_count, const qint32 &timeout_ms)
+{
+	Internal::ipc_t *const ptr = reinterpret_cast<Internal::ipc_t*>(sharedmem->data());
+	if(!ptr)
+	{
+		qWarning("Shared memory pointer is NULL -> unable to read data!");
+		return -1;
+	}
+
+	QMutexLocker locker(&subscriber_lock);
+	Internal::ipc_subscriber_t *const slot = &ptr->subscribers[subscriber];
+
+	const quint32 start_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+
+	QElapsedTimer timer;
+	timer.start();
+
+	quint32 pos = Internal::ipc_load(&slot->pos);
+	for(;;)
+	{
+		const quint32 pos_wr = Internal::ipc_load(&ptr->cursor_wr.pos);
+		int result = 0;
+		while((pos != pos_wr) && (quint32(result) < max_count))
+		{
+			IPCChannel::ipc_message_t message;
+			bool success;
+			const quint32 record_size = (pos_wr - pos > Internal::IPC_RING_SIZE) ? 0U : READ_MESSAGE(ptr->data, pos, pos_wr - pos, success, message, &ptr->cursor_res.pos);
+			if(record_size == 0)
+			{
+				qWarning("IPC subscriber has fallen behind, messages have been lost!");
+				Internal::ipc_fetch_add(&slot->overflows, 1U);
+				pos = Internal::ipc_load(&ptr->cursor_wr.pos);
+				break;
+			}
+			pos += record_size;
+			if(success)
+			{
+				messages.append(message);
+				++result;
+			}
+		}
+
+		Internal::ipc_store(&slot->pos, pos);
+
+		if(result > 0)
+		{
+			return result;
+		}
+
+		const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+		if(remaining == 0)
+		{
+			CHECK_STALLED(&ptr->cursor_wr, &ptr->cursor_res.pos, start_wr, timeout_ms);
+			return 0;
+		}
+
+		if(pos == pos_wr)
+		{
+			recover(ptr);
+			WAIT_CURSOR(&ptr->cursor_wr, pos_wr, semaphore_rd.data(), remaining);
+		}
+	}
+}
+
+quint32 MUtils::IPCChannel_Private::read_position(const Internal::ipc_t *const ptr) const
+{
+	switch(mode)
+	{
+	case IPCChannel::MODE_MPMC:
+		return Internal::ipc_load(&ptr->cursor_claim.pos);
+	case IPCChannel::MODE_PUBSUB:
+		return Internal::ipc_load(&ptr->subscribers[subscriber].pos);
+	default:
+		return Internal::ipc_load(&ptr->cursor_rd.pos);
+	}
+}
+
+//Skips the ranges at the cursors that are still pending, although their owner has died; called before a sender or reader goes to sleep
+void MUtils::IPCChannel_Private::recover(Internal::ipc_t *const ptr)
+{
+	ADVANCE_MARKED(ptr, &ptr->cursor_wr, &ptr->cursor_res.pos, Internal::IPC_MARK_COMMITTED, semaphore_rd.data(), true);
+	if(mode == IPCChannel::MODE_MPMC)
+	{
+		ADVANCE_MARKED(ptr, &ptr->cursor_rd, &ptr->cursor_claim.pos, Internal::IPC_MARK_RELEASED, semaphore_wr.data(), true);
+	}
+}
+
+quint32 MUtils::IPCChannel::overflow_count(void) const
+{
+	QReadLocker readLock(&p->lock);
+
+	if((!p->initialized) || (p->subscriber < 0))
+	{
+		return 0;
+	}
+
+	const Internal::ipc_t *const ptr = reinterpret_cast<const Internal::ipc_t*>(p->sharedmem->data());
+	return ptr ? Internal::ipc_load(&ptr->subscribers[p->subscriber].overflows) : 0U;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// SHARED BUFFERS
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * The buffer pool lives in a separate shared memory segment, which is only created for channels that have shared buffers enabled. Every
+ * instance of such a channel attaches the segment when it is initialized, so that the segment can not vanish, if the sender exits before
+ * the reader has accessed the buffer. All instances must agree on whether shared buffers are enabled, which is verified in initialize().
+ * The state of a buffer holds the process ID of its owner: whoever has allocated it, until its handle is sent; then it is in flight, until
+ * the reader of that message takes it over, who has to release it. Only the owner can send or release a buffer. A buffer whose owner has
+ * died is reclaimed by alloc_buffer(); a buffer in flight is not, because its message can still be read. The pool relies on shared memory
+ * being zero-initialized by the operating system, so that no process ever has to initialize it explicitly.
+ */
+
+bool MUtils::IPCChannel_Private::attach_pool(void)
+{
+	QScopedPointer<QSharedMemory> sharedmem_pool(new QSharedMemory(pool_key[0], 0));
+	if(!sharedmem_pool->create(sizeof(Internal::ipc_pool_t)))
+	{
+		if((sharedmem_pool->error() != QSharedMemory::AlreadyExists) || (!sharedmem_pool->attach()))
+		{
+			const QString errorMessage = sharedmem_pool->errorString();
+			qWarning("Failed to attach to shared buffer pool: %s", MUTILS_UTF8(errorMessage));
+			return false;
+		}
+		if(sharedmem_pool->size() < int(sizeof(Internal::ipc_pool_t)))
+		{
+			qWarning("Failed to attach to shared buffer pool: Size verification has failed!");
+			return false;
+		}
+	}
+
+	semaphore_pool.reset(new QSystemSemaphore(pool_key[1], 0));
+	if(semaphore_pool->error() != QSystemSemaphore::NoError)
+	{
+		const QString errorMessage = semaphore_pool->errorString();
+		qWarning("Failed to create system smaphore: %s", MUTILS_UTF8(errorMessage));
+		return false;
+	}
+
+	pool.reset(sharedmem_pool.take());
+	return true;
+}
+
+bool MUtils::IPCChannel_Private::check_buffer(const quint32 &handle, const quint32 &size)
+{
+	const Internal::ipc_pool_t *const ptr = get_pool();
+	if(!ptr)
+	{
+		return false;
+	}
+
+	if((handle >= IPCChannel::BUFFER_COUNT) || (size > IPCChannel::BUFFER_SIZE))
+	{
+		qWarning("Invalid shared buffer handle or size -> unable to send!");
+		return false;
+	}
+
+	if(Internal::ipc_load(&ptr->state[handle]) != MUtils::OS::process_id())
+	{
+		qWarning("Shared buffer is not owned by this process -> unable to send!");
+		return false;
+	}
+
+	return true;
+}
+
+//Hands the attached buffers over to the readers, then writes the messages; if that fails, the buffers that have not been taken are taken back
+bool MUtils::IPCChannel_Private::write_buffers(const QList<Internal::ipc_pending_t> &messages, const qint32 &timeout_ms)
+{
+	Internal::ipc_pool_t *const ptr = pool.isNull() ? NULL : reinterpret_cast<Internal::ipc_pool_t*>(pool->data());
+	const quint32 pid = MUtils::OS::process_id();
+
+	QList<Internal::ipc_pending_t>::ConstIterator iter = messages.constBegin();
+	for(; iter != messages.constEnd(); ++iter)
+	{
+		if((iter->buffer != IPCChannel::NO_BUFFER) && ((!ptr) || (!Internal::ipc_cas(&ptr->state[iter->buffer], pid, Internal::IPC_BUFFER_SENT))))
+		{
+			qWarning("Shared buffer is not owned by this process -> unable to send!");
+			break;
+		}
+	}
+
+	if((iter == messages.constEnd()) && write_messages(messages, timeout_ms))
+	{
+		return true;
+	}
+
+	while(iter != messages.constBegin())
+	{
+		--iter;
+		if(iter->buffer != IPCChannel::NO_BUFFER)
+		{
+			Internal::ipc_cas(&ptr->state[iter->buffer], Internal::IPC_BUFFER_SENT, pid);
+		}
+	}
+
+	return false;
+}
+
+//Takes over the buffers of the messages that have been read, starting at "first"; a buffer that is not in flight is detached from its message
+void MUtils::IPCChannel_Private::accept_buffers(QList<IPCChannel::ipc_message_t> &messages, const int &first)
+{
+	const quint32 pid = MUtils::OS::process_id();
+	for(int i = first; i < messages.count(); ++i)
+	{
+		IPCChannel::ipc_message_t &message = messages[i];
+		if(message.buffer != IPCChannel::NO_BUFFER)
+		{
+			Internal::ipc_pool_t *const ptr = get_pool();
+			if((!ptr) || (!Internal::ipc_cas(&ptr->state[message.buffer], Internal::IPC_BUFFER_SENT, pid)))
+			{
+				qWarning("Shared buffer of the IPC message is not in flight -> discarded!");
+				message.buffer = IPCChannel::NO_BUFFER;
+				message.buffer_size = 0U;
+			}
+		}
+	}
+}
+
+bool MUtils::IPCChannel_Private::release_buffer(const quint32 &handle)
+{
+	Internal::ipc_pool_t *const ptr = get_pool();
+	if(!ptr)
+	{
+		return false;
+	}
+
+	if((handle >= IPCChannel::BUFFER_COUNT) || (!Internal::ipc_cas(&ptr->state[handle], MUtils::OS::process_id(), 0U)))
+	{
+		qWarning("Shared buffer is not owned by this process -> unable to release!");
+		return false;
+	}
+
+	Internal::ipc_fetch_add(&ptr->released.pos, 1U);
+	Internal::ipc_fence();
+	NOTIFY_CURSOR(&ptr->released, semaphore_pool.data());
+	return true;
+}
+
+quint8 *MUtils::IPCChannel::alloc_buffer(quint32 &handle, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+	handle = NO_BUFFER;
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	Internal::ipc_pool_t *const ptr = p->get_pool();
+	if(!ptr)
+	{
+		return NULL;
+	}
+
+	const quint32 pid = MUtils::OS::process_id();
+
+	QElapsedTimer timer;
+	timer.start();
+
+	for(;;)
+	{
+		const quint32 released = Internal::ipc_load(&ptr->released.pos);
+		for(quint32 i = 0; i < BUFFER_COUNT; ++i)
+		{
+			if((!Internal::ipc_load(&ptr->state[i])) && Internal::ipc_cas(&ptr->state[i], 0U, pid))
+			{
+				handle = i;
+				return ptr->data[i];
+			}
+		}
+		for(quint32 i = 0; i < BUFFER_COUNT; ++i)
+		{
+			const quint32 owner = Internal::ipc_load(&ptr->state[i]);
+			if((owner != 0U) && (owner != Internal::IPC_BUFFER_SENT) && (owner != pid) && (!Internal::ipc_process_alive(owner)) && Internal::ipc_cas(&ptr->state[i], owner, pid))
+			{
+				qWarning("Shared buffer #%u was owned by a process that no longer exists -> reclaimed!", i);
+				handle = i;
+				return ptr->data[i];
+			}
+		}
+
+		const qint32 remaining = REMAINING_TIME(timer, timeout_ms);
+		if(remaining == 0)
+		{
+			return NULL;
+		}
+
+		WAIT_CURSOR(&ptr->released, released, p->semaphore_pool.data(), remaining);
+	}
+}
+
+bool MUtils::IPCChannel::send_buffer(const quint32 &command, const quint32 &flags, const quint32 &handle, const quint32 &size, const QStringList &params, const qint32 &timeout_ms)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	if(!p->check_buffer(handle, size))
+	{
+		return false;
+	}
+
+	QList<Internal::ipc_pending_t> messages;
+	messages.append(Internal::ipc_pending_t());
+	if(!PREPARE_MESSAGE(messages.last(), command, flags, params, handle, size))
+	{
+		qWarning("IPC message exceeds the maximum size -> unable to send!");
+		return false;
+	}
+
+	return p->write_buffers(messages, timeout_ms);
+}
+
+const quint8 *MUtils::IPCChannel::buffer_data(const quint32 &handle)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	Internal::ipc_pool_t *const ptr = p->get_pool();
+	return (ptr && (handle < BUFFER_COUNT)) ? ptr->data[handle] : NULL;
+}
+
+bool MUtils::IPCChannel::release_buffer(const quint32 &handle)
+{
+	QReadLocker readLock(&p->lock);
+
+	if(!p->initialized)
+	{
+		MUTILS_THROW("Shared memory for IPC not initialized yet.");
+	}
+
+	return p->release_buffer(handle);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// INTERNAL
+///////////////////////////////////////////////////////////////////////////////
+
+void MUtils::Internal::ipc_abandon_next(IPCChannel *const channel)
+{
+	channel->p->abandon_next = 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// NOTIFIER
+///////////////////////////////////////////////////////////////////////////////
+
+namespace MUtils
+{
+	class IPCChannelNotifier_Thread : public QThread
+	{
+	public:
+		IPCChannelNotifier_Thread(IPCChannelNotifier *const notifier, IPCChannel_Private *const channel)
+		:
+			m_notifier(notifier),
+			m_channel(channel),
+			m_ipc(get_ipc(channel))
+		{
+		}
+
+		void stop(void)
+		{
+			m_stopped.ref();
+			while(!wait(IPC_STOP_INTERVAL))
+			{
+				INTERRUPT_CURSOR(&m_ipc->cursor_wr, m_channel->semaphore_rd.data()); /*repeat, in case the thread was just about to go to sleep*/
+			}
+		}
+
+	protected:
+		virtual void run(void)
+		{
+			quint32 pos_seen = m_channel->read_position(m_ipc);
+			while(!MUTILS_BOOLIFY(m_stopped))
+			{
+				const quint32 pos_wr = Internal::ipc_load(&m_ipc->cursor_wr.pos);
+				if((pos_wr != pos_seen) && (pos_wr != m_channel->read_position(m_ipc)))
+				{
+					pos_seen = pos_wr;
+					emit m_notifier->messagesAvailable();
+					continue;
+				}
+				WAIT_CURSOR(&m_ipc->cursor_wr, pos_wr, m_channel->semaphore_rd.data(), -1);
+			}
+		}
+
+	private:
+		static const unsigned long IPC_STOP_INTERVAL = 10;
+
+		static Internal::ipc_t *get_ipc(IPCChannel_Private *const channel)
+		{
+			Internal::ipc_t *const ptr = channel->initialized ? reinterpret_cast<Internal::ipc_t*>(channel->sharedmem->data()) : NULL;
+			if(!ptr)
+			{
+				MUTILS_THROW("Shared memory for IPC not initialized yet.");
+			}
+			return ptr;
+		}
+
+		IPCChannelNotifier *const m_notifier;
+		IPCChannel_Private *const m_channel;
+		Internal::ipc_t *const m_ipc;
+		QAtomicInt m_stopped;
+	};
+}
+
+MUtils::IPCChannelNotifier::IPCChannelNotifier(IPCChannel *const channel, QObject *const parent)
+:
+	QObject(parent),
+	m_thread(new IPCChannelNotifier_Thread(this, channel->p))
+{
+	m_thread->start();
+}
+
+MUtils::IPCChannelNotifier::~IPCChannelNotifier(void)
+{
+	m_thread->stop();
+	delete m_thread;
 }
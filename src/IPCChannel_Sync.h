@@ -0,0 +1,200 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+//MUtils
+#include <MUtils/Global.h>
+
+//Platform
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#if defined(_WIN32)
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <signal.h>
+#endif
+#if defined(__linux__)
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <climits>
+#include <ctime>
+#endif
+
+/*
+ * Atomic operations on 32-Bit words that live in shared memory.
+ *
+ * These must be lock-free and address-free, so that they work across process boundaries; that is why they are implemented on top
+ * of the compiler intrinsics, rather than QAtomicInt (whose layout and implementation may differ between Qt builds).
+ */
+
+namespace MUtils
+{
+	namespace Internal
+	{
+		typedef volatile quint32 ipc_word_t;
+
+#if defined(_MSC_VER)
+
+		static inline quint32 ipc_load(const ipc_word_t *const ptr)
+		{
+#if defined(_M_IX86) || defined(_M_X64)
+			const quint32 value = *ptr; /*plain loads have acquire semantics on x86*/
+			_ReadWriteBarrier();
+			return value;
+#else
+			return quint32(_InterlockedCompareExchange((volatile long*)ptr, 0L, 0L));
+#endif
+		}
+
+		static inline void ipc_store(ipc_word_t *const ptr, const quint32 value)
+		{
+#if defined(_M_IX86) || defined(_M_X64)
+			_ReadWriteBarrier(); /*plain stores have release semantics on x86*/
+			*ptr = value;
+#else
+			_InterlockedExchange((volatile long*)ptr, long(value));
+#endif
+		}
+
+		static inline quint32 ipc_fetch_add(ipc_word_t *const ptr, const quint32 value)
+		{
+			return quint32(_InterlockedExchangeAdd((volatile long*)ptr, long(value)));
+		}
+
+		static inline bool ipc_cas(ipc_word_t *const ptr, const quint32 expected, const quint32 desired)
+		{
+			return (quint32(_InterlockedCompareExchange((volatile long*)ptr, long(desired), long(expected))) == expected);
+		}
+
+		static inline void ipc_fence(void)
+		{
+#if defined(_M_IX86) || defined(_M_X64)
+			_mm_mfence();
+#else
+			__dmb(_ARM64_BARRIER_ISH);
+#endif
+		}
+
+		static inline void ipc_pause(void)
+		{
+#if defined(_M_IX86) || defined(_M_X64)
+			_mm_pause();
+#else
+			__yield();
+#endif
+		}
+
+#else //__GNUC__
+
+		static inline quint32 ipc_load(const ipc_word_t *const ptr)
+		{
+			return __atomic_load_n(ptr, __ATOMIC_ACQUIRE);
+		}
+
+		static inline void ipc_store(ipc_word_t *const ptr, const quint32 value)
+		{
+			__atomic_store_n(ptr, value, __ATOMIC_RELEASE);
+		}
+
+		static inline quint32 ipc_fetch_add(ipc_word_t *const ptr, const quint32 value)
+		{
+			return __atomic_fetch_add(ptr, value, __ATOMIC_SEQ_CST);
+		}
+
+		static inline bool ipc_cas(ipc_word_t *const ptr, quint32 expected, const quint32 desired)
+		{
+			return __atomic_compare_exchange_n(ptr, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+		}
+
+		static inline void ipc_fence(void)
+		{
+			__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		}
+
+		static inline void ipc_pause(void)
+		{
+#if defined(__i386__) || defined(__x86_64__)
+			__builtin_ia32_pause();
+#elif defined(__aarch64__)
+			__asm__ __volatile__("yield");
+#endif
+		}
+
+#endif //_MSC_VER
+
+		/*
+		 * Checks whether the process that owns a slot in shared memory is still running; a process that can not be queried, e.g. because
+		 * it belongs to another user, is assumed to be running. Process IDs may be re-used, so a slot may be reclaimed late, but never early.
+		 */
+
+#if defined(_WIN32)
+
+		static inline bool ipc_process_alive(const quint32 pid)
+		{
+			if(const HANDLE process = OpenProcess(SYNCHRONIZE, FALSE, DWORD(pid)))
+			{
+				const bool alive = (WaitForSingleObject(process, 0) == WAIT_TIMEOUT);
+				CloseHandle(process);
+				return alive;
+			}
+			return (GetLastError() != ERROR_INVALID_PARAMETER);
+		}
+
+#else
+
+		static inline bool ipc_process_alive(const quint32 pid)
+		{
+			return (kill(pid_t(pid), 0) == 0) || (errno != ESRCH);
+		}
+
+#endif //_WIN32
+
+#if defined(__linux__)
+
+		/*
+		 * Futex operations on a shared word; the shared (non-private) variant is required, because the word is mapped by several processes.
+		 */
+
+		static inline void ipc_futex_wait(ipc_word_t *const ptr, const quint32 expected, const qint32 timeout_ms)
+		{
+			if(timeout_ms < 0)
+			{
+				syscall(SYS_futex, ptr, FUTEX_WAIT, expected, NULL, NULL, 0); /*returns immediately, if the value has changed already*/
+				return;
+			}
+			struct timespec timeout;
+			timeout.tv_sec = timeout_ms / 1000;
+			timeout.tv_nsec = long(timeout_ms % 1000) * 1000000L;
+			syscall(SYS_futex, ptr, FUTEX_WAIT, expected, &timeout, NULL, 0);
+		}
+
+		static inline void ipc_futex_wake(ipc_word_t *const ptr)
+		{
+			syscall(SYS_futex, ptr, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+		}
+
+#endif //__linux__
+	}
+}
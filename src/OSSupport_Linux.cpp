@@ -0,0 +1,59 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Minimal replacement for the parts of OSSupport_Win32.cpp that are required by the portable (CMake) build
+ * of the IPC channel on Linux. The full OSSupport_Win32.cpp depends on the Win32 API and is not used there.
+ */
+
+//Linux API
+#include <unistd.h>
+#include <time.h>
+
+//MUtils
+#include <MUtils/OSSupport.h>
+
+//CRT
+#include <cerrno>
+
+///////////////////////////////////////////////////////////////////////////////
+// SLEEP
+///////////////////////////////////////////////////////////////////////////////
+
+void MUtils::OS::sleep_ms(const size_t &duration)
+{
+	struct timespec request, remaining;
+	request.tv_sec = time_t(duration / 1000U);
+	request.tv_nsec = long(duration % 1000U) * 1000000L;
+	while ((nanosleep(&request, &remaining) != 0) && (errno == EINTR))
+	{
+		request = remaining;
+	}
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// PROCESS ID
+///////////////////////////////////////////////////////////////////////////////
+
+quint32 MUtils::OS::process_id(void)
+{
+	return quint32(getpid());
+}
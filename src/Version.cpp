@@ -23,7 +23,6 @@
 #include <MUtils/Version.h>
 #include <MUtils/Global.h>
 #include <MUtils/Exception.h>
-#include <MUtils/OSSupport.h>
 
 //Internal
 #define MUTILS_INC_CONFIG 1
@@ -33,6 +32,12 @@
 // HELPER FUNCTIONS
 ///////////////////////////////////////////////////////////////////////////////
 
+#if defined(_MSC_VER)
+#define SSCANF sscanf_s
+#else
+#define SSCANF sscanf
+#endif
+
 static const char *g_months_lut[] = {"Jan", "Feb", "Mar", "Apr", "May", "Jun", "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"};
 
 static int month_str2int(const char *str)
@@ -41,7 +46,7 @@ static int month_str2int(const char *str)
 
 	for(int j = 0; j < 12; j++)
 	{
-		if(!_strnicmp(str, g_months_lut[j], 3))
+		if(!qstrnicmp(str, g_months_lut[j], 3))
 		{
 			ret = j+1;
 			break;
@@ -55,7 +60,7 @@ static const QDate decode_date_str(const char *const date_str) //Mmm dd yyyy
 {
 	int date[3] = {0, 0, 0};
 
-	if(sscanf_s(date_str, "%*3s %2d %4d", &date[2], &date[0]) != 2)
+	if(SSCANF(date_str, "%*3s %2d %4d", &date[2], &date[0]) != 2)
 	{
 		MUTILS_THROW("Internal error: Date format could not be recognized!");
 	}
@@ -73,7 +78,7 @@ static const QTime decode_time_str(const char *const time_str) //hh:mm:ss
 {
 	int time[3] = {0, 0, 0};
 
-	if(sscanf_s(time_str, "%2d:%2d:%2d", &time[0], &time[1], &time[2]) != 3)
+	if(SSCANF(time_str, "%2d:%2d:%2d", &time[0], &time[1], &time[2]) != 3)
 	{
 		MUTILS_THROW("Internal error: Time format could not be recognized!");
 	}
@@ -0,0 +1,468 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+//MUtils
+#include <MUtils/Global.h>
+#include <MUtils/Hash.h>
+#include <MUtils/CPUFeatures.h>
+#include <MUtils/Version.h>
+
+//Qt
+#include <QThread>
+#include <QFile>
+#include <QDir>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QScopedPointer>
+
+//CRT
+#include <cstdio>
+#include <cstring>
+
+//===========================================================================
+// Benchmark Setup
+//===========================================================================
+
+typedef struct
+{
+	quint16 hashId;
+	const char *name;
+}
+algorithm_t;
+
+static const algorithm_t ALGORITHMS[] =
+{
+	{ MUtils::Hash::HASH_BLAKE2_512,        "BLAKE2_512"        },
+	{ MUtils::Hash::HASH_BLAKE2BP_512,      "BLAKE2BP_512"      },
+	{ MUtils::Hash::HASH_BLAKE2SP_256,      "BLAKE2SP_256"      },
+	{ MUtils::Hash::HASH_KECCAK_224,        "KECCAK_224"        },
+	{ MUtils::Hash::HASH_KECCAK_256,        "KECCAK_256"        },
+	{ MUtils::Hash::HASH_KECCAK_384,        "KECCAK_384"        },
+	{ MUtils::Hash::HASH_KECCAK_512,        "KECCAK_512"        },
+	{ MUtils::Hash::HASH_SHA3_224,          "SHA3_224"          },
+	{ MUtils::Hash::HASH_SHA3_256,          "SHA3_256"          },
+	{ MUtils::Hash::HASH_SHA3_384,          "SHA3_384"          },
+	{ MUtils::Hash::HASH_SHA3_512,          "SHA3_512"          },
+	{ MUtils::Hash::HASH_SHAKE_128,         "SHAKE_128"         },
+	{ MUtils::Hash::HASH_SHAKE_256,         "SHAKE_256"         },
+	{ MUtils::Hash::HASH_BLAKE3,            "BLAKE3"            },
+	{ MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, "BLAKE3_DERIVE_KEY" },
+	{ MUtils::Hash::HASH_XXH3_64,           "XXH3_64"           },
+	{ MUtils::Hash::HASH_XXH3_128,          "XXH3_128"          },
+	{ MUtils::Hash::HASH_CRC32C,            "CRC32C"            },
+	{ 0xFFFF, NULL }
+};
+
+static const qint64 MIN_SIZE = 16;
+static const qint64 MAX_SIZE = Q_INT64_C(1073741824);
+
+typedef struct
+{
+	qint64 maxSize;
+	quint32 threads;
+	qint64 minTime; //milliseconds
+	QString filter;
+	QString output;
+	bool noFile;
+}
+options_t;
+
+typedef enum
+{
+	MODE_MEMORY = 0,
+	MODE_FILE   = 1
+}
+bench_mode_t;
+
+typedef struct
+{
+	const algorithm_t *algorithm;
+	bench_mode_t mode;
+	quint32 threads;
+	qint64 size;
+	quint32 iterations;
+	qint64 nanosecs;
+}
+result_t;
+
+//===========================================================================
+// Worker Thread
+//===========================================================================
+
+/*
+ * Each worker owns a separate Hash instance (and, in file mode, a separate QFile), so the
+ * multi-threaded runs measure the aggregate throughput of independent streams, which is
+ * how hash_files() and HashTree use the hash functions.
+ */
+class BenchWorker : public QThread
+{
+public:
+	BenchWorker(const quint16 hashId, const bench_mode_t mode, const QByteArray &data, const QString &filePath, const quint32 iterations)
+	:
+		m_hashId(hashId), m_mode(mode), m_data(data), m_filePath(filePath), m_iterations(iterations), m_success(false)
+	{
+	}
+
+	bool success(void) const { return m_success; }
+
+	bool runIterations(void)
+	{
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(m_hashId));
+		quint8 digest[MUtils::Hash::DIGEST_MAX_SIZE];
+		QFile file(m_filePath);
+		if ((m_mode == MODE_FILE) && (!file.open(QIODevice::ReadOnly)))
+		{
+			return false;
+		}
+		for (quint32 i = 0; i < m_iterations; ++i)
+		{
+			hash->reset();
+			if (m_mode == MODE_FILE)
+			{
+				if (!(file.seek(0) && hash->update(file)))
+				{
+					return false;
+				}
+			}
+			else if (!hash->update(reinterpret_cast<const quint8*>(m_data.constData()), quint32(m_data.size())))
+			{
+				return false;
+			}
+			hash->digest_into(digest, sizeof(digest));
+		}
+		return true;
+	}
+
+protected:
+	virtual void run(void)
+	{
+		try
+		{
+			m_success = runIterations();
+		}
+		catch (...)
+		{
+			m_success = false;
+		}
+	}
+
+private:
+	const quint16 m_hashId;
+	const bench_mode_t m_mode;
+	const QByteArray &m_data;
+	const QString m_filePath;
+	const quint32 m_iterations;
+	bool m_success;
+};
+
+//===========================================================================
+// Benchmark Runner
+//===========================================================================
+
+static bool run_once(const algorithm_t *const algorithm, const bench_mode_t mode, const quint32 threads, const QByteArray &data, const QString &filePath, const quint32 iterations, qint64 &nanosecs)
+{
+	QList<BenchWorker*> workers;
+	for (quint32 t = 0; t < threads; ++t)
+	{
+		workers.append(new BenchWorker(algorithm->hashId, mode, data, filePath, iterations));
+	}
+
+	QElapsedTimer timer;
+	timer.start();
+	bool success = true;
+	if (threads > 1)
+	{
+		for (QList<BenchWorker*>::ConstIterator iter = workers.constBegin(); iter != workers.constEnd(); ++iter)
+		{
+			(*iter)->start();
+		}
+		for (QList<BenchWorker*>::ConstIterator iter = workers.constBegin(); iter != workers.constEnd(); ++iter)
+		{
+			(*iter)->wait();
+			success = success && (*iter)->success();
+		}
+	}
+	else
+	{
+		success = workers.first()->runIterations();
+	}
+	nanosecs = timer.nsecsElapsed();
+
+	while (!workers.isEmpty())
+	{
+		delete workers.takeFirst();
+	}
+	return success;
+}
+
+//Doubles the number of iterations until the run takes at least "minTime" milliseconds
+static bool run_benchmark(result_t &result, const QByteArray &data, const QString &filePath, const qint64 minTime)
+{
+	quint32 iterations = 1U;
+	for (;;)
+	{
+		qint64 nanosecs = 0;
+		if (!run_once(result.algorithm, result.mode, result.threads, data, filePath, iterations, nanosecs))
+		{
+			return false;
+		}
+		if ((nanosecs >= minTime * Q_INT64_C(1000000)) || (iterations >= 0x40000000U))
+		{
+			result.iterations = iterations;
+			result.nanosecs = qMax(nanosecs, Q_INT64_C(1));
+			return true;
+		}
+		iterations *= 2U;
+	}
+}
+
+static bool write_file(const QString &filePath, const QByteArray &data)
+{
+	QFile file(filePath);
+	if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+	{
+		return false;
+	}
+	const bool success = (file.write(data) == qint64(data.size()));
+	file.close();
+	return success;
+}
+
+static QByteArray make_test_data(const qint64 size)
+{
+	QByteArray data;
+	data.resize(int(size));
+	quint32 state = 0x9E3779B9U;
+	for (int i = 0; i < data.size(); ++i)
+	{
+		state = (state * 1664525U) + 1013904223U;
+		data[i] = char(state >> 24);
+	}
+	return data;
+}
+
+//===========================================================================
+// JSON Output
+//===========================================================================
+
+static QByteArray json_string(const QString &str)
+{
+	QByteArray escaped("\"");
+	const QByteArray utf8 = str.toUtf8();
+	for (int i = 0; i < utf8.size(); ++i)
+	{
+		const char c = utf8[i];
+		if ((c == '"') || (c == '\\'))
+		{
+			escaped.append('\\').append(c);
+		}
+		else if (quint8(c) < 0x20)
+		{
+			char buffer[8];
+			sprintf(buffer, "\\u%04x", unsigned(quint8(c)));
+			escaped.append(buffer);
+		}
+		else
+		{
+			escaped.append(c);
+		}
+	}
+	return escaped.append('"');
+}
+
+static QByteArray make_json(const QList<result_t> &results, const options_t &options)
+{
+	const MUtils::CPUFetaures::cpu_info_t cpu = MUtils::CPUFetaures::detect();
+	QByteArray json("{\n");
+	json.append("  \"library\": ").append(json_string(QString("MUtilities v%1.%2").arg(MUtils::Version::lib_version_major()).arg(MUtils::Version::lib_version_minor(), 2, 10, QLatin1Char('0')))).append(",\n");
+	json.append("  \"compiler\": ").append(json_string(QString::fromLatin1(MUtils::Version::compiler_version()))).append(",\n");
+	json.append("  \"arch\": ").append(json_string(QString::fromLatin1(MUtils::Version::compiler_arch()))).append(",\n");
+	json.append("  \"cpu\": ").append(json_string(QString::fromLatin1(cpu.brand).simplified())).append(",\n");
+	json.append("  \"cpu_count\": ").append(QByteArray::number(cpu.count)).append(",\n");
+	json.append("  \"timestamp\": ").append(json_string(QDateTime::currentDateTime().toUTC().toString(Qt::ISODate))).append(",\n");
+	json.append("  \"min_time_ms\": ").append(QByteArray::number(options.minTime)).append(",\n");
+	json.append("  \"results\": [");
+	for (int i = 0; i < results.count(); ++i)
+	{
+		const result_t &r = results[i];
+		const double seconds = double(r.nanosecs) / 1.0e9;
+		const double bytes = double(r.size) * double(r.iterations) * double(r.threads);
+		json.append((i > 0) ? ",\n" : "\n");
+		json.append("    { \"algorithm\": ").append(json_string(QString::fromLatin1(r.algorithm->name)));
+		json.append(", \"id\": ").append(QByteArray::number(r.algorithm->hashId));
+		json.append(", \"mode\": ").append((r.mode == MODE_FILE) ? "\"file\"" : "\"memory\"");
+		json.append(", \"threads\": ").append(QByteArray::number(r.threads));
+		json.append(", \"size\": ").append(QByteArray::number(r.size));
+		json.append(", \"iterations\": ").append(QByteArray::number(r.iterations));
+		json.append(", \"seconds\": ").append(QByteArray::number(seconds, 'f', 6));
+		json.append(", \"mb_per_sec\": ").append(QByteArray::number(bytes / seconds / 1048576.0, 'f', 2));
+		json.append(", \"ns_per_byte\": ").append(QByteArray::number(double(r.nanosecs) / bytes, 'f', 4));
+		json.append(" }");
+	}
+	json.append("\n  ]\n}\n");
+	return json;
+}
+
+//===========================================================================
+// Main function
+//===========================================================================
+
+static bool parse_options(const int argc, char **argv, options_t &options)
+{
+	options.maxSize = MAX_SIZE;
+	options.threads = MUtils::CPUFetaures::detect().count;
+	options.minTime = 250;
+	options.noFile = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const QString arg = QString::fromLocal8Bit(argv[i]);
+		const QString value = arg.section(QLatin1Char('='), 1);
+		bool ok = true;
+		if (arg.startsWith("--max-size="))
+		{
+			options.maxSize = qBound(MIN_SIZE, value.toLongLong(&ok), MAX_SIZE);
+		}
+		else if (arg.startsWith("--threads="))
+		{
+			options.threads = qMax(1U, value.toUInt(&ok));
+		}
+		else if (arg.startsWith("--min-time="))
+		{
+			options.minTime = qMax(Q_INT64_C(1), value.toLongLong(&ok));
+		}
+		else if (arg.startsWith("--filter="))
+		{
+			options.filter = value;
+		}
+		else if (arg.startsWith("--output="))
+		{
+			options.output = value;
+		}
+		else if (arg == "--no-file")
+		{
+			options.noFile = true;
+		}
+		else
+		{
+			ok = false;
+		}
+		if (!ok)
+		{
+			fprintf(stderr, "Invalid argument: %s\n\n", argv[i]);
+			fprintf(stderr, "Usage: MUtilitiesBench [--max-size=<bytes>] [--threads=<n>] [--min-time=<ms>] [--filter=<name>] [--no-file] [--output=<file.json>]\n");
+			return false;
+		}
+	}
+	return true;
+}
+
+int main(int argc, char **argv)
+{
+	fprintf(stderr, "MuldeR's Utilities for Qt v%u.%02u - Hash Benchmark [%s]\n", MUtils::Version::lib_version_major(), MUtils::Version::lib_version_minor(), MUTILS_DEBUG ? "DEBUG" : "RELEASE");
+	fprintf(stderr, "Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>. Some rights reserved.\n\n");
+
+	options_t options;
+	if (!parse_options(argc, argv, options))
+	{
+		return 1;
+	}
+
+	const QString tempFolder = MUtils::temp_folder();
+	if (tempFolder.isEmpty() && (!options.noFile))
+	{
+		fprintf(stderr, "Warning: No temporary folder available, skipping file benchmarks!\n");
+		options.noFile = true;
+	}
+	const QString filePath = QDir(tempFolder).absoluteFilePath("MUtilitiesBench.bin");
+
+	QList<quint32> threadCounts;
+	threadCounts << 1U;
+	if (options.threads > 1U)
+	{
+		threadCounts << options.threads;
+	}
+
+	QList<result_t> results;
+	bool success = true;
+	for (qint64 size = MIN_SIZE; size <= options.maxSize; size *= 4)
+	{
+		QByteArray data;
+		try
+		{
+			data = make_test_data(size);
+		}
+		catch (...)
+		{
+			fprintf(stderr, "Warning: Failed to allocate %lld bytes, stopping!\n", size);
+			break;
+		}
+
+		const bool haveFile = (!options.noFile) && write_file(filePath, data);
+		for (const algorithm_t *algorithm = ALGORITHMS; algorithm->name; ++algorithm)
+		{
+			if ((!options.filter.isEmpty()) && (!QString::fromLatin1(algorithm->name).contains(options.filter, Qt::CaseInsensitive)))
+			{
+				continue;
+			}
+			for (int m = MODE_MEMORY; m <= (haveFile ? MODE_FILE : MODE_MEMORY); ++m)
+			{
+				for (QList<quint32>::ConstIterator threads = threadCounts.constBegin(); threads != threadCounts.constEnd(); ++threads)
+				{
+					result_t result = { algorithm, bench_mode_t(m), *threads, size, 0U, 0 };
+					fprintf(stderr, "%-18s %-6s %2u thread(s) %11lld bytes ... ", algorithm->name, (m == MODE_FILE) ? "file" : "memory", *threads, size);
+					if (run_benchmark(result, data, filePath, options.minTime))
+					{
+						const double bytes = double(result.size) * double(result.iterations) * double(result.threads);
+						fprintf(stderr, "%10.2f MB/s\n", bytes / (double(result.nanosecs) / 1.0e9) / 1048576.0);
+						results.append(result);
+					}
+					else
+					{
+						fprintf(stderr, "failed!\n");
+						success = false;
+					}
+				}
+			}
+		}
+		if (haveFile)
+		{
+			QFile::remove(filePath);
+		}
+	}
+
+	const QByteArray json = make_json(results, options);
+	if (!options.output.isEmpty())
+	{
+		if (!write_file(options.output, json))
+		{
+			fprintf(stderr, "Failed to write output file!\n");
+			return 1;
+		}
+	}
+	else
+	{
+		fwrite(json.constData(), 1, size_t(json.size()), stdout);
+	}
+
+	return success ? 0 : 1;
+}
@@ -26,12 +26,14 @@
 
 //Qt
 #include <QSet>
+#include <QThread>
+#include <QMutex>
 
 //===========================================================================
 // HELPER METHODS
 //===========================================================================
 
-static _inline void fisherYatesShuffle(QByteArray &arr)
+static inline void fisherYatesShuffle(QByteArray &arr)
 {
 	char *const ptr = arr.data();
 	for (int k = arr.size() - 1; k > 0; k--)
@@ -40,6 +42,112 @@ static _inline void fisherYatesShuffle(QByteArray &arr)
 	}
 }
 
+static QByteArray makeTestData(const int size)
+{
+	QByteArray data(size, '\0');
+	char *const ptr = data.data();
+	for (int k = 0; k < size; k++)
+	{
+		ptr[k] = char((k * 7) + 3);
+	}
+	return data;
+}
+
+//Collects the warnings, e.g. in order to check that a problem is reported exactly once
+static QStringList g_warnings;
+static QMutex g_warningsLock;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+static void collectMessageHandler(QtMsgType type, const QMessageLogContext&, const QString &message)
+{
+	if (type == QtWarningMsg)
+	{
+		QMutexLocker locker(&g_warningsLock);
+		g_warnings << message;
+	}
+}
+#else
+static void collectMessageHandler(QtMsgType type, const char *const message)
+{
+	if (type == QtWarningMsg)
+	{
+		QMutexLocker locker(&g_warningsLock);
+		g_warnings << QString::fromLatin1(message);
+	}
+}
+#endif
+
+class WarningCollector
+{
+public:
+	WarningCollector(void)
+	{
+		g_warnings.clear();
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+		m_previousHandler = qInstallMessageHandler(collectMessageHandler);
+#else
+		m_previousHandler = qInstallMsgHandler(collectMessageHandler);
+#endif
+	}
+	~WarningCollector(void)
+	{
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+		qInstallMessageHandler(m_previousHandler);
+#else
+		qInstallMsgHandler(m_previousHandler);
+#endif
+	}
+	QStringList warnings(void) const
+	{
+		QMutexLocker locker(&g_warningsLock);
+		return g_warnings;
+	}
+private:
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+	QtMessageHandler m_previousHandler;
+#else
+	QtMsgHandler m_previousHandler;
+#endif
+};
+
+//Checks that a file exists all the time, until it is stopped
+class FileWatchThread : public QThread
+{
+public:
+	FileWatchThread(const QString &fileName) : m_fileName(fileName), m_missing(0) {}
+	void stop(void) { m_stop.ref(); }
+	int missing(void) const { return m_missing; }
+
+protected:
+	virtual void run(void)
+	{
+		while (!m_stop)
+		{
+			if (!QFile::exists(m_fileName))
+			{
+				m_missing.ref();
+			}
+		}
+	}
+
+private:
+	const QString m_fileName;
+	QAtomicInt m_stop, m_missing;
+};
+
+static bool streamProgress(const double &progress, void *const userData)
+{
+	double *const lastProgress = reinterpret_cast<double*>(userData);
+	const bool valid = (progress > *lastProgress) && (progress <= 1.0);
+	*lastProgress = progress;
+	return valid;
+}
+
+static bool streamCancel(const double& /*progress*/, void *const /*userData*/)
+{
+	return false;
+}
+
 //===========================================================================
 // TESTBED CLASS
 //===========================================================================
@@ -101,6 +209,94 @@ while(0)
 } \
 while(0)
 
+#define TEST_HASH_FILEMAP(ID, SIZE, OFFSET) do \
+{ \
+	const QString workDir = makeTempFolder(__FUNCTION__); \
+	ASSERT_FALSE(workDir.isEmpty()); \
+	const QString fileName = QString("%1/message.bin").arg(workDir); \
+	const QByteArray message = makeTestData((SIZE)); \
+	{ \
+		QFile file(fileName); \
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate)); \
+		ASSERT_EQ(file.write(message), qint64(message.size())); \
+		file.close(); \
+	} \
+	{ \
+		QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+		QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+		QFile file(fileName); \
+		ASSERT_TRUE(file.open(QIODevice::ReadOnly)); \
+		ASSERT_TRUE(file.seek((OFFSET))); \
+		ASSERT_TRUE(test_1->update(file)); \
+		ASSERT_TRUE(file.atEnd()); \
+		file.close(); \
+		ASSERT_TRUE(test_2->update(message.mid((OFFSET)))); \
+		ASSERT_STRCASEEQ(test_1->digest().constData(), test_2->digest().constData()); \
+	} \
+	QFile::remove(fileName); \
+} \
+while(0)
+
+#define TEST_HASH_STREAM(ID, SIZE, BUFFSIZE, DEPTH) do \
+{ \
+	const QString workDir = makeTempFolder(__FUNCTION__); \
+	ASSERT_FALSE(workDir.isEmpty()); \
+	const QString fileName = QString("%1/message.bin").arg(workDir); \
+	const QByteArray message = makeTestData((SIZE)); \
+	{ \
+		QFile file(fileName); \
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate)); \
+		ASSERT_EQ(file.write(message), qint64(message.size())); \
+		file.close(); \
+	} \
+	{ \
+		QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+		QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+		QFile file(fileName); \
+		ASSERT_TRUE(file.open(QIODevice::ReadOnly)); \
+		double progress = -1.0; \
+		ASSERT_TRUE(test_1->update_stream(file, (BUFFSIZE), (DEPTH), streamProgress, &progress)); \
+		ASSERT_TRUE(file.atEnd()); \
+		ASSERT_DOUBLE_EQ(progress, 1.0); \
+		file.close(); \
+		ASSERT_TRUE(test_2->update(message)); \
+		ASSERT_STRCASEEQ(test_1->digest().constData(), test_2->digest().constData()); \
+	} \
+	{ \
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+		QFile file(fileName); \
+		ASSERT_TRUE(file.open(QIODevice::ReadOnly)); \
+		ASSERT_FALSE(test->update_stream(file, (BUFFSIZE), (DEPTH), streamCancel, NULL)); \
+		file.close(); \
+	} \
+	QFile::remove(fileName); \
+} \
+while(0)
+
+#define TEST_HASH_CHUNKED(ID, SIZE, DIGEST) do \
+{ \
+	static const int CHUNK_SIZE[] = { 1, 127, 128, 129, 255, 256, 257, 4093, 65536, 131071 }; \
+	const QByteArray message = makeTestData((SIZE)); \
+	QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+	for (int offset = 0, k = 0; offset < message.size(); k = (k + 1) % MUTILS_ARR2LEN(CHUNK_SIZE)) \
+	{ \
+		const int len = qMin(CHUNK_SIZE[k], message.size() - offset); \
+		ASSERT_TRUE(test->update(((const quint8*)message.constData()) + offset, len)); \
+		offset += len; \
+	} \
+	ASSERT_STRCASEEQ(test->digest().constData(), (DIGEST)); \
+} \
+while(0)
+
+#define TEST_HASH_BULK(ID, SIZE, DIGEST) do \
+{ \
+	const QByteArray message = makeTestData((SIZE)); \
+	QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_##ID)); \
+	ASSERT_TRUE(test->update(message)); \
+	ASSERT_STRCASEEQ(test->digest().constData(), (DIGEST)); \
+} \
+while(0)
+
 #define TEST_HASH_STRESS(ID, HASHMAP, INPUT) do \
 { \
 	QByteArray message((INPUT)); \
@@ -117,6 +313,42 @@ while(0)
 } \
 while (0)
 
+static const MUtils::Hash::Internal::kernel_t ALL_KERNELS[] =
+{
+	MUtils::Hash::Internal::KERNEL_REF, MUtils::Hash::Internal::KERNEL_SSE2, MUtils::Hash::Internal::KERNEL_SSSE3,
+	MUtils::Hash::Internal::KERNEL_SSE41, MUtils::Hash::Internal::KERNEL_SSE42, MUtils::Hash::Internal::KERNEL_AVX2
+};
+
+static const char *const KERNEL_NAMES[] = { "REF", "SSE2", "SSSE3", "SSE4.1", "SSE4.2", "AVX2" };
+
+//Restores the automatic kernel selection, even if the test has failed
+class KernelGuard
+{
+public:
+	typedef bool (*select_fn)(const MUtils::Hash::Internal::kernel_t kernel);
+	KernelGuard(const select_fn select) : m_select(select) {}
+	~KernelGuard(void) { m_select(MUtils::Hash::Internal::KERNEL_AUTO); }
+private:
+	const select_fn m_select;
+};
+
+//Runs the test function once for each kernel that is available (the reference kernel is always available)
+#define TEST_HASH_KERNELS(SELECT, FUNCTION) do \
+{ \
+	const KernelGuard guard(MUtils::Hash::Internal::SELECT); \
+	ASSERT_TRUE(MUtils::Hash::Internal::SELECT(MUtils::Hash::Internal::KERNEL_REF)); \
+	for (size_t k = 0; k < MUTILS_ARR2LEN(ALL_KERNELS); ++k) \
+	{ \
+		if (MUtils::Hash::Internal::SELECT(ALL_KERNELS[k])) \
+		{ \
+			SCOPED_TRACE(KERNEL_NAMES[k]); \
+			FUNCTION(); \
+			if (HasFatalFailure()) return; \
+		} \
+	} \
+} \
+while(0)
+
 //-----------------------------------------------------------------
 // Keccak
 //-----------------------------------------------------------------
@@ -173,6 +405,21 @@ TEST_F(HashTest, TestKeccak512FileIO)
 	TEST_HASH_FILEIO(KECCAK_512, TEST_MESSAGE_ALT, "0b46f421465ec602262e0a1044e59b36fbdb5f63f84e712963d2bc61bcb46ab0ebf86e59c14c253717ea558929c251695663226ffa5660ff7a29a5acbdaea901");
 }
 
+TEST_F(HashTest, TestKeccakLargeUpdate)
+{
+	//Updates of 512 MiB, or more, must not overflow the 32-Bit bit count
+	const QByteArray message = makeTestData(536870919);
+	quint8 expected[MUtils::Hash::DIGEST_MAX_SIZE];
+	const size_t length = MUtils::Hash::compute(MUtils::Hash::HASH_KECCAK_256, (const quint8*)message.constData(), message.size(), expected, sizeof(expected));
+	QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_KECCAK_256));
+	ASSERT_TRUE(test->update((const quint8*)message.constData(), quint32(message.size())));
+	ASSERT_EQ(test->digest(false), QByteArray((const char*)expected, int(length)));
+	test->reset();
+	ASSERT_TRUE(test->update((const quint8*)message.constData(), 1048576U));
+	ASSERT_TRUE(test->update(((const quint8*)message.constData()) + 1048576, quint32(message.size() - 1048576)));
+	ASSERT_EQ(test->digest(false), QByteArray((const char*)expected, int(length)));
+}
+
 TEST_F(HashTest, TestKeccak512Stress)
 {
 	QSet<QByteArray> test;
@@ -180,6 +427,115 @@ TEST_F(HashTest, TestKeccak512Stress)
 	TEST_HASH_STRESS(KECCAK_512, test, TEST_MESSAGE_ALT);
 }
 
+//-----------------------------------------------------------------
+// SHA-3 (FIPS 202)
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestSha3_224Direct)
+{
+	TEST_HASH_DIRECT(SHA3_224, "",               "6b4e03423667dbb73b6e15454f0eb1abd4597f9a1b078e3f5b5a6bc7");
+	TEST_HASH_DIRECT(SHA3_224, TEST_MESSAGE_ORG, "d15dadceaa4d5d7bb3b48f446421d542e08ad8887305e28d58335795");
+	TEST_HASH_DIRECT(SHA3_224, TEST_MESSAGE_ALT, "854437b658d84ec0587ae7b2565fb386f415a18463f4b169c5bb618b");
+}
+
+TEST_F(HashTest, TestSha3_224FileIO)
+{
+	TEST_HASH_FILEIO(SHA3_224, TEST_MESSAGE_ORG, "d15dadceaa4d5d7bb3b48f446421d542e08ad8887305e28d58335795");
+	TEST_HASH_FILEIO(SHA3_224, TEST_MESSAGE_ALT, "854437b658d84ec0587ae7b2565fb386f415a18463f4b169c5bb618b");
+}
+
+TEST_F(HashTest, TestSha3_256Direct)
+{
+	TEST_HASH_DIRECT(SHA3_256, "",               "a7ffc6f8bf1ed76651c14756a061d662f580ff4de43b49fa82d80a4b80f8434a");
+	TEST_HASH_DIRECT(SHA3_256, TEST_MESSAGE_ORG, "69070dda01975c8c120c3aada1b282394e7f032fa9cf32f4cb2259a0897dfc04");
+	TEST_HASH_DIRECT(SHA3_256, TEST_MESSAGE_ALT, "3c1fa0c6bf31885dbf28b514b52779a14f2fd0b7bacc6d19df6fb201ac99c361");
+}
+
+TEST_F(HashTest, TestSha3_256FileIO)
+{
+	TEST_HASH_FILEIO(SHA3_256, TEST_MESSAGE_ORG, "69070dda01975c8c120c3aada1b282394e7f032fa9cf32f4cb2259a0897dfc04");
+	TEST_HASH_FILEIO(SHA3_256, TEST_MESSAGE_ALT, "3c1fa0c6bf31885dbf28b514b52779a14f2fd0b7bacc6d19df6fb201ac99c361");
+}
+
+TEST_F(HashTest, TestSha3_384Direct)
+{
+	TEST_HASH_DIRECT(SHA3_384, "",               "0c63a75b845e4f7d01107d852e4c2485c51a50aaaa94fc61995e71bbee983a2ac3713831264adb47fb6bd1e058d5f004");
+	TEST_HASH_DIRECT(SHA3_384, TEST_MESSAGE_ORG, "7063465e08a93bce31cd89d2e3ca8f602498696e253592ed26f07bf7e703cf328581e1471a7ba7ab119b1a9ebdf8be41");
+	TEST_HASH_DIRECT(SHA3_384, TEST_MESSAGE_ALT, "8ed0eb2f9fe1d4d14f1c06e25ec9e07cd9fe86a987162db578a87ab6ef9e1e81b84859688bf9b7737ab280abe07dcab9");
+}
+
+TEST_F(HashTest, TestSha3_384FileIO)
+{
+	TEST_HASH_FILEIO(SHA3_384, TEST_MESSAGE_ORG, "7063465e08a93bce31cd89d2e3ca8f602498696e253592ed26f07bf7e703cf328581e1471a7ba7ab119b1a9ebdf8be41");
+	TEST_HASH_FILEIO(SHA3_384, TEST_MESSAGE_ALT, "8ed0eb2f9fe1d4d14f1c06e25ec9e07cd9fe86a987162db578a87ab6ef9e1e81b84859688bf9b7737ab280abe07dcab9");
+}
+
+TEST_F(HashTest, TestSha3_512Direct)
+{
+	TEST_HASH_DIRECT(SHA3_512, "",               "a69f73cca23a9ac5c8b567dc185a756e97c982164fe25859e0d1dcc1475c80a615b2123af1f5f94c11e3e9402c3ac558f500199d95b6d3e301758586281dcd26");
+	TEST_HASH_DIRECT(SHA3_512, TEST_MESSAGE_ORG, "01dedd5de4ef14642445ba5f5b97c15e47b9ad931326e4b0727cd94cefc44fff23f07bf543139939b49128caf436dc1bdee54fcb24023a08d9403f9b4bf0d450");
+	TEST_HASH_DIRECT(SHA3_512, TEST_MESSAGE_ALT, "758e42049c10205ba5e81e1c5613043aab045b8ad2a5185557a7cc5b3e8b44c4c80cdb790c4ea94b5b87bcea0b45869c5bb27b85c6e0c3a222f994202a413392");
+}
+
+TEST_F(HashTest, TestSha3_512FileIO)
+{
+	TEST_HASH_FILEIO(SHA3_512, TEST_MESSAGE_ORG, "01dedd5de4ef14642445ba5f5b97c15e47b9ad931326e4b0727cd94cefc44fff23f07bf543139939b49128caf436dc1bdee54fcb24023a08d9403f9b4bf0d450");
+	TEST_HASH_FILEIO(SHA3_512, TEST_MESSAGE_ALT, "758e42049c10205ba5e81e1c5613043aab045b8ad2a5185557a7cc5b3e8b44c4c80cdb790c4ea94b5b87bcea0b45869c5bb27b85c6e0c3a222f994202a413392");
+}
+
+TEST_F(HashTest, TestShake128Direct)
+{
+	TEST_HASH_DIRECT(SHAKE_128, "",               "7f9c2ba4e88f827d616045507605853ed73b8093f6efbc88eb1a6eacfa66ef26");
+	TEST_HASH_DIRECT(SHAKE_128, TEST_MESSAGE_ORG, "f4202e3c5852f9182a0430fd8144f0a74b95e7417ecae17db0f8cfeed0e3e66e");
+	TEST_HASH_DIRECT(SHAKE_128, TEST_MESSAGE_ALT, "6992964fdc4e918fb288a0f76fb42b0e89dd7354c5a2f7126efa5d28a8bdec6b");
+}
+
+TEST_F(HashTest, TestShake128FileIO)
+{
+	TEST_HASH_FILEIO(SHAKE_128, TEST_MESSAGE_ORG, "f4202e3c5852f9182a0430fd8144f0a74b95e7417ecae17db0f8cfeed0e3e66e");
+	TEST_HASH_FILEIO(SHAKE_128, TEST_MESSAGE_ALT, "6992964fdc4e918fb288a0f76fb42b0e89dd7354c5a2f7126efa5d28a8bdec6b");
+}
+
+TEST_F(HashTest, TestShake256Direct)
+{
+	TEST_HASH_DIRECT(SHAKE_256, "",               "46b9dd2b0ba88d13233b3feb743eeb243fcd52ea62b81b82b50c27646ed5762fd75dc4ddd8c0f200cb05019d67b592f6fc821c49479ab48640292eacb3b7c4be");
+	TEST_HASH_DIRECT(SHAKE_256, TEST_MESSAGE_ORG, "2f671343d9b2e1604dc9dcf0753e5fe15c7c64a0d283cbbf722d411a0e36f6ca1d01d1369a23539cd80f7c054b6e5daf9c962cad5b8ed5bd11998b40d5734442");
+	TEST_HASH_DIRECT(SHAKE_256, TEST_MESSAGE_ALT, "284a28b23afc6f2178966371c441cc8a8e031688c79ebcbf1c3baeba07ad314afb81b6c05d58de475b487e55d8c432ac7cba462f6467b9f65faba765e47a64f6");
+}
+
+TEST_F(HashTest, TestShake256FileIO)
+{
+	TEST_HASH_FILEIO(SHAKE_256, TEST_MESSAGE_ORG, "2f671343d9b2e1604dc9dcf0753e5fe15c7c64a0d283cbbf722d411a0e36f6ca1d01d1369a23539cd80f7c054b6e5daf9c962cad5b8ed5bd11998b40d5734442");
+	TEST_HASH_FILEIO(SHAKE_256, TEST_MESSAGE_ALT, "284a28b23afc6f2178966371c441cc8a8e031688c79ebcbf1c3baeba07ad314afb81b6c05d58de475b487e55d8c432ac7cba462f6467b9f65faba765e47a64f6");
+}
+
+TEST_F(HashTest, TestSha3Chunked)
+{
+	TEST_HASH_CHUNKED(SHA3_256, 1048583, "dc06b2a53bf268a007815d5e63e32b0d284869bc8a378bc66a87328e083783e1");
+	TEST_HASH_CHUNKED(SHA3_512, 1048583, "0c3f92e666d255f4108b6d00b844e47d0069cdd9d46e897d99da79e4429787f10c464b593acb8bc513fcbf01e47d6c8ade81fa861fea21d94b300040e1401f42");
+}
+
+TEST_F(HashTest, TestShakeVariableLength)
+{
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_SHAKE_256));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		ASSERT_STRCASEEQ(test->digest_xof(300).constData(), "2f671343d9b2e1604dc9dcf0753e5fe15c7c64a0d283cbbf722d411a0e36f6ca1d01d1369a23539cd80f7c054b6e5daf9c962cad5b8ed5bd11998b40d5734442bed798f6e5c915bd8bb07e0188d0a55c1290074f1c287af06352299184492cbdec9acba737ee292e5adaa445547355e72a03a3bac3aac770fe5d6b66600ff15d37d5b4789994ea2aeb097f550aa5e88e4d8ff0ba07b88c1c88573063f5d96df820abc2abd177ab037f351c375e553af917132cf2f563c79a619e1bb76e8e2266b0c5617d695f2c496a25f4073b6840c1833757ebb386f16757a8e16a21e9355e9b248f3b33be672da700266be99b8f8725e8ab06075f0219e655ebc188976364b7db139390d34a6ea67b4b223229183a94cf455ece91fdaf5b9c707fa4b40ec39816c1120c7aaaf47920977b");
+	}
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_SHAKE_128));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		const QByteArray result = test->digest_xof(1000);
+		ASSERT_EQ(result.size(), 2000);
+		ASSERT_STRCASEEQ(result.right(64).constData(), "1998594d79e844a76259fa1b2c4a2c6e1ff21f45faccdc1066ee2ce81535254b");
+	}
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_SHA3_256));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		ASSERT_ANY_THROW(test->digest_xof(64));
+	}
+}
+
 //-----------------------------------------------------------------
 // BLAKE2
 //-----------------------------------------------------------------
@@ -197,6 +553,24 @@ TEST_F(HashTest, TestBlake2FileIO)
 	TEST_HASH_FILEIO(BLAKE2_512, TEST_MESSAGE_ALT, "a5b8a16391f8e34e16901fc2fd5754523b0c95354c2f22d3efc327c53070504ea062e219c502561f77a4933c18d36633e5f3ecf1f11506159f4b1875abb767c1");
 }
 
+TEST_F(HashTest, TestBlake2FileMap)
+{
+	TEST_HASH_FILEMAP(BLAKE2_512, 1048583, 0);
+	TEST_HASH_FILEMAP(BLAKE2_512, 1048583, 4099);
+}
+
+TEST_F(HashTest, TestBlake2Stream)
+{
+	TEST_HASH_STREAM(BLAKE2_512, 1048583, 4096, 2);
+	TEST_HASH_STREAM(BLAKE2_512, 1048583, 65537, 5);
+	TEST_HASH_STREAM(BLAKE2_512, 1048583, MUtils::Hash::STREAM_BUFFER_SIZE, MUtils::Hash::STREAM_QUEUE_DEPTH);
+}
+
+TEST_F(HashTest, TestBlake2Chunked)
+{
+	TEST_HASH_CHUNKED(BLAKE2_512, 1048583, "2498d3105f0133a6e5c2878bfdc00acc20700df2fe7621c9dcd5613660610d0f579e9590c92ee8281b9d07a08446a1ec332d5fd3766e06f0a1f78aad4ba28a1e");
+}
+
 TEST_F(HashTest, TestBlake2Stress)
 {
 	QSet<QByteArray> test;
@@ -204,5 +578,1143 @@ TEST_F(HashTest, TestBlake2Stress)
 	TEST_HASH_STRESS(BLAKE2_512, test, TEST_MESSAGE_ALT);
 }
 
+static void testBlake2Kernel(void)
+{
+	TEST_HASH_DIRECT(BLAKE2_512,   "",               "786a02f742015903c6c6fd852552d272912f4740e15847618a86e217f71f5419d25e1031afee585313896444934eb04b903a685b1448b755d56f701afe9be2ce");
+	TEST_HASH_DIRECT(BLAKE2_512,   TEST_MESSAGE_ORG, "a8add4bdddfd93e4877d2746e62817b116364a1fa7bc148d95090bc7333b3673f82401cf7aa2e4cb1ecd90296e3f14cb5413f8ed77be73045b13914cdcd6a918");
+	TEST_HASH_DIRECT(BLAKE2_512,   TEST_MESSAGE_ALT, "a5b8a16391f8e34e16901fc2fd5754523b0c95354c2f22d3efc327c53070504ea062e219c502561f77a4933c18d36633e5f3ecf1f11506159f4b1875abb767c1");
+	TEST_HASH_CHUNKED(BLAKE2_512,  1048583,          "2498d3105f0133a6e5c2878bfdc00acc20700df2fe7621c9dcd5613660610d0f579e9590c92ee8281b9d07a08446a1ec332d5fd3766e06f0a1f78aad4ba28a1e");
+	TEST_HASH_DIRECT(BLAKE2BP_512, TEST_MESSAGE_ORG, "f10e0523631699102c63412c0701fa19f6550fbac0e9c035803c6033b50465222bb92ee0af0dad53edca32f0e08a72c077a6cafc6f4d24a7fb649079d47ce089");
+	TEST_HASH_BULK(BLAKE2BP_512,   1048583,          "6a6b0d9a2a6aea75fdda05f7cb80bb499a031f294391a282a04c471b6570814107f41ac3ab7778d38e11dbbc0b9a413c52202910882e191ec8644d658d0da7fb");
+}
+
+TEST_F(HashTest, TestBlake2Kernels)
+{
+	TEST_HASH_KERNELS(blake2_select_kernel, testBlake2Kernel);
+}
+
+//-----------------------------------------------------------------
+// BLAKE2bp
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestBlake2bpDirect)
+{
+	TEST_HASH_DIRECT(BLAKE2BP_512, "",               "b5ef811a8038f70b628fa8b294daae7492b1ebe343a80eaabbf1f6ae664dd67b9d90b0120791eab81dc96985f28849f6a305186a85501b405114bfa678df9380");
+	TEST_HASH_DIRECT(BLAKE2BP_512, TEST_MESSAGE_ORG, "f10e0523631699102c63412c0701fa19f6550fbac0e9c035803c6033b50465222bb92ee0af0dad53edca32f0e08a72c077a6cafc6f4d24a7fb649079d47ce089");
+	TEST_HASH_DIRECT(BLAKE2BP_512, TEST_MESSAGE_ALT, "f15e5856a8d5180eee3832fbe6d546b237d4e1be28aaefdf588801f8392ef20eedde15236cf9cf35be4182d50aab4ce7958d8991154c80fe757709bcde1ee569");
+}
+
+TEST_F(HashTest, TestBlake2bpFileIO)
+{
+	TEST_HASH_FILEIO(BLAKE2BP_512, TEST_MESSAGE_ORG, "f10e0523631699102c63412c0701fa19f6550fbac0e9c035803c6033b50465222bb92ee0af0dad53edca32f0e08a72c077a6cafc6f4d24a7fb649079d47ce089");
+	TEST_HASH_FILEIO(BLAKE2BP_512, TEST_MESSAGE_ALT, "f15e5856a8d5180eee3832fbe6d546b237d4e1be28aaefdf588801f8392ef20eedde15236cf9cf35be4182d50aab4ce7958d8991154c80fe757709bcde1ee569");
+}
+
+TEST_F(HashTest, TestBlake2bpChunked)
+{
+	TEST_HASH_CHUNKED(BLAKE2BP_512, 1048583, "6a6b0d9a2a6aea75fdda05f7cb80bb499a031f294391a282a04c471b6570814107f41ac3ab7778d38e11dbbc0b9a413c52202910882e191ec8644d658d0da7fb");
+	TEST_HASH_BULK   (BLAKE2BP_512, 1048583, "6a6b0d9a2a6aea75fdda05f7cb80bb499a031f294391a282a04c471b6570814107f41ac3ab7778d38e11dbbc0b9a413c52202910882e191ec8644d658d0da7fb");
+}
+
+//-----------------------------------------------------------------
+// BLAKE2sp
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestBlake2spDirect)
+{
+	TEST_HASH_DIRECT(BLAKE2SP_256, "",               "dd0e891776933f43c7d032b08a917e25741f8aa9a12c12e1cac8801500f2ca4f");
+	TEST_HASH_DIRECT(BLAKE2SP_256, TEST_MESSAGE_ORG, "cf192976714bb648e72b29fa90e6bf0fbc5bf2efe7d5c26ed8ff34e855368691");
+	TEST_HASH_DIRECT(BLAKE2SP_256, TEST_MESSAGE_ALT, "be9cf2c9d2f8b7d670ca8e49cb41eae1aff1e8783e40b2a490479b710371c522");
+}
+
+TEST_F(HashTest, TestBlake2spFileIO)
+{
+	TEST_HASH_FILEIO(BLAKE2SP_256, TEST_MESSAGE_ORG, "cf192976714bb648e72b29fa90e6bf0fbc5bf2efe7d5c26ed8ff34e855368691");
+	TEST_HASH_FILEIO(BLAKE2SP_256, TEST_MESSAGE_ALT, "be9cf2c9d2f8b7d670ca8e49cb41eae1aff1e8783e40b2a490479b710371c522");
+}
+
+TEST_F(HashTest, TestBlake2spChunked)
+{
+	TEST_HASH_CHUNKED(BLAKE2SP_256, 1048583, "5e1abaef81c196bea3e1d253cec7f54a66dbad340b238fae28e045067377da31");
+	TEST_HASH_BULK   (BLAKE2SP_256, 1048583, "5e1abaef81c196bea3e1d253cec7f54a66dbad340b238fae28e045067377da31");
+}
+
+//-----------------------------------------------------------------
+// BLAKE3
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestBlake3Direct)
+{
+	TEST_HASH_DIRECT(BLAKE3, "",               "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262");
+	TEST_HASH_DIRECT(BLAKE3, TEST_MESSAGE_ORG, "2f1514181aadccd913abd94cfa592701a5686ab23f8df1dff1b74710febc6d4a");
+	TEST_HASH_DIRECT(BLAKE3, TEST_MESSAGE_ALT, "320706ef3b2b3f6a351c8796df81cf3bde251026318a7af01d987e2ffe8a1509");
+}
+
+TEST_F(HashTest, TestBlake3FileIO)
+{
+	TEST_HASH_FILEIO(BLAKE3, TEST_MESSAGE_ORG, "2f1514181aadccd913abd94cfa592701a5686ab23f8df1dff1b74710febc6d4a");
+	TEST_HASH_FILEIO(BLAKE3, TEST_MESSAGE_ALT, "320706ef3b2b3f6a351c8796df81cf3bde251026318a7af01d987e2ffe8a1509");
+}
+
+TEST_F(HashTest, TestBlake3Chunked)
+{
+	TEST_HASH_CHUNKED(BLAKE3, 1048583, "e455102e4392e911e16c6ba0e70120ce0ac54d2c35575831aee8a07a27f6108c");
+	TEST_HASH_BULK   (BLAKE3, 1048583, "e455102e4392e911e16c6ba0e70120ce0ac54d2c35575831aee8a07a27f6108c");
+	TEST_HASH_BULK   (BLAKE3, 4194311, "4abd35204e18f7223e35f833e965654f6730b235c433692a31dd40014791985e");
+}
+
+TEST_F(HashTest, TestBlake3Keyed)
+{
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3, SEED_KEY));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		ASSERT_STRCASEEQ(test->digest().constData(), "61ace1377acc77d9c454fe598b2a15a404ef8785b9fc95efea2ec3f25457b823");
+	}
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3, "0123456789abcdef0123456789abcdef"));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		ASSERT_STRCASEEQ(test->digest().constData(), "21a07a8ba8ffb2012fd4e281a41a1fda1396a27ca10c5c897a8813fa98e3173b");
+	}
+}
+
+TEST_F(HashTest, TestBlake3DeriveKey)
+{
+	static const char *const INPUT[] = { "", TEST_MESSAGE_ORG, TEST_MESSAGE_ALT };
+	static const char *const DIGEST[] =
+	{
+		"90ab2829d6ac665c1245909e8ce37696bacc9b491b548d5b5f7da477b455f021",
+		"cea2442490657f0042c5651b23cb0bba5b8a92f9456d893fcf492a96e7767257",
+		"2eee514ee05d5ba86b185c0fb2811bb1dcbf8d9e9d40420f81eceb849b27e03d"
+	};
+	for (size_t i = 0; i < MUTILS_ARR2LEN(INPUT); ++i)
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, SEED_KEY));
+		ASSERT_TRUE(test->update(QByteArray(INPUT[i])));
+		ASSERT_STRCASEEQ(test->digest().constData(), DIGEST[i]);
+	}
+	//The context string is mandatory
+	quint8 buffer[32];
+	ASSERT_ANY_THROW(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY));
+	ASSERT_ANY_THROW(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, ""));
+	ASSERT_ANY_THROW(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, QByteArray()));
+	ASSERT_ANY_THROW(MUtils::Hash::compute(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, (const quint8*)TEST_MESSAGE_ORG, 4U, buffer, sizeof(buffer)));
+	ASSERT_ANY_THROW(MUtils::Hash::compute(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, (const quint8*)TEST_MESSAGE_ORG, 4U, buffer, sizeof(buffer), QByteArray()));
+}
+
+TEST_F(HashTest, TestBlake3BinaryKey)
+{
+	//Keys and context strings that contain NULL characters must be used in full
+	QByteArray key32(32, '\0'), key7("\0key\0\1\2", 7), context("MUtils\0context", 14);
+	for (int i = 0; i < key32.size(); ++i)
+	{
+		key32[i] = char(i);
+	}
+	static const char *const DIGEST[] =
+	{
+		"f1c78a63454ec51f42b9d88ac49133942182b5ecb380dc9ec90dcd7e6ad675e8",
+		"5a0a69ff660b73c6406e83042aac89ec69fe20a038d7573ffa7228e977f62fd7",
+		"caab17a2274f41d75f3fd20e6715fcab9e83f32c13796e0280900e18186179ce"
+	};
+	const quint16 hashIds[] = { MUtils::Hash::HASH_BLAKE3, MUtils::Hash::HASH_BLAKE3, MUtils::Hash::HASH_BLAKE3_DERIVE_KEY };
+	const QByteArray keys[] = { key32, key7, context };
+	for (size_t i = 0; i < MUTILS_ARR2LEN(DIGEST); ++i)
+	{
+		QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(hashIds[i], keys[i]));
+		ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+		ASSERT_STRCASEEQ(test->digest().constData(), DIGEST[i]);
+		quint8 buffer[32];
+		ASSERT_EQ(MUtils::Hash::compute(hashIds[i], (const quint8*)TEST_MESSAGE_ORG, qstrlen(TEST_MESSAGE_ORG), buffer, sizeof(buffer), keys[i]), size_t(32U));
+		ASSERT_EQ(MUtils::Hash::to_hex(QByteArray((const char*)buffer, 32)), QByteArray(DIGEST[i]));
+	}
+	//Other hash functions take a NULL-terminated key, so they must reject keys that contain NULL characters
+	QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_SHA3_256, QByteArray(SEED_KEY)));
+	QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_SHA3_256, SEED_KEY));
+	ASSERT_TRUE(test_1->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_TRUE(test_2->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_STRCASEEQ(test_1->digest().constData(), test_2->digest().constData());
+	ASSERT_ANY_THROW(MUtils::Hash::create(MUtils::Hash::HASH_SHA3_256, key7));
+}
+
+TEST_F(HashTest, TestBlake3VariableLength)
+{
+	QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3));
+	ASSERT_TRUE(test->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_STRCASEEQ(test->digest_xof(100).constData(), "2f1514181aadccd913abd94cfa592701a5686ab23f8df1dff1b74710febc6d4ac0615cd845be939b4ef6aec25e799aaa450c63f8d9e333cdb0dd79b70ee698793ca5d743d5be1581b2a800bbc21624cbc2ec21a7b24cf36b0e20e55872470758ac3001a0");
+}
+
+//BLAKE3 vectors for multi-chunk inputs, so that the SIMD kernels (4 or 8 chunks at a time) are actually used
+static const char *const BLAKE3_KERNEL_KEY = "0123456789abcdef0123456789abcdef";
+static const char *const BLAKE3_KERNEL_CONTEXT = "MUtils BLAKE3 kernel test context";
+
+static const struct
+{
+	int size;
+	const char *hash, *keyed, *derived;
+}
+BLAKE3_KERNEL_VECTORS[] =
+{
+	{      0, "af1349b9f5f9a1a6a0404dea36dcc9499bcb25c9adc112b7cc9a93cae41f3262", "81591338b3d8b9dc4ff3b228cdd28b23df07fcecb1e2e77c4725beeccd77e916", "5ad64a19d466295e4480929a2ea52e2519c6bc86804a23f4159172fcd640e46f" },
+	{      1, "e1e0e81d6ea39b0cf8b86ffd440921011f57400cbc3f76a8a171906a9b8d7505", "95fef620cffd9cf82a759a62dde57d729c993a543a57f720a8a82bc0e640777a", "2f2202c90680b54f999391ed7fb0237b0d0f48b3bdadd5eaff6d2ef47941d38e" },
+	{   1023, "b16a55436c00d72a5bbdeae4b0cfb08c88a9cf5aad4de867a4fd0f4526afa8c7", "83936cc9b5037235b98f1f00eacb513b9ee031540ec75c80c5de21cfc7431c05", "55f41146fdfe9090b8bf36eb6f66d9e805721178342d9c91284f41ebc1becbc8" },
+	{   1024, "e3f027f2c0380f4ee59b4213e5bbfc65e5158b27196bb5ea63453a2cbc47a888", "e7c99c2a6928c1c9fcc094bb230b8bcfe3cfa2a1fd9293b177da6e8360fa22cd", "64e931306d47b4754fa1719b6ff99724d877e9b8fe39530e6a109aec0e4afb8a" },
+	{   1025, "afd7cf3dec77579ce5aaab21256350d354ca4caaef56e897405771d6bb4c0c93", "0fb488ce3907c1fcffd1ba8e598388e549cd6eb0babb979bfe5828a3bffb1e12", "f11bf5dfc384c02f8f400804933dac9e123b17152ea1147ecc364b07ddcc116a" },
+	{   4096, "9e3a7ccd40e77a7060d87c025e1a98d250a2911c7c3e5c2f0d99f1232701750e", "66620dfdb6d671329cf0ae9d1820e35c7f9ad78c0aab8349c92abe6845164a43", "4d06ddfeb75517eafb5ce97d0143a9d68f1a357d4e3a64532b153abaced83902" },
+	{   4097, "dc0106879b10043942fec7a334f9b54c8c775fdbb60f90904b513a20370ba5dc", "be2fa3a374e06904fb7d638d723634455fc131d2f6358a1bd13d7b5af90ff99f", "4e501e3a72322a6ba07bd402e8bebf6ff9308517a1e08fc2173f521a535975d3" },
+	{   8192, "f5ef5e2c6912ded4e8f695eaf80634afb47bba83c51dc6708eed91cfafb9d2fe", "9e14d0a5fad88b5c240d33e8e3e78a3301473f2c154085acfc91626a6804164c", "11d20380d09d8dd1fa9601556272e42a9ab72cc6d1c810f9ee13c987c32578e8" },
+	{   8193, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da", "a32621b577ba5814f5544cd8a8d90d33cb13e2f762bc0452e2a61e9d4fb0e7b6" },
+	{  31745, "1313413a8bf25df7db3af3a47e912c860e2870ae3e2fe3973c705209b2f8e8a5", "b71213c3f1eb08326a03f90e3085cf38d5ddf24af878c1f2fff1fb6ebde1e596", "acd7a9f8d4a6ad59d213fbb8551cc3ab5a1b14c3af4e8ee835e5b8d6adfc76d1" },
+	{ 102400, "b27d36270f97131805636689d1879f884e33dd113dfcacc88caef68d2fcc89b4", "66819d9781de02372b395670e006b07ae3173414343670fe4be411bb7067dcbb", "97ffafc152edad85012fb774140d8b172f5c06b68f68ddb243e4335f18f957b1" },
+};
+
+static const struct
+{
+	quint32 length;
+	const char *hash, *keyed;
+}
+BLAKE3_KERNEL_XOF_VECTORS[] = /*input size is 8193*/
+{
+	{   1, "c9", "15" },
+	{  31, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d2908", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9" },
+	{  32, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da" },
+	{  33, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883cf", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da6d" },
+	{  64, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883cf0d5db2cd25377733644ed1eb1523dc15427fb8a45d364ff2bdd73d159b389d", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da6d4e062aa98c332ec6bff3a85bcd8f0ae47e8d47c56be30361e03a8a9144d5da" },
+	{  65, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883cf0d5db2cd25377733644ed1eb1523dc15427fb8a45d364ff2bdd73d159b389d21", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da6d4e062aa98c332ec6bff3a85bcd8f0ae47e8d47c56be30361e03a8a9144d5dac7" },
+	{ 131, "c9b4555444dc857c86dd221f7c6752aa52e85c1f304a0a4954a256168d290883cf0d5db2cd25377733644ed1eb1523dc15427fb8a45d364ff2bdd73d159b389d2128dee25993ae66e09f9c3128b866b810dee02a31b22aa734886c6ebd8d15412ff5359fa6a4099d86bad4923a85187971c6c023a01ad61553630d47afd0bf08e67e54", "1580a14812aa9d2194fbb517a299fc98256c146ada161c799371361a60bfc9da6d4e062aa98c332ec6bff3a85bcd8f0ae47e8d47c56be30361e03a8a9144d5dac7fde25a6a6d14db8982d50d67fc66044d392efa258b1e8e4e10d8001c064b6497c8d54e5b779fcbbc3b6ae2dc42791ca6d7dd7ca378ca31acec2ee822174b2b14dc02" },
+};
+
+static void testBlake3Kernel(void)
+{
+	for (size_t i = 0; i < MUTILS_ARR2LEN(BLAKE3_KERNEL_VECTORS); ++i)
+	{
+		const QByteArray message = makeTestData(BLAKE3_KERNEL_VECTORS[i].size);
+		QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3));
+		QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3, BLAKE3_KERNEL_KEY));
+		QScopedPointer<MUtils::Hash::Hash> test_3(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3_DERIVE_KEY, BLAKE3_KERNEL_CONTEXT));
+		ASSERT_TRUE(test_1->update(message));
+		ASSERT_TRUE(test_2->update(message));
+		ASSERT_TRUE(test_3->update(message));
+		ASSERT_STRCASEEQ(test_1->digest().constData(), BLAKE3_KERNEL_VECTORS[i].hash);
+		ASSERT_STRCASEEQ(test_2->digest().constData(), BLAKE3_KERNEL_VECTORS[i].keyed);
+		ASSERT_STRCASEEQ(test_3->digest().constData(), BLAKE3_KERNEL_VECTORS[i].derived);
+	}
+	const QByteArray message = makeTestData(8193);
+	for (size_t i = 0; i < MUTILS_ARR2LEN(BLAKE3_KERNEL_XOF_VECTORS); ++i)
+	{
+		QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3));
+		QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3, BLAKE3_KERNEL_KEY));
+		ASSERT_TRUE(test_1->update(message));
+		ASSERT_TRUE(test_2->update(message));
+		ASSERT_STRCASEEQ(test_1->digest_xof(BLAKE3_KERNEL_XOF_VECTORS[i].length).constData(), BLAKE3_KERNEL_XOF_VECTORS[i].hash);
+		ASSERT_STRCASEEQ(test_2->digest_xof(BLAKE3_KERNEL_XOF_VECTORS[i].length).constData(), BLAKE3_KERNEL_XOF_VECTORS[i].keyed);
+	}
+	TEST_HASH_BULK(BLAKE3, 4194311, "4abd35204e18f7223e35f833e965654f6730b235c433692a31dd40014791985e");
+}
+
+TEST_F(HashTest, TestBlake3Kernels)
+{
+	TEST_HASH_KERNELS(blake3_select_kernel, testBlake3Kernel);
+}
+
+//-----------------------------------------------------------------
+// XXH3 / CRC32C
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestXXH3_64Direct)
+{
+	TEST_HASH_DIRECT(XXH3_64, "",               "2d06800538d394c2");
+	TEST_HASH_DIRECT(XXH3_64, TEST_MESSAGE_ORG, "ce7d19a5418fb365");
+	TEST_HASH_DIRECT(XXH3_64, TEST_MESSAGE_ALT, "9fcadf1e04854830");
+}
+
+TEST_F(HashTest, TestXXH3_64FileIO)
+{
+	TEST_HASH_FILEIO(XXH3_64, TEST_MESSAGE_ORG, "ce7d19a5418fb365");
+	TEST_HASH_FILEIO(XXH3_64, TEST_MESSAGE_ALT, "9fcadf1e04854830");
+}
+
+TEST_F(HashTest, TestXXH3_128Direct)
+{
+	TEST_HASH_DIRECT(XXH3_128, "",               "99aa06d3014798d86001c324468d497f");
+	TEST_HASH_DIRECT(XXH3_128, TEST_MESSAGE_ORG, "ddd650205ca3e7fa24a1cc2e3a8a7651");
+	TEST_HASH_DIRECT(XXH3_128, TEST_MESSAGE_ALT, "9275774ae6218bdf8934c7ad4a9c435e");
+}
+
+TEST_F(HashTest, TestXXH3_128FileIO)
+{
+	TEST_HASH_FILEIO(XXH3_128, TEST_MESSAGE_ORG, "ddd650205ca3e7fa24a1cc2e3a8a7651");
+	TEST_HASH_FILEIO(XXH3_128, TEST_MESSAGE_ALT, "9275774ae6218bdf8934c7ad4a9c435e");
+}
+
+TEST_F(HashTest, TestXXH3Chunked)
+{
+	TEST_HASH_CHUNKED(XXH3_64,  1048583, "3e3b343c763535e7");
+	TEST_HASH_BULK   (XXH3_64,  4194311, "4c544ba50f7ac53c");
+	TEST_HASH_CHUNKED(XXH3_128, 1048583, "5a5f580899350ab23e3b343c763535e7");
+	TEST_HASH_BULK   (XXH3_128, 4194311, "ad607f7ce4a3a1e54c544ba50f7ac53c");
+}
+
+TEST_F(HashTest, TestXXH3Keyed)
+{
+	QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_XXH3_64, SEED_KEY));
+	QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_XXH3_128, SEED_KEY));
+	ASSERT_TRUE(test_1->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_TRUE(test_2->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_STRCASEEQ(test_1->digest().constData(), "5e1d3e65b7229536");
+	ASSERT_STRCASEEQ(test_2->digest().constData(), "992327c54cf5214069f9ec186f7cbfdd");
+}
+
+TEST_F(HashTest, TestCRC32CDirect)
+{
+	TEST_HASH_DIRECT(CRC32C, "",               "00000000");
+	TEST_HASH_DIRECT(CRC32C, "123456789",      "e3069283");
+	TEST_HASH_DIRECT(CRC32C, TEST_MESSAGE_ORG, "22620404");
+	TEST_HASH_DIRECT(CRC32C, TEST_MESSAGE_ALT, "6d0d5609");
+}
+
+TEST_F(HashTest, TestCRC32CFileIO)
+{
+	TEST_HASH_FILEIO(CRC32C, TEST_MESSAGE_ORG, "22620404");
+	TEST_HASH_FILEIO(CRC32C, TEST_MESSAGE_ALT, "6d0d5609");
+}
+
+TEST_F(HashTest, TestCRC32CChunked)
+{
+	TEST_HASH_CHUNKED(CRC32C, 1048583, "b56c6b18");
+	TEST_HASH_BULK   (CRC32C, 4194311, "adf58e1f");
+}
+
+//Vectors around the boundaries of the short-input paths (16, 128 and 240 bytes) and of the stripes/blocks that the SIMD kernels process
+static const struct
+{
+	int size;
+	const char *xxh3_64, *xxh3_64_keyed, *xxh3_128, *xxh3_128_keyed;
+}
+XXH3_KERNEL_VECTORS[] =
+{
+	{      0, "2d06800538d394c2", "8adf4033241b0af5", "99aa06d3014798d86001c324468d497f", "9474bc086519f6172de07f7fbeeac38b" },
+	{      1, "13e608bc156defed", "63e29ceeebf239a4", "22bbb76b211a39ba13e608bc156defed", "6e65a5747b892c6763e29ceeebf239a4" },
+	{      3, "a9088dda485b481c", "384405a6e097c025", "ce31763cbf8245a5a9088dda485b481c", "f56cae4e55fabfeb384405a6e097c025" },
+	{      4, "6d9253b16c8b1ed3", "139d7ddf72ba4ca6", "47197970590746b1788a609154b0fe20", "9b0777a234f81f7feb4e7a283bf4a1cd" },
+	{      8, "60539db630471163", "3b9d4659a96b1edf", "e3bc8a5f461715553cd024e3d63a1588", "8efa7febcb93abfe894204772b37d954" },
+	{      9, "feff668361d723a8", "551609f5c0094e60", "c72c88247a9a56d7eafab1c7f123109f", "4fd336a114bc183f1bdcebea130b8c28" },
+	{     16, "b8c859b0f030b585", "e4355e88fafec1e5", "ce0b9647ab24f88460d75c5e47d40a24", "ca97f0960f17e5fe1fa621816f6b1113" },
+	{     17, "714a04408e79b80f", "d7cc9ef64080e37c", "bfd327edcc2fbd12eeed7654312a26d7", "e60cd889eba2944535606043fc67f8f2" },
+	{    128, "67425a03650261bf", "2cc208e0654c8eee", "1b1962a096bac78bc580008b6c92ac53", "9f2aa93e2deb2ac44954f2b6eb961d3f" },
+	{    129, "c664bf3311c6abc4", "9565239585a18f8b", "293e4968c4619023bd91ce7ace4d385b", "fa7c57b806d343432f0cb26aa9c10cf4" },
+	{    240, "64556dc6b462a6cf", "62ad5e676075ea51", "ad46c1021b076bc704e0b5f034bee80b", "467ea0f2e2912158c49616441fc0f8ad" },
+	{    241, "8beadd3a8874fe17", "68953220f78c4224", "ac6c3492c3d6b45d8beadd3a8874fe17", "81f3c4d8da5331aa68953220f78c4224" },
+	{   1023, "d26986a0b85dcc44", "b309fec967326c94", "dedd3c0d6bceed34d26986a0b85dcc44", "9b52afbf3dd88628b309fec967326c94" },
+	{   1024, "9b81661c641c72b1", "5c247d9233fce73f", "18bc0eaca9a336369b81661c641c72b1", "9d8d2817c5b5fb095c247d9233fce73f" },
+	{   1025, "806c2072ed713576", "e62fa29d67820daa", "bf447251cfa98d7c806c2072ed713576", "2887755252a6b966e62fa29d67820daa" },
+	{   4096, "d7428746842be37e", "cb62553ba1e704e0", "1546867423105cd5d7428746842be37e", "954261e7baea7b22cb62553ba1e704e0" },
+	{   4097, "a51ead018cadb378", "03af9febbdc7be36", "895472d9c4a4a7d2a51ead018cadb378", "051c50da26ea2df803af9febbdc7be36" },
+	{ 100003, "d3c5426780ed98b3", "4e38993aa587247e", "45791f178bfff9e8d3c5426780ed98b3", "11ad53e71d1a29504e38993aa587247e" },
+};
+
+static const struct
+{
+	int size;
+	const char *crc, *crc_keyed;
+}
+CRC32C_KERNEL_VECTORS[] =
+{
+	{      0, "00000000", "cf35a957" },
+	{      1, "412da0a5", "c40d2b34" },
+	{      7, "a5702c56", "122ffb32" },
+	{      8, "d225c0e8", "74ce9b42" },
+	{      9, "922c64ce", "5b23120b" },
+	{    255, "92bb6a3d", "79629abf" },
+	{    256, "63094dfc", "002fdf83" },
+	{   1023, "c392f6e6", "06376ee9" },
+	{   1024, "29022ef0", "77d4b74c" },
+	{   1025, "b26acdfe", "4d62a67e" },
+	{   8195, "20db9545", "a811f387" },
+	{ 100003, "97614f92", "67c8f766" },
+};
+
+static void testXXH3Kernel(void)
+{
+	for (size_t i = 0; i < MUTILS_ARR2LEN(XXH3_KERNEL_VECTORS); ++i)
+	{
+		const QByteArray message = makeTestData(XXH3_KERNEL_VECTORS[i].size);
+		const char *const expected[] = { XXH3_KERNEL_VECTORS[i].xxh3_64, XXH3_KERNEL_VECTORS[i].xxh3_64_keyed, XXH3_KERNEL_VECTORS[i].xxh3_128, XXH3_KERNEL_VECTORS[i].xxh3_128_keyed };
+		for (size_t j = 0; j < 4U; ++j)
+		{
+			QScopedPointer<MUtils::Hash::Hash> test(MUtils::Hash::create((j < 2U) ? MUtils::Hash::HASH_XXH3_64 : MUtils::Hash::HASH_XXH3_128, (j % 2U) ? SEED_KEY : NULL));
+			ASSERT_TRUE(test->update(message));
+			ASSERT_STRCASEEQ(test->digest().constData(), expected[j]);
+		}
+	}
+	TEST_HASH_CHUNKED(XXH3_64,  1048583, "3e3b343c763535e7");
+	TEST_HASH_CHUNKED(XXH3_128, 1048583, "5a5f580899350ab23e3b343c763535e7");
+}
+
+static void testCRC32CKernel(void)
+{
+	for (size_t i = 0; i < MUTILS_ARR2LEN(CRC32C_KERNEL_VECTORS); ++i)
+	{
+		const QByteArray message = makeTestData(CRC32C_KERNEL_VECTORS[i].size);
+		QScopedPointer<MUtils::Hash::Hash> test_1(MUtils::Hash::create(MUtils::Hash::HASH_CRC32C));
+		QScopedPointer<MUtils::Hash::Hash> test_2(MUtils::Hash::create(MUtils::Hash::HASH_CRC32C, SEED_KEY));
+		ASSERT_TRUE(test_1->update(message));
+		ASSERT_TRUE(test_2->update(message));
+		ASSERT_STRCASEEQ(test_1->digest().constData(), CRC32C_KERNEL_VECTORS[i].crc);
+		ASSERT_STRCASEEQ(test_2->digest().constData(), CRC32C_KERNEL_VECTORS[i].crc_keyed);
+	}
+	TEST_HASH_DIRECT(CRC32C, "123456789", "e3069283");
+	TEST_HASH_CHUNKED(CRC32C, 1048583, "b56c6b18");
+}
+
+TEST_F(HashTest, TestXXH3Kernels)
+{
+	TEST_HASH_KERNELS(xxh3_select_kernel, testXXH3Kernel);
+}
+
+TEST_F(HashTest, TestCRC32CKernels)
+{
+	TEST_HASH_KERNELS(crc32c_select_kernel, testCRC32CKernel);
+}
+
+//-----------------------------------------------------------------
+// Reset
+//-----------------------------------------------------------------
+
+static const quint16 ALL_HASH_IDS[] =
+{
+	MUtils::Hash::HASH_BLAKE2_512, MUtils::Hash::HASH_BLAKE2BP_512, MUtils::Hash::HASH_BLAKE2SP_256,
+	MUtils::Hash::HASH_KECCAK_224, MUtils::Hash::HASH_KECCAK_256, MUtils::Hash::HASH_KECCAK_384, MUtils::Hash::HASH_KECCAK_512,
+	MUtils::Hash::HASH_SHA3_224, MUtils::Hash::HASH_SHA3_256, MUtils::Hash::HASH_SHA3_384, MUtils::Hash::HASH_SHA3_512,
+	MUtils::Hash::HASH_SHAKE_128, MUtils::Hash::HASH_SHAKE_256, MUtils::Hash::HASH_BLAKE3, MUtils::Hash::HASH_BLAKE3_DERIVE_KEY,
+	MUtils::Hash::HASH_XXH3_64, MUtils::Hash::HASH_XXH3_128, MUtils::Hash::HASH_CRC32C
+};
+
+TEST_F(HashTest, TestHashReset)
+{
+	const QByteArray message = makeTestData(4093);
+	for (size_t k = 0; k < MUTILS_ARR2LEN(ALL_HASH_IDS); ++k)
+	{
+		for (int seeded = 0; seeded < 2; ++seeded)
+		{
+			const char *const key = seeded ? SEED_KEY : NULL;
+			if ((!key) && (ALL_HASH_IDS[k] == MUtils::Hash::HASH_BLAKE3_DERIVE_KEY))
+			{
+				continue; /*requires a context string*/
+			}
+			QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(ALL_HASH_IDS[k], key));
+			ASSERT_TRUE(expected->update(message));
+			const QByteArray digest = expected->digest();
+			QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(ALL_HASH_IDS[k], key));
+			ASSERT_TRUE(hash->update(QByteArray(TEST_MESSAGE_ORG)));
+			hash->reset();
+			ASSERT_TRUE(hash->update(message));
+			ASSERT_STRCASEEQ(hash->digest().constData(), digest.constData());
+			for (int i = 0; i < 3; ++i)
+			{
+				hash->reset();
+				ASSERT_TRUE(hash->update(message));
+				ASSERT_STRCASEEQ(hash->digest().constData(), digest.constData());
+			}
+		}
+	}
+}
+
+TEST_F(HashTest, TestHashPool)
+{
+	const QByteArray message = makeTestData(65537);
+	QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3, SEED_KEY));
+	ASSERT_TRUE(expected->update(message));
+	const QByteArray digest = expected->digest();
+
+	MUtils::Hash::HashPool pool(MUtils::Hash::HASH_BLAKE3, SEED_KEY);
+	MUtils::Hash::Hash *const hash_1 = pool.acquire();
+	MUtils::Hash::Hash *const hash_2 = pool.acquire();
+	ASSERT_NE(hash_1, hash_2);
+	ASSERT_TRUE(hash_1->update(message));
+	ASSERT_TRUE(hash_2->update(QByteArray(TEST_MESSAGE_ORG)));
+	ASSERT_STRCASEEQ(hash_1->digest().constData(), digest.constData());
+	pool.release(hash_1);
+	pool.release(hash_2);
+	for (int i = 0; i < 3; ++i)
+	{
+		MUtils::Hash::Hash *const hash = pool.acquire();
+		ASSERT_TRUE((hash == hash_1) || (hash == hash_2));
+		ASSERT_TRUE(hash->update(message));
+		ASSERT_STRCASEEQ(hash->digest().constData(), digest.constData());
+		pool.release(hash);
+	}
+	ASSERT_ANY_THROW(MUtils::Hash::HashPool(0xFFFF));
+}
+
+//-----------------------------------------------------------------
+// Resume
+//-----------------------------------------------------------------
+
+static const quint16 RESUMABLE_HASH_IDS[] =
+{
+	MUtils::Hash::HASH_BLAKE2_512, MUtils::Hash::HASH_KECCAK_224, MUtils::Hash::HASH_KECCAK_256, MUtils::Hash::HASH_KECCAK_384, MUtils::Hash::HASH_KECCAK_512,
+	MUtils::Hash::HASH_SHA3_224, MUtils::Hash::HASH_SHA3_256, MUtils::Hash::HASH_SHA3_384, MUtils::Hash::HASH_SHA3_512, MUtils::Hash::HASH_SHAKE_128, MUtils::Hash::HASH_SHAKE_256
+};
+
+TEST_F(HashTest, TestHashSaveState)
+{
+	const QByteArray message = makeTestData(1048583);
+	for (size_t k = 0; k < MUTILS_ARR2LEN(RESUMABLE_HASH_IDS); ++k)
+	{
+		for (int seeded = 0; seeded < 2; ++seeded)
+		{
+			const char *const key = seeded ? SEED_KEY : NULL;
+			QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(RESUMABLE_HASH_IDS[k], key));
+			ASSERT_TRUE(expected->update(message));
+			const QByteArray digest = expected->digest();
+			QByteArray state;
+			{
+				QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(RESUMABLE_HASH_IDS[k], key));
+				ASSERT_TRUE(hash->update(message.left(65537)));
+				state = hash->save_state();
+			}
+			QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(RESUMABLE_HASH_IDS[k], key));
+			ASSERT_TRUE(hash->update(QByteArray(TEST_MESSAGE_ORG)));
+			ASSERT_TRUE(hash->restore_state(state));
+			ASSERT_TRUE(hash->update(message.mid(65537)));
+			ASSERT_STRCASEEQ(hash->digest().constData(), digest.constData());
+		}
+	}
+}
+
+TEST_F(HashTest, TestHashSaveStateInvalid)
+{
+	QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_KECCAK_256));
+	ASSERT_TRUE(hash->update(QByteArray(TEST_MESSAGE_ORG)));
+	const QByteArray state = hash->save_state();
+	QByteArray corrupted(state);
+	corrupted[corrupted.size() / 2] = corrupted[corrupted.size() / 2] ^ 0x01;
+	ASSERT_FALSE(hash->restore_state(corrupted));
+	ASSERT_FALSE(hash->restore_state(state.left(state.size() - 1)));
+	ASSERT_FALSE(hash->restore_state(QByteArray()));
+	QScopedPointer<MUtils::Hash::Hash> other(MUtils::Hash::create(MUtils::Hash::HASH_SHA3_256));
+	ASSERT_FALSE(other->restore_state(state));
+	QScopedPointer<MUtils::Hash::Hash> blake3(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE3));
+	ASSERT_ANY_THROW(blake3->save_state());
+	ASSERT_STRCASEEQ(hash->digest().constData(), "4d741b6f1eb29cb2a9b9911c82f56fa8d73b04959d3d9d222895df6c0b28aa15");
+}
+
+TEST_F(HashTest, TestHashUpdateOffset)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/message.bin").arg(workDir);
+	const QByteArray message = makeTestData(4194311);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(message), qint64(message.size()));
+		file.close();
+	}
+	QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+	ASSERT_TRUE(expected->update(message));
+	const QByteArray digest = expected->digest();
+
+	//Process the file in several "sessions", passing on the saved state from one session to the next
+	static const qint64 SESSION_SIZE = 1048573;
+	QByteArray state;
+	for (qint64 offset = 0; offset < qint64(message.size()); offset += SESSION_SIZE)
+	{
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+		if (!state.isEmpty())
+		{
+			ASSERT_TRUE(hash->restore_state(state));
+		}
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(hash->update(file, offset, SESSION_SIZE));
+		ASSERT_EQ(file.pos(), qMin(offset + SESSION_SIZE, qint64(message.size())));
+		file.close();
+		state = hash->save_state();
+	}
+
+	QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+	ASSERT_TRUE(hash->restore_state(state));
+	ASSERT_STRCASEEQ(hash->digest().constData(), digest.constData());
+	QFile::remove(fileName);
+}
+
+//-----------------------------------------------------------------
+// One-Shot
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestHashCompute)
+{
+	const QByteArray message = makeTestData(65537);
+	for (size_t k = 0; k < MUTILS_ARR2LEN(ALL_HASH_IDS); ++k)
+	{
+		for (int seeded = 0; seeded < 2; ++seeded)
+		{
+			const char *const key = seeded ? SEED_KEY : NULL;
+			if ((!key) && (ALL_HASH_IDS[k] == MUtils::Hash::HASH_BLAKE3_DERIVE_KEY))
+			{
+				continue; /*requires a context string*/
+			}
+			QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(ALL_HASH_IDS[k], key));
+			ASSERT_TRUE(expected->update(message));
+			const QByteArray digest = expected->digest(false);
+			ASSERT_EQ(size_t(digest.size()), MUtils::Hash::digest_size(ALL_HASH_IDS[k]));
+			quint8 buffer[MUtils::Hash::DIGEST_MAX_SIZE];
+			const size_t length = MUtils::Hash::compute(ALL_HASH_IDS[k], (const quint8*)message.constData(), message.size(), buffer, sizeof(buffer), key);
+			ASSERT_EQ(QByteArray((const char*)buffer, int(length)), digest);
+			QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(ALL_HASH_IDS[k], key));
+			ASSERT_TRUE(hash->update(message));
+			ASSERT_EQ(hash->digest_into(buffer, sizeof(buffer)), length);
+			ASSERT_EQ(QByteArray((const char*)buffer, int(length)), digest);
+			ASSERT_ANY_THROW(MUtils::Hash::compute(ALL_HASH_IDS[k], (const quint8*)message.constData(), message.size(), buffer, length - 1U, key));
+		}
+	}
+	ASSERT_ANY_THROW(MUtils::Hash::digest_size(0xFFFF));
+}
+
+TEST_F(HashTest, TestHashDigestXofInto)
+{
+	static const quint16 XOF_HASH_IDS[] = { MUtils::Hash::HASH_SHAKE_128, MUtils::Hash::HASH_SHAKE_256, MUtils::Hash::HASH_BLAKE3 };
+	for (size_t k = 0; k < MUTILS_ARR2LEN(XOF_HASH_IDS); ++k)
+	{
+		QScopedPointer<MUtils::Hash::Hash> expected(MUtils::Hash::create(XOF_HASH_IDS[k]));
+		ASSERT_TRUE(expected->update(QByteArray(TEST_MESSAGE_ORG)));
+		const QByteArray digest = expected->digest_xof(100U, false);
+		quint8 buffer[100U];
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(XOF_HASH_IDS[k]));
+		ASSERT_TRUE(hash->update(QByteArray(TEST_MESSAGE_ORG)));
+		hash->digest_xof_into(buffer, sizeof(buffer));
+		ASSERT_EQ(QByteArray((const char*)buffer, int(sizeof(buffer))), digest);
+	}
+}
+
+//-----------------------------------------------------------------
+// Multi
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestMultiHash)
+{
+	const QByteArray message = makeTestData(4194311);
+	QList<quint16> hashIds;
+	hashIds << MUtils::Hash::HASH_BLAKE2_512 << MUtils::Hash::HASH_KECCAK_256 << MUtils::Hash::HASH_BLAKE3 << MUtils::Hash::HASH_CRC32C;
+	for (int seeded = 0; seeded < 2; ++seeded)
+	{
+		const char *const key = seeded ? SEED_KEY : NULL;
+		QList<QByteArray> expected;
+		for (int k = 0; k < hashIds.count(); ++k)
+		{
+			QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(hashIds[k], key));
+			ASSERT_TRUE(hash->update(message));
+			expected << hash->digest();
+		}
+		for (int parallel = 0; parallel < 2; ++parallel)
+		{
+			MUtils::Hash::MultiHash multi(hashIds, parallel != 0, key);
+			ASSERT_TRUE(multi.update(message.left(4099)));
+			ASSERT_TRUE(multi.update(message.mid(4099)));
+			ASSERT_EQ(multi.digests(), expected);
+			multi.reset();
+			ASSERT_TRUE(multi.update(message));
+			ASSERT_STRCASEEQ(multi.digest().constData(), (expected[0] + expected[1] + expected[2] + expected[3]).constData());
+			ASSERT_ANY_THROW(multi.update(message));
+			multi.reset();
+			ASSERT_TRUE(multi.update(message));
+			QByteArray raw(int(multi.digest_size()), '\0');
+			ASSERT_EQ(multi.digest_into((quint8*)raw.data(), size_t(raw.size())), multi.digest_size());
+			ASSERT_EQ(MUtils::Hash::to_hex(raw), expected[0] + expected[1] + expected[2] + expected[3]);
+		}
+	}
+	ASSERT_ANY_THROW(MUtils::Hash::MultiHash(QList<quint16>()));
+	ASSERT_ANY_THROW(MUtils::Hash::MultiHash(QList<quint16>() << MUtils::Hash::HASH_BLAKE3 << 0xFFFF));
+}
+
+TEST_F(HashTest, TestMultiHashFileIO)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/message.bin").arg(workDir);
+	const QByteArray message = makeTestData(1048583);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(message), qint64(message.size()));
+		file.close();
+	}
+	QList<quint16> hashIds;
+	hashIds << MUtils::Hash::HASH_BLAKE2_512 << MUtils::Hash::HASH_KECCAK_256;
+	MUtils::Hash::MultiHash multi(hashIds, true);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::ReadOnly));
+		ASSERT_TRUE(multi.update(file));
+		file.close();
+	}
+	const QList<QByteArray> digests = multi.digests();
+	ASSERT_EQ(digests.count(), hashIds.count());
+	for (int k = 0; k < hashIds.count(); ++k)
+	{
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(hashIds[k]));
+		ASSERT_TRUE(hash->update(message));
+		ASSERT_STRCASEEQ(digests[k].constData(), hash->digest().constData());
+	}
+	QFile::remove(fileName);
+}
+
+//-----------------------------------------------------------------
+// Tree
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestHashTree)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/message.bin").arg(workDir), sidecarName = QString("%1/message.tree").arg(workDir);
+	QByteArray message = makeTestData(1048583);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(message), qint64(message.size()));
+		file.close();
+	}
+	MUtils::Hash::HashTree tree(MUtils::Hash::HASH_BLAKE2_512, 65536U);
+	ASSERT_TRUE(tree.build(fileName, 4));
+	ASSERT_EQ(tree.chunkCount(), 17U);
+	ASSERT_EQ(tree.fileSize(), qint64(message.size()));
+	for (quint32 i = 0; i < tree.chunkCount(); ++i)
+	{
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+		ASSERT_TRUE(hash->update(QByteArray(1, '\0') + message.mid(int(i * 65536U), 65536)));
+		ASSERT_STRCASEEQ(tree.leaf(i).constData(), hash->digest().constData());
+	}
+	ASSERT_TRUE(tree.save(sidecarName));
+	{
+		MUtils::Hash::HashTree loaded(MUtils::Hash::HASH_BLAKE2_512, 4096U);
+		ASSERT_TRUE(loaded.load(sidecarName));
+		ASSERT_EQ(loaded.chunkSize(), 65536U);
+		ASSERT_STRCASEEQ(loaded.root().constData(), tree.root().constData());
+		MUtils::Hash::HashTree other(MUtils::Hash::HASH_SHA3_512, 65536U);
+		ASSERT_FALSE(other.load(sidecarName));
+		ASSERT_TRUE(other.isEmpty());
+	}
+	message[200000] = message[200000] ^ 0x5A;
+	message.append(makeTestData(70000));
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(message), qint64(message.size()));
+		file.close();
+	}
+	QList<quint32> mismatched;
+	ASSERT_TRUE(tree.verify(fileName, mismatched));
+	ASSERT_EQ(mismatched.count(), 3);
+	ASSERT_EQ(mismatched.first(), 3U);
+	ASSERT_EQ(mismatched.last(), 17U);
+	ASSERT_TRUE(tree.update(fileName, 200000, 1));
+	MUtils::Hash::HashTree fresh(MUtils::Hash::HASH_BLAKE2_512, 65536U);
+	ASSERT_TRUE(fresh.build(fileName, 1));
+	ASSERT_EQ(tree.chunkCount(), fresh.chunkCount());
+	ASSERT_STRCASEEQ(tree.root().constData(), fresh.root().constData());
+	ASSERT_TRUE(tree.verify(fileName, mismatched));
+	ASSERT_TRUE(mismatched.isEmpty());
+	QFile::remove(sidecarName);
+	QFile::remove(fileName);
+}
+
+TEST_F(HashTest, TestHashTreeEmpty)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/empty.bin").arg(workDir);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		file.close();
+	}
+	MUtils::Hash::HashTree tree(MUtils::Hash::HASH_SHA3_256);
+	ASSERT_TRUE(tree.build(fileName));
+	ASSERT_EQ(tree.chunkCount(), 1U);
+	ASSERT_STRCASEEQ(tree.root().constData(), tree.leaf(0).constData());
+	ASSERT_FALSE(tree.build(QString("%1/missing.bin").arg(workDir)));
+	ASSERT_TRUE(tree.isEmpty());
+	ASSERT_ANY_THROW(MUtils::Hash::HashTree(MUtils::Hash::HASH_SHA3_256, 1024U));
+	QFile::remove(fileName);
+}
+
+//-----------------------------------------------------------------
+// Cache
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestHashCache)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	QStringList fileNames;
+	for (int i = 0; i < 3; ++i)
+	{
+		fileNames << QString("%1/message_%2.bin").arg(workDir, QString::number(i));
+		QFile file(fileNames.last());
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(makeTestData(4093 * (i + 1))), qint64(4093 * (i + 1)));
+		file.close();
+	}
+	const MUtils::Hash::DigestMap expected = MUtils::Hash::hash_files(fileNames, MUtils::Hash::HASH_BLAKE2_512);
+	{
+		MUtils::Hash::HashCache cache(workDir);
+		cache.clear();
+		QByteArray digest;
+		ASSERT_FALSE(cache.lookup(fileNames[0], MUtils::Hash::HASH_BLAKE2_512, digest));
+		ASSERT_STRCASEEQ(cache.digest(fileNames[0], MUtils::Hash::HASH_BLAKE2_512).constData(), expected.value(fileNames[0]).constData());
+		ASSERT_TRUE(cache.lookup(fileNames[0], MUtils::Hash::HASH_BLAKE2_512, digest));
+		ASSERT_STRCASEEQ(digest.constData(), expected.value(fileNames[0]).constData());
+		ASSERT_FALSE(cache.lookup(fileNames[0], MUtils::Hash::HASH_SHA3_512, digest));
+		const MUtils::Hash::DigestMap digests = cache.digests(fileNames, MUtils::Hash::HASH_BLAKE2_512, 2);
+		for (QStringList::ConstIterator iter = fileNames.constBegin(); iter != fileNames.constEnd(); ++iter)
+		{
+			ASSERT_STRCASEEQ(digests.value(*iter).constData(), expected.value(*iter).constData());
+		}
+		ASSERT_EQ(cache.count(), 3U);
+	}
+	{
+		QFile file(fileNames[1]);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Append));
+		ASSERT_EQ(file.write("x", 1), qint64(1));
+		file.close();
+	}
+	{
+		MUtils::Hash::HashCache cache(workDir);
+		ASSERT_EQ(cache.count(), 3U);
+		QByteArray digest;
+		ASSERT_TRUE(cache.lookup(fileNames[2], MUtils::Hash::HASH_BLAKE2_512, digest));
+		ASSERT_STRCASEEQ(digest.constData(), expected.value(fileNames[2]).constData());
+		ASSERT_FALSE(cache.lookup(fileNames[1], MUtils::Hash::HASH_BLAKE2_512, digest));
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+		ASSERT_TRUE(hash->update(makeTestData(4093 * 2) + QByteArray("x")));
+		ASSERT_STRCASEEQ(cache.digest(fileNames[1], MUtils::Hash::HASH_BLAKE2_512).constData(), hash->digest().constData());
+		QFile::remove(fileNames[0]);
+		ASSERT_TRUE(cache.compact());
+		ASSERT_EQ(cache.count(), 2U);
+		ASSERT_TRUE(cache.digest(fileNames[0], MUtils::Hash::HASH_BLAKE2_512).isEmpty());
+		cache.clear();
+		ASSERT_EQ(cache.count(), 0U);
+	}
+	{
+		//Compaction must preserve the records that another instance has appended in the meantime
+		MUtils::Hash::HashCache cache1(workDir), cache2(workDir);
+		ASSERT_FALSE(cache1.digest(fileNames[1], MUtils::Hash::HASH_BLAKE2_512).isEmpty());
+		ASSERT_FALSE(cache2.digest(fileNames[2], MUtils::Hash::HASH_BLAKE2_512).isEmpty());
+		ASSERT_TRUE(cache2.compact());
+		ASSERT_EQ(cache2.count(), 2U);
+		MUtils::Hash::HashCache cache3(workDir);
+		ASSERT_EQ(cache3.count(), 2U);
+		cache3.clear();
+		QFile::remove(cache3.logFile());
+	}
+	ASSERT_ANY_THROW(MUtils::Hash::HashCache cache((QString())));
+	for (QStringList::ConstIterator iter = fileNames.constBegin(); iter != fileNames.constEnd(); ++iter)
+	{
+		QFile::remove(*iter);
+	}
+}
+
+TEST_F(HashTest, TestHashCacheDisabled)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/message.bin").arg(workDir);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(makeTestData(4093)), qint64(4093));
+		file.close();
+	}
+	const QStringList fileNames(fileName);
+	const QByteArray expected = MUtils::Hash::hash_files(fileNames, MUtils::Hash::HASH_BLAKE2_512).value(fileName);
+	const WarningCollector collector;
+	{
+		//The directory can not be created below a regular file, so the cache must be disabled, with a single warning
+		MUtils::Hash::HashCache cache(QString("%1/sub").arg(fileName));
+		ASSERT_TRUE(cache.logFile().isEmpty());
+		for (int i = 0; i < 3; ++i)
+		{
+			ASSERT_STRCASEEQ(cache.digest(fileName, MUtils::Hash::HASH_BLAKE2_512).constData(), expected.constData());
+			ASSERT_STRCASEEQ(cache.digests(fileNames, MUtils::Hash::HASH_SHA3_256).value(fileName).constData(), MUtils::Hash::hash_files(fileNames, MUtils::Hash::HASH_SHA3_256).value(fileName).constData());
+		}
+		QByteArray digest;
+		ASSERT_TRUE(cache.lookup(fileName, MUtils::Hash::HASH_BLAKE2_512, digest));
+		ASSERT_FALSE(cache.compact());
+		cache.clear();
+		ASSERT_EQ(cache.count(), 0U);
+	}
+	ASSERT_EQ(collector.warnings().count(), 1);
+	QFile::remove(fileName);
+}
+
+TEST_F(HashTest, TestHashCacheCorrupted)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	QStringList fileNames;
+	for (int i = 0; i < 3; ++i)
+	{
+		fileNames << QString("%1/message_%2.bin").arg(workDir, QString::number(i));
+		QFile file(fileNames.last());
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(makeTestData(4093 * (i + 1))), qint64(4093 * (i + 1)));
+		file.close();
+	}
+	QString logFile;
+	{
+		MUtils::Hash::HashCache cache(workDir);
+		cache.clear();
+		ASSERT_EQ(cache.digests(fileNames, MUtils::Hash::HASH_BLAKE2_512).count(), 3);
+		logFile = cache.logFile();
+	}
+	{
+		//Flip a byte in the middle of the log, so that the checksum of one record does not match
+		QFile file(logFile);
+		ASSERT_TRUE(file.open(QIODevice::ReadWrite));
+		QByteArray data = file.readAll();
+		data[data.size() / 2] = char(data[data.size() / 2] ^ 0x5A);
+		ASSERT_TRUE(file.seek(0));
+		ASSERT_EQ(file.write(data), qint64(data.size()));
+		file.close();
+	}
+	const WarningCollector collector;
+	{
+		MUtils::Hash::HashCache cache(workDir);
+		ASSERT_EQ(cache.count(), 2U);
+	}
+	const QStringList warnings = collector.warnings();
+	ASSERT_EQ(warnings.count(), 1);
+	ASSERT_FALSE(warnings.first().startsWith("Serialized hash state"));
+	QFile::remove(logFile);
+	for (QStringList::ConstIterator iter = fileNames.constBegin(); iter != fileNames.constEnd(); ++iter)
+	{
+		QFile::remove(*iter);
+	}
+}
+
+TEST_F(HashTest, TestHashCacheCompactAtomic)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	const QString fileName = QString("%1/message.bin").arg(workDir);
+	{
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(makeTestData(4093)), qint64(4093));
+		file.close();
+	}
+	MUtils::Hash::HashCache cache(workDir);
+	ASSERT_FALSE(cache.digest(fileName, MUtils::Hash::HASH_BLAKE2_512).isEmpty());
+	//The log file is replaced by the compacted one, so it must never be missing, not even for a moment
+	FileWatchThread watcher(cache.logFile());
+	watcher.start();
+	for (int i = 0; i < 500; ++i)
+	{
+		ASSERT_TRUE(cache.compact());
+	}
+	watcher.stop();
+	ASSERT_TRUE(watcher.wait(10000));
+	ASSERT_EQ(watcher.missing(), 0);
+	ASSERT_FALSE(QFile::exists(cache.logFile() + QLatin1String(".tmp")));
+	cache.clear();
+	QFile::remove(cache.logFile());
+	QFile::remove(fileName);
+}
+
+//-----------------------------------------------------------------
+// Batch
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestHashFiles)
+{
+	const QString workDir = makeTempFolder(__FUNCTION__);
+	ASSERT_FALSE(workDir.isEmpty());
+	static const int FILE_SIZE[] = { 0, 1, 127, 4093, 65536, 1048575, 1048583, 3145739 };
+
+	QStringList files;
+	QMap<QString, QByteArray> expected;
+	for (int i = 0; i < 97; ++i)
+	{
+		const QString fileName = QString("%1/file_%2.bin").arg(workDir, QString::number(i));
+		const QByteArray message = makeTestData(FILE_SIZE[i % MUTILS_ARR2LEN(FILE_SIZE)] + i);
+		QFile file(fileName);
+		ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+		ASSERT_EQ(file.write(message), qint64(message.size()));
+		file.close();
+		QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+		ASSERT_TRUE(hash->update(message));
+		expected.insert(fileName, hash->digest());
+		files << fileName;
+	}
+	files << QString("%1/does_not_exist.bin").arg(workDir);
+
+	for (quint32 threads = 1; threads <= 4; threads += 3)
+	{
+		const MUtils::Hash::DigestMap digests = MUtils::Hash::hash_files(files, MUtils::Hash::HASH_BLAKE2_512, threads);
+		ASSERT_EQ(digests.count(), files.count());
+		for (QMap<QString, QByteArray>::ConstIterator iter = expected.constBegin(); iter != expected.constEnd(); ++iter)
+		{
+			ASSERT_STRCASEEQ(digests.value(iter.key()).constData(), iter.value().constData());
+		}
+		ASSERT_TRUE(digests.value(files.last()).isEmpty());
+	}
+
+	for (int i = 0; i < files.count(); ++i)
+	{
+		QFile::remove(files.at(i));
+	}
+}
+
+TEST_F(HashTest, TestHashMessages)
+{
+	static const quint16 HASH_ID[] = { MUtils::Hash::HASH_KECCAK_224, MUtils::Hash::HASH_KECCAK_256, MUtils::Hash::HASH_KECCAK_384, MUtils::Hash::HASH_KECCAK_512, MUtils::Hash::HASH_BLAKE2_512 };
+
+	QList<QByteArray> messages;
+	messages << QByteArray() << QByteArray(TEST_MESSAGE_ORG) << QByteArray(TEST_MESSAGE_ALT);
+	for (int i = 0; i < 997; ++i)
+	{
+		messages << makeTestData((i * 37) % 577);
+	}
+
+	for (size_t k = 0; k < MUTILS_ARR2LEN(HASH_ID); ++k)
+	{
+		for (int seeded = 0; seeded < 2; ++seeded)
+		{
+			const char *const key = seeded ? SEED_KEY : NULL;
+			const QList<QByteArray> digests = MUtils::Hash::hash_messages(messages, HASH_ID[k], true, key);
+			ASSERT_EQ(digests.count(), messages.count());
+			for (int i = 0; i < messages.count(); ++i)
+			{
+				QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(HASH_ID[k], key));
+				ASSERT_TRUE(hash->update(messages.at(i)));
+				ASSERT_STRCASEEQ(digests.at(i).constData(), hash->digest().constData());
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------
+// Hex
+//-----------------------------------------------------------------
+
+TEST_F(HashTest, TestHexEncode)
+{
+	for (int size = 0; size < 300; ++size)
+	{
+		const QByteArray data = makeTestData(size);
+		ASSERT_EQ(MUtils::Hash::to_hex(data), data.toHex());
+		ASSERT_EQ(MUtils::Hash::to_hex(data, true), data.toHex().toUpper());
+		char buffer[600];
+		ASSERT_EQ(MUtils::Hash::to_hex_into((const quint8*)data.constData(), size_t(size), buffer, sizeof(buffer)), size_t(2 * size));
+		ASSERT_EQ(QByteArray(buffer, 2 * size), data.toHex());
+		ASSERT_EQ(MUtils::Hash::from_hex(data.toHex()), data);
+		ASSERT_EQ(MUtils::Hash::from_hex(data.toHex().toUpper()), data);
+	}
+	char small[7];
+	ASSERT_ANY_THROW(MUtils::Hash::to_hex_into((const quint8*)TEST_MESSAGE_ORG, 4U, small, sizeof(small)));
+}
+
+static void testHexKernel(void)
+{
+	static const char INVALID[] = { '\0', ' ', '/', ':', '@', 'G', '`', 'g', '\xFF' };
+	for (int size = 0; size < 300; ++size)
+	{
+		const QByteArray data = makeTestData(size);
+		ASSERT_EQ(MUtils::Hash::to_hex(data), data.toHex());
+		ASSERT_EQ(MUtils::Hash::to_hex(data, true), data.toHex().toUpper());
+		ASSERT_EQ(MUtils::Hash::from_hex(data.toHex()), data);
+		ASSERT_EQ(MUtils::Hash::from_hex(data.toHex().toUpper()), data);
+	}
+	//Odd lengths and lengths around the 32 (SSSE3) and 64 (AVX2) character blocks
+	static const int HEX_LENGTHS[] = { 1, 15, 31, 32, 33, 63, 64, 65, 95, 96, 97, 127, 128, 129, 130 };
+	for (size_t i = 0; i < MUTILS_ARR2LEN(HEX_LENGTHS); ++i)
+	{
+		const int len = HEX_LENGTHS[i];
+		const QByteArray hex = makeTestData((len + 1) / 2).toHex().left(len);
+		quint8 output[65];
+		if (len % 2)
+		{
+			ASSERT_FALSE(MUtils::Hash::from_hex_into(hex.constData(), size_t(len), output, sizeof(output)));
+			ASSERT_TRUE(MUtils::Hash::from_hex(hex).isEmpty());
+			continue;
+		}
+		ASSERT_TRUE(MUtils::Hash::from_hex_into(hex.constData(), size_t(len), output, sizeof(output)));
+		ASSERT_EQ(QByteArray((const char*)output, len / 2), QByteArray::fromHex(hex));
+		for (int pos = 0; pos < len; ++pos)
+		{
+			for (size_t k = 0; k < MUTILS_ARR2LEN(INVALID); ++k)
+			{
+				QByteArray broken(hex);
+				broken[pos] = INVALID[k];
+				ASSERT_FALSE(MUtils::Hash::from_hex_into(broken.constData(), size_t(len), output, sizeof(output))) << "position: " << pos;
+			}
+		}
+	}
+}
+
+TEST_F(HashTest, TestHexKernels)
+{
+	TEST_HASH_KERNELS(hex_select_kernel, testHexKernel);
+}
+
+TEST_F(HashTest, TestHexDecode)
+{
+	QScopedPointer<MUtils::Hash::Hash> hash(MUtils::Hash::create(MUtils::Hash::HASH_BLAKE2_512));
+	ASSERT_TRUE(hash->update(QByteArray(TEST_MESSAGE_ORG)));
+	char hex[2U * MUtils::Hash::DIGEST_MAX_SIZE];
+	ASSERT_EQ(hash->digest_hex_into(hex, sizeof(hex)), size_t(128U));
+	const QByteArray expected = QByteArray::fromHex(QByteArray(hex, 128));
+	for (size_t pos = 0; pos < 128U; ++pos)
+	{
+		static const char INVALID[] = { '\0', ' ', '/', ':', '@', 'G', '`', 'g', '\xFF' };
+		quint8 digest[MUtils::Hash::DIGEST_MAX_SIZE];
+		ASSERT_TRUE(MUtils::Hash::from_hex_into(hex, 128U, digest, sizeof(digest)));
+		ASSERT_TRUE(MUtils::Hash::digest_equal(digest, (const quint8*)expected.constData(), sizeof(digest)));
+		for (size_t k = 0; k < MUTILS_ARR2LEN(INVALID); ++k)
+		{
+			QByteArray broken(hex, 128);
+			broken[int(pos)] = INVALID[k];
+			ASSERT_FALSE(MUtils::Hash::from_hex_into(broken.constData(), 128U, digest, sizeof(digest)));
+			ASSERT_TRUE(MUtils::Hash::from_hex(broken).isEmpty());
+		}
+	}
+	quint8 small[63];
+	ASSERT_TRUE(MUtils::Hash::from_hex(QByteArray("abc")).isEmpty());
+	ASSERT_ANY_THROW(MUtils::Hash::from_hex_into(hex, 128U, small, sizeof(small)));
+	//The combined digest of a MultiHash exceeds DIGEST_MAX_SIZE
+	QList<quint16> hashIds;
+	hashIds << MUtils::Hash::HASH_BLAKE2_512 << MUtils::Hash::HASH_KECCAK_256;
+	MUtils::Hash::MultiHash multi(hashIds);
+	ASSERT_TRUE(multi.update(QByteArray(TEST_MESSAGE_ORG)));
+	const QList<QByteArray> digests = multi.digests();
+	multi.reset();
+	ASSERT_TRUE(multi.update(QByteArray(TEST_MESSAGE_ORG)));
+	QByteArray multiHex(int(2U * multi.digest_size()), '\0');
+	ASSERT_EQ(multi.digest_hex_into(multiHex.data(), size_t(multiHex.size())), size_t(192U));
+	ASSERT_EQ(multiHex, digests[0] + digests[1]);
+	ASSERT_EQ(MUtils::Hash::from_hex(multiHex).size(), 96);
+	multi.reset();
+	ASSERT_ANY_THROW(multi.digest_hex_into(multiHex.data(), size_t(multiHex.size() - 1)));
+}
+
+TEST_F(HashTest, TestDigestEqual)
+{
+	const QByteArray digest = MUtils::Hash::hash_messages(QList<QByteArray>() << QByteArray(TEST_MESSAGE_ORG), MUtils::Hash::HASH_SHA3_256, false).first();
+	ASSERT_TRUE(MUtils::Hash::digest_equal(digest, MUtils::Hash::from_hex(MUtils::Hash::to_hex(digest, true))));
+	for (int i = 0; i < digest.size(); ++i)
+	{
+		QByteArray other(digest);
+		other[i] = other[i] ^ 0x01;
+		ASSERT_FALSE(MUtils::Hash::digest_equal(digest, other));
+	}
+	ASSERT_FALSE(MUtils::Hash::digest_equal(digest, digest.left(31)));
+	ASSERT_TRUE(MUtils::Hash::digest_equal(QByteArray(), QByteArray()));
+}
+
 #undef TEST_HASH_DIRECT
 #undef TEST_HASH_FILEIO
+#undef TEST_HASH_FILEMAP
+#undef TEST_HASH_STREAM
+#undef TEST_HASH_CHUNKED
+#undef TEST_HASH_BULK
@@ -0,0 +1,1162 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+#include "MUtilsTest.h"
+
+//MUtils
+#include <MUtils/IPCChannel.h>
+#include <MUtils/IPCChannelNotifier.h>
+#include <MUtils/OSSupport.h>
+
+//Qt
+#include <QThread>
+#include <QElapsedTimer>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <QVector>
+#include <QProcess>
+
+//Utilities
+#define IPC_TIMEOUT 10000
+
+typedef MUtils::IPCChannel::ipc_message_t ipc_message_t;
+
+//Test data
+static const char *const TEST_APP_ID = "MUtilsTest";
+static const quint32 TEST_VERSION_NO = 1;
+static const quint32 TEST_RING_SIZE = 1048576; //Size of the ring inside the channel, in bytes
+static const quint32 TEST_HEADER_LEN = 20;     //Size of the fixed part of a message, in bytes
+
+//===========================================================================
+// HELPER METHODS
+//===========================================================================
+
+static QString makeChannelId(const char *const name)
+{
+	return QString("%1_%2").arg(QString::fromLatin1(name), QString::number(MUtils::next_rand_u32(), 16));
+}
+
+static QString makeParam(const quint32 index, const int length)
+{
+	QString param(QString::number(index, 16));
+	while (param.length() < length)
+	{
+		param.append(QChar('a' + ((index + param.length()) % 26)));
+	}
+	return param;
+}
+
+static QList<ipc_message_t> makeMessages(const quint32 count, quint64 &totalSize)
+{
+	QList<ipc_message_t> messages;
+	totalSize = 0;
+	for (quint32 i = 0; i < count; ++i)
+	{
+		ipc_message_t message;
+		message.command = i;
+		message.flags = ~i;
+		message.params << makeParam(i, (i * 37U) % 1024U) << QString("param_%1").arg(i);
+		for (QStringList::ConstIterator iter = message.params.constBegin(); iter != message.params.constEnd(); ++iter)
+		{
+			totalSize += iter->toUtf8().size();
+		}
+		messages.append(message);
+	}
+	return messages;
+}
+
+static QList<ipc_message_t> makeLargeMessages(const quint32 count, const int length)
+{
+	QList<ipc_message_t> messages;
+	for (quint32 i = 0; i < count; ++i)
+	{
+		ipc_message_t message;
+		message.command = i;
+		message.params << makeParam(i, length + int(i * 997U));
+		messages.append(message);
+	}
+	return messages;
+}
+
+//Returns true, if at least one of the records is split across the end of the ring (16 byte header, record padded to 8 bytes)
+static bool checkWrapAround(const QList<ipc_message_t> &messages)
+{
+	quint64 position = 0;
+	for (QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); ++iter)
+	{
+		quint64 length = TEST_HEADER_LEN;
+		for (QStringList::ConstIterator param = iter->params.constBegin(); param != iter->params.constEnd(); ++param)
+		{
+			length += 4U + param->toUtf8().size();
+		}
+		const quint64 next = position + ((16U + length + 7U) & (~quint64(7U)));
+		if ((position / TEST_RING_SIZE) != ((next - 1U) / TEST_RING_SIZE))
+		{
+			return true;
+		}
+		position = next;
+	}
+	return false;
+}
+
+static bool compareMessages(const QList<ipc_message_t> &messages, const QList<ipc_message_t> &expected)
+{
+	if (messages.count() != expected.count())
+	{
+		return false;
+	}
+	for (int i = 0; i < messages.count(); ++i)
+	{
+		if ((messages[i].command != expected[i].command) || (messages[i].flags != expected[i].flags) || (messages[i].params != expected[i].params))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool readMessages(MUtils::IPCChannel &channel, const QList<ipc_message_t> &expected)
+{
+	for (QList<ipc_message_t>::ConstIterator iter = expected.constBegin(); iter != expected.constEnd(); ++iter)
+	{
+		ipc_message_t message;
+		if (!channel.read(message.command, message.flags, message.params, IPC_TIMEOUT))
+		{
+			return false;
+		}
+		if ((message.command != iter->command) || (message.flags != iter->flags) || (message.params != iter->params))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+//Runs the DISABLED_ChildProcess test in a child process, which performs the given action ("role") on the channel and exits
+static bool runChildProcess(const QString &channelId, const MUtils::IPCChannel::ipc_mode_t mode, const char *const role)
+{
+	int argc = 1;
+	char appName[] = "MUtilsTest", *argv[] = { appName, NULL };
+	QScopedPointer<QCoreApplication> application(QCoreApplication::instance() ? NULL : new QCoreApplication(argc, argv));
+	QProcessEnvironment environment(QProcessEnvironment::systemEnvironment());
+	environment.insert("MUTILS_TEST_CHILD", QString("%1:%2:%3").arg(channelId, QString::number(int(mode)), QString::fromLatin1(role)));
+	QProcess process;
+	process.setProcessEnvironment(environment);
+	process.setProcessChannelMode(QProcess::ForwardedChannels);
+	process.start(QCoreApplication::applicationFilePath(), QStringList() << "--gtest_filter=IPCChannelTest.DISABLED_ChildProcess" << "--gtest_also_run_disabled_tests");
+	return process.waitForFinished(IPC_TIMEOUT) && (process.exitStatus() == QProcess::NormalExit) && (process.exitCode() == 0);
+}
+
+//Counts the warnings about a stalled channel, see RecoveryStalled
+static QAtomicInt g_stalledWarnings;
+
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+static void stalledMessageHandler(QtMsgType, const QMessageLogContext&, const QString &message)
+{
+	if (message.contains("has not moved"))
+	{
+		g_stalledWarnings.ref();
+	}
+}
+#else
+static void stalledMessageHandler(QtMsgType, const char *const message)
+{
+	if (strstr(message, "has not moved"))
+	{
+		g_stalledWarnings.ref();
+	}
+}
+#endif
+
+//===========================================================================
+// SENDER THREAD
+//===========================================================================
+
+class IPCSenderThread : public QThread
+{
+public:
+	IPCSenderThread(MUtils::IPCChannel &channel, const QList<ipc_message_t> &messages, const bool batch = false)
+	:
+		m_channel(channel),
+		m_messages(messages),
+		m_batch(batch),
+		m_success(false)
+	{
+	}
+
+	bool success(void) const
+	{
+		return m_success;
+	}
+
+protected:
+	virtual void run(void)
+	{
+		if (m_batch)
+		{
+			m_success = m_channel.send_batch(m_messages);
+			return;
+		}
+		for (QList<ipc_message_t>::ConstIterator iter = m_messages.constBegin(); iter != m_messages.constEnd(); ++iter)
+		{
+			if (!m_channel.send(iter->command, iter->flags, iter->params, IPC_TIMEOUT))
+			{
+				return;
+			}
+		}
+		m_success = true;
+	}
+
+	MUtils::IPCChannel &m_channel;
+	const QList<ipc_message_t> m_messages;
+	const bool m_batch;
+	volatile bool m_success;
+};
+
+//===========================================================================
+// READER THREAD
+//===========================================================================
+
+class IPCReaderThread : public QThread
+{
+public:
+	IPCReaderThread(MUtils::IPCChannel &channel, QAtomicInt &counter, const int total)
+	:
+		m_channel(channel),
+		m_counter(counter),
+		m_total(total),
+		m_success(false)
+	{
+	}
+
+	bool success(void) const
+	{
+		return m_success;
+	}
+
+	const QList<ipc_message_t> &messages(void) const
+	{
+		return m_messages;
+	}
+
+protected:
+	virtual void run(void)
+	{
+		QElapsedTimer timer;
+		timer.start();
+		while (m_counter < m_total)
+		{
+			const int count = m_channel.read_batch(m_messages, 16, 50);
+			if ((count < 0) || (timer.elapsed() > 2 * IPC_TIMEOUT))
+			{
+				return;
+			}
+			m_counter.fetchAndAddOrdered(count);
+		}
+		m_success = true;
+	}
+
+	MUtils::IPCChannel &m_channel;
+	QAtomicInt &m_counter;
+	const int m_total;
+	QList<ipc_message_t> m_messages;
+	volatile bool m_success;
+};
+
+//===========================================================================
+// RELEASE THREAD
+//===========================================================================
+
+class IPCReleaseThread : public QThread
+{
+public:
+	IPCReleaseThread(MUtils::IPCChannel &channel, const quint32 handle, const size_t delay)
+	:
+		m_channel(channel),
+		m_handle(handle),
+		m_delay(delay),
+		m_success(false)
+	{
+	}
+
+	bool success(void) const
+	{
+		return m_success;
+	}
+
+protected:
+	virtual void run(void)
+	{
+		MUtils::OS::sleep_ms(m_delay);
+		m_success = m_channel.release_buffer(m_handle);
+	}
+
+	MUtils::IPCChannel &m_channel;
+	const quint32 m_handle;
+	const size_t m_delay;
+	volatile bool m_success;
+};
+
+//===========================================================================
+// TESTBED CLASS
+//===========================================================================
+
+class IPCChannelTest : public Testbed
+{
+protected:
+	virtual void SetUp()
+	{
+	}
+
+	virtual void TearDown()
+	{
+	}
+};
+
+//===========================================================================
+// TEST METHODS
+//===========================================================================
+
+//-----------------------------------------------------------------
+// Child Process
+//-----------------------------------------------------------------
+
+//Not a test by itself, runs in the child process that is started by runChildProcess()
+TEST_F(IPCChannelTest, DISABLED_ChildProcess)
+{
+	const QStringList child(QString::fromLatin1(qgetenv("MUTILS_TEST_CHILD")).split(QChar(':')));
+	ASSERT_EQ(child.count(), 3);
+	MUtils::IPCChannel channel(TEST_APP_ID, TEST_VERSION_NO, child[0], MUtils::IPCChannel::ipc_mode_t(child[1].toInt()));
+	ASSERT_EQ(channel.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	if (child[2] == QLatin1String("send"))
+	{
+		ASSERT_TRUE(channel.send(42, 0, QStringList() << "hello", IPC_TIMEOUT));
+	}
+	else if (child[2] == QLatin1String("abandon_send"))
+	{
+		MUtils::Internal::ipc_abandon_next(&channel);
+		ASSERT_TRUE(channel.send_batch(makeLargeMessages(3, 200000))); //more than one filler record is needed to replace these
+	}
+	else if (child[2] == QLatin1String("abandon_read"))
+	{
+		MUtils::Internal::ipc_abandon_next(&channel);
+		QList<ipc_message_t> output;
+		ASSERT_EQ(channel.read_batch(output, 3, 0), 0);
+	}
+	else
+	{
+		FAIL() << "Unknown role: " << child[2].toStdString();
+	}
+}
+
+//-----------------------------------------------------------------
+// Exchange
+//-----------------------------------------------------------------
+
+#define TEST_IPC_EXCHANGE(MODE, COUNT) do \
+{ \
+	const QString channelId(makeChannelId(#MODE)); \
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER)); \
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE)); \
+	quint64 totalSize = 0; \
+	const QList<ipc_message_t> messages(makeMessages((COUNT), totalSize)); \
+	ASSERT_GT(totalSize, quint64(4U * TEST_RING_SIZE)); \
+	IPCSenderThread thread(sender, messages); \
+	thread.start(); \
+	const bool result = readMessages(reader, messages); \
+	ASSERT_TRUE(thread.wait(2 * IPC_TIMEOUT)); \
+	ASSERT_TRUE(result); \
+	ASSERT_TRUE(thread.success()); \
+	quint32 command, flags; \
+	QStringList params; \
+	ASSERT_FALSE(reader.try_read(command, flags, params)); \
+} \
+while(0)
+
+TEST_F(IPCChannelTest, ExchangeLocked)
+{
+	TEST_IPC_EXCHANGE(MODE_LOCKED, 16384);
+}
+
+TEST_F(IPCChannelTest, ExchangeSPSC)
+{
+	TEST_IPC_EXCHANGE(MODE_SPSC, 16384);
+}
+
+TEST_F(IPCChannelTest, ExchangeMPMC)
+{
+	TEST_IPC_EXCHANGE(MODE_MPMC, 16384);
+}
+
+#undef TEST_IPC_EXCHANGE
+
+//-----------------------------------------------------------------
+// Records
+//-----------------------------------------------------------------
+
+#define TEST_IPC_WRAP_AROUND(MODE) do \
+{ \
+	const QString channelId(makeChannelId(#MODE)); \
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER)); \
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE)); \
+	const QList<ipc_message_t> messages(makeLargeMessages(32, 100000)); \
+	ASSERT_TRUE(checkWrapAround(messages)); \
+	IPCSenderThread thread(sender, messages); \
+	thread.start(); \
+	const bool result = readMessages(reader, messages); \
+	ASSERT_TRUE(thread.wait(2 * IPC_TIMEOUT)); \
+	ASSERT_TRUE(result); \
+	ASSERT_TRUE(thread.success()); \
+} \
+while(0)
+
+TEST_F(IPCChannelTest, RecordWrapAroundLocked)
+{
+	TEST_IPC_WRAP_AROUND(MODE_LOCKED);
+}
+
+TEST_F(IPCChannelTest, RecordWrapAroundSPSC)
+{
+	TEST_IPC_WRAP_AROUND(MODE_SPSC);
+}
+
+#undef TEST_IPC_WRAP_AROUND
+
+TEST_F(IPCChannelTest, RecordLargeParams)
+{
+	const QString channelId(makeChannelId("RecordLargeParams"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	QStringList params;
+	params << makeParam(1, 4097) << makeParam(2, 65536) << QString() << makeParam(3, 8191);
+	ASSERT_TRUE(sender.send(42, 7, params));
+	quint32 command, flags;
+	QStringList output;
+	ASSERT_TRUE(reader.read(command, flags, output));
+	ASSERT_EQ(command, 42U);
+	ASSERT_EQ(flags, 7U);
+	ASSERT_TRUE(output == params);
+}
+
+TEST_F(IPCChannelTest, RecordMaxLength)
+{
+	const QString channelId(makeChannelId("RecordMaxLength"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	const QStringList params(makeParam(0, int(MUtils::IPCChannel::MAX_MESSAGE_LEN - TEST_HEADER_LEN - 4U)));
+	ASSERT_TRUE(sender.send(1, 0, params));
+	quint32 command, flags;
+	QStringList output;
+	ASSERT_TRUE(reader.read(command, flags, output));
+	ASSERT_EQ(command, 1U);
+	ASSERT_TRUE(output == params);
+	const QStringList tooLong(makeParam(0, int(MUtils::IPCChannel::MAX_MESSAGE_LEN - TEST_HEADER_LEN - 3U)));
+	ASSERT_FALSE(sender.send(2, 0, tooLong));
+	ASSERT_TRUE(sender.send(3, 0));
+	ASSERT_TRUE(reader.read(command, flags, output));
+	ASSERT_EQ(command, 3U);
+}
+
+TEST_F(IPCChannelTest, RecordMaxParams)
+{
+	const QString channelId(makeChannelId("RecordMaxParams"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	QStringList params;
+	for (quint32 i = 0; i < MUtils::IPCChannel::MAX_PARAM_CNT; ++i)
+	{
+		params << QString::number(i);
+	}
+	ASSERT_TRUE(sender.send(1, 0, params));
+	params << QString::number(MUtils::IPCChannel::MAX_PARAM_CNT);
+	ASSERT_FALSE(sender.send(2, 0, params));
+	quint32 command, flags;
+	QStringList output;
+	ASSERT_TRUE(reader.read(command, flags, output));
+	ASSERT_EQ(command, 1U);
+	ASSERT_EQ(output.count(), int(MUtils::IPCChannel::MAX_PARAM_CNT));
+	ASSERT_TRUE(sender.send(3, 0));
+	ASSERT_TRUE(reader.read(command, flags, output));
+	ASSERT_EQ(command, 3U);
+}
+
+//-----------------------------------------------------------------
+// Batch
+//-----------------------------------------------------------------
+
+#define TEST_IPC_BATCH(MODE) do \
+{ \
+	const QString channelId(makeChannelId(#MODE)); \
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER)); \
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE)); \
+	const QList<ipc_message_t> messages(makeLargeMessages(48, 65536)); \
+	ASSERT_TRUE(checkWrapAround(messages)); \
+	IPCSenderThread thread(sender, messages, true); \
+	thread.start(); \
+	QList<ipc_message_t> output; \
+	bool result = true; \
+	while (result && (output.count() < messages.count())) \
+	{ \
+		const int count = reader.read_batch(output, 5, IPC_TIMEOUT); \
+		result = (count > 0) && (count <= 5); \
+	} \
+	ASSERT_TRUE(thread.wait(2 * IPC_TIMEOUT)); \
+	ASSERT_TRUE(result); \
+	ASSERT_TRUE(thread.success()); \
+	ASSERT_TRUE(compareMessages(output, messages)); \
+	ASSERT_EQ(reader.read_batch(output, 5, 0), 0); \
+} \
+while(0)
+
+TEST_F(IPCChannelTest, BatchSplitLocked)
+{
+	TEST_IPC_BATCH(MODE_LOCKED);
+}
+
+TEST_F(IPCChannelTest, BatchSplitSPSC)
+{
+	TEST_IPC_BATCH(MODE_SPSC);
+}
+
+#undef TEST_IPC_BATCH
+
+TEST_F(IPCChannelTest, BatchMaxCount)
+{
+	const QString channelId(makeChannelId("BatchMaxCount"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	quint64 totalSize = 0;
+	const QList<ipc_message_t> messages(makeMessages(10, totalSize));
+	ASSERT_TRUE(sender.send_batch(messages));
+	QList<ipc_message_t> output;
+	ASSERT_EQ(reader.read_batch(output, 3, 0), 3);
+	ASSERT_EQ(output.count(), 3);
+	ASSERT_EQ(reader.read_batch(output, 100, 0), 7);
+	ASSERT_TRUE(compareMessages(output, messages));
+	ASSERT_EQ(reader.read_batch(output, 100, 0), 0);
+}
+
+TEST_F(IPCChannelTest, BatchTimeout)
+{
+	const QString channelId(makeChannelId("BatchTimeout"));
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	QList<ipc_message_t> output;
+	QElapsedTimer timer;
+	timer.start();
+	ASSERT_EQ(reader.read_batch(output, 10, 250), 0);
+	ASSERT_GE(timer.elapsed(), 250);
+	ASSERT_TRUE(output.isEmpty());
+}
+
+//-----------------------------------------------------------------
+// Timeouts
+//-----------------------------------------------------------------
+
+#define TEST_IPC_TIMEOUT(MODE) do \
+{ \
+	const QString channelId(makeChannelId(#MODE)); \
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER)); \
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE)); \
+	quint32 command, flags; \
+	QStringList params; \
+	QElapsedTimer timer; \
+	timer.start(); \
+	ASSERT_FALSE(reader.read(command, flags, params, 250)); \
+	ASSERT_GE(timer.elapsed(), 250); \
+	timer.start(); \
+	ASSERT_FALSE(reader.try_read(command, flags, params)); \
+	ASSERT_LT(timer.elapsed(), 100); \
+	const QStringList payload(makeParam(0, 65536)); \
+	quint32 count = 0; \
+	while (sender.try_send(count, 0, payload)) \
+	{ \
+		ASSERT_LT(++count, TEST_RING_SIZE / 65536U); \
+	} \
+	ASSERT_GT(count, 0U); \
+	timer.start(); \
+	ASSERT_FALSE(sender.try_send(count, 0, payload)); \
+	ASSERT_LT(timer.elapsed(), 100); \
+	timer.start(); \
+	ASSERT_FALSE(sender.send(count, 0, payload, 250)); \
+	ASSERT_GE(timer.elapsed(), 250); \
+	for (quint32 i = 0; i < count; ++i) \
+	{ \
+		ASSERT_TRUE(reader.try_read(command, flags, params)); \
+		ASSERT_EQ(command, i); \
+	} \
+	ASSERT_FALSE(reader.try_read(command, flags, params)); \
+} \
+while(0)
+
+TEST_F(IPCChannelTest, TimeoutLocked)
+{
+	TEST_IPC_TIMEOUT(MODE_LOCKED);
+}
+
+TEST_F(IPCChannelTest, TimeoutSPSC)
+{
+	TEST_IPC_TIMEOUT(MODE_SPSC);
+}
+
+TEST_F(IPCChannelTest, TimeoutMPMC)
+{
+	TEST_IPC_TIMEOUT(MODE_MPMC);
+}
+
+#undef TEST_IPC_TIMEOUT
+
+//-----------------------------------------------------------------
+// Multi-Producer/Multi-Consumer
+//-----------------------------------------------------------------
+
+#define MPMC_THREADS 4
+#define MPMC_COUNT 8192
+
+TEST_F(IPCChannelTest, MultiExactlyOnce)
+{
+	const QString channelId(makeChannelId("MultiExactlyOnce"));
+	QList<MUtils::IPCChannel*> channels;
+	for (int i = 0; i < 2 * MPMC_THREADS; ++i)
+	{
+		channels.append(new MUtils::IPCChannel(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC));
+		ASSERT_EQ(channels.last()->initialize(), int(i ? MUtils::IPCChannel::RET_SUCCESS_SLAVE : MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	}
+	QList<IPCSenderThread*> senders;
+	QList<IPCReaderThread*> readers;
+	QAtomicInt counter;
+	for (int i = 0; i < MPMC_THREADS; ++i)
+	{
+		quint64 totalSize = 0;
+		QList<ipc_message_t> messages(makeMessages(MPMC_COUNT, totalSize));
+		for (QList<ipc_message_t>::Iterator iter = messages.begin(); iter != messages.end(); ++iter)
+		{
+			iter->flags = quint32(i);
+		}
+		senders.append(new IPCSenderThread(*channels[i], messages));
+		readers.append(new IPCReaderThread(*channels[MPMC_THREADS + i], counter, MPMC_THREADS * MPMC_COUNT));
+	}
+	for (int i = 0; i < MPMC_THREADS; ++i)
+	{
+		readers[i]->start();
+		senders[i]->start();
+	}
+	bool success = true;
+	for (int i = 0; i < MPMC_THREADS; ++i)
+	{
+		success = senders[i]->wait(4 * IPC_TIMEOUT) && success;
+		success = readers[i]->wait(4 * IPC_TIMEOUT) && success;
+	}
+	QVector<quint32> received(MPMC_THREADS * MPMC_COUNT, 0U);
+	for (int i = 0; i < MPMC_THREADS; ++i)
+	{
+		success = senders[i]->success() && readers[i]->success() && success;
+		QVector<qint64> lastCommand(MPMC_THREADS, -1);
+		const QList<ipc_message_t> &messages = readers[i]->messages();
+		for (QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); ++iter)
+		{
+			if ((iter->flags >= MPMC_THREADS) || (iter->command >= MPMC_COUNT) || (qint64(iter->command) <= lastCommand[iter->flags]))
+			{
+				success = false; /*unexpected message, or messages of the same sender out of order*/
+				break;
+			}
+			lastCommand[iter->flags] = iter->command;
+			++received[(iter->flags * MPMC_COUNT) + iter->command];
+		}
+	}
+	qDeleteAll(senders);
+	qDeleteAll(readers);
+	qDeleteAll(channels);
+	ASSERT_TRUE(success);
+	for (int i = 0; i < received.count(); ++i)
+	{
+		ASSERT_EQ(received[i], 1U);
+	}
+}
+
+#undef MPMC_THREADS
+#undef MPMC_COUNT
+
+//-----------------------------------------------------------------
+// Publish/Subscribe
+//-----------------------------------------------------------------
+
+TEST_F(IPCChannelTest, PublishFanOut)
+{
+	const QString channelId(makeChannelId("PublishFanOut"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	QList<MUtils::IPCChannel*> subscribers;
+	for (int i = 0; i < 4; ++i)
+	{
+		subscribers.append(new MUtils::IPCChannel(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB));
+		ASSERT_EQ(subscribers.last()->initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	}
+	quint64 totalSize = 0;
+	const QList<ipc_message_t> messages(makeMessages(512, totalSize));
+	ASSERT_LT(totalSize, quint64(TEST_RING_SIZE / 2U));
+	ASSERT_TRUE(sender.send_batch(messages));
+	bool success = true;
+	for (QList<MUtils::IPCChannel*>::ConstIterator iter = subscribers.constBegin(); iter != subscribers.constEnd(); ++iter)
+	{
+		QList<ipc_message_t> output;
+		while ((output.count() < messages.count()) && ((*iter)->read_batch(output, 100, 0) > 0)) {}
+		success = compareMessages(output, messages) && ((*iter)->overflow_count() == 0U) && ((*iter)->read_batch(output, 100, 0) == 0) && success;
+	}
+	qDeleteAll(subscribers);
+	ASSERT_TRUE(success);
+}
+
+TEST_F(IPCChannelTest, PublishOverflow)
+{
+	const QString channelId(makeChannelId("PublishOverflow"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB);
+	MUtils::IPCChannel subscriber(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(subscriber.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	const QList<ipc_message_t> messages(makeLargeMessages(32, 65536));
+	for (QList<ipc_message_t>::ConstIterator iter = messages.constBegin(); iter != messages.constEnd(); ++iter)
+	{
+		ASSERT_TRUE(sender.try_send(iter->command, iter->flags, iter->params)); //senders never wait for the subscribers
+	}
+	ASSERT_EQ(subscriber.overflow_count(), 0U);
+	QList<ipc_message_t> output;
+	ASSERT_EQ(subscriber.read_batch(output, 100, 0), 0);
+	ASSERT_EQ(subscriber.overflow_count(), 1U);
+	ASSERT_TRUE(sender.try_send(42, 0, QStringList() << "hello"));
+	ASSERT_EQ(subscriber.read_batch(output, 100, 0), 1);
+	ASSERT_EQ(output.first().command, 42U);
+	ASSERT_EQ(subscriber.overflow_count(), 1U);
+	ASSERT_EQ(sender.overflow_count(), 0U);
+}
+
+TEST_F(IPCChannelTest, PublishMaxSubscribers)
+{
+	const QString channelId(makeChannelId("PublishMaxSubscribers"));
+	QList<MUtils::IPCChannel*> subscribers;
+	bool success = true;
+	for (int i = 0; success && (i < 64); ++i)
+	{
+		subscribers.append(new MUtils::IPCChannel(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB));
+		success = (subscribers.last()->initialize() != MUtils::IPCChannel::RET_FAILURE);
+	}
+	MUtils::IPCChannel extra(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB);
+	const int resultFull = extra.initialize();
+	delete subscribers.takeLast();
+	const int resultFreed = extra.initialize();
+	qDeleteAll(subscribers);
+	ASSERT_TRUE(success);
+	ASSERT_EQ(resultFull, int(MUtils::IPCChannel::RET_FAILURE));
+	ASSERT_EQ(resultFreed, int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+}
+
+//-----------------------------------------------------------------
+// Recovery
+//-----------------------------------------------------------------
+
+#define TEST_IPC_DEAD_SENDER(MODE) do \
+{ \
+	const QString channelId(makeChannelId(#MODE)); \
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE); \
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER)); \
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE)); \
+	quint64 totalSize = 0; \
+	const QList<ipc_message_t> messages(makeMessages(64, totalSize)); \
+	ASSERT_TRUE(sender.try_send(messages.first().command, messages.first().flags, messages.first().params)); \
+	ASSERT_TRUE(runChildProcess(channelId, MUtils::IPCChannel::MODE, "abandon_send")); \
+	ASSERT_TRUE(sender.send_batch(messages.mid(1))); \
+	QList<ipc_message_t> output; \
+	while ((output.count() < messages.count()) && (reader.read_batch(output, 100, IPC_TIMEOUT) > 0)) {} \
+	ASSERT_TRUE(compareMessages(output, messages)); \
+	ASSERT_EQ(reader.read_batch(output, 100, 0), 0); \
+	ASSERT_EQ(reader.overflow_count(), 0U); \
+} \
+while(0)
+
+TEST_F(IPCChannelTest, RecoveryDeadSenderMPMC)
+{
+	TEST_IPC_DEAD_SENDER(MODE_MPMC);
+}
+
+TEST_F(IPCChannelTest, RecoveryDeadSenderPubSub)
+{
+	TEST_IPC_DEAD_SENDER(MODE_PUBSUB);
+}
+
+#undef TEST_IPC_DEAD_SENDER
+
+TEST_F(IPCChannelTest, RecoveryDeadReaderMPMC)
+{
+	const QString channelId(makeChannelId("RecoveryDeadReaderMPMC"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	quint64 totalSize = 0;
+	const QList<ipc_message_t> messages(makeMessages(8, totalSize));
+	ASSERT_TRUE(sender.send_batch(messages));
+	ASSERT_TRUE(runChildProcess(channelId, MUtils::IPCChannel::MODE_MPMC, "abandon_read")); //the first three messages are lost with the reader
+	QList<ipc_message_t> output;
+	while ((output.count() < messages.count() - 3) && (reader.read_batch(output, 100, IPC_TIMEOUT) > 0)) {}
+	ASSERT_TRUE(compareMessages(output, messages.mid(3)));
+	const QList<ipc_message_t> largeMessages(makeLargeMessages(16, 131072));
+	for (QList<ipc_message_t>::ConstIterator iter = largeMessages.constBegin(); iter != largeMessages.constEnd(); ++iter)
+	{
+		ASSERT_TRUE(sender.send(iter->command, iter->flags, iter->params, IPC_TIMEOUT)); //the claimed records must not block the sender, once the ring is full
+		ipc_message_t message;
+		ASSERT_TRUE(reader.read(message, IPC_TIMEOUT));
+		ASSERT_EQ(message.command, iter->command);
+		ASSERT_TRUE(message.params == iter->params);
+	}
+	ipc_message_t message;
+	ASSERT_FALSE(reader.read(message, 0));
+}
+
+TEST_F(IPCChannelTest, RecoveryStalled)
+{
+	const QString channelId(makeChannelId("RecoveryStalled"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	MUtils::Internal::ipc_abandon_next(&sender);
+	ASSERT_TRUE(sender.try_send(1, 0));
+	ASSERT_TRUE(sender.try_send(2, 0));
+	g_stalledWarnings = 0;
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+	const QtMessageHandler previousHandler = qInstallMessageHandler(stalledMessageHandler);
+#else
+	const QtMsgHandler previousHandler = qInstallMsgHandler(stalledMessageHandler);
+#endif
+	ipc_message_t message;
+	const bool result = reader.read(message, 100); //the owner of the pending records is still alive, so they must *not* be skipped
+#if QT_VERSION >= QT_VERSION_CHECK(5,0,0)
+	qInstallMessageHandler(previousHandler);
+#else
+	qInstallMsgHandler(previousHandler);
+#endif
+	ASSERT_FALSE(result);
+	ASSERT_EQ(int(g_stalledWarnings), 1);
+}
+
+//-----------------------------------------------------------------
+// Shared Buffers
+//-----------------------------------------------------------------
+
+TEST_F(IPCChannelTest, BufferSenderGone)
+{
+	const QString channelId(makeChannelId("BufferSenderGone"));
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	const QByteArray payload(QByteArray(TEST_STRING).repeated(1024));
+	quint32 handles[3];
+	{
+		MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+		ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+		for (quint32 i = 0; i < 3; ++i)
+		{
+			quint8 *const buffer = sender.alloc_buffer(handles[i], 0);
+			ASSERT_TRUE(buffer != NULL);
+			memcpy(buffer, payload.constData(), payload.size());
+			buffer[0] = quint8('0' + i);
+			ASSERT_TRUE(sender.send_buffer(i, 0, handles[i], quint32(payload.size()), QStringList(), 0));
+		}
+	} //the sender is gone, before the reader has accessed any of the buffers
+	for (quint32 i = 0; i < 3; ++i)
+	{
+		ipc_message_t message;
+		ASSERT_TRUE(reader.read(message, 0));
+		ASSERT_EQ(message.command, i);
+		ASSERT_EQ(message.buffer, handles[i]);
+		ASSERT_EQ(message.buffer_size, quint32(payload.size()));
+		const quint8 *const data = reader.buffer_data(message.buffer);
+		ASSERT_TRUE(data != NULL);
+		ASSERT_EQ(data[0], quint8('0' + i));
+		ASSERT_EQ(memcmp(data + 1, payload.constData() + 1, payload.size() - 1), 0);
+		ASSERT_TRUE(reader.release_buffer(message.buffer));
+	}
+	ipc_message_t message;
+	ASSERT_FALSE(reader.read(message, 0));
+}
+
+TEST_F(IPCChannelTest, BufferExhausted)
+{
+	const QString channelId(makeChannelId("BufferExhausted"));
+	MUtils::IPCChannel channel(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+	ASSERT_EQ(channel.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	quint32 handles[MUtils::IPCChannel::BUFFER_COUNT];
+	for (quint32 i = 0; i < MUtils::IPCChannel::BUFFER_COUNT; ++i)
+	{
+		ASSERT_TRUE(channel.alloc_buffer(handles[i], 0) != NULL);
+	}
+	quint32 handle;
+	QElapsedTimer timer;
+	timer.start();
+	ASSERT_TRUE(channel.alloc_buffer(handle, 0) == NULL);
+	ASSERT_EQ(handle, quint32(MUtils::IPCChannel::NO_BUFFER));
+	ASSERT_LT(timer.elapsed(), 100);
+	timer.start();
+	ASSERT_TRUE(channel.alloc_buffer(handle, 250) == NULL);
+	ASSERT_GE(timer.elapsed(), 250);
+	IPCReleaseThread thread(channel, handles[7], 250);
+	thread.start();
+	timer.start();
+	ASSERT_TRUE(channel.alloc_buffer(handle, IPC_TIMEOUT) != NULL); //woken up by the release
+	ASSERT_LT(timer.elapsed(), IPC_TIMEOUT);
+	ASSERT_TRUE(thread.wait());
+	ASSERT_TRUE(thread.success());
+	ASSERT_EQ(handle, handles[7]);
+	for (quint32 i = 0; i < MUtils::IPCChannel::BUFFER_COUNT; ++i)
+	{
+		ASSERT_TRUE(channel.release_buffer(handles[i]));
+	}
+}
+
+TEST_F(IPCChannelTest, BufferInvalid)
+{
+	const QString channelId(makeChannelId("BufferInvalid"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	quint32 handle;
+	ASSERT_TRUE(sender.alloc_buffer(handle, 0) != NULL);
+	ASSERT_FALSE(sender.send_buffer(0, 0, quint32(MUtils::IPCChannel::BUFFER_COUNT), 16));
+	ASSERT_FALSE(sender.send_buffer(0, 0, handle, MUtils::IPCChannel::BUFFER_SIZE + 1U));
+	ASSERT_FALSE(sender.release_buffer(quint32(MUtils::IPCChannel::BUFFER_COUNT)));
+	ASSERT_FALSE(sender.release_buffer(quint32(MUtils::IPCChannel::NO_BUFFER)));
+	ASSERT_TRUE(sender.buffer_data(quint32(MUtils::IPCChannel::BUFFER_COUNT)) == NULL);
+	ASSERT_TRUE(sender.send_buffer(1, 0, handle, 16, QStringList(), 0));
+	ASSERT_FALSE(sender.send_buffer(2, 0, handle, 16, QStringList(), 0)); //the buffer is in flight
+	ASSERT_FALSE(sender.release_buffer(handle));
+	ipc_message_t message;
+	ASSERT_TRUE(reader.read(message, 0));
+	ASSERT_EQ(message.buffer, handle);
+	ASSERT_FALSE(reader.read(message, 0));
+	ASSERT_TRUE(reader.release_buffer(handle));
+	ASSERT_FALSE(reader.release_buffer(handle));
+	ASSERT_FALSE(sender.send_buffer(3, 0, handle, 16, QStringList(), 0));
+}
+
+TEST_F(IPCChannelTest, BufferDisabled)
+{
+	const QString channelId(makeChannelId("BufferDisabled"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_LOCKED, true);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_FAILURE));
+	quint32 handle;
+	ASSERT_TRUE(sender.alloc_buffer(handle, 0) == NULL);
+	ASSERT_EQ(handle, quint32(MUtils::IPCChannel::NO_BUFFER));
+	ASSERT_FALSE(sender.send_buffer(0, 0, 0, 16, QStringList(), 0));
+	ASSERT_TRUE(sender.buffer_data(0) == NULL);
+}
+
+TEST_F(IPCChannelTest, BufferPublish)
+{
+	const QString channelId(makeChannelId("BufferPublish"));
+	ASSERT_ANY_THROW(MUtils::IPCChannel(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB, true));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_PUBSUB);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	quint32 handle;
+	ASSERT_TRUE(sender.alloc_buffer(handle, 0) == NULL);
+	ASSERT_EQ(handle, quint32(MUtils::IPCChannel::NO_BUFFER));
+	ASSERT_FALSE(sender.send_buffer(0, 0, 0, 16, QStringList(), 0));
+	QList<ipc_message_t> messages;
+	messages.append(ipc_message_t());
+	messages.last().buffer = 0;
+	ASSERT_FALSE(sender.send_batch(messages));
+}
+
+TEST_F(IPCChannelTest, BufferBatch)
+{
+	const QString channelId(makeChannelId("BufferBatch"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC, true);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_MPMC, true);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	quint64 totalSize = 0;
+	QList<ipc_message_t> messages(makeMessages(6, totalSize));
+	for (int i = 0; i < messages.count(); i += 2)
+	{
+		quint8 *const buffer = sender.alloc_buffer(messages[i].buffer, 0);
+		ASSERT_TRUE(buffer != NULL);
+		memset(buffer, 'a' + i, 4096);
+		messages[i].buffer_size = 4096U + quint32(i);
+	}
+	QList<ipc_message_t> duplicate(messages);
+	duplicate.last().buffer = messages.first().buffer;
+	duplicate.last().buffer_size = 16U;
+	ASSERT_FALSE(sender.send_batch(duplicate)); //the same buffer can not be sent twice
+	ASSERT_TRUE(sender.send_batch(messages));
+	QList<ipc_message_t> output;
+	ASSERT_EQ(reader.read_batch(output, 100, 0), messages.count());
+	ASSERT_TRUE(compareMessages(output, messages));
+	for (int i = 0; i < output.count(); ++i)
+	{
+		ASSERT_EQ(output[i].buffer, messages[i].buffer);
+		ASSERT_EQ(output[i].buffer_size, messages[i].buffer_size);
+		if (output[i].buffer != MUtils::IPCChannel::NO_BUFFER)
+		{
+			const quint8 *const data = reader.buffer_data(output[i].buffer);
+			ASSERT_TRUE(data != NULL);
+			ASSERT_EQ(data[0], quint8('a' + i));
+			ASSERT_EQ(data[4095], quint8('a' + i));
+			ASSERT_TRUE(reader.release_buffer(output[i].buffer));
+		}
+	}
+}
+
+TEST_F(IPCChannelTest, BufferLegacyRead)
+{
+	const QString channelId(makeChannelId("BufferLegacyRead"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_SPSC, true);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_SPSC, true);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	quint32 handle;
+	ASSERT_TRUE(sender.alloc_buffer(handle, 0) != NULL);
+	ASSERT_TRUE(sender.send_buffer(42, 7, handle, 16, QStringList() << "param", 0));
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_TRUE(reader.read(command, flags, params, 0));
+	ASSERT_EQ(command, 42U);
+	ASSERT_EQ(flags, 7U);
+	ASSERT_EQ(params, QStringList() << "param");
+	ASSERT_FALSE(reader.release_buffer(handle)); //already released by read()
+	quint32 handles[MUtils::IPCChannel::BUFFER_COUNT];
+	for (quint32 i = 0; i < MUtils::IPCChannel::BUFFER_COUNT; ++i)
+	{
+		ASSERT_TRUE(sender.alloc_buffer(handles[i], 0) != NULL);
+	}
+}
+
+//-----------------------------------------------------------------
+// Notifier
+//-----------------------------------------------------------------
+
+TEST_F(IPCChannelTest, NotifierSignal)
+{
+	int argc = 1;
+	char appName[] = "MUtilsTest", *argv[] = { appName, NULL };
+	QScopedPointer<QCoreApplication> application(QCoreApplication::instance() ? NULL : new QCoreApplication(argc, argv));
+	const QString channelId(makeChannelId("NotifierSignal"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	MUtils::IPCChannelNotifier notifier(&reader);
+	QEventLoop loop;
+	QTimer timer;
+	timer.setSingleShot(true);
+	QObject::connect(&notifier, SIGNAL(messagesAvailable()), &loop, SLOT(quit()));
+	QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+	timer.start(IPC_TIMEOUT);
+	ASSERT_TRUE(sender.try_send(42, 0));
+	loop.exec();
+	ASSERT_TRUE(timer.isActive()); //the loop must have been stopped by the notifier, not by the timer
+	timer.stop();
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_TRUE(reader.try_read(command, flags, params));
+	ASSERT_EQ(command, 42U);
+}
+
+TEST_F(IPCChannelTest, NotifierStop)
+{
+	const QString channelId(makeChannelId("NotifierStop"));
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	QScopedPointer<MUtils::IPCChannelNotifier> notifier(new MUtils::IPCChannelNotifier(&reader));
+	MUtils::OS::sleep_ms(100); //make sure the thread is sleeping on the channel
+	QElapsedTimer timer;
+	timer.start();
+	notifier.reset();
+	ASSERT_LT(timer.elapsed(), 1000);
+}
+
+TEST_F(IPCChannelTest, NotifierWakeup)
+{
+	int argc = 1;
+	char appName[] = "MUtilsTest", *argv[] = { appName, NULL };
+	QScopedPointer<QCoreApplication> application(QCoreApplication::instance() ? NULL : new QCoreApplication(argc, argv));
+	const QString channelId(makeChannelId("NotifierWakeup"));
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId);
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	MUtils::IPCChannelNotifier notifier(&reader);
+	QEventLoop loop;
+	QTimer timer;
+	timer.setSingleShot(true);
+	QObject::connect(&notifier, SIGNAL(messagesAvailable()), &loop, SLOT(quit()));
+	QObject::connect(&timer, SIGNAL(timeout()), &loop, SLOT(quit()));
+	for (int round = 0; round < 2; ++round)
+	{
+		MUtils::OS::sleep_ms(100); //make sure the thread is sleeping on the channel
+		timer.start(IPC_TIMEOUT);
+		ASSERT_TRUE(runChildProcess(channelId, MUtils::IPCChannel::MODE_LOCKED, "send")); //the wake-up must cross the process boundary
+		loop.exec();
+		ASSERT_TRUE(timer.isActive()); //the loop must have been stopped by the notifier, not by the timer
+		timer.stop();
+		quint32 command, flags;
+		QStringList params;
+		ASSERT_TRUE(reader.try_read(command, flags, params)); //the notifier must signal again, once the channel has been drained
+		ASSERT_EQ(command, 42U);
+		ASSERT_FALSE(reader.try_read(command, flags, params));
+	}
+}
+
+TEST_F(IPCChannelTest, NotifierStopPending)
+{
+	const QString channelId(makeChannelId("NotifierStopPending"));
+	MUtils::IPCChannel sender(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_SPSC);
+	MUtils::IPCChannel reader(TEST_APP_ID, TEST_VERSION_NO, channelId, MUtils::IPCChannel::MODE_SPSC);
+	ASSERT_EQ(sender.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_MASTER));
+	ASSERT_EQ(reader.initialize(), int(MUtils::IPCChannel::RET_SUCCESS_SLAVE));
+	QScopedPointer<MUtils::IPCChannelNotifier> notifier(new MUtils::IPCChannelNotifier(&reader));
+	ASSERT_TRUE(sender.try_send(42, 0));
+	MUtils::OS::sleep_ms(100); //the message has been signalled, but not read, so the thread is sleeping on the channel again
+	QElapsedTimer timer;
+	timer.start();
+	notifier.reset();
+	ASSERT_LT(timer.elapsed(), 1000);
+	quint32 command, flags;
+	QStringList params;
+	ASSERT_TRUE(reader.try_read(command, flags, params));
+	ASSERT_EQ(command, 42U);
+}
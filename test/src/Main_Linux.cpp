@@ -0,0 +1,42 @@
+///////////////////////////////////////////////////////////////////////////////
+// MuldeR's Utilities for Qt
+// Copyright (C) 2004-2025 LoRd_MuldeR <MuldeR2@GMX.de>
+//
+// This library is free software; you can redistribute it and/or
+// modify it under the terms of the GNU Lesser General Public
+// License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+//
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public
+// License along with this library; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301  USA
+//
+// http://www.gnu.org/licenses/lgpl-2.1.txt
+//////////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Entry point of the regression tests in the portable (CMake) build. Unlike the Hash tests, which only need
+ * GTest::Main, the IPC tests need a QCoreApplication, e.g. for IPCChannelNotifier and for spawning helper processes.
+ */
+
+//Google Test
+#include <gtest/gtest.h>
+
+//Qt
+#include <QCoreApplication>
+
+//===========================================================================
+// Main function
+//===========================================================================
+
+int main(int argc, char **argv)
+{
+	QCoreApplication application(argc, argv);
+	::testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}